@@ -0,0 +1,536 @@
+#include "EngineServer.h"
+#include "../Source/DebugLog.h"
+#include <string>
+#include <utility>
+
+#if ! JUCE_WINDOWS
+ #include <poll.h>
+ #include <sys/socket.h>
+ #include <unistd.h>
+ #include <cerrno>
+#endif
+
+namespace
+{
+    // A new connection must say what it is for within this long, in a line no longer than this
+    constexpr juce::uint32 firstLineTimeoutMs = 2000;
+    constexpr size_t maxFirstLineBytes = 256;
+}
+
+//==============================================================================
+/** One connected plugin instance */
+class EngineServer::Session
+{
+public:
+    Session(EngineServer& owner, int sessionId, int socket)
+        : server(owner), id(sessionId), controlSocket(socket),
+          memoryName("/hmrs" + juce::String(juce::Process::getCurrentProcessId()) + "_" + juce::String(sessionId)),
+          engine(std::make_unique<SamplerEngine>())
+    {
+        renderBuffer.setSize(EngineIPC::numChannels, EngineIPC::maxBlockSize);
+        engine->prepareToPlay(sampleRate, EngineIPC::maxBlockSize);
+    }
+
+    ~Session()
+    {
+        stopRendering.store(true);
+        EngineIPC::shutdownSocket(wakeSocket);
+        if (renderThread.joinable())
+            renderThread.join();
+
+        EngineIPC::shutdownSocket(controlSocket);
+        if (controlThread.joinable())
+            controlThread.join();
+
+        EngineIPC::closeSocket(wakeSocket);
+        EngineIPC::closeSocket(controlSocket);
+
+        if (!memoryUnlinked)
+            EngineIPC::unlinkSessionBlock(memoryName);
+        EngineIPC::unmapSessionBlock(block);
+
+        server.retireEngine(std::move(engine));
+        DebugLog::write("EngineServer: session " + juce::String(id) + " closed");
+    }
+
+    int getId() const { return id; }
+    const juce::String& getMemoryName() const { return memoryName; }
+    bool isFinished() const { return finished.load(); }
+
+    /** Create the shared memory and start serving commands */
+    bool open()
+    {
+        block = EngineIPC::createSessionBlock(memoryName);
+        if (block == nullptr)
+            return false;
+
+        block->reset(blockSize);
+        return true;
+    }
+
+    void startControl()
+    {
+        controlThread = std::thread([this] { runControl(); });
+    }
+
+    /** The client has mapped the memory and opened its wake-up connection: start rendering */
+    bool attachWakeSocket(int socket)
+    {
+        if (wakeSocket >= 0)
+            return false;
+
+        wakeSocket = socket;
+        EngineIPC::unlinkSessionBlock(memoryName);
+        memoryUnlinked = true;
+
+        renderThread = std::thread([this] { runRender(); });
+        return true;
+    }
+
+private:
+    void runControl()
+    {
+        juce::String line;
+        while (EngineIPC::readLine(controlSocket, line, -1))
+        {
+            if (line == "BYE")
+            {
+                EngineIPC::sendLine(controlSocket, "OK");
+                break;
+            }
+
+            if (!EngineIPC::sendLine(controlSocket, handleCommand(line)))
+                break;
+        }
+
+        finished.store(true);
+    }
+
+    juce::String handleCommand(const juce::String& line)
+    {
+        const juce::String command = line.upToFirstOccurrenceOf(" ", false, false);
+        const juce::String arguments = line.fromFirstOccurrenceOf(" ", false, false);
+
+        juce::StringArray values;
+        values.addTokens(arguments, " ", {});
+
+        if (command == "PREPARE" && values.size() == 2)
+        {
+            std::lock_guard<std::mutex> lock(engineMutex);
+            sampleRate = values[0].getDoubleValue();
+            blockSize = juce::jlimit(1, EngineIPC::maxBlockSize, values[1].getIntValue());
+
+            // Prepared for the largest request, so any host block size fits
+            engine->prepareToPlay(sampleRate, EngineIPC::maxBlockSize);
+            block->reset(blockSize);
+            return "OK";
+        }
+
+        if (command == "LOAD" && arguments.isNotEmpty())
+        {
+            loadSamples(arguments);
+            return "OK";
+        }
+
+        if (command == "ADSR" && values.size() == 4)
+        {
+            engine->setADSR(values[0].getFloatValue(), values[1].getFloatValue(),
+                            values[2].getFloatValue(), values[3].getFloatValue());
+            return "OK";
+        }
+
+        if (command == "PRELOAD" && values.size() == 1)
+        {
+            engine->setPreloadSizeKB(values[0].getIntValue());
+            engine->reloadPreloadBuffers();
+            return "OK";
+        }
+
+        if (command == "VELLIMIT" && values.size() == 1)
+        {
+            engine->setVelocityLayerLimit(values[0].getIntValue());
+            return "OK";
+        }
+
+        if (command == "RRLIMIT" && values.size() == 1)
+        {
+            engine->setRoundRobinLimit(values[0].getIntValue());
+            return "OK";
+        }
+
+        if (command == "COLDSTART" && values.size() == 1)
+        {
+            engine->setColdStart(values[0].getIntValue() != 0);
+            return "OK";
+        }
+
+        if (command == "HIBERNATE" && values.size() == 1)
+        {
+            engine->setHibernateAfterSeconds(values[0].getIntValue());
+            return "OK";
+        }
+
+        return "ERR unknown command: " + command;
+    }
+
+    void loadSamples(const juce::String& folderPath)
+    {
+        auto warm = server.takeWarmEngine(folderPath);
+        if (warm == nullptr)
+        {
+            engine->loadSamplesFromFolder(juce::File(folderPath));
+            return;
+        }
+
+        // Adopt the warm engine with this session's settings
+        const auto adsr = engine->getADSR();
+        warm->setADSR(adsr.attack, adsr.decay, adsr.sustain, adsr.release);
+        warm->setColdStart(engine->getColdStart());
+        warm->setHibernateAfterSeconds(engine->getHibernateAfterSeconds());
+
+        // Limits start at the library's maximum, as after any load; the client's VELLIMIT/RRLIMIT follow
+        warm->setVelocityLayerLimit(warm->getMaxVelocityLayersGlobal());
+        warm->setRoundRobinLimit(warm->getMaxRoundRobins());
+        if (warm->getPreloadSizeKB() != engine->getPreloadSizeKB())
+        {
+            warm->setPreloadSizeKB(engine->getPreloadSizeKB());
+            warm->reloadPreloadBuffers();
+        }
+
+        std::unique_ptr<SamplerEngine> previous;
+        {
+            std::lock_guard<std::mutex> lock(engineMutex);
+            warm->prepareToPlay(sampleRate, EngineIPC::maxBlockSize);
+            previous = std::exchange(engine, std::move(warm));
+        }
+
+        DebugLog::write("EngineServer: session " + juce::String(id) + " adopted warm engine for " + folderPath);
+        server.retireEngine(std::move(previous));
+    }
+
+    void runRender()
+    {
+        while (!stopRendering.load())
+        {
+            // Wakes once per client block; the timeout only bounds how long a stop takes
+            if (!EngineIPC::waitForWake(wakeSocket, 100))
+                break;
+
+            std::lock_guard<std::mutex> lock(engineMutex);
+            while (const auto* request = block->peekRequest())
+            {
+                render(*request);
+                block->popRequest();
+            }
+
+            block->loadingState.store(static_cast<int32_t>(engine->getLoadingState()), std::memory_order_relaxed);
+            block->activeVoices.store(engine->getActiveVoiceCount(), std::memory_order_relaxed);
+            block->streamingVoices.store(engine->getStreamingVoiceCount(), std::memory_order_relaxed);
+            block->preloadBytes.store(engine->getPreloadMemoryBytes(), std::memory_order_relaxed);
+            block->diskThroughputMBps.store(engine->getDiskThroughputMBps(), std::memory_order_relaxed);
+        }
+
+        finished.store(true);
+    }
+
+    void render(const EngineIPC::RenderRequest& request)
+    {
+        const int numSamples = juce::jlimit(0, EngineIPC::maxBlockSize, static_cast<int>(request.numSamples));
+        juce::AudioBuffer<float> output(renderBuffer.getArrayOfWritePointers(), EngineIPC::numChannels, numSamples);
+        output.clear();
+
+        engine->setInterpolationQuality(static_cast<InterpolationQuality>(juce::jlimit(0, 2, static_cast<int>(request.interpolationQuality))));
+
+        const int numEvents = juce::jlimit(0, EngineIPC::maxEventsPerRequest, static_cast<int>(request.numEvents));
+        for (int i = 0; i < numEvents; ++i)
+        {
+            const auto& event = request.events[i];
+            if (event.type == NoteEventQueue::Type::NoteOn)
+                engine->queueNoteOn(event.samplePosition, event.midiNote, event.velocity, event.roundRobin, event.sampleOffset);
+            else
+                engine->queueNoteOff(event.samplePosition, event.midiNote);
+        }
+
+        engine->processBlock(output);
+        block->writeAudio(output.getArrayOfReadPointers(), numSamples);
+    }
+
+    EngineServer& server;
+    const int id;
+    int controlSocket = -1;
+    int wakeSocket = -1;
+
+    const juce::String memoryName;
+    bool memoryUnlinked = false;
+    EngineIPC::SessionBlock* block = nullptr;
+
+    std::mutex engineMutex;  // Render thread vs. PREPARE and engine adoption
+    std::unique_ptr<SamplerEngine> engine;
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+    juce::AudioBuffer<float> renderBuffer;
+
+    std::thread controlThread;
+    std::thread renderThread;
+    std::atomic<bool> stopRendering{false};
+    std::atomic<bool> finished{false};
+};
+
+//==============================================================================
+EngineServer::EngineServer(const juce::String& path, int keepWarm)
+    : socketPath(path), keepWarmSeconds(juce::jmax(0, keepWarm))
+{
+}
+
+EngineServer::~EngineServer()
+{
+    stop();
+}
+
+bool EngineServer::start()
+{
+    if (running.load() || !EngineIPC::isSupported())
+        return false;
+
+    listenSocket = EngineIPC::listenOnSocket(socketPath);
+    if (listenSocket < 0)
+        return false;
+
+    running.store(true);
+    acceptThread = std::thread([this] { acceptConnections(); });
+
+    DebugLog::write("EngineServer: listening on " + socketPath);
+    return true;
+}
+
+void EngineServer::stop()
+{
+    if (!running.exchange(false))
+        return;
+
+    if (acceptThread.joinable())
+        acceptThread.join();
+
+    EngineIPC::closeSocket(listenSocket);
+    listenSocket = -1;
+    juce::File(socketPath).deleteFile();
+
+    std::vector<std::unique_ptr<Session>> closing;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        closing.swap(sessions);
+    }
+    closing.clear();
+
+    std::lock_guard<std::mutex> lock(warmMutex);
+    warmEngines.clear();
+}
+
+int EngineServer::getNumSessions() const
+{
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    return static_cast<int>(sessions.size());
+}
+
+int EngineServer::getNumWarmEngines() const
+{
+    std::lock_guard<std::mutex> lock(warmMutex);
+    return static_cast<int>(warmEngines.size());
+}
+
+#if ! JUCE_WINDOWS
+/** Read what has arrived of a connection's first line without blocking: 1 once the line is complete, -1 if the peer is gone */
+static int readFirstLineBytes(int socket, std::string& text)
+{
+    for (;;)
+    {
+        char c = 0;
+        const ssize_t received = recv(socket, &c, 1, MSG_DONTWAIT);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return 0;
+        if (received <= 0 || text.size() >= maxFirstLineBytes)
+            return -1;
+
+        if (c == '\n')
+            return 1;
+        text += c;
+    }
+}
+#endif
+
+void EngineServer::acceptConnections()
+{
+   #if ! JUCE_WINDOWS
+    // Connections that haven't sent their first line yet, read as bytes arrive so a slow or
+    // silent client can't hold up everyone else's connect
+    struct PendingConnection
+    {
+        int socket = -1;
+        std::string text;
+        juce::uint32 acceptedAt = 0;
+    };
+    std::vector<PendingConnection> pending;
+    std::vector<pollfd> waiting;
+
+    while (running.load())
+    {
+        waiting.clear();
+        waiting.push_back({ listenSocket, POLLIN, 0 });
+        for (const auto& connection : pending)
+            waiting.push_back({ connection.socket, POLLIN, 0 });
+
+        // On an error no revents are set, so it just counts as a timeout
+        poll(waiting.data(), static_cast<nfds_t>(waiting.size()), pending.empty() ? 1000 : 100);
+
+        const auto now = juce::Time::getMillisecondCounter();
+        std::vector<PendingConnection> stillPending;
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            auto& connection = pending[i];
+            const int state = waiting[i + 1].revents != 0 ? readFirstLineBytes(connection.socket, connection.text) : 0;
+
+            if (state > 0)
+                handleNewConnection(connection.socket, juce::String::fromUTF8(connection.text.data(), static_cast<int>(connection.text.size())).trimEnd());
+            else if (state < 0 || now - connection.acceptedAt > firstLineTimeoutMs)
+                EngineIPC::closeSocket(connection.socket);
+            else
+                stillPending.push_back(std::move(connection));
+        }
+        pending.swap(stillPending);
+
+        if ((waiting[0].revents & POLLIN) != 0)
+        {
+            int socket = accept(listenSocket, nullptr, nullptr);
+            if (socket >= 0)
+                pending.push_back({ socket, {}, now });
+        }
+
+        reapFinishedSessions();
+        evictWarmEngines();
+    }
+
+    for (auto& connection : pending)
+        EngineIPC::closeSocket(connection.socket);
+   #endif
+}
+
+void EngineServer::handleNewConnection(int socket, const juce::String& line)
+{
+    // The first line says what the connection is for
+    if (line.startsWith("HELLO "))
+    {
+        if (line.fromFirstOccurrenceOf(" ", false, false).getIntValue() != EngineIPC::protocolVersion)
+        {
+            EngineIPC::sendLine(socket, "ERR protocol version " + juce::String(EngineIPC::protocolVersion) + " required");
+            EngineIPC::closeSocket(socket);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        auto session = std::make_unique<Session>(*this, nextSessionId++, socket);
+        if (!session->open())
+        {
+            EngineIPC::sendLine(socket, "ERR shared memory unavailable");
+            return;  // The session closes the socket
+        }
+
+        EngineIPC::sendLine(socket, "OK " + juce::String(session->getId()) + " " + session->getMemoryName());
+        session->startControl();
+        DebugLog::write("EngineServer: session " + juce::String(session->getId()) + " opened");
+        sessions.push_back(std::move(session));
+        return;
+    }
+
+    if (line.startsWith("WAKE "))
+    {
+        const int sessionId = line.fromFirstOccurrenceOf(" ", false, false).getIntValue();
+
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        for (auto& session : sessions)
+        {
+            if (session->getId() == sessionId && session->attachWakeSocket(socket))
+            {
+                EngineIPC::sendLine(socket, "OK");
+                return;
+            }
+        }
+    }
+
+    EngineIPC::sendLine(socket, "ERR unexpected connection");
+    EngineIPC::closeSocket(socket);
+}
+
+void EngineServer::reapFinishedSessions()
+{
+    std::vector<std::unique_ptr<Session>> finished;
+    {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        for (auto it = sessions.begin(); it != sessions.end();)
+        {
+            if ((*it)->isFinished())
+            {
+                finished.push_back(std::move(*it));
+                it = sessions.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    // Joins the session's threads and retires its engine, outside the sessions lock
+    finished.clear();
+}
+
+std::unique_ptr<SamplerEngine> EngineServer::takeWarmEngine(const juce::String& folderPath)
+{
+    std::lock_guard<std::mutex> lock(warmMutex);
+    for (auto it = warmEngines.begin(); it != warmEngines.end(); ++it)
+    {
+        if (it->engine->getLoadedFolderPath() == folderPath && it->engine->isLoaded())
+        {
+            auto engine = std::move(it->engine);
+            warmEngines.erase(it);
+            return engine;
+        }
+    }
+    return nullptr;
+}
+
+void EngineServer::retireEngine(std::unique_ptr<SamplerEngine> engine)
+{
+    if (engine == nullptr || keepWarmSeconds == 0 || !engine->isLoaded())
+        return;
+
+    // Release anything still held so a later adopter starts clean
+    for (int note = 0; note < 128; ++note)
+        engine->noteOff(note);
+
+    std::lock_guard<std::mutex> lock(warmMutex);
+    warmEngines.push_back({ std::move(engine), juce::Time::getMillisecondCounterHiRes() });
+}
+
+void EngineServer::evictWarmEngines()
+{
+    std::vector<std::unique_ptr<SamplerEngine>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(warmMutex);
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        for (auto it = warmEngines.begin(); it != warmEngines.end();)
+        {
+            if (now - it->retiredAt > keepWarmSeconds * 1000.0)
+            {
+                DebugLog::write("EngineServer: evicting warm engine for " + it->engine->getLoadedFolderPath());
+                evicted.push_back(std::move(it->engine));
+                it = warmEngines.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../Source/EngineIPC.h"
+#include "../Source/SamplerEngine.h"
+
+/**
+ * EngineServer runs SamplerEngines for plugin clients in one long-lived process
+ * (HammerSamplerServer), so libraries, preloads, disk streaming and voice rendering live
+ * in one place however many instances the DAW opens.
+ *
+ * - Listens on a Unix-domain socket; each client gets a Session with its own SamplerEngine,
+ *   a shared-memory SessionBlock for note events and audio, and a render thread
+ * - All sessions share the process-wide SharedSamplePool and DiskStreamer, so clients that
+ *   load the same library share its scan, preloads and disk threads
+ * - When a client goes away its loaded engine is kept warm for keepWarmSeconds: a client
+ *   that loads the same folder again (a DAW restart, a reopened project) adopts it instantly
+ */
+class EngineServer
+{
+public:
+    static constexpr int defaultKeepWarmSeconds = 600;
+
+    EngineServer(const juce::String& socketPath, int keepWarmSeconds = defaultKeepWarmSeconds);
+    ~EngineServer();
+
+    /** Start listening. False if the socket can't be created. */
+    bool start();
+    void stop();
+
+    int getNumSessions() const;
+    int getNumWarmEngines() const;
+
+private:
+    class Session;
+
+    void acceptConnections();
+    void handleNewConnection(int socket, const juce::String& line);
+    void reapFinishedSessions();
+
+    /** A warm engine that has this folder loaded, or nullptr */
+    std::unique_ptr<SamplerEngine> takeWarmEngine(const juce::String& folderPath);
+
+    /** Keep a loaded engine warm (drop it if nothing is loaded) */
+    void retireEngine(std::unique_ptr<SamplerEngine> engine);
+    void evictWarmEngines();
+
+    const juce::String socketPath;
+    const int keepWarmSeconds;
+    int listenSocket = -1;
+
+    std::atomic<bool> running{false};
+    std::thread acceptThread;
+
+    mutable std::mutex sessionsMutex;
+    std::vector<std::unique_ptr<Session>> sessions;
+    int nextSessionId = 1;
+
+    struct WarmEngine
+    {
+        std::unique_ptr<SamplerEngine> engine;
+        double retiredAt = 0.0;  // Time::getMillisecondCounterHiRes
+    };
+
+    mutable std::mutex warmMutex;
+    std::vector<WarmEngine> warmEngines;
+};
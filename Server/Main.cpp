@@ -0,0 +1,54 @@
+#include <juce_core/juce_core.h>
+#include <csignal>
+#include <iostream>
+#include "EngineServer.h"
+#include "../Source/PreloadBudget.h"
+
+//==============================================================================
+// Headless engine server: hosts SamplerEngines for plugin instances on this machine
+//
+//   HammerSamplerServer [--socket <path>] [--keep-warm <seconds>] [--preload-budget <MB>]
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    juce::String socketPath = EngineIPC::getDefaultSocketPath();
+    if (args.containsOption("--socket"))
+        socketPath = args.getValueForOption("--socket");
+
+    int keepWarmSeconds = EngineServer::defaultKeepWarmSeconds;
+    if (args.containsOption("--keep-warm"))
+        keepWarmSeconds = args.getValueForOption("--keep-warm").getIntValue();
+
+    // Block the stop signals before any thread starts, then wait for one on the main thread
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    sigaddset(&stopSignals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Preload RAM budget for every engine the server runs (held for the server's lifetime)
+    juce::SharedResourcePointer<PreloadBudget> preloadBudget;
+    if (args.containsOption("--preload-budget"))
+        preloadBudget->setBudgetBytes(static_cast<int64_t>(args.getValueForOption("--preload-budget").getIntValue()) * 1024 * 1024);
+
+    EngineServer server(socketPath, keepWarmSeconds);
+    if (!server.start())
+    {
+        std::cerr << "Could not listen on " << socketPath << " (is another server running there?)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Hammer Sampler engine server listening on " << socketPath
+              << " (keeping libraries warm for " << keepWarmSeconds << " s)" << std::endl;
+
+    int signalNumber = 0;
+    sigwait(&stopSignals, &signalNumber);
+
+    std::cout << "Stopping (" << server.getNumSessions() << " sessions)" << std::endl;
+    server.stop();
+    return 0;
+}
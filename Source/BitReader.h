@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+ #include <intrin.h>
+#endif
+
+/**
+ * MSB-first bit reader over a block of bytes, shared by the decoders (LosslessCodec for the
+ * sample container, FlacSeekIndex for FLAC frames).
+ *
+ * A 64-bit cache is topped up before every read, so reads of up to 32 bits need no bounds
+ * checks. Reading past the end yields zero bits rather than failing; callers check
+ * isValid() once per block instead.
+ */
+class BitReader
+{
+public:
+    BitReader(const uint8_t* bytes, size_t size) : data(bytes), numBytes(size) { refill(); }
+
+    /** The next numBits (0 to 32) as an unsigned value */
+    uint32_t read(int numBits)
+    {
+        if (numBits == 0)
+            return 0;
+
+        refill();
+        const auto value = static_cast<uint32_t>(cache >> (64 - numBits));
+        skipCached(numBits);
+        return value;
+    }
+
+    /** The next numBits as a two's complement value */
+    int32_t readSigned(int numBits)
+    {
+        if (numBits == 0)
+            return 0;
+
+        const uint32_t value = read(numBits);
+        return static_cast<int32_t>(value << (32 - numBits)) >> (32 - numBits);
+    }
+
+    /** Count zeros up to the next one bit, which is consumed too. Runs of any length are
+        allowed; past the end the count stops at the zeros that were left. */
+    uint32_t readUnary()
+    {
+        uint32_t zeros = 0;
+        for (;;)
+        {
+            refill();
+            if (cache != 0)
+            {
+                const int leading = countLeadingZeros(cache);
+                skipCached(leading + 1);
+                return zeros + static_cast<uint32_t>(leading);
+            }
+
+            // Nothing but zeros is cached (the bits below the cached ones are zero too)
+            zeros += static_cast<uint32_t>(available);
+            available = 0;
+            if (position > numBytes)
+                return zeros;
+        }
+    }
+
+    /** Leading zeros of the next 57 bits, without consuming them (57 or more: all of them) */
+    int peekLeadingZeros()
+    {
+        refill();
+        return countLeadingZeros(cache);
+    }
+
+    /** Drop numBits (at most 57) */
+    void skip(int numBits)
+    {
+        refill();
+        skipCached(numBits);
+    }
+
+    void alignToByte() { read(static_cast<int>((8 - getBitPosition() % 8) % 8)); }
+
+    size_t getBitPosition() const { return position * 8 - static_cast<size_t>(available); }
+
+    /** False once a read has gone past the end of the data */
+    bool isValid() const { return getBitPosition() <= numBytes * 8; }
+
+    static int countLeadingZeros(uint64_t value)
+    {
+       #if defined(_MSC_VER)
+        unsigned long index = 0;
+        return _BitScanReverse64(&index, value) ? 63 - static_cast<int>(index) : 64;
+       #else
+        return value != 0 ? __builtin_clzll(value) : 64;
+       #endif
+    }
+
+private:
+    void skipCached(int numBits)
+    {
+        cache = numBits < 64 ? cache << numBits : 0;
+        available -= numBits;
+    }
+
+    // At least 57 bits stay cached after a refill, the rest of the cache word being zero
+    void refill()
+    {
+        while (available <= 56)
+        {
+            const uint64_t byte = position < numBytes ? data[position] : 0;
+            cache |= byte << (56 - available);
+            available += 8;
+            ++position;
+        }
+    }
+
+    const uint8_t* data;
+    size_t numBytes;
+    size_t position = 0;
+    uint64_t cache = 0;
+    int available = 0;
+};
@@ -0,0 +1,151 @@
+#include "BlockEnvelope.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void BlockEnvelope::setSampleRate(double newSampleRate)
+{
+    sampleRate = newSampleRate > 0.0 ? newSampleRate : 44100.0;
+}
+
+void BlockEnvelope::setParameters(const juce::ADSR::Parameters& newParameters)
+{
+    parameters = newParameters;
+
+    // Re-aim the running segment so the new times take effect immediately
+    switch (stage)
+    {
+        case Stage::Attack:  beginSegment(Stage::Attack, 1.0f, parameters.attack, attackOvershoot); break;
+        case Stage::Decay:   beginSegment(Stage::Decay, parameters.sustain, parameters.decay, decayReleaseOvershoot); break;
+        case Stage::Sustain: level = parameters.sustain; break;
+        case Stage::Release:
+        case Stage::Idle:    break;
+    }
+}
+
+void BlockEnvelope::noteOn()
+{
+    beginSegment(Stage::Attack, 1.0f, parameters.attack, attackOvershoot);
+}
+
+void BlockEnvelope::noteOff()
+{
+    noteOff(parameters.release);
+}
+
+void BlockEnvelope::noteOff(float releaseSeconds)
+{
+    if (stage == Stage::Idle)
+        return;
+
+    beginSegment(Stage::Release, 0.0f, releaseSeconds, decayReleaseOvershoot);
+}
+
+void BlockEnvelope::reset()
+{
+    stage = Stage::Idle;
+    level = 0.0f;
+}
+
+void BlockEnvelope::beginSegment(Stage newStage, float endLevel, float seconds, float overshootRatio)
+{
+    stage = newStage;
+    segmentEnd = endLevel;
+
+    const float span = endLevel - level;
+    const double numSamples = std::max(1.0, static_cast<double>(seconds) * sampleRate);
+
+    if (std::abs(span) < 1.0e-6f)
+    {
+        // Already there: a zero-length segment that completes on the next sample
+        segmentTarget = endLevel;
+        coefficient = 0.0f;
+        offset = endLevel;
+        return;
+    }
+
+    // Aim past the end level so the curve crosses it after exactly numSamples
+    segmentTarget = endLevel + overshootRatio * span;
+    coefficient = static_cast<float>(std::exp(std::log(overshootRatio / (1.0 + overshootRatio)) / numSamples));
+    offset = segmentTarget * (1.0f - coefficient);
+}
+
+int BlockEnvelope::samplesUntilSegmentEnd() const
+{
+    if (stage == Stage::Sustain)
+        return std::numeric_limits<int>::max();
+
+    if (coefficient <= 0.0f)
+        return 1;
+
+    // level(n) = target + (level - target) * coefficient^n, solved for level(n) == segmentEnd
+    const double remaining = static_cast<double>(segmentEnd - segmentTarget) / static_cast<double>(level - segmentTarget);
+    if (remaining <= 0.0 || remaining >= 1.0)
+        return 1;
+
+    const double n = std::log(remaining) / std::log(static_cast<double>(coefficient));
+    return static_cast<int>(std::min(std::ceil(n), static_cast<double>(std::numeric_limits<int>::max() / 2)));
+}
+
+int BlockEnvelope::process(float* gains, int numSamples)
+{
+    int position = 0;
+
+    while (position < numSamples && stage != Stage::Idle)
+    {
+        const int runLength = std::min(numSamples - position, samplesUntilSegmentEnd());
+
+        if (stage == Stage::Sustain)
+        {
+            std::fill(gains + position, gains + position + runLength, level);
+        }
+        else
+        {
+            // Branch-free exponential run
+            float current = level;
+            const float c = coefficient;
+            const float o = offset;
+            for (int i = 0; i < runLength; ++i)
+            {
+                current = current * c + o;
+                gains[position + i] = current;
+            }
+            level = current;
+        }
+
+        position += runLength;
+
+        if (stage == Stage::Sustain)
+            continue;
+
+        // Segment finished inside this run?
+        const bool reachedEnd = (segmentTarget >= segmentEnd) ? (level >= segmentEnd) : (level <= segmentEnd);
+        if (!reachedEnd)
+            continue;
+
+        level = segmentEnd;
+        if (position > 0)
+            gains[position - 1] = level;
+
+        switch (stage)
+        {
+            case Stage::Attack:
+                beginSegment(Stage::Decay, parameters.sustain, parameters.decay, decayReleaseOvershoot);
+                break;
+            case Stage::Decay:
+                stage = Stage::Sustain;
+                level = parameters.sustain;
+                break;
+            case Stage::Release:
+                reset();
+                break;
+            case Stage::Sustain:
+            case Stage::Idle:
+                break;
+        }
+    }
+
+    const int activeSamples = position;
+    std::fill(gains + position, gains + numSamples, 0.0f);
+    return activeSamples;
+}
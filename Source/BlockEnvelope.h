@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * BlockEnvelope is an ADSR that renders a whole block of gain values at once.
+ *
+ * Every stage is an exponential segment heading for a target slightly beyond its end
+ * level, so each sample is a single multiply-add with no per-sample state branching:
+ *     level = level * coefficient + offset
+ * The number of samples left in a segment is computed in closed form, so a block is
+ * filled as a few branch-free runs, one per segment it touches.
+ *
+ * Parameters use juce::ADSR::Parameters, so it can stand in for juce::ADSR.
+ */
+class BlockEnvelope
+{
+public:
+    void setSampleRate(double newSampleRate);
+    void setParameters(const juce::ADSR::Parameters& newParameters);
+    const juce::ADSR::Parameters& getParameters() const { return parameters; }
+
+    void noteOn();
+    void noteOff();
+
+    /** Release over a one-off time instead of the parameter release (same-note retrigger) */
+    void noteOff(float releaseSeconds);
+
+    void reset();
+    bool isActive() const { return stage != Stage::Idle; }
+    float getCurrentLevel() const { return level; }
+
+    /** The loudest the envelope can still get: full scale while attacking, else the current level */
+    float getPeakRemainingLevel() const { return stage == Stage::Attack ? 1.0f : level; }
+
+    /**
+     * Writes numSamples envelope values to gains.
+     * Returns how many samples were active; the rest of the block is zero-filled.
+     */
+    int process(float* gains, int numSamples);
+
+private:
+    enum class Stage { Idle, Attack, Decay, Sustain, Release };
+
+    /** Sets up an exponential segment from the current level to endLevel over the given time */
+    void beginSegment(Stage newStage, float endLevel, float seconds, float overshootRatio);
+
+    /** Samples until the current segment reaches its end level (closed form) */
+    int samplesUntilSegmentEnd() const;
+
+    juce::ADSR::Parameters parameters;
+    double sampleRate = 44100.0;
+
+    Stage stage = Stage::Idle;
+    float level = 0.0f;
+    float segmentEnd = 0.0f;
+    float segmentTarget = 0.0f;
+    float coefficient = 0.0f;
+    float offset = 0.0f;
+
+    // Target overshoot as a fraction of the segment span: small for attack (near-linear rise),
+    // tiny for decay/release (natural exponential tail that still ends on time)
+    static constexpr float attackOvershoot = 0.3f;
+    static constexpr float decayReleaseOvershoot = 0.001f;
+};
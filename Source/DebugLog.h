@@ -0,0 +1,17 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * The engine's debug log, shared by every source file.
+ *
+ * Messages go through juce::Logger: to stderr (or the debugger) unless the application
+ * installs its own logger, so the plugin, the engine server and the tools all log the same way.
+ */
+namespace DebugLog
+{
+    inline void write(const juce::String& message)
+    {
+        juce::Logger::writeToLog("[" + juce::Time::getCurrentTime().toString(true, true, true, true) + "] " + message);
+    }
+}
@@ -1,176 +1,390 @@
 #include "DiskStreamer.h"
+#include "DebugLog.h"
+#include "SampleContainer.h"
+#include <algorithm>
+
+#if ! JUCE_WINDOWS
+ #include <sys/stat.h>
+#endif
 
 // Debug logging to file (same as PluginProcessor)
-static void streamDebugLog(const juce::String& msg)
+//==============================================================================
+DiskStreamer::IOThread::IOThread(DiskStreamer& owner, int index)
+    : juce::Thread("DiskStreamer " + juce::String(index)),
+      service(owner)
 {
-    auto logFile = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
-                       .getChildFile("sampler_streaming_debug.txt");
-    auto timestamp = juce::Time::getCurrentTime().toString(true, true, true, true);
-    logFile.appendText("[" + timestamp + "] " + msg + "\n");
+    // Allocate temporary buffer for disk reads (stereo)
+    tempReadBuffer.setSize(2, StreamingConstants::diskReadFrames);
 }
 
-DiskStreamer::DiskStreamer()
-    : juce::Thread("DiskStreamer")
+void DiskStreamer::IOThread::run()
 {
-    // Initialize all voice pointers to null
-    for (auto& voice : voices)
-        voice.store(nullptr, std::memory_order_relaxed);
+    DebugLog::write(">>> " + getThreadName() + " thread STARTED");
+    service.serveRequests(*this);
+    DebugLog::write(">>> " + getThreadName() + " thread STOPPED");
+}
 
-    // Allocate temporary buffer for disk reads (stereo)
-    tempReadBuffer.setSize(2, StreamingConstants::diskReadFrames);
+//==============================================================================
+DiskStreamer::DiskStreamer()
+{
+    formatManager.registerBasicFormats();
+    lastThroughputTime = juce::Time::getMillisecondCounterHiRes();
+    setNumIOThreads(defaultIOThreads);
 }
 
 DiskStreamer::~DiskStreamer()
 {
-    stopThread();
+    setNumIOThreads(0);
+}
+
+void DiskStreamer::setNumIOThreads(int numThreads)
+{
+    std::lock_guard<std::mutex> threadsLock(threadsMutex);
+    numThreads = juce::jlimit(0, maxIOThreads, numThreads);
+
+    while (static_cast<int>(ioThreads.size()) > numThreads)
+    {
+        auto& thread = ioThreads.back();
+        thread->signalThreadShouldExit();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            workAvailable.notify_all();
+        }
+        thread->stopThread(2000);
+        ioThreads.pop_back();
+    }
+
+    while (static_cast<int>(ioThreads.size()) < numThreads)
+    {
+        ioThreads.push_back(std::make_unique<IOThread>(*this, static_cast<int>(ioThreads.size())));
+        ioThreads.back()->startThread(juce::Thread::Priority::high);
+    }
+
+    numIOThreads.store(numThreads, std::memory_order_relaxed);
+}
+
+void DiskStreamer::notify()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        scanRequested = true;
+    }
+    workAvailable.notify_one();
 }
 
-void DiskStreamer::startThread()
+void DiskStreamer::notifyColdStart()
 {
-    juce::Thread::startThread();
+    coldStartPending.store(true, std::memory_order_release);
+    workAvailable.notify_one();
 }
 
-void DiskStreamer::stopThread()
+DiskStreamer::ClientId DiskStreamer::registerClient(RingBufferPool* ringPool, const std::atomic<bool>* hibernating)
 {
-    signalThreadShouldExit();
-    notify();  // Wake up the thread if it's waiting
-    juce::Thread::stopThread(1000);
+    auto client = std::make_shared<Client>();
+    client->ringPool = ringPool;
+    client->hibernating = hibernating;
+    for (auto& voice : client->voices)
+        voice.store(nullptr, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    client->id = nextClientId++;
+    clients.push_back(client);
+    numClients.store(static_cast<int>(clients.size()), std::memory_order_relaxed);
 
-    // Clean up readers
-    for (auto& reader : readers)
-        reader.reset();
+    DebugLog::write("DiskStreamer: client " + juce::String(client->id) + " registered ("
+                   + juce::String(static_cast<int>(clients.size())) + " clients)");
+    return client->id;
 }
 
-void DiskStreamer::registerVoice(int voiceIndex, StreamingVoice* voice)
+void DiskStreamer::unregisterClient(ClientId clientId)
 {
-    if (voiceIndex >= 0 && voiceIndex < StreamingConstants::maxStreamingVoices)
+    std::unique_lock<std::mutex> lock(mutex);
+
+    auto it = std::find_if(clients.begin(), clients.end(),
+                           [clientId](const auto& c) { return c->id == clientId; });
+    if (it == clients.end())
+        return;
+
+    auto client = *it;
+    clients.erase(it);
+    numClients.store(static_cast<int>(clients.size()), std::memory_order_relaxed);
+
+    // Drop queued requests, then wait for reads already running
+    for (auto r = requests.begin(); r != requests.end();)
     {
-        voices[static_cast<size_t>(voiceIndex)].store(voice, std::memory_order_release);
+        if (r->client == client.get())
+        {
+            client->inFlight[static_cast<size_t>(r->voiceIndex)] = false;
+            --client->requestsInFlight;
+            r = requests.erase(r);
+        }
+        else
+        {
+            ++r;
+        }
     }
+    queuedRequests.store(static_cast<int>(requests.size()), std::memory_order_relaxed);
+
+    requestFinished.wait(lock, [&client] { return client->requestsInFlight == 0; });
+
+    DebugLog::write("DiskStreamer: client " + juce::String(clientId) + " unregistered");
 }
 
-void DiskStreamer::unregisterVoice(int voiceIndex)
+DiskStreamer::Client* DiskStreamer::findClient(ClientId clientId) const
 {
-    if (voiceIndex >= 0 && voiceIndex < StreamingConstants::maxStreamingVoices)
+    for (const auto& client : clients)
     {
-        voices[static_cast<size_t>(voiceIndex)].store(nullptr, std::memory_order_release);
-        closeReader(voiceIndex);
+        if (client->id == clientId)
+            return client.get();
     }
+    return nullptr;
 }
 
-void DiskStreamer::run()
+void DiskStreamer::registerVoice(ClientId clientId, int voiceIndex, StreamingVoice* voice)
 {
-    streamDebugLog(">>> DiskStreamer thread STARTED");
-    int loopCount = 0;
-    int lastActiveVoices = 0;
-    lastThroughputTime = juce::Time::getMillisecondCounterHiRes();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* client = findClient(clientId);
+    if (client != nullptr && voiceIndex >= 0 && voiceIndex < StreamingConstants::maxStreamingVoices)
+    {
+        client->voices[static_cast<size_t>(voiceIndex)].store(voice, std::memory_order_release);
+    }
+}
 
-    while (!threadShouldExit())
+void DiskStreamer::unregisterVoice(ClientId clientId, int voiceIndex)
+{
+    // The reader is closed by the next scan, once no read is using it
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* client = findClient(clientId);
+    if (client != nullptr && voiceIndex >= 0 && voiceIndex < StreamingConstants::maxStreamingVoices)
     {
-        loopCount++;
-        int activeVoices = 0;
+        client->voices[static_cast<size_t>(voiceIndex)].store(nullptr, std::memory_order_release);
+    }
+}
+
+float DiskStreamer::getClientThroughputMBps(ClientId clientId) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* client = findClient(clientId);
+    return client != nullptr ? client->throughputMBps.load(std::memory_order_relaxed) : 0.0f;
+}
+
+int64_t DiskStreamer::getClientBytesRead(ClientId clientId) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto* client = findClient(clientId);
+    return client != nullptr ? client->totalBytesRead.load(std::memory_order_relaxed) : 0;
+}
+
+void DiskStreamer::serveRequests(IOThread& thread)
+{
+    while (!thread.threadShouldExit())
+    {
+        Request request;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            // Whichever thread is free rescans every poll interval; the queue is re-sorted each time
+            const double now = juce::Time::getMillisecondCounterHiRes();
+            if (scanRequested || coldStartPending.exchange(false, std::memory_order_acq_rel)
+                || now - lastScanTime >= StreamingConstants::diskThreadPollMs)
+            {
+                scheduleRequests(now);
+                if (requests.size() > 1)
+                    workAvailable.notify_all();
+            }
+
+            if (requests.empty())
+            {
+                // Wait before polling again (but can be woken early)
+                workAvailable.wait_for(lock, std::chrono::milliseconds(StreamingConstants::diskThreadPollMs));
+                continue;
+            }
+
+            request = requests.back();
+            requests.pop_back();
+            queuedRequests.store(static_cast<int>(requests.size()), std::memory_order_relaxed);
+        }
+
+        fillVoiceBuffer(*request.client, request.voiceIndex, request.generation, thread.tempReadBuffer);
 
-        // Poll all registered voices
-        for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
         {
-            if (threadShouldExit())
-                break;
+            std::lock_guard<std::mutex> lock(mutex);
+            request.client->inFlight[static_cast<size_t>(request.voiceIndex)] = false;
+            --request.client->requestsInFlight;
+        }
+        requestFinished.notify_all();
+    }
+}
+
+void DiskStreamer::scheduleRequests(double now)
+{
+    lastScanTime = now;
+    scanRequested = false;
 
-            StreamingVoice* voice = voices[static_cast<size_t>(i)].load(std::memory_order_acquire);
-            if (voice != nullptr && voice->isActive())
+    for (const auto& clientPtr : clients)
+    {
+        auto& client = *clientPtr;
+
+        // Keep ring storage ahead of streaming polyphony (and reclaim it when idle)
+        if (client.ringPool != nullptr)
+            client.ringPool->maintain();
+
+        // A hibernating engine plays nothing: don't scan its voices, and close its files once
+        if (client.hibernating != nullptr && client.hibernating->load(std::memory_order_acquire))
+        {
+            if (!client.readersClosed && client.requestsInFlight == 0)
             {
-                activeVoices++;
-                if (voice->needsMoreData())
+                for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
                 {
-                    fillVoiceBuffer(i);
+                    const auto index = static_cast<size_t>(i);
+                    if (StreamingVoice* voice = client.voices[index].load(std::memory_order_acquire))
+                        voice->releaseParkedRing();
+
+                    client.readers[index].reset();
+                    client.readerFilePaths[index].clear();
                 }
+                client.readersClosed = true;
             }
+            continue;
         }
+        client.readersClosed = false;
 
-        // Calculate throughput every ~1 second (200 loops at 5ms each)
-        if (loopCount % 200 == 0)
+        for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
         {
-            double currentTime = juce::Time::getMillisecondCounterHiRes();
-            double elapsedMs = currentTime - lastThroughputTime;
+            const auto index = static_cast<size_t>(i);
+            if (client.inFlight[index])
+                continue;
 
-            if (elapsedMs > 0)
+            StreamingVoice* voice = client.voices[index].load(std::memory_order_acquire);
+            if (voice == nullptr)
             {
-                int64_t bytesInWindow = bytesReadInWindow.exchange(0, std::memory_order_relaxed);
-                float mbps = static_cast<float>(static_cast<double>(bytesInWindow) / (elapsedMs * 1000.0));  // bytes/ms -> MB/s
-                currentThroughputMBps.store(mbps, std::memory_order_relaxed);
+                client.readers[index].reset();
+                client.readerFilePaths[index].clear();
+                continue;
             }
 
-            lastThroughputTime = currentTime;
-
-            streamDebugLog("DiskStreamer heartbeat: loop=" + juce::String(loopCount)
-                          + " activeVoices=" + juce::String(activeVoices)
-                          + " throughput=" + juce::String(currentThroughputMBps.load(), 2) + " MB/s");
+            // Nothing is reading into this voice, so its finished rings can go back to the pool
+            voice->releaseParkedRing();
+
+            // Generation before activity: a note retired after this load fails the lease
+            const uint32_t generation = voice->getRingGeneration();
+            if (!voice->isActive() || !voice->needsMoreData())
+                continue;
+
+            // Time until the voice runs dry, in output samples: fewer buffered frames or a
+            // higher playback rate is more urgent
+            Request request;
+            request.client = &client;
+            request.voiceIndex = i;
+            request.generation = generation;
+            request.urgency = static_cast<double>(voice->samplesAvailable()) / std::max(0.01, voice->getPitchRatio());
+
+            // A cold start has no audio at all yet: its attack goes before everything else
+            if (voice->isColdStarting())
+                request.urgency = -1.0;
+
+            requests.push_back(request);
+            client.inFlight[index] = true;
+            ++client.requestsInFlight;
         }
-        else if (activeVoices != lastActiveVoices)
+    }
+
+    // Most urgent at the back, where the I/O threads pop from
+    std::sort(requests.begin(), requests.end(),
+              [](const Request& a, const Request& b) { return a.urgency > b.urgency; });
+    queuedRequests.store(static_cast<int>(requests.size()), std::memory_order_relaxed);
+
+    // Calculate throughput every ~1 second
+    const double elapsedMs = now - lastThroughputTime;
+    if (elapsedMs >= 1000.0)
+    {
+        int64_t bytesInWindow = bytesReadInWindow.exchange(0, std::memory_order_relaxed);
+        float mbps = static_cast<float>(static_cast<double>(bytesInWindow) / (elapsedMs * 1000.0));  // bytes/ms -> MB/s
+        currentThroughputMBps.store(mbps, std::memory_order_relaxed);
+
+        for (const auto& client : clients)
         {
-            streamDebugLog("DiskStreamer: activeVoices changed " + juce::String(lastActiveVoices)
-                          + " -> " + juce::String(activeVoices));
-            lastActiveVoices = activeVoices;
+            int64_t clientBytes = client->bytesReadInWindow.exchange(0, std::memory_order_relaxed);
+            client->throughputMBps.store(static_cast<float>(static_cast<double>(clientBytes) / (elapsedMs * 1000.0)),
+                                         std::memory_order_relaxed);
         }
 
-        // Wait before polling again (but can be woken early)
-        wait(StreamingConstants::diskThreadPollMs);
-    }
+        lastThroughputTime = now;
 
-    streamDebugLog(">>> DiskStreamer thread STOPPED");
+        DebugLog::write("DiskStreamer heartbeat: clients=" + juce::String(static_cast<int>(clients.size()))
+                       + " queued=" + juce::String(static_cast<int>(requests.size()))
+                       + " throughput=" + juce::String(currentThroughputMBps.load(), 2) + " MB/s");
+    }
 }
 
-void DiskStreamer::fillVoiceBuffer(int voiceIndex)
+void DiskStreamer::fillVoiceBuffer(Client& client, int voiceIndex, uint32_t generation, juce::AudioBuffer<float>& tempReadBuffer)
 {
-    StreamingVoice* voice = voices[static_cast<size_t>(voiceIndex)].load(std::memory_order_acquire);
+    StreamingVoice* voice = client.voices[static_cast<size_t>(voiceIndex)].load(std::memory_order_acquire);
     if (voice == nullptr)
         return;
 
-    const PreloadedSample* sample = voice->getCurrentSample();
-    if (sample == nullptr || !sample->isValid())
+    // The audio thread may reset the voice at any point; the lease keeps its ring valid until we're done
+    StreamingVoice::RingLease lease;
+    if (!voice->beginRingLease(generation, lease))
+        return;
+
+    fillLeasedRing(client, voiceIndex, *voice, lease, tempReadBuffer);
+    voice->endRingLease();
+}
+
+void DiskStreamer::fillLeasedRing(Client& client, int voiceIndex, StreamingVoice& voice, const StreamingVoice::RingLease& lease,
+                                  juce::AudioBuffer<float>& tempReadBuffer)
+{
+    const PreloadedSample* sample = lease.sample;
+    if (!sample->isValid())
         return;
 
-    streamDebugLog("fillVoiceBuffer[" + juce::String(voiceIndex) + "] ENTER - sample=" + sample->name);
+    DebugLog::write("fillVoiceBuffer[" + juce::String(client.id) + ":" + juce::String(voiceIndex) + "] ENTER - sample=" + sample->name);
+
+    const double requestStartTime = juce::Time::getMillisecondCounterHiRes();
 
     // Check if we need to open or reopen the file reader
-    auto& reader = readers[static_cast<size_t>(voiceIndex)];
-    if (reader == nullptr || readerFilePaths[static_cast<size_t>(voiceIndex)] != sample->filePath)
+    auto& reader = client.readers[static_cast<size_t>(voiceIndex)];
+    if (reader == nullptr || client.readerFilePaths[static_cast<size_t>(voiceIndex)] != sample->filePath)
     {
         reader = openReader(sample->filePath);
-        readerFilePaths[static_cast<size_t>(voiceIndex)] = sample->filePath;
+        client.readerFilePaths[static_cast<size_t>(voiceIndex)] = sample->filePath;
 
         if (reader == nullptr)
         {
-            voice->setReadError(true);
-            voice->clearNeedsData();
+            voice.setReadError(true);
+            voice.clearNeedsData();
             return;
         }
     }
 
-    // Get current file position and available space
-    int64_t filePos = voice->getFileReadPosition();
-    int64_t totalFrames = static_cast<int64_t>(reader->lengthInSamples);
+    // Get current position (from the sample's start) and available space; the sample ends at its
+    // effective end, before any trimmed tail
+    int64_t filePos = voice.getFileReadPosition();
+    int64_t totalFrames = std::min(sample->totalSampleFrames, static_cast<int64_t>(reader->lengthInSamples) - sample->startFrame);
 
     // Check for end of file
     if (filePos >= totalFrames)
     {
-        voice->setEndOfFile(true);
-        voice->clearNeedsData();
+        voice.setEndOfFile(true);
+        voice.clearNeedsData();
         return;
     }
 
     // Calculate how much we can read
-    int space = voice->spaceAvailable();
+    int space = voice.spaceAvailable();
     if (space < StreamingConstants::diskReadFrames)
     {
         // Ring buffer is nearly full - clear needsData and wait
-        voice->clearNeedsData();
+        voice.clearNeedsData();
         return;
     }
 
-    // Fill the buffer in chunks
+    // Fill the buffer in chunks (bounded, so one voice can't hold an I/O thread while others starve)
     int totalFramesFilled = 0;
-    while (space >= StreamingConstants::diskReadFrames && filePos < totalFrames && !threadShouldExit())
+    for (int chunk = 0; chunk < maxChunksPerRequest && space >= StreamingConstants::diskReadFrames && filePos < totalFrames
+                        && !juce::Thread::currentThreadShouldExit(); ++chunk)
     {
         int framesToRead = static_cast<int>(std::min(static_cast<int64_t>(StreamingConstants::diskReadFrames),
                                                       totalFrames - filePos));
@@ -184,90 +398,102 @@ void DiskStreamer::fillVoiceBuffer(int voiceIndex)
 
         // Read from disk
         bool success = reader->read(&tempReadBuffer, 0, framesToRead,
-                                    filePos, true, true);
+                                    sample->startFrame + filePos, true, true);
 
         if (!success)
         {
-            voice->setReadError(true);
+            voice.setReadError(true);
             break;
         }
 
+        // Retired while we were reading: drop the chunk and free the voice
+        if (!voice.isRingLeaseCurrent(lease))
+            return;
+
         // Track bytes read for throughput calculation
         int64_t bytesRead = static_cast<int64_t>(framesToRead) * static_cast<int64_t>(sample->numChannels) * static_cast<int64_t>(sizeof(float));
         bytesReadInWindow.fetch_add(bytesRead, std::memory_order_relaxed);
         totalBytesRead.fetch_add(bytesRead, std::memory_order_relaxed);
+        client.bytesReadInWindow.fetch_add(bytesRead, std::memory_order_relaxed);
+        client.totalBytesRead.fetch_add(bytesRead, std::memory_order_relaxed);
 
         // Copy to voice's ring buffer
-        int writePos = voice->getWritePosition();
+        int writePos = voice.getWritePosition();
         int numChannels = std::min(tempReadBuffer.getNumChannels(),
                                     static_cast<int>(sample->numChannels));
 
         for (int ch = 0; ch < numChannels; ++ch)
         {
-            float* ringBuffer = voice->getWritePointer(ch);
+            float* ringBuffer = lease.channels[static_cast<size_t>(ch)];
             const float* sourceData = tempReadBuffer.getReadPointer(ch);
 
             for (int frame = 0; frame < framesToRead; ++frame)
             {
-                int ringPos = (writePos + frame) % StreamingConstants::ringBufferFrames;
-                ringBuffer[ringPos] = sourceData[frame];
-            }
-        }
-
-        // Handle mono source -> stereo ring buffer
-        if (numChannels == 1 && sample->numChannels < 2)
-        {
-            float* ringBuffer = voice->getWritePointer(1);
-            const float* sourceData = tempReadBuffer.getReadPointer(0);
-
-            for (int frame = 0; frame < framesToRead; ++frame)
-            {
-                int ringPos = (writePos + frame) % StreamingConstants::ringBufferFrames;
+                int ringPos = (writePos + frame) & StreamingConstants::ringBufferMask;
                 ringBuffer[ringPos] = sourceData[frame];
             }
         }
 
         // Update positions
-        voice->advanceWritePosition(framesToRead);
+        voice.advanceWritePosition(framesToRead);
         filePos += framesToRead;
-        voice->setFileReadPosition(filePos);
+        voice.setFileReadPosition(filePos);
         totalFramesFilled += framesToRead;
 
-        space = voice->spaceAvailable();
+        space = voice.spaceAvailable();
+
+        if (chunk == 0)
+            recordDeviceLatency(sample->deviceId, juce::Time::getMillisecondCounterHiRes() - requestStartTime);
     }
 
     // Check if we reached end of file
     if (filePos >= totalFrames)
     {
-        voice->setEndOfFile(true);
+        voice.setEndOfFile(true);
     }
 
-    streamDebugLog("fillVoiceBuffer[" + juce::String(voiceIndex) + "] EXIT - filled "
-                  + juce::String(totalFramesFilled) + " frames, filePos="
-                  + juce::String(filePos) + "/" + juce::String(totalFrames)
-                  + " EOF=" + juce::String(voice->hasReachedEndOfFile() ? "yes" : "no"));
+    DebugLog::write("fillVoiceBuffer[" + juce::String(client.id) + ":" + juce::String(voiceIndex) + "] EXIT - filled "
+                   + juce::String(totalFramesFilled) + " frames, filePos="
+                   + juce::String(filePos) + "/" + juce::String(totalFrames)
+                   + " EOF=" + juce::String(voice.hasReachedEndOfFile() ? "yes" : "no"));
 
     // Clear the needs data flag
-    voice->clearNeedsData();
+    voice.clearNeedsData();
 }
 
 std::unique_ptr<juce::AudioFormatReader> DiskStreamer::openReader(const juce::String& filePath)
 {
-    if (formatManager == nullptr)
-        return nullptr;
+    // Container entries share the container's descriptor rather than opening a file each
+    return SampleContainer::createReaderFor(formatManager, filePath);
+}
+
+void DiskStreamer::recordDeviceLatency(uint64_t deviceId, double latencyMs)
+{
+    std::lock_guard<std::mutex> lock(deviceMutex);
 
-    juce::File file(filePath);
-    if (!file.existsAsFile())
-        return nullptr;
+    auto [it, inserted] = deviceLatencies.try_emplace(deviceId, static_cast<float>(latencyMs));
+    if (!inserted)
+        it->second += deviceLatencySmoothing * (static_cast<float>(latencyMs) - it->second);
+}
 
-    return std::unique_ptr<juce::AudioFormatReader>(formatManager->createReaderFor(file));
+float DiskStreamer::getDeviceLatencyMs(uint64_t deviceId) const
+{
+    std::lock_guard<std::mutex> lock(deviceMutex);
+
+    auto it = deviceLatencies.find(deviceId);
+    return it != deviceLatencies.end() ? it->second : -1.0f;
 }
 
-void DiskStreamer::closeReader(int voiceIndex)
+uint64_t DiskStreamer::getDeviceId(const juce::String& samplePath)
 {
-    if (voiceIndex >= 0 && voiceIndex < StreamingConstants::maxStreamingVoices)
-    {
-        readers[static_cast<size_t>(voiceIndex)].reset();
-        readerFilePaths[static_cast<size_t>(voiceIndex)].clear();
-    }
+    juce::String containerPath;
+    int entryIndex = 0;
+    const auto filePath = SampleContainer::parseEntryPath(samplePath, containerPath, entryIndex) ? containerPath : samplePath;
+
+   #if JUCE_WINDOWS
+    return static_cast<uint64_t>(static_cast<uint32_t>(juce::File(filePath).getVolumeSerialNumber()));
+   #else
+    struct stat info;
+    return stat(filePath.toRawUTF8(), &info) == 0 ? static_cast<uint64_t>(info.st_dev) : 0;
+   #endif
 }
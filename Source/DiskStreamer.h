@@ -5,75 +5,179 @@
 #include <array>
 #include <memory>
 #include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "DiskStreaming.h"
 #include "StreamingVoice.h"
+#include "RingBufferPool.h"
 
 /**
- * DiskStreamer is a background thread that handles all disk I/O for streaming voices.
+ * DiskStreamer is the process-wide disk streaming service shared by every SamplerEngine
+ * (hold it through juce::SharedResourcePointer).
  *
  * Design:
- * - Polls active voices every few milliseconds
- * - When a voice signals needsData, reads from disk and fills the voice's ring buffer
- * - Manages file readers to avoid repeatedly opening/closing files
+ * - Each engine registers as a client and registers its voices with it
+ * - Every few milliseconds one I/O thread scans all clients and queues the voices that
+ *   signalled needsData, most urgent first (least buffered audio relative to playback rate)
+ * - A fixed pool of I/O threads, sized for the storage rather than the instance count,
+ *   reads the queued voices' next chunks into their ring buffers
  * - Completely non-blocking from audio thread perspective
+ *
+ * Thread count stays the same however many plugin instances are loaded.
  */
-class DiskStreamer : public juce::Thread
+class DiskStreamer
 {
 public:
+    using ClientId = int;
+    static constexpr ClientId invalidClient = -1;
+
+    static constexpr int defaultIOThreads = 2;   // Enough to keep an SSD's queue busy
+    static constexpr int maxIOThreads = 8;
+
+    // A request reads at most this many disk chunks before going back in the queue
+    static constexpr int maxChunksPerRequest = 4;
+
     DiskStreamer();
-    ~DiskStreamer() override;
+    ~DiskStreamer();
+
+    /** Register an engine. Its ring pool is maintained by the service. While *hibernating is
+        true the engine has nothing playing: its voices aren't scanned and its files are closed
+        (the engine flips the flag itself, lock-free, and calls notifyColdStart() to resume). */
+    ClientId registerClient(RingBufferPool* ringPool, const std::atomic<bool>* hibernating = nullptr);
+
+    /** Unregister an engine (blocks until reads into its voices have finished) */
+    void unregisterClient(ClientId client);
 
-    /** Start the disk streaming thread */
-    void startThread();
+    /** Register a voice of a client for disk streaming (call from main/message thread) */
+    void registerVoice(ClientId client, int voiceIndex, StreamingVoice* voice);
 
-    /** Stop the thread and clean up resources */
-    void stopThread();
+    /** Unregister a voice of a client (call from main/message thread) */
+    void unregisterVoice(ClientId client, int voiceIndex);
 
-    /** Register a voice for disk streaming (call from main/message thread) */
-    void registerVoice(int voiceIndex, StreamingVoice* voice);
+    /** Number of I/O threads shared by all clients (1 - maxIOThreads) */
+    void setNumIOThreads(int numThreads);
+    int getNumIOThreads() const { return numIOThreads.load(std::memory_order_relaxed); }
 
-    /** Unregister a voice (call from main/message thread) */
-    void unregisterVoice(int voiceIndex);
+    /** Wake the I/O threads early */
+    void notify();
 
-    /** Set the audio format manager for creating file readers */
-    void setAudioFormatManager(juce::AudioFormatManager* manager) { formatManager = manager; }
+    /** Wake the I/O threads for a cold-starting voice (audio thread: takes no lock, so a
+        wake-up racing with a thread going to sleep is caught by the next poll) */
+    void notifyColdStart();
 
-    /** Get current disk throughput in MB/s (averaged over ~1 second) */
+    /** Aggregate disk throughput of all clients in MB/s (averaged over ~1 second) */
     float getThroughputMBps() const { return currentThroughputMBps.load(std::memory_order_relaxed); }
 
-    /** Get total bytes read since last reset */
+    /** Total bytes read for all clients */
     int64_t getTotalBytesRead() const { return totalBytesRead.load(std::memory_order_relaxed); }
 
-private:
-    void run() override;
+    /** Per-client statistics */
+    float getClientThroughputMBps(ClientId client) const;
+    int64_t getClientBytesRead(ClientId client) const;
+
+    /** Time from picking up a request to its first chunk landing, averaged per storage device.
+        -1 if nothing has been read from that device yet. */
+    float getDeviceLatencyMs(uint64_t deviceId) const;
+
+    /** Identifies the storage device (volume) a sample file or container entry lives on */
+    static uint64_t getDeviceId(const juce::String& samplePath);
 
-    /** Fill a single voice's ring buffer from disk */
-    void fillVoiceBuffer(int voiceIndex);
+    int getNumClients() const { return numClients.load(std::memory_order_relaxed); }
+    int getQueuedRequestCount() const { return queuedRequests.load(std::memory_order_relaxed); }
+
+private:
+    struct Client
+    {
+        ClientId id = invalidClient;
+        RingBufferPool* ringPool = nullptr;
+        const std::atomic<bool>* hibernating = nullptr;
+        bool readersClosed = false;   // Service mutex: closed since the client started hibernating
+
+        // Registered voices (atomic for lock-free access)
+        std::array<std::atomic<StreamingVoice*>, StreamingConstants::maxStreamingVoices> voices {};
+
+        // File readers - one per voice (used only by the I/O thread serving that voice)
+        std::array<std::unique_ptr<juce::AudioFormatReader>, StreamingConstants::maxStreamingVoices> readers;
+        std::array<juce::String, StreamingConstants::maxStreamingVoices> readerFilePaths;
+
+        // Voices with a queued or running read (service mutex)
+        std::array<bool, StreamingConstants::maxStreamingVoices> inFlight {};
+        int requestsInFlight = 0;
+
+        // Throughput tracking
+        std::atomic<int64_t> bytesReadInWindow{0};
+        std::atomic<int64_t> totalBytesRead{0};
+        std::atomic<float> throughputMBps{0.0f};
+    };
+
+    struct Request
+    {
+        Client* client = nullptr;
+        int voiceIndex = 0;
+        uint32_t generation = 0;   // The voice's note when queued (see StreamingVoice::RingLease)
+        double urgency = 0.0;   // Output samples until the voice runs dry (lower = more urgent)
+    };
+
+    class IOThread : public juce::Thread
+    {
+    public:
+        IOThread(DiskStreamer& owner, int index);
+        void run() override;
+
+        juce::AudioBuffer<float> tempReadBuffer;  // Batches reads before writing to ring buffers
+
+    private:
+        DiskStreamer& service;
+    };
+
+    /** Main loop of each I/O thread */
+    void serveRequests(IOThread& thread);
+
+    /** Scan all clients and queue voices that need data (service mutex held) */
+    void scheduleRequests(double now);
+
+    /** Fill a single voice's ring buffer from disk, if it still plays the note the request was queued for */
+    void fillVoiceBuffer(Client& client, int voiceIndex, uint32_t generation, juce::AudioBuffer<float>& tempReadBuffer);
+
+    /** Read into a leased ring; stops as soon as the voice retires the note */
+    void fillLeasedRing(Client& client, int voiceIndex, StreamingVoice& voice, const StreamingVoice::RingLease& lease,
+                        juce::AudioBuffer<float>& tempReadBuffer);
 
     /** Open a reader for the given sample file path */
     std::unique_ptr<juce::AudioFormatReader> openReader(const juce::String& filePath);
 
-    /** Close reader for a voice */
-    void closeReader(int voiceIndex);
-
-    // Array of registered voices (atomic for lock-free access)
-    std::array<std::atomic<StreamingVoice*>, StreamingConstants::maxStreamingVoices> voices;
+    Client* findClient(ClientId client) const;
 
-    // File readers - one per voice (managed by disk thread only)
-    std::array<std::unique_ptr<juce::AudioFormatReader>, StreamingConstants::maxStreamingVoices> readers;
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable requestFinished;
 
-    // Track which sample each reader was opened for
-    std::array<juce::String, StreamingConstants::maxStreamingVoices> readerFilePaths;
+    std::vector<std::shared_ptr<Client>> clients;   // Service mutex
+    std::vector<Request> requests;                  // Sorted, most urgent at the back
+    ClientId nextClientId = 0;
+    double lastScanTime = 0.0;
+    bool scanRequested = false;
+    std::atomic<bool> coldStartPending{false};
 
-    // Temporary buffer for disk reads (to batch reads before writing to ring buffer)
-    juce::AudioBuffer<float> tempReadBuffer;
+    std::mutex threadsMutex;
+    std::vector<std::unique_ptr<IOThread>> ioThreads;
+    std::atomic<int> numIOThreads{0};
 
-    // Audio format manager (owned by processor, we just hold a pointer)
-    juce::AudioFormatManager* formatManager = nullptr;
+    juce::AudioFormatManager formatManager;
 
-    // Throughput tracking
+    // Throughput tracking (all clients)
     std::atomic<int64_t> bytesReadInWindow{0};      // Bytes read in current measurement window
     std::atomic<int64_t> totalBytesRead{0};         // Total bytes read since start
     std::atomic<float> currentThroughputMBps{0.0f}; // Current throughput in MB/s
     double lastThroughputTime = 0.0;                // Time of last throughput calculation
+    std::atomic<int> numClients{0};
+    std::atomic<int> queuedRequests{0};
+
+    // First-chunk latency per storage device (moving average)
+    static constexpr float deviceLatencySmoothing = 0.1f;
+    void recordDeviceLatency(uint64_t deviceId, double latencyMs);
+    mutable std::mutex deviceMutex;
+    std::map<uint64_t, float> deviceLatencies;
 };
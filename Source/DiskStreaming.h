@@ -1,7 +1,10 @@
 #pragma once
 
 #include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
 #include <atomic>
+#include <memory>
+#include <vector>
 
 /**
  * DFD (Direct From Disk) Streaming Core Types
@@ -19,9 +22,17 @@ struct PreloadedSample
 {
     juce::AudioBuffer<float> preloadBuffer;  // First 64KB only
     juce::String filePath;                    // Full path for streaming
-    int64_t totalSampleFrames = 0;            // Total frames in the file
+    int64_t startFrame = 0;                   // File frame the sample starts at (leading silence trimmed, see SampleAnalysis)
+    int64_t totalSampleFrames = 0;            // Frames from startFrame to the effective end (inaudible tail trimmed)
+    int64_t endFadeFrames = 0;                // Fade-out ending at a trimmed end (0 = plays to the file's own end)
     double sampleRate = 44100.0;
     int numChannels = 2;
+    uint64_t deviceId = 0;                    // Storage device holding the file (DiskStreamer::getDeviceId)
+
+    // Coarse level envelope from SampleAnalysis: per levelBlockFrames of the file, the loudest
+    // RMS from there to the end. Null until the sample has been analysed.
+    std::shared_ptr<const std::vector<float>> levelEnvelope;
+    double levelBlockFrames = 0.0;
 
     // Sample zone mapping info
     int rootNote = 60;
@@ -37,6 +48,16 @@ struct PreloadedSample
 
     bool isValid() const { return totalSampleFrames > 0 && filePath.isNotEmpty(); }
 
+    /** The loudest the sample gets from a frame (relative to startFrame) to its end; 1 if unknown */
+    float getRemainingLevel(int64_t frame) const
+    {
+        if (levelEnvelope == nullptr || levelEnvelope->empty())
+            return 1.0f;
+
+        const auto block = static_cast<size_t>(std::max(0.0, static_cast<double>(startFrame + frame) / levelBlockFrames));
+        return block < levelEnvelope->size() ? (*levelEnvelope)[block] : 0.0f;
+    }
+
     /** Returns true if this sample is large enough to require streaming */
     bool needsStreaming() const { return totalSampleFrames > preloadSizeFrames; }
 
@@ -89,6 +110,10 @@ namespace StreamingConstants
     // Ring buffer size in frames (~743ms at 44.1kHz)
     constexpr int ringBufferFrames = 32768;
 
+    // Ring positions wrap with a mask instead of a modulo
+    constexpr int ringBufferMask = ringBufferFrames - 1;
+    static_assert((ringBufferFrames & ringBufferMask) == 0, "ringBufferFrames must be a power of two");
+
     // Request more data when available falls below this threshold
     constexpr int lowWatermarkFrames = 8192;  // ~185ms at 44.1kHz
 
@@ -0,0 +1,276 @@
+#include "EngineIPC.h"
+
+#if ! JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <poll.h>
+ #include <sys/mman.h>
+ #include <sys/socket.h>
+ #include <sys/stat.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+ #include <cerrno>
+ #include <cstring>
+ #include <new>
+#endif
+
+namespace EngineIPC
+{
+
+juce::String getDefaultSocketPath()
+{
+    auto fromEnvironment = juce::SystemStats::getEnvironmentVariable("HAMMER_SAMPLER_SOCKET", {});
+    if (fromEnvironment.isNotEmpty())
+        return fromEnvironment;
+
+   #if JUCE_WINDOWS
+    return {};
+   #else
+    return "/tmp/hammer-sampler-" + juce::String(static_cast<int>(getuid())) + ".sock";
+   #endif
+}
+
+#if JUCE_WINDOWS
+
+bool isSupported() { return false; }
+int listenOnSocket(const juce::String&) { return -1; }
+int connectToSocket(const juce::String&) { return -1; }
+void closeSocket(int) {}
+void shutdownSocket(int) {}
+bool sendLine(int, const juce::String&) { return false; }
+bool readLine(int, juce::String&, int) { return false; }
+bool sendWake(int) { return false; }
+bool waitForWake(int, int) { return false; }
+SessionBlock* createSessionBlock(const juce::String&) { return nullptr; }
+SessionBlock* mapSessionBlock(const juce::String&) { return nullptr; }
+void unmapSessionBlock(SessionBlock*) {}
+void unlinkSessionBlock(const juce::String&) {}
+
+#else
+
+static bool makeAddress(const juce::String& path, sockaddr_un& address)
+{
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+
+    const char* utf8 = path.toRawUTF8();
+    if (std::strlen(utf8) >= sizeof(address.sun_path))
+        return false;
+
+    std::strncpy(address.sun_path, utf8, sizeof(address.sun_path) - 1);
+    return true;
+}
+
+bool isSupported()
+{
+    return true;
+}
+
+int listenOnSocket(const juce::String& path)
+{
+    sockaddr_un address;
+    if (!makeAddress(path, address))
+        return -1;
+
+    // A socket file left by a server that crashed would make bind() fail, but one that still
+    // accepts belongs to a running server: only remove the path when nobody answers on it
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe < 0)
+        return -1;
+
+    const bool answered = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    const int probeError = errno;
+    close(probe);
+
+    if (answered || (probeError != ECONNREFUSED && probeError != ENOENT))
+        return -1;
+
+    if (probeError == ECONNREFUSED)
+        unlink(address.sun_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 16) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    chmod(address.sun_path, 0600);
+    return fd;
+}
+
+int connectToSocket(const juce::String& path)
+{
+    sockaddr_un address;
+    if (!makeAddress(path, address))
+        return -1;
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+   #ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+   #endif
+    return fd;
+}
+
+void closeSocket(int fd)
+{
+    if (fd >= 0)
+    {
+        shutdown(fd, SHUT_RDWR);
+        close(fd);
+    }
+}
+
+void shutdownSocket(int fd)
+{
+    if (fd >= 0)
+        shutdown(fd, SHUT_RDWR);
+}
+
+static ssize_t sendNoSignal(int fd, const void* data, size_t size, int flags)
+{
+   #ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;  // A vanished peer must not kill the host with SIGPIPE
+   #endif
+    return send(fd, data, size, flags);
+}
+
+bool sendLine(int fd, const juce::String& line)
+{
+    const juce::String text = line + "\n";
+    const char* data = text.toRawUTF8();
+    size_t remaining = std::strlen(data);
+
+    while (remaining > 0)
+    {
+        const ssize_t sent = sendNoSignal(fd, data, remaining, 0);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+
+        data += sent;
+        remaining -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+bool readLine(int fd, juce::String& line, int timeoutMs)
+{
+    // Control traffic is a few short lines per user action: byte-at-a-time keeps it unbuffered
+    juce::MemoryOutputStream text;
+    const auto deadline = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(timeoutMs);
+
+    for (;;)
+    {
+        const auto now = juce::Time::getMillisecondCounter();
+        pollfd waiting { fd, POLLIN, 0 };
+        const int remaining = timeoutMs < 0 ? -1 : static_cast<int>(deadline > now ? deadline - now : 0);
+        if (poll(&waiting, 1, remaining) <= 0)
+            return false;
+
+        char c = 0;
+        const ssize_t received = recv(fd, &c, 1, 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received <= 0)
+            return false;
+
+        if (c == '\n')
+            break;
+        text.writeByte(c);
+    }
+
+    line = text.toString().trimEnd();
+    return true;
+}
+
+bool sendWake(int fd)
+{
+    const char wake = 'w';
+    if (sendNoSignal(fd, &wake, 1, MSG_DONTWAIT) >= 0)
+        return true;
+
+    // If the socket is full the server is awake anyway
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+
+bool waitForWake(int fd, int timeoutMs)
+{
+    pollfd waiting { fd, POLLIN, 0 };
+    const int ready = poll(&waiting, 1, timeoutMs);
+    if (ready <= 0)
+        return ready == 0 || errno == EINTR;
+
+    char wakes[256];
+    const ssize_t received = recv(fd, wakes, sizeof(wakes), MSG_DONTWAIT);
+    return received > 0 || (received < 0 && (errno == EAGAIN || errno == EINTR));
+}
+
+SessionBlock* createSessionBlock(const juce::String& name)
+{
+    int fd = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return nullptr;
+
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, static_cast<off_t>(sizeof(SessionBlock))) == 0)
+        memory = mmap(nullptr, sizeof(SessionBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(name.toRawUTF8());
+        return nullptr;
+    }
+
+    return new (memory) SessionBlock();
+}
+
+SessionBlock* mapSessionBlock(const juce::String& name)
+{
+    int fd = shm_open(name.toRawUTF8(), O_RDWR, 0);
+    if (fd < 0)
+        return nullptr;
+
+    void* memory = mmap(nullptr, sizeof(SessionBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (memory == MAP_FAILED)
+        return nullptr;
+
+    auto* block = static_cast<SessionBlock*>(memory);
+    if (block->magic != sessionMagic || block->version != static_cast<uint32_t>(protocolVersion))
+    {
+        munmap(memory, sizeof(SessionBlock));
+        return nullptr;
+    }
+    return block;
+}
+
+void unmapSessionBlock(SessionBlock* block)
+{
+    if (block != nullptr)
+        munmap(block, sizeof(SessionBlock));
+}
+
+void unlinkSessionBlock(const juce::String& name)
+{
+    shm_unlink(name.toRawUTF8());
+}
+
+#endif
+
+} // namespace EngineIPC
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include "NoteEventQueue.h"
+
+/**
+ * EngineIPC is what the plugin (client) and the engine server (HammerSamplerServer) share.
+ *
+ * - Control: newline-terminated text commands over a Unix-domain socket, one reply line each
+ * - Audio: one SessionBlock in POSIX shared memory per client, holding an SPSC ring of render
+ *   requests (block size + note events, client -> server) and an SPSC ring of rendered stereo
+ *   audio (server -> client)
+ * - Wake-up: a second connection to the same socket; the client writes one byte per block so
+ *   the server's render thread sleeps in recv() instead of polling
+ *
+ * The server primes the audio ring with one block of silence, so each callback the client
+ * reads the audio rendered during the previous one: one block of latency, reported to the host.
+ */
+namespace EngineIPC
+{
+    constexpr int protocolVersion = 1;
+    constexpr uint32_t sessionMagic = 0x484d5253;  // "HMRS"
+
+    constexpr int numChannels = 2;
+    constexpr int maxBlockSize = 4096;
+    constexpr int audioRingFrames = 16384;         // Power of 2, several blocks of headroom
+    constexpr int audioRingMask = audioRingFrames - 1;
+    constexpr int requestRingSize = 16;            // Power of 2
+    constexpr int maxEventsPerRequest = 256;
+
+    /** One block for the server to render */
+    struct RenderRequest
+    {
+        int32_t numSamples = 0;
+        int32_t interpolationQuality = 0;  // InterpolationQuality of the client (live vs bounce)
+        int32_t numEvents = 0;
+        NoteEventQueue::Event events[maxEventsPerRequest];
+    };
+
+    /** Lives in shared memory; every field is either atomic or owned by one side of a ring */
+    struct SessionBlock
+    {
+        uint32_t magic = sessionMagic;
+        uint32_t version = protocolVersion;
+
+        // Render requests (client writes, server reads)
+        std::atomic<uint32_t> requestWrite{0};
+        std::atomic<uint32_t> requestRead{0};
+        RenderRequest requests[requestRingSize];
+
+        // Rendered audio (server writes, client reads), positions in frames
+        std::atomic<uint64_t> audioWrite{0};
+        std::atomic<uint64_t> audioRead{0};
+        float audio[numChannels][audioRingFrames];
+
+        // Published by the server for the client's UI
+        std::atomic<int32_t> loadingState{0};  // LoadingState of the server engine
+        std::atomic<int32_t> activeVoices{0};
+        std::atomic<int32_t> streamingVoices{0};
+        std::atomic<int64_t> preloadBytes{0};
+        std::atomic<float> diskThroughputMBps{0.0f};
+
+        // Counted by the client
+        std::atomic<uint32_t> audioUnderruns{0};
+        std::atomic<uint32_t> droppedRequests{0};
+
+        /** Client: queue a block (events beyond maxEventsPerRequest are dropped). False if the ring is full. */
+        bool pushRequest(int numSamples, int interpolationQuality, const NoteEventQueue& events)
+        {
+            const uint32_t write = requestWrite.load(std::memory_order_relaxed);
+            if (write - requestRead.load(std::memory_order_acquire) >= static_cast<uint32_t>(requestRingSize))
+            {
+                droppedRequests.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            auto& request = requests[write & (requestRingSize - 1)];
+            request.numSamples = numSamples;
+            request.interpolationQuality = interpolationQuality;
+            request.numEvents = 0;
+            for (const auto& event : events)
+            {
+                if (request.numEvents == maxEventsPerRequest)
+                    break;
+                request.events[request.numEvents++] = event;
+            }
+
+            requestWrite.store(write + 1, std::memory_order_release);
+            return true;
+        }
+
+        /** Server: oldest pending request, or nullptr */
+        const RenderRequest* peekRequest() const
+        {
+            const uint32_t read = requestRead.load(std::memory_order_relaxed);
+            if (read == requestWrite.load(std::memory_order_acquire))
+                return nullptr;
+            return &requests[read & (requestRingSize - 1)];
+        }
+
+        void popRequest()
+        {
+            requestRead.store(requestRead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /** Server: append rendered audio. Returns frames written (less if the client fell behind). */
+        int writeAudio(const float* const* channels, int numFrames)
+        {
+            const uint64_t write = audioWrite.load(std::memory_order_relaxed);
+            const uint64_t used = write - audioRead.load(std::memory_order_acquire);
+            const int frames = static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(numFrames), audioRingFrames - used));
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < frames; ++i)
+                    audio[ch][(write + static_cast<uint64_t>(i)) & audioRingMask] = channels != nullptr ? channels[ch][i] : 0.0f;
+            }
+
+            audioWrite.store(write + static_cast<uint64_t>(frames), std::memory_order_release);
+            return frames;
+        }
+
+        /** Client: take rendered audio. Returns frames read; the caller zeroes the rest. */
+        int readAudio(float* const* channels, int numChannelsOut, int numFrames)
+        {
+            const uint64_t read = audioRead.load(std::memory_order_relaxed);
+            const uint64_t available = audioWrite.load(std::memory_order_acquire) - read;
+            const int frames = static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(numFrames), available));
+
+            for (int ch = 0; ch < numChannelsOut; ++ch)
+            {
+                const float* source = audio[std::min(ch, numChannels - 1)];
+                for (int i = 0; i < frames; ++i)
+                    channels[ch][i] = source[(read + static_cast<uint64_t>(i)) & audioRingMask];
+            }
+
+            audioRead.store(read + static_cast<uint64_t>(frames), std::memory_order_release);
+            return frames;
+        }
+
+        int getBufferedFrames() const
+        {
+            return static_cast<int>(audioWrite.load(std::memory_order_acquire) - audioRead.load(std::memory_order_acquire));
+        }
+
+        /** Server, while the client's audio is stopped: empty both rings and prime the latency */
+        void reset(int latencyFrames)
+        {
+            requestRead.store(requestWrite.load(std::memory_order_acquire), std::memory_order_release);
+            audioWrite.store(0, std::memory_order_relaxed);
+            audioRead.store(0, std::memory_order_release);
+            writeAudio(nullptr, std::min(latencyFrames, audioRingFrames));
+        }
+    };
+
+    /** Unix-domain socket path of the server for this user (override with HAMMER_SAMPLER_SOCKET) */
+    juce::String getDefaultSocketPath();
+
+    /** Whether the server/client transport exists on this platform (not on Windows) */
+    bool isSupported();
+
+    // Socket helpers: return -1 on failure (listening also fails while another server accepts there)
+    int listenOnSocket(const juce::String& path);
+    int connectToSocket(const juce::String& path);
+    void closeSocket(int fd);
+    void shutdownSocket(int fd);  // Unblocks a thread reading it; close afterwards
+
+    bool sendLine(int fd, const juce::String& line);
+    bool readLine(int fd, juce::String& line, int timeoutMs);
+
+    /** Wake-up byte from the client's audio thread (never blocks). False if the server is gone. */
+    bool sendWake(int fd);
+
+    /** Server: block until woken, the timeout passes (true) or the peer is gone (false) */
+    bool waitForWake(int fd, int timeoutMs);
+
+    // Session memory: the server creates it, the client maps it, the server unlinks the name
+    // once the client has mapped it (so nothing is left behind if either side crashes)
+    SessionBlock* createSessionBlock(const juce::String& name);
+    SessionBlock* mapSessionBlock(const juce::String& name);
+    void unmapSessionBlock(SessionBlock* block);
+    void unlinkSessionBlock(const juce::String& name);
+}
@@ -0,0 +1,742 @@
+#include "FlacSeekIndex.h"
+#include "BitReader.h"
+#include "DebugLog.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    constexpr char indexMagic[4] = { 'H', 'S', 'F', 'I' };
+    constexpr int indexVersion = 1;
+
+    constexpr int maxHeaderBytes = 16;      // Longest possible frame header, CRC included
+    constexpr int64_t scanChunkBytes = 1024 * 1024;
+
+    // Indexes open in this process, so the voices streaming a file share one table
+    std::mutex registryMutex;
+    std::map<juce::String, std::weak_ptr<FlacSeekIndex>> registry;
+
+    //==============================================================================
+    struct CrcTables
+    {
+        CrcTables()
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                uint8_t crc = static_cast<uint8_t>(i);
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = static_cast<uint8_t>((crc & 0x80) != 0 ? (crc << 1) ^ 0x07 : crc << 1);
+                crc8[static_cast<size_t>(i)] = crc;
+
+                uint16_t crc16 = static_cast<uint16_t>(i << 8);
+                for (int bit = 0; bit < 8; ++bit)
+                    crc16 = static_cast<uint16_t>((crc16 & 0x8000) != 0 ? (crc16 << 1) ^ 0x8005 : crc16 << 1);
+                crc16Table[static_cast<size_t>(i)] = crc16;
+            }
+        }
+
+        std::array<uint8_t, 256> crc8 {};
+        std::array<uint16_t, 256> crc16Table {};
+    };
+
+    const CrcTables& crcTables()
+    {
+        static const CrcTables tables;
+        return tables;
+    }
+
+    uint8_t crc8(const uint8_t* data, size_t size)
+    {
+        const auto& table = crcTables().crc8;
+        uint8_t crc = 0;
+        for (size_t i = 0; i < size; ++i)
+            crc = table[crc ^ data[i]];
+        return crc;
+    }
+
+    uint16_t crc16(const uint8_t* data, size_t size)
+    {
+        const auto& table = crcTables().crc16Table;
+        uint16_t crc = 0;
+        for (size_t i = 0; i < size; ++i)
+            crc = static_cast<uint16_t>((crc << 8) ^ table[(crc >> 8) ^ data[i]]);
+        return crc;
+    }
+
+    /** A Rice-coded residual: unary quotient, k-bit remainder, folded sign */
+    inline int32_t readRice(BitReader& reader, int k)
+    {
+        const uint64_t value = (uint64_t(reader.readUnary()) << k) | reader.read(k);
+        return static_cast<int32_t>(static_cast<uint32_t>(value >> 1) ^ (0u - static_cast<uint32_t>(value & 1)));
+    }
+
+    //==============================================================================
+    enum ChannelAssignment
+    {
+        independent,
+        leftSide,
+        sideRight,
+        midSide
+    };
+
+    struct FrameHeader
+    {
+        int headerBytes = 0;
+        int blockSize = 0;
+        int numChannels = 0;
+        int bitsPerSample = 0;          // 0: from STREAMINFO
+        ChannelAssignment assignment = independent;
+        bool variableBlockSize = false;
+        uint64_t number = 0;            // Frame number, or first sample with variable block sizes
+    };
+
+    /** Parse and check (CRC-8) a frame header at data; false if there is no frame header there */
+    bool parseFrameHeader(const uint8_t* data, size_t size, FrameHeader& header)
+    {
+        if (size < 6 || data[0] != 0xFF || (data[1] & 0xFE) != 0xF8)
+            return false;
+
+        header.variableBlockSize = (data[1] & 1) != 0;
+        const int blockSizeCode = data[2] >> 4;
+        const int sampleRateCode = data[2] & 0x0F;
+        const int channelCode = data[3] >> 4;
+        const int sampleSizeCode = (data[3] >> 1) & 0x07;
+
+        if (blockSizeCode == 0 || sampleRateCode == 15 || channelCode > 10 || sampleSizeCode == 3 || (data[3] & 1) != 0)
+            return false;
+
+        // The frame or sample number, UTF-8 style: leading ones give the byte count
+        size_t pos = 4;
+        const uint8_t first = data[pos++];
+        int extraBytes = 0;
+        uint64_t number = 0;
+        if ((first & 0x80) == 0)
+        {
+            number = first;
+        }
+        else
+        {
+            while (extraBytes < 7 && (first & (0x40 >> extraBytes)) != 0)
+                ++extraBytes;
+            if (extraBytes == 0 || extraBytes > 6 || (!header.variableBlockSize && extraBytes > 5))
+                return false;
+
+            number = extraBytes == 6 ? 0 : first & (0x3F >> extraBytes);
+            for (int i = 0; i < extraBytes; ++i)
+            {
+                if (pos >= size || (data[pos] & 0xC0) != 0x80)
+                    return false;
+                number = (number << 6) | (data[pos++] & 0x3F);
+            }
+        }
+
+        int blockSize = 0;
+        if (blockSizeCode == 1)
+            blockSize = 192;
+        else if (blockSizeCode <= 5)
+            blockSize = 576 << (blockSizeCode - 2);
+        else if (blockSizeCode >= 8)
+            blockSize = 256 << (blockSizeCode - 8);
+
+        const size_t extraBlockBytes = blockSizeCode == 6 ? 1 : blockSizeCode == 7 ? 2 : 0;
+        const size_t extraRateBytes = sampleRateCode == 12 ? 1 : sampleRateCode >= 13 ? 2 : 0;
+        if (pos + extraBlockBytes + extraRateBytes + 1 > size)
+            return false;
+
+        if (blockSizeCode == 6)
+            blockSize = data[pos] + 1;
+        else if (blockSizeCode == 7)
+            blockSize = ((data[pos] << 8) | data[pos + 1]) + 1;
+        pos += extraBlockBytes + extraRateBytes;
+
+        if (crc8(data, pos) != data[pos])
+            return false;
+
+        static constexpr int sampleSizes[8] = { 0, 8, 12, 0, 16, 20, 24, 32 };
+
+        header.headerBytes = static_cast<int>(pos + 1);
+        header.blockSize = blockSize;
+        header.number = number;
+        header.bitsPerSample = sampleSizes[sampleSizeCode];
+        header.numChannels = channelCode < 8 ? channelCode + 1 : 2;
+        header.assignment = channelCode == 8 ? leftSide : channelCode == 9 ? sideRight : channelCode == 10 ? midSide : independent;
+        return true;
+    }
+
+    //==============================================================================
+    bool decodeResidual(BitReader& reader, int blockSize, int order, int32_t* residual)
+    {
+        const uint32_t method = reader.read(2);
+        if (method > 1)
+            return false;
+
+        const int parameterBits = method == 0 ? 4 : 5;
+        const uint32_t escape = method == 0 ? 15u : 31u;
+        const int partitionOrder = static_cast<int>(reader.read(4));
+        const int partitions = 1 << partitionOrder;
+        const int partitionSize = blockSize >> partitionOrder;
+
+        if ((partitionSize << partitionOrder) != blockSize || partitionSize < order)
+            return false;
+
+        int n = 0;
+        for (int p = 0; p < partitions; ++p)
+        {
+            const int count = p == 0 ? partitionSize - order : partitionSize;
+            const uint32_t parameter = reader.read(parameterBits);
+
+            if (parameter == escape)
+            {
+                const int bits = static_cast<int>(reader.read(5));
+                for (int i = 0; i < count; ++i)
+                    residual[n++] = reader.readSigned(bits);
+            }
+            else
+            {
+                const int k = static_cast<int>(parameter);
+                for (int i = 0; i < count; ++i)
+                    residual[n++] = readRice(reader, k);
+            }
+
+            if (!reader.isValid())
+                return false;
+        }
+        return true;
+    }
+
+    bool decodeSubframe(BitReader& reader, int blockSize, int bitsPerSample, int32_t* x)
+    {
+        if (reader.read(1) != 0)
+            return false;
+
+        const uint32_t type = reader.read(6);
+
+        int wasted = 0;
+        if (reader.read(1) != 0)
+            wasted = static_cast<int>(reader.readUnary()) + 1;
+        bitsPerSample -= wasted;
+        if (bitsPerSample <= 0)
+            return false;
+
+        if (type == 0)
+        {
+            std::fill_n(x, blockSize, reader.readSigned(bitsPerSample));
+        }
+        else if (type == 1)
+        {
+            for (int i = 0; i < blockSize; ++i)
+                x[i] = reader.readSigned(bitsPerSample);
+        }
+        else if (type >= 8 && type <= 12)
+        {
+            const int order = static_cast<int>(type - 8);
+            if (order > blockSize)
+                return false;
+
+            for (int i = 0; i < order; ++i)
+                x[i] = reader.readSigned(bitsPerSample);
+            if (!decodeResidual(reader, blockSize, order, x + order))
+                return false;
+
+            // Residuals are in place: add the fixed polynomial prediction
+            switch (order)
+            {
+                case 1:  for (int i = 1; i < blockSize; ++i) x[i] += x[i - 1]; break;
+                case 2:  for (int i = 2; i < blockSize; ++i) x[i] += static_cast<int32_t>(2 * int64_t(x[i - 1]) - x[i - 2]); break;
+                case 3:  for (int i = 3; i < blockSize; ++i) x[i] += static_cast<int32_t>(3 * (int64_t(x[i - 1]) - x[i - 2]) + x[i - 3]); break;
+                case 4:  for (int i = 4; i < blockSize; ++i) x[i] += static_cast<int32_t>(4 * (int64_t(x[i - 1]) + x[i - 3]) - 6 * int64_t(x[i - 2]) - x[i - 4]); break;
+                default: break;
+            }
+        }
+        else if (type >= 32)
+        {
+            const int order = static_cast<int>(type - 31);
+            if (order > blockSize)
+                return false;
+
+            for (int i = 0; i < order; ++i)
+                x[i] = reader.readSigned(bitsPerSample);
+
+            const int precision = static_cast<int>(reader.read(4)) + 1;
+            const int shift = reader.readSigned(5);
+            if (precision == 16 || shift < 0)
+                return false;
+
+            std::array<int32_t, 32> coefficients {};
+            for (int i = 0; i < order; ++i)
+                coefficients[static_cast<size_t>(i)] = reader.readSigned(precision);
+
+            if (!decodeResidual(reader, blockSize, order, x + order))
+                return false;
+
+            for (int i = order; i < blockSize; ++i)
+            {
+                int64_t sum = 0;
+                for (int j = 0; j < order; ++j)
+                    sum += int64_t(coefficients[static_cast<size_t>(j)]) * x[i - 1 - j];
+                x[i] += static_cast<int32_t>(sum >> shift);
+            }
+        }
+        else
+        {
+            return false;
+        }
+
+        if (wasted > 0)
+            for (int i = 0; i < blockSize; ++i)
+                x[i] = static_cast<int32_t>(static_cast<uint32_t>(x[i]) << wasted);
+
+        return reader.isValid();
+    }
+
+    /** Decode one whole frame (CRC-16 checked) into channels, which hold maxBlockSize samples each */
+    bool decodeFrame(const uint8_t* data, size_t size, int streamBitsPerSample, int numChannels, int maxBlockSize,
+                     int32_t* const* channels, int& blockSize)
+    {
+        FrameHeader header;
+        if (!parseFrameHeader(data, std::min<size_t>(size, maxHeaderBytes), header)
+            || header.numChannels != numChannels || header.blockSize > maxBlockSize)
+            return false;
+
+        const int bitsPerSample = header.bitsPerSample != 0 ? header.bitsPerSample : streamBitsPerSample;
+        if (bitsPerSample > FlacSeekIndex::maxBitsPerSample)
+            return false;
+
+        BitReader reader(data + header.headerBytes, size - static_cast<size_t>(header.headerBytes));
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            // Side channels carry one extra bit
+            const bool isSide = (header.assignment == leftSide && ch == 1) || (header.assignment == sideRight && ch == 0)
+                             || (header.assignment == midSide && ch == 1);
+            if (!decodeSubframe(reader, header.blockSize, bitsPerSample + (isSide ? 1 : 0), channels[ch]))
+                return false;
+        }
+
+        reader.alignToByte();
+        const size_t frameBytes = static_cast<size_t>(header.headerBytes) + reader.getBitPosition() / 8 + 2;
+        if (frameBytes > size || crc16(data, frameBytes - 2) != ((data[frameBytes - 2] << 8) | data[frameBytes - 1]))
+            return false;
+
+        int32_t* a = channels[0];
+        int32_t* b = numChannels > 1 ? channels[1] : nullptr;
+        switch (header.assignment)
+        {
+            case leftSide:  for (int i = 0; i < header.blockSize; ++i) b[i] = a[i] - b[i]; break;
+            case sideRight: for (int i = 0; i < header.blockSize; ++i) a[i] += b[i]; break;
+            case midSide:
+                for (int i = 0; i < header.blockSize; ++i)
+                {
+                    const int64_t mid = (int64_t(a[i]) * 2) | (b[i] & 1);
+                    const int64_t side = b[i];
+                    a[i] = static_cast<int32_t>((mid + side) >> 1);
+                    b[i] = static_cast<int32_t>((mid - side) >> 1);
+                }
+                break;
+            case independent:
+            default:
+                break;
+        }
+
+        blockSize = header.blockSize;
+        return true;
+    }
+
+    //==============================================================================
+    /** Reads a FLAC file as float through its index */
+    class FlacStreamReader : public juce::AudioFormatReader
+    {
+    public:
+        FlacStreamReader(std::shared_ptr<FlacSeekIndex> seekIndex, std::unique_ptr<juce::FileInputStream> stream)
+            : juce::AudioFormatReader(nullptr, "Hammer Sampler FLAC"),
+              index(std::move(seekIndex)),
+              input(std::move(stream))
+        {
+            sampleRate = index->getSampleRate();
+            numChannels = static_cast<unsigned int>(index->getNumChannels());
+            lengthInSamples = index->getTotalSamples();
+            bitsPerSample = 32;
+            usesFloatingPointData = true;
+
+            decoded.assign(numChannels, std::vector<int32_t>(static_cast<size_t>(index->getMaxBlockSize())));
+            for (auto& channel : decoded)
+                decodedChannels.push_back(channel.data());
+
+            scale = 1.0f / static_cast<float>(1 << (index->getBitsPerSample() - 1));
+        }
+
+        bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                         juce::int64 startSampleInFile, int numSamples) override
+        {
+            const auto& frames = index->getFrames();
+            float* const* dest = reinterpret_cast<float* const*>(destChannels);
+            int done = 0;
+
+            while (done < numSamples)
+            {
+                const int64_t sample = startSampleInFile + done;
+                const int destOffset = startOffsetInDestBuffer + done;
+
+                // Outside the file: zeros, as the JUCE reader gives (voices read ahead of their start)
+                if (sample < 0 || sample >= index->getTotalSamples())
+                {
+                    const int silent = sample < 0 ? static_cast<int>(std::min<int64_t>(-sample, numSamples - done))
+                                                  : numSamples - done;
+                    for (int ch = 0; ch < numDestChannels; ++ch)
+                        if (dest[ch] != nullptr)
+                            std::fill_n(dest[ch] + destOffset, silent, 0.0f);
+                    done += silent;
+                    continue;
+                }
+
+                // Streaming reads continue in the decoded frame or the one after it; only a jump looks the frame up
+                int frame = decodedFrame;
+                if (frame < 0 || sample < frames[static_cast<size_t>(frame)].firstSample || sample >= decodedEnd)
+                    frame = (frame >= 0 && sample == decodedEnd) ? frame + 1 : index->findFrame(sample);
+
+                if (frame != decodedFrame && !decode(frame, startSampleInFile + numSamples))
+                    return false;
+
+                const int64_t frameStart = frames[static_cast<size_t>(frame)].firstSample;
+                const int offset = static_cast<int>(sample - frameStart);
+                const int count = static_cast<int>(std::min<int64_t>(decodedEnd - sample, numSamples - done));
+
+                for (int ch = 0; ch < numDestChannels; ++ch)
+                {
+                    if (dest[ch] == nullptr)
+                        continue;
+
+                    if (ch >= static_cast<int>(numChannels))
+                    {
+                        std::fill_n(dest[ch] + destOffset, count, 0.0f);
+                        continue;
+                    }
+
+                    const int32_t* source = decoded[static_cast<size_t>(ch)].data() + offset;
+                    float* out = dest[ch] + destOffset;
+                    for (int i = 0; i < count; ++i)
+                        out[i] = static_cast<float>(source[i]) * scale;
+                }
+
+                done += count;
+            }
+
+            return true;
+        }
+
+    private:
+        static constexpr int64_t maxSpanBytes = 256 * 1024;
+
+        /** Decode a frame, reading it (and the following frames up to endSample) from disk unless
+            the last read already brought it in */
+        bool decode(int frame, int64_t endSample)
+        {
+            const auto& frames = index->getFrames();
+
+            if (frame < spanFirst || frame > spanLast)
+            {
+                // One read for the frames this request needs, within a bound
+                const int64_t start = frames[static_cast<size_t>(frame)].offset;
+                int last = frame;
+                while (last + 1 < static_cast<int>(frames.size())
+                       && frames[static_cast<size_t>(last + 1)].firstSample < endSample
+                       && index->getFrameEnd(last + 1) - start <= maxSpanBytes)
+                    ++last;
+
+                const auto bytes = static_cast<size_t>(index->getFrameEnd(last) - start);
+                spanFirst = spanLast = -1;
+                span.resize(bytes);
+                if (!input->setPosition(start) || input->read(span.data(), static_cast<int>(bytes)) != static_cast<int>(bytes))
+                    return false;
+
+                spanFirst = frame;
+                spanLast = last;
+            }
+
+            const auto offset = static_cast<size_t>(frames[static_cast<size_t>(frame)].offset - frames[static_cast<size_t>(spanFirst)].offset);
+            const auto size = static_cast<size_t>(index->getFrameEnd(frame) - frames[static_cast<size_t>(frame)].offset);
+
+            int blockSize = 0;
+            decodedFrame = -1;
+            if (!decodeFrame(span.data() + offset, size, index->getBitsPerSample(), static_cast<int>(numChannels),
+                             index->getMaxBlockSize(), decodedChannels.data(), blockSize))
+            {
+                DebugLog::write("FlacSeekIndex: frame " + juce::String(frame) + " of " + index->getFile().getFullPathName()
+                                + " doesn't decode");
+                return false;
+            }
+
+            decodedFrame = frame;
+            decodedEnd = frames[static_cast<size_t>(frame)].firstSample + blockSize;
+            return true;
+        }
+
+        std::shared_ptr<FlacSeekIndex> index;
+        std::unique_ptr<juce::FileInputStream> input;   // This reader's own: a seek and read must not interleave with another's
+        float scale = 1.0f;
+
+        std::vector<uint8_t> span;
+        int spanFirst = -1, spanLast = -1;              // Frames held in span
+
+        std::vector<std::vector<int32_t>> decoded;
+        std::vector<int32_t*> decodedChannels;
+        int decodedFrame = -1;
+        int64_t decodedEnd = 0;
+    };
+}
+
+//==============================================================================
+std::shared_ptr<FlacSeekIndex> FlacSeekIndex::open(const juce::File& flacFile, bool build)
+{
+    const auto path = flacFile.getFullPathName();
+    const int64_t size = flacFile.getSize();
+    const int64_t modified = flacFile.getLastModificationTime().toMilliseconds();
+
+    std::unique_lock<std::mutex> lock(registryMutex);
+
+    if (auto existing = registry[path].lock())
+        if (existing->fileSize == size && existing->modificationTime == modified)
+            return existing;
+
+    lock.unlock();
+
+    std::shared_ptr<FlacSeekIndex> index(new FlacSeekIndex());
+    index->file = flacFile;
+    index->fileSize = size;
+    index->modificationTime = modified;
+
+    const auto cacheFile = getDefaultDirectory().getChildFile(juce::String::toHexString(path.hashCode64()) + ".idx");
+    if (!index->load(cacheFile))
+    {
+        if (!build || !index->scan())
+            return nullptr;
+
+        index->save(cacheFile);
+    }
+
+    lock.lock();
+    registry[path] = index;
+    return index;
+}
+
+juce::File FlacSeekIndex::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("HammerSampler")
+               .getChildFile("FlacIndex");
+}
+
+int FlacSeekIndex::findFrame(int64_t sample) const
+{
+    if (sample < 0 || sample >= totalSamples)
+        return -1;
+
+    auto it = std::upper_bound(frames.begin(), frames.end(), sample,
+                               [](int64_t s, const Frame& frame) { return s < frame.firstSample; });
+    return static_cast<int>(it - frames.begin()) - 1;
+}
+
+int64_t FlacSeekIndex::getFrameEnd(int frameIndex) const
+{
+    return frameIndex + 1 < static_cast<int>(frames.size()) ? frames[static_cast<size_t>(frameIndex + 1)].offset : audioEnd;
+}
+
+std::unique_ptr<juce::AudioFormatReader> FlacSeekIndex::createReader()
+{
+    auto stream = file.createInputStream();
+    if (stream == nullptr)
+        return nullptr;
+
+    return std::make_unique<FlacStreamReader>(shared_from_this(), std::move(stream));
+}
+
+bool FlacSeekIndex::scan()
+{
+    auto input = file.createInputStream();
+    if (input == nullptr)
+        return false;
+
+    // Skip an ID3v2 tag some taggers put in front
+    uint8_t header[10] {};
+    int64_t position = 0;
+    if (input->read(header, 10) == 10 && std::memcmp(header, "ID3", 3) == 0)
+        position = 10 + (int64_t(header[6] & 0x7F) << 21 | int64_t(header[7] & 0x7F) << 14
+                         | int64_t(header[8] & 0x7F) << 7 | int64_t(header[9] & 0x7F)) + ((header[5] & 0x10) != 0 ? 10 : 0);
+
+    // "fLaC", then metadata blocks; STREAMINFO comes first
+    uint8_t magic[4] {};
+    if (!input->setPosition(position) || input->read(magic, 4) != 4 || std::memcmp(magic, "fLaC", 4) != 0)
+        return false;
+    position += 4;
+
+    for (bool first = true, last = false; !last; first = false)
+    {
+        uint8_t blockHeader[4] {};
+        if (input->read(blockHeader, 4) != 4)
+            return false;
+
+        last = (blockHeader[0] & 0x80) != 0;
+        const int type = blockHeader[0] & 0x7F;
+        const int length = (blockHeader[1] << 16) | (blockHeader[2] << 8) | blockHeader[3];
+
+        if (type == 0)
+        {
+            uint8_t info[34] {};
+            if (length < 34 || input->read(info, 34) != 34)
+                return false;
+
+            sampleRate = static_cast<double>((info[10] << 12) | (info[11] << 4) | (info[12] >> 4));
+            numChannels = ((info[12] >> 1) & 0x07) + 1;
+            bitsPerSample = (((info[12] & 1) << 4) | (info[13] >> 4)) + 1;
+        }
+        else if (first)
+        {
+            return false;
+        }
+
+        position += 4 + length;
+        if (!input->setPosition(position))
+            return false;
+    }
+
+    if (numChannels == 0 || numChannels > maxChannels || bitsPerSample > maxBitsPerSample || sampleRate <= 0.0)
+        return false;
+
+    // Walk the frame headers: a frame starts at a sync code whose header checks out and carries
+    // the next frame (or sample) number, which rules out sync patterns inside audio data
+    std::vector<uint8_t> buffer;
+    int64_t bufferStart = 0;
+    int64_t nextSample = 0;
+    frames.clear();
+    maxBlockSize = 0;
+
+    while (position + 2 < fileSize)
+    {
+        // Keep a whole header's worth of bytes from position in the buffer
+        const int64_t wanted = std::min<int64_t>(maxHeaderBytes, fileSize - position);
+        if (position < bufferStart || position + wanted > bufferStart + static_cast<int64_t>(buffer.size()))
+        {
+            bufferStart = position;
+            buffer.resize(static_cast<size_t>(std::min(scanChunkBytes, fileSize - position)));
+            if (!input->setPosition(position) || input->read(buffer.data(), static_cast<int>(buffer.size())) != static_cast<int>(buffer.size()))
+                return false;
+        }
+
+        const auto offset = static_cast<size_t>(position - bufferStart);
+        const uint8_t* data = buffer.data() + offset;
+        const size_t available = buffer.size() - offset;
+
+        if (data[0] != 0xFF)
+        {
+            const auto* sync = static_cast<const uint8_t*>(std::memchr(data, 0xFF, available));
+            position += sync != nullptr ? sync - data : static_cast<int64_t>(available);
+            continue;
+        }
+
+        FrameHeader frameHeader;
+        if (parseFrameHeader(data, std::min<size_t>(available, maxHeaderBytes), frameHeader)
+            && frameHeader.numChannels == numChannels
+            && (frameHeader.bitsPerSample == 0 || frameHeader.bitsPerSample == bitsPerSample)
+            && frameHeader.number == (frameHeader.variableBlockSize ? static_cast<uint64_t>(nextSample) : frames.size()))
+        {
+            frames.push_back({ nextSample, position });
+            nextSample += frameHeader.blockSize;
+            maxBlockSize = std::max(maxBlockSize, frameHeader.blockSize);
+            position += frameHeader.headerBytes;
+            continue;
+        }
+
+        ++position;
+    }
+
+    if (frames.empty())
+        return false;
+
+    totalSamples = nextSample;
+    audioEnd = fileSize;
+
+    DebugLog::write("FlacSeekIndex: indexed " + file.getFullPathName() + " (" + juce::String(static_cast<int>(frames.size()))
+                    + " frames, " + juce::String(totalSamples) + " samples)");
+    return true;
+}
+
+bool FlacSeekIndex::load(const juce::File& cacheFile)
+{
+    juce::FileInputStream in(cacheFile);
+    if (in.failedToOpen())
+        return false;
+
+    char magic[4] {};
+    if (in.read(magic, 4) != 4 || std::memcmp(magic, indexMagic, 4) != 0 || in.readInt() != indexVersion)
+        return false;
+
+    // Tied to the file it was made from, as it is now
+    if (in.readString() != file.getFullPathName() || in.readInt64() != fileSize || in.readInt64() != modificationTime)
+        return false;
+
+    sampleRate = in.readDouble();
+    numChannels = in.readInt();
+    bitsPerSample = in.readInt();
+    maxBlockSize = in.readInt();
+    totalSamples = in.readInt64();
+    audioEnd = in.readInt64();
+    const int numFrames = in.readInt();
+
+    if (numChannels <= 0 || numChannels > maxChannels || bitsPerSample <= 0 || bitsPerSample > maxBitsPerSample
+        || maxBlockSize <= 0 || maxBlockSize > 65536 || audioEnd > fileSize || numFrames <= 0
+        || in.getNumBytesRemaining() != int64_t(numFrames) * 16)
+        return false;
+
+    frames.resize(static_cast<size_t>(numFrames));
+    for (auto& frame : frames)
+    {
+        frame.firstSample = in.readInt64();
+        frame.offset = in.readInt64();
+    }
+
+    for (size_t i = 1; i < frames.size(); ++i)
+        if (frames[i].firstSample <= frames[i - 1].firstSample || frames[i].offset <= frames[i - 1].offset)
+            return false;
+
+    return frames.back().offset < audioEnd && frames.back().firstSample < totalSamples;
+}
+
+void FlacSeekIndex::save(const juce::File& cacheFile) const
+{
+    if (cacheFile.getParentDirectory().createDirectory().failed())
+        return;
+
+    juce::TemporaryFile temp(cacheFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+            return;
+
+        out.write(indexMagic, sizeof(indexMagic));
+        out.writeInt(indexVersion);
+        out.writeString(file.getFullPathName());
+        out.writeInt64(fileSize);
+        out.writeInt64(modificationTime);
+        out.writeDouble(sampleRate);
+        out.writeInt(numChannels);
+        out.writeInt(bitsPerSample);
+        out.writeInt(maxBlockSize);
+        out.writeInt64(totalSamples);
+        out.writeInt64(audioEnd);
+        out.writeInt(static_cast<int>(frames.size()));
+        for (const auto& frame : frames)
+        {
+            out.writeInt64(frame.firstSample);
+            out.writeInt64(frame.offset);
+        }
+        out.flush();
+
+        if (out.getStatus().failed())
+            return;
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+        DebugLog::write("FlacSeekIndex: could not cache the index of " + file.getFullPathName());
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * FlacSeekIndex is the frame table of a FLAC file (first sample and byte offset of every
+ * frame). It is built when a library is scanned and cached on disk, so streaming a FLAC
+ * sample never searches the file for a frame.
+ *
+ * - Building walks the frame headers (sync code, header CRC and frame numbering checked)
+ *   without decoding audio, so indexing a file costs about one sequential read of it
+ * - The cached table is tied to the file's size and modification time and rebuilt when
+ *   either changes
+ * - Readers from createReader() decode FLAC themselves: a read anywhere looks its frame up
+ *   in the table, and a reader keeps its last decoded frame, so the refills of a streaming
+ *   voice carry on from where the previous one stopped without seeking
+ *
+ * Files the decoder doesn't handle (more than maxChannels channels or maxBitsPerSample
+ * bits) get no index and stream through the JUCE reader as before.
+ */
+class FlacSeekIndex : public std::enable_shared_from_this<FlacSeekIndex>
+{
+public:
+    static constexpr int maxChannels = 8;
+    static constexpr int maxBitsPerSample = 24;
+
+    struct Frame
+    {
+        int64_t firstSample = 0;
+        int64_t offset = 0;         // File offset of the frame header
+    };
+
+    /** The index of a FLAC file, from memory or the cache, or (if build is true) made by scanning
+        the file and cached. nullptr if there is none or the file can't be indexed. */
+    static std::shared_ptr<FlacSeekIndex> open(const juce::File& file, bool build);
+
+    const juce::File& getFile() const { return file; }
+    double getSampleRate() const { return sampleRate; }
+    int getNumChannels() const { return numChannels; }
+    int getBitsPerSample() const { return bitsPerSample; }
+    int getMaxBlockSize() const { return maxBlockSize; }
+    int64_t getTotalSamples() const { return totalSamples; }
+    const std::vector<Frame>& getFrames() const { return frames; }
+
+    /** The frame holding a sample, or -1 if the sample is out of range */
+    int findFrame(int64_t sample) const;
+
+    /** Where a frame ends (the next frame's offset, or the end of the audio) */
+    int64_t getFrameEnd(int frameIndex) const;
+
+    /** A float reader for the file, keeping the index alive */
+    std::unique_ptr<juce::AudioFormatReader> createReader();
+
+    /** Where indexes are cached */
+    static juce::File getDefaultDirectory();
+
+private:
+    FlacSeekIndex() = default;
+
+    bool scan();
+    bool load(const juce::File& cacheFile);
+    void save(const juce::File& cacheFile) const;
+
+    juce::File file;
+    int64_t fileSize = 0;
+    int64_t modificationTime = 0;
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    int bitsPerSample = 16;
+    int maxBlockSize = 0;
+    int64_t totalSamples = 0;
+    int64_t audioEnd = 0;
+    std::vector<Frame> frames;
+};
@@ -0,0 +1,196 @@
+#include "HostRateCache.h"
+#include "DebugLog.h"
+#include "SampleContainer.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace
+{
+    constexpr int kernelZeroCrossings = 64;   // Each side of the centre, at the kernel's cutoff
+    constexpr int kernelOversampling = 512;   // Table entries per zero crossing (linearly interpolated)
+    constexpr int kernelTableSize = kernelZeroCrossings * kernelOversampling;
+    constexpr double kaiserBeta = 10.0;       // About 100 dB of stopband rejection
+    constexpr double kernelCutoff = 0.95;     // Of the lower Nyquist; the transition band ends at Nyquist
+    constexpr int renderChunkFrames = 16384;
+    constexpr int maxCopyBitsPerSample = 24;  // Integer PCM; deeper or float sources are rounded to it
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 64 && term > sum * 1.0e-15; ++k)
+        {
+            const double half = x / (2.0 * k);
+            term *= half * half;
+            sum += term;
+        }
+        return sum;
+    }
+
+    // Kaiser-windowed sinc from the centre out, one entry past the end so lookups can interpolate
+    const std::vector<float>& getKernelTable()
+    {
+        static const std::vector<float> table = []
+        {
+            std::vector<float> values(static_cast<size_t>(kernelTableSize) + 2, 0.0f);
+            const double windowScale = 1.0 / besselI0(kaiserBeta);
+
+            for (int i = 0; i <= kernelTableSize; ++i)
+            {
+                const double x = static_cast<double>(i) / kernelOversampling;
+                const double r = x / kernelZeroCrossings;
+                const double sinc = i == 0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+                values[static_cast<size_t>(i)] = static_cast<float>(sinc * besselI0(kaiserBeta * std::sqrt(1.0 - r * r)) * windowScale);
+            }
+            return values;
+        }();
+        return table;
+    }
+}
+
+//==============================================================================
+juce::File HostRateCache::getCopyFile(const juce::File& directory, const juce::String& samplePath,
+                                      uint64_t fingerprint, double sampleRate)
+{
+    const int rate = juce::roundToInt(sampleRate);
+    const auto key = samplePath + "|" + juce::String::toHexString(static_cast<juce::int64>(fingerprint)) + "|" + juce::String(rate);
+    return directory.getChildFile(juce::String::toHexString(key.hashCode64()) + "_" + juce::String(rate) + ".wav");
+}
+
+bool HostRateCache::render(juce::AudioFormatManager& formatManager, const juce::String& samplePath,
+                           const juce::File& destination, double sampleRate)
+{
+    auto reader = SampleContainer::createReaderFor(formatManager, samplePath);
+    if (reader == nullptr || reader->numChannels == 0 || reader->sampleRate <= 0.0 || sampleRate <= 0.0
+        || destination.getParentDirectory().createDirectory().failed())
+        return false;
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+    const double step = reader->sampleRate / sampleRate;                   // Source frames per rendered frame
+    const double cutoff = kernelCutoff * std::min(1.0, 1.0 / step);        // Relative to the source Nyquist
+    const int radius = static_cast<int>(std::ceil(kernelZeroCrossings / cutoff));   // Source frames each side
+    const auto renderedFrames = static_cast<int64_t>(std::llround(static_cast<double>(reader->lengthInSamples) / step));
+    const double tableScale = cutoff * kernelOversampling;
+    const auto& table = getKernelTable();
+
+    juce::TemporaryFile temp(destination);
+    {
+        auto stream = std::make_unique<juce::FileOutputStream>(temp.getFile());
+        if (stream->failedToOpen())
+            return false;
+
+        // Source bit depth (16 or 24), capped at 24-bit integer
+        const int bitsPerSample = reader->usesFloatingPointData || reader->bitsPerSample > 16 ? maxCopyBitsPerSample : 16;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, reader->numChannels,
+                                                                            bitsPerSample, {}, 0));
+        if (writer == nullptr)
+            return false;
+        stream.release();
+
+        juce::AudioBuffer<float> input;
+        juce::AudioBuffer<float> output(numChannels, renderChunkFrames);
+        std::vector<float> weights(static_cast<size_t>(2 * radius));
+        double weightsFraction = -1.0;
+        float weightsScale = 0.0f;
+
+        for (int64_t first = 0; first < renderedFrames; first += renderChunkFrames)
+        {
+            const int numFrames = static_cast<int>(std::min<int64_t>(renderChunkFrames, renderedFrames - first));
+
+            // Every source frame the chunk's kernels touch; reads before the start or past the end give silence
+            const auto inputStart = static_cast<int64_t>(std::floor(static_cast<double>(first) * step)) - radius;
+            const auto inputEnd = static_cast<int64_t>(std::floor(static_cast<double>(first + numFrames - 1) * step)) + radius + 2;
+            const int inputFrames = static_cast<int>(inputEnd - inputStart);
+            input.setSize(numChannels, inputFrames, false, false, true);
+            if (!reader->read(&input, 0, inputFrames, inputStart, true, true))
+                return false;
+
+            for (int frame = 0; frame < numFrames; ++frame)
+            {
+                const double position = static_cast<double>(first + frame) * step;
+                const auto centre = static_cast<int64_t>(std::floor(position));
+                const double fraction = position - static_cast<double>(centre);
+
+                // Integer ratios land on the same fraction every frame: the weights carry over
+                if (fraction != weightsFraction)
+                {
+                    float sum = 0.0f;
+                    for (int tap = 0; tap < 2 * radius; ++tap)
+                    {
+                        const double distance = std::abs(static_cast<double>(tap - radius + 1) - fraction) * tableScale;
+                        const int index = static_cast<int>(distance);
+                        float weight = 0.0f;
+                        if (index < kernelTableSize)
+                        {
+                            const auto alpha = static_cast<float>(distance - index);
+                            weight = table[static_cast<size_t>(index)]
+                                   + alpha * (table[static_cast<size_t>(index) + 1] - table[static_cast<size_t>(index)]);
+                        }
+                        weights[static_cast<size_t>(tap)] = weight;
+                        sum += weight;
+                    }
+
+                    // Unity gain at DC whatever the fraction
+                    weightsScale = sum != 0.0f ? 1.0f / sum : 0.0f;
+                    weightsFraction = fraction;
+                }
+
+                const int offset = static_cast<int>(centre - inputStart) - radius + 1;
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    const float* in = input.getReadPointer(ch, offset);
+                    float acc = 0.0f;
+                    for (int tap = 0; tap < 2 * radius; ++tap)
+                        acc += weights[static_cast<size_t>(tap)] * in[tap];
+                    output.setSample(ch, frame, acc * weightsScale);
+                }
+            }
+
+            if (!writer->writeFromAudioSampleBuffer(output, 0, numFrames))
+                return false;
+        }
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+int HostRateCache::renderAll(const std::vector<Job>& jobs, double sampleRate)
+{
+    std::atomic<size_t> nextJob{0};
+    std::atomic<int> numRendered{0};
+
+    auto work = [&jobs, &nextJob, &numRendered, sampleRate]
+    {
+        // Each thread opens its own readers
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+        {
+            if (render(formatManager, jobs[i].source, jobs[i].destination, sampleRate))
+                ++numRendered;
+            else
+                DebugLog::write("HostRateCache: could not render " + jobs[i].source);
+        }
+    };
+
+    // The calling thread takes a share too
+    const int numThreads = static_cast<int>(std::min<size_t>(jobs.size(), static_cast<size_t>(juce::jmax(1, juce::SystemStats::getNumCpus()))));
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto& thread : threads)
+        thread.join();
+
+    return numRendered.load();
+}
+
+juce::File HostRateCache::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("HammerSampler")
+               .getChildFile("RateCache");
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <vector>
+
+/**
+ * HostRateCache renders copies of samples at the host's sample rate, so voices playing a sample
+ * at its root pitch don't interpolate and a 96 kHz library streams half the bytes at 48 kHz.
+ *
+ * - Copies are WAVs in a local cache folder, named after the source (path and fingerprint) and
+ *   the rate, so a changed sample or another host rate renders a new copy
+ * - They keep the source's bit depth, at most 24-bit integer: float sources are 24-bit too
+ *   (144 dB is below the resampler's own floor, and the copies are a quarter smaller)
+ * - Rendering is offline and multithreaded: renderAll() spreads the samples over the CPU cores.
+ *   It runs inside acquireLibrary, on the loading thread, so the first load at a new rate waits
+ *   for it, as does every instance asking for the same rendering meanwhile
+ * - The resampler is a Kaiser-windowed sinc (136 taps upsampling, proportionally more when
+ *   decimating): passband flat to 0.95 of the lower Nyquist, about 100 dB of stopband rejection
+ * - The folder is trimmed like the transcode cache: least recently used copies go first, except
+ *   those a loaded library still reads
+ *
+ * SharedSamplePool builds a host-rate variant of a library from these copies
+ * (acquireLibrary with a render rate); SamplerEngine asks for it when the option is on.
+ */
+class HostRateCache
+{
+public:
+    static constexpr int64_t defaultMaxBytes = int64_t(16) * 1024 * 1024 * 1024;
+
+    struct Job
+    {
+        juce::String source;        // Sample path (a file or a container entry)
+        juce::File destination;
+    };
+
+    /** Where the copy of a sample at a rate goes in a cache folder */
+    static juce::File getCopyFile(const juce::File& directory, const juce::String& samplePath,
+                                  uint64_t fingerprint, double sampleRate);
+
+    /** Resample a sample into a WAV at destination (replaced atomically; false on failure) */
+    static bool render(juce::AudioFormatManager& formatManager, const juce::String& samplePath,
+                       const juce::File& destination, double sampleRate);
+
+    /** Render every job on all cores (blocks until done); returns how many copies were written */
+    static int renderAll(const std::vector<Job>& jobs, double sampleRate);
+
+    static juce::File getDefaultDirectory();
+};
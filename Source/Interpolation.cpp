@@ -0,0 +1,71 @@
+#include "Interpolation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Interpolation
+{
+    const SincTable& SincTable::get()
+    {
+        static const SincTable instance;
+        return instance;
+    }
+
+    SincTable::SincTable()
+    {
+        constexpr double pi = 3.14159265358979323846;
+        constexpr int history = KernelTraits<InterpolationQuality::Sinc>::history;
+        constexpr double halfWidth = numTaps / 2.0;
+
+        for (size_t t = 0; t < tables.size(); ++t)
+        {
+            const double cutoff = cutoffs[t];
+
+            for (int phase = 0; phase <= numPhases; ++phase)
+            {
+                const double frac = static_cast<double>(phase) / numPhases;
+                auto& row = tables[t][static_cast<size_t>(phase)];
+                double sum = 0.0;
+
+                for (int tap = 0; tap < numTaps; ++tap)
+                {
+                    // Distance from the interpolation point to this tap, in source frames
+                    const double d = static_cast<double>(tap - history) - frac;
+
+                    const double x = pi * cutoff * d;
+                    const double sincValue = (std::abs(x) < 1.0e-9) ? 1.0 : std::sin(x) / x;
+
+                    // Blackman window over the kernel width
+                    double window = 0.0;
+                    if (std::abs(d) < halfWidth)
+                        window = 0.42 + 0.5 * std::cos(pi * d / halfWidth) + 0.08 * std::cos(2.0 * pi * d / halfWidth);
+
+                    const double value = cutoff * sincValue * window;
+                    row.coefficients[tap] = static_cast<float>(value);
+                    sum += value;
+                }
+
+                // Normalize to unity DC gain
+                if (sum != 0.0)
+                {
+                    for (auto& c : row.coefficients)
+                        c = static_cast<float>(c / sum);
+                }
+            }
+        }
+    }
+
+    const SincTable::Table& SincTable::tableForPitchRatio(double pitchRatio) const
+    {
+        // Source is read pitchRatio frames per output frame, so content above
+        // (output Nyquist / pitchRatio) would fold back. Pick the widest cutoff below that.
+        const double maxCutoff = cutoffs[0] / std::max(1.0, std::abs(pitchRatio));
+
+        for (size_t t = 0; t < tables.size(); ++t)
+        {
+            if (cutoffs[t] <= maxCutoff + 1.0e-6)
+                return tables[t];
+        }
+
+        return tables.back();
+    }
+}
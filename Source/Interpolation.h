@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Interpolation kernels used by StreamingVoice when a voice plays at a pitch ratio other than 1.0.
+ *
+ * - Linear: 2-point, cheapest, default for live use
+ * - Cubic:  4-point 3rd-order Hermite, good compromise
+ * - Sinc:   16-tap windowed-sinc polyphase filter with precomputed coefficient tables,
+ *           band-limited to the voice's pitch ratio (intended for offline bounce)
+ */
+enum class InterpolationQuality
+{
+    Linear = 0,
+    Cubic,
+    Sinc
+};
+
+namespace Interpolation
+{
+    /** Frames needed before (history) and after (lookahead) the integer read position */
+    template <InterpolationQuality Quality>
+    struct KernelTraits;
+
+    template <>
+    struct KernelTraits<InterpolationQuality::Linear>
+    {
+        static constexpr int numTaps = 2;
+        static constexpr int history = 0;
+        static constexpr int lookahead = 1;
+    };
+
+    template <>
+    struct KernelTraits<InterpolationQuality::Cubic>
+    {
+        static constexpr int numTaps = 4;
+        static constexpr int history = 1;
+        static constexpr int lookahead = 2;
+    };
+
+    template <>
+    struct KernelTraits<InterpolationQuality::Sinc>
+    {
+        static constexpr int numTaps = 16;
+        static constexpr int history = 7;
+        static constexpr int lookahead = 8;
+    };
+
+    /** Largest history any kernel requires (ring buffer must keep this many consumed frames) */
+    constexpr int maxHistoryFrames = KernelTraits<InterpolationQuality::Sinc>::history;
+
+    inline float linear(const float* window, float frac)
+    {
+        return window[0] + frac * (window[1] - window[0]);
+    }
+
+    /** 4-point, 3rd-order Hermite. window[1] is the sample at the integer position. */
+    inline float hermite(const float* window, float frac)
+    {
+        const float xm1 = window[0], x0 = window[1], x1 = window[2], x2 = window[3];
+        const float c1 = 0.5f * (x1 - xm1);
+        const float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+        const float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+        return ((c3 * frac + c2) * frac + c1) * frac + x0;
+    }
+
+    /**
+     * Precomputed windowed-sinc polyphase tables.
+     *
+     * One table per cutoff so pitched-up voices can pick a lower cutoff and stay band-limited.
+     * Each phase row holds numTaps contiguous, 16-byte aligned coefficients, so the dot product
+     * in sinc() vectorizes. Rows are normalized to unity DC gain.
+     */
+    class SincTable
+    {
+    public:
+        static constexpr int numTaps = KernelTraits<InterpolationQuality::Sinc>::numTaps;
+        static constexpr int numPhases = 256;
+        static constexpr int numCutoffs = 6;
+
+        struct alignas(16) Row
+        {
+            float coefficients[numTaps];
+        };
+
+        using Table = std::array<Row, numPhases + 1>;
+
+        /** Shared instance. Call once off the audio thread (SamplerEngine does) to build the tables. */
+        static const SincTable& get();
+
+        /** Table whose cutoff suits a voice playing at the given pitch ratio */
+        const Table& tableForPitchRatio(double pitchRatio) const;
+
+        static constexpr std::array<float, numCutoffs> cutoffs { 0.95f, 0.85f, 0.7f, 0.5f, 0.35f, 0.25f };
+
+    private:
+        SincTable();
+
+        std::array<Table, numCutoffs> tables;
+    };
+
+    /** Polyphase windowed-sinc. window[history] is the sample at the integer position. */
+    inline float sinc(const float* window, float frac, const SincTable::Table& table)
+    {
+        const float phasePos = frac * static_cast<float>(SincTable::numPhases);
+        const int phase = static_cast<int>(phasePos);
+        const float phaseFrac = phasePos - static_cast<float>(phase);
+
+        const float* c0 = table[static_cast<size_t>(phase)].coefficients;
+        const float* c1 = table[static_cast<size_t>(phase + 1)].coefficients;
+
+        float sum0 = 0.0f, sum1 = 0.0f;
+        for (int tap = 0; tap < SincTable::numTaps; ++tap)
+        {
+            sum0 += window[tap] * c0[tap];
+            sum1 += window[tap] * c1[tap];
+        }
+
+        return sum0 + phaseFrac * (sum1 - sum0);
+    }
+}
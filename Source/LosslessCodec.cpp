@@ -0,0 +1,286 @@
+#include "LosslessCodec.h"
+#include "BitReader.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace
+{
+    constexpr int riceParameterBits = 5;
+    constexpr int escapeZeros = 32;     // This many zeros: the value follows as 32 raw bits
+
+    // First byte of a block
+    enum BlockMode : uint8_t
+    {
+        independent = 0,
+        leftSide = 1,       // Second channel holds left - right
+        verbatim = 2        // Noise-like audio: 24-bit samples as they are, channel after channel
+    };
+
+    inline uint32_t zigzag(int32_t value)   { return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31); }
+    inline int32_t unzigzag(uint32_t value) { return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1u))); }
+
+    /** Fixed polynomial prediction of x[i] from the previous order samples */
+    inline int64_t predict(const int32_t* x, int i, int order)
+    {
+        switch (order)
+        {
+            case 1:  return x[i - 1];
+            case 2:  return 2 * int64_t(x[i - 1]) - x[i - 2];
+            case 3:  return 3 * int64_t(x[i - 1]) - 3 * int64_t(x[i - 2]) + x[i - 3];
+            case 4:  return 4 * int64_t(x[i - 1]) - 6 * int64_t(x[i - 2]) + 4 * int64_t(x[i - 3]) - x[i - 4];
+            default: return 0;
+        }
+    }
+
+    // The first samples of a block use the highest order they have history for, so a block
+    // needs no warm-up samples and decodes on its own
+    inline int orderAt(int i, int order) { return std::min(i, order); }
+
+    class BitWriter
+    {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& destination) : out(destination) {}
+
+        void write(uint32_t value, int numBits)
+        {
+            if (numBits == 0)
+                return;
+
+            cache = (cache << numBits) | (value & ((uint64_t(1) << numBits) - 1));
+            cached += numBits;
+
+            while (cached >= 8)
+            {
+                cached -= 8;
+                out.push_back(static_cast<uint8_t>(cache >> cached));
+            }
+        }
+
+        void writeRice(uint32_t value, int k)
+        {
+            const uint32_t quotient = value >> k;
+            if (quotient >= static_cast<uint32_t>(escapeZeros))
+            {
+                write(0, escapeZeros);
+                write(value, 32);
+                return;
+            }
+
+            write(1, static_cast<int>(quotient) + 1);   // quotient zeros, then a one
+            write(value, k);
+        }
+
+        void flush()
+        {
+            if (cached > 0)
+                out.push_back(static_cast<uint8_t>(cache << (8 - cached)));
+            cached = 0;
+        }
+
+    private:
+        std::vector<uint8_t>& out;
+        uint64_t cache = 0;
+        int cached = 0;
+    };
+
+    /** A Rice-coded value as BitWriter::writeRice wrote it (escapeZeros zeros: 32 raw bits follow) */
+    inline uint32_t readRice(BitReader& reader, int k)
+    {
+        const int zeros = reader.peekLeadingZeros();
+        if (zeros >= escapeZeros)
+        {
+            reader.skip(escapeZeros);
+            return reader.read(32);
+        }
+
+        reader.skip(zeros + 1);
+        return (static_cast<uint32_t>(zeros) << k) | reader.read(k);
+    }
+
+    /** Sum of absolute residuals of each predictor order */
+    std::array<int64_t, LosslessCodec::maxPredictorOrder + 1> residualCosts(const int32_t* x, int numFrames)
+    {
+        std::array<int64_t, LosslessCodec::maxPredictorOrder + 1> costs {};
+        for (int order = 0; order <= LosslessCodec::maxPredictorOrder; ++order)
+            for (int i = 0; i < numFrames; ++i)
+                costs[static_cast<size_t>(order)] += std::abs(int64_t(x[i]) - predict(x, i, orderAt(i, order)));
+        return costs;
+    }
+
+    int bestOrder(const std::array<int64_t, LosslessCodec::maxPredictorOrder + 1>& costs)
+    {
+        return static_cast<int>(std::min_element(costs.begin(), costs.end()) - costs.begin());
+    }
+
+    void encodeChannel(BitWriter& writer, const int32_t* x, int numFrames, int order)
+    {
+        std::array<uint32_t, LosslessCodec::partitionFrames> values;
+
+        for (int start = 0; start < numFrames; start += LosslessCodec::partitionFrames)
+        {
+            const int count = std::min(LosslessCodec::partitionFrames, numFrames - start);
+            uint64_t sum = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                const int n = start + i;
+                values[static_cast<size_t>(i)] = zigzag(static_cast<int32_t>(int64_t(x[n]) - predict(x, n, orderAt(n, order))));
+                sum += values[static_cast<size_t>(i)];
+            }
+
+            // Rice parameter near log2 of the mean, refined by exact bit counts
+            int estimate = 0;
+            while (estimate < 30 && (uint64_t(count) << (estimate + 1)) <= sum)
+                ++estimate;
+
+            int bestK = estimate;
+            uint64_t bestBits = ~uint64_t(0);
+            for (int k = std::max(0, estimate - 2); k <= std::min(30, estimate + 2); ++k)
+            {
+                uint64_t bits = 0;
+                for (int i = 0; i < count; ++i)
+                {
+                    const uint32_t quotient = values[static_cast<size_t>(i)] >> k;
+                    bits += quotient >= static_cast<uint32_t>(escapeZeros) ? escapeZeros + 32 : quotient + 1 + static_cast<uint32_t>(k);
+                }
+                if (bits < bestBits)
+                {
+                    bestBits = bits;
+                    bestK = k;
+                }
+            }
+
+            writer.write(static_cast<uint32_t>(bestK), riceParameterBits);
+            for (int i = 0; i < count; ++i)
+                writer.writeRice(values[static_cast<size_t>(i)], bestK);
+        }
+    }
+}
+
+namespace LosslessCodec
+{
+    void encodeBlock(const int32_t* const* channels, int numChannels, int numFrames, std::vector<uint8_t>& out)
+    {
+        std::vector<int32_t> side;
+        std::array<const int32_t*, maxChannels> sources {};
+        std::array<int, maxChannels> orders {};
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            sources[static_cast<size_t>(ch)] = channels[ch];
+            orders[static_cast<size_t>(ch)] = bestOrder(residualCosts(channels[ch], numFrames));
+        }
+
+        // Stereo: keep right or side, whichever predicts better
+        bool useSide = false;
+        if (numChannels == 2)
+        {
+            side.resize(static_cast<size_t>(numFrames));
+            for (int i = 0; i < numFrames; ++i)
+                side[static_cast<size_t>(i)] = channels[0][i] - channels[1][i];
+
+            const auto sideCosts = residualCosts(side.data(), numFrames);
+            const auto rightCosts = residualCosts(channels[1], numFrames);
+            if (sideCosts[static_cast<size_t>(bestOrder(sideCosts))] < rightCosts[static_cast<size_t>(orders[1])])
+            {
+                useSide = true;
+                sources[1] = side.data();
+                orders[1] = bestOrder(sideCosts);
+            }
+        }
+
+        const size_t blockStart = out.size();
+        out.push_back(useSide ? leftSide : independent);
+        for (int ch = 0; ch < numChannels; ++ch)
+            out.push_back(static_cast<uint8_t>(orders[static_cast<size_t>(ch)]));
+
+        BitWriter writer(out);
+        for (int ch = 0; ch < numChannels; ++ch)
+            encodeChannel(writer, sources[static_cast<size_t>(ch)], numFrames, orders[static_cast<size_t>(ch)]);
+        writer.flush();
+
+        // Never much bigger than the samples themselves
+        const size_t verbatimBytes = 1 + static_cast<size_t>(numFrames * numChannels * 3);
+        if (out.size() - blockStart > verbatimBytes)
+        {
+            out.resize(blockStart);
+            out.push_back(verbatim);
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numFrames; ++i)
+                    for (int b = 0; b < 3; ++b)
+                        out.push_back(static_cast<uint8_t>(static_cast<uint32_t>(channels[ch][i]) >> (8 * b)));
+        }
+    }
+
+    bool decodeBlock(const uint8_t* data, size_t numBytes, int numChannels, int numFrames, int32_t* const* channels)
+    {
+        if (numChannels <= 0 || numChannels > maxChannels || numFrames <= 0 || numFrames > blockFrames
+            || numBytes < static_cast<size_t>(1 + numChannels))
+            return false;
+
+        if (data[0] == verbatim)
+        {
+            if (numBytes != 1 + static_cast<size_t>(numFrames * numChannels * 3))
+                return false;
+
+            const uint8_t* source = data + 1;
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numFrames; ++i, source += 3)
+                    channels[ch][i] = static_cast<int32_t>(static_cast<uint32_t>(source[0]) << 8
+                                                           | static_cast<uint32_t>(source[1]) << 16
+                                                           | static_cast<uint32_t>(source[2]) << 24) >> 8;
+            return true;
+        }
+
+        const bool useSide = data[0] == leftSide;
+        if (data[0] > leftSide || (useSide && numChannels != 2))
+            return false;
+
+        BitReader reader(data + 1 + numChannels, numBytes - 1 - static_cast<size_t>(numChannels));
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const int order = data[1 + ch];
+            if (order > maxPredictorOrder)
+                return false;
+
+            int32_t* x = channels[ch];
+            for (int start = 0; start < numFrames; start += partitionFrames)
+            {
+                const int end = std::min(numFrames, start + partitionFrames);
+                const int k = static_cast<int>(reader.read(riceParameterBits));
+                if (k > 30)
+                    return false;
+
+                // Warm-up samples at the start of the block, then the plain recurrence
+                int n = start;
+                for (; n < std::min(end, order); ++n)
+                    x[n] = static_cast<int32_t>(unzigzag(readRice(reader, k)) + predict(x, n, n));
+
+                switch (order)
+                {
+                    case 0:  for (; n < end; ++n) x[n] = unzigzag(readRice(reader, k)); break;
+                    case 1:  for (; n < end; ++n) x[n] = static_cast<int32_t>(unzigzag(readRice(reader, k)) + predict(x, n, 1)); break;
+                    case 2:  for (; n < end; ++n) x[n] = static_cast<int32_t>(unzigzag(readRice(reader, k)) + predict(x, n, 2)); break;
+                    case 3:  for (; n < end; ++n) x[n] = static_cast<int32_t>(unzigzag(readRice(reader, k)) + predict(x, n, 3)); break;
+                    default: for (; n < end; ++n) x[n] = static_cast<int32_t>(unzigzag(readRice(reader, k)) + predict(x, n, 4)); break;
+                }
+            }
+        }
+
+        if (!reader.isValid())
+            return false;
+
+        if (useSide)
+            for (int i = 0; i < numFrames; ++i)
+                channels[1][i] = channels[0][i] - channels[1][i];
+
+        return true;
+    }
+
+    void toFloat(const int32_t* source, float* dest, int numSamples, float scale)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = static_cast<float>(source[i]) * scale;
+    }
+}
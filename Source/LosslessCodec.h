@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lossless block codec for integer PCM (16 and 24-bit), used by SampleContainer to store
+ * samples compressed so each streaming voice costs fewer disk bytes.
+ *
+ * - Audio is cut into independent blocks of blockFrames, so any block decodes on its own
+ *   (the container keeps a seek table of block offsets)
+ * - Stereo blocks may store left and side (left - right) instead of left and right
+ * - Each channel picks the best fixed polynomial predictor (order 0-4, as in FLAC) and
+ *   Rice-codes the residual in partitions with their own parameter
+ *
+ * Decoding is a branch-light bit reader plus an integer recurrence per channel; the
+ * conversion to float is a separate flat loop the compiler vectorises.
+ */
+namespace LosslessCodec
+{
+    constexpr int blockFrames = 4096;
+    constexpr int partitionFrames = 256;
+    constexpr int maxPredictorOrder = 4;
+    constexpr int maxChannels = 8;
+
+    /** Append one encoded block of numFrames (<= blockFrames) to out. channels[ch][i] hold the
+        integer samples (at most 24 bits). */
+    void encodeBlock(const int32_t* const* channels, int numChannels, int numFrames, std::vector<uint8_t>& out);
+
+    /** Decode a block into integer samples (channels[ch] must hold numFrames). False if the
+        data is malformed or runs past numBytes. */
+    bool decodeBlock(const uint8_t* data, size_t numBytes, int numChannels, int numFrames, int32_t* const* channels);
+
+    /** Integer samples to float (scale = 1 / 2^(bitsPerSample - 1)) */
+    void toFloat(const int32_t* source, float* dest, int numSamples, float scale);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * NoteEventQueue holds the note events of one audio block, ordered by sample position.
+ *
+ * Fixed capacity, no allocation: events are inserted from the back, so the already
+ * time-ordered MIDI from the host costs O(1) per event, and events that share a
+ * sample position keep their arrival order (a note-off followed by a note-on for the
+ * same key stays in that order).
+ */
+class NoteEventQueue
+{
+public:
+    enum class Type : uint8_t { NoteOn, NoteOff };
+
+    struct Event
+    {
+        int samplePosition = 0;
+        Type type = Type::NoteOn;
+        int midiNote = 0;
+        int velocity = 0;
+        int roundRobin = 0;
+        int sampleOffset = 0;
+    };
+
+    static constexpr int capacity = 2048;
+
+    /** Insert an event in time order. Returns false if the queue is full. */
+    bool push(const Event& event)
+    {
+        if (numEvents == capacity)
+            return false;
+
+        int index = numEvents++;
+        while (index > 0 && events[static_cast<size_t>(index - 1)].samplePosition > event.samplePosition)
+        {
+            events[static_cast<size_t>(index)] = events[static_cast<size_t>(index - 1)];
+            --index;
+        }
+
+        events[static_cast<size_t>(index)] = event;
+        return true;
+    }
+
+    void clear() { numEvents = 0; }
+    bool isEmpty() const { return numEvents == 0; }
+    int size() const { return numEvents; }
+
+    const Event* begin() const { return events.data(); }
+    const Event* end() const { return events.data() + numEvents; }
+
+private:
+    std::array<Event, capacity> events {};
+    int numEvents = 0;
+};
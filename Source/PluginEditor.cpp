@@ -14,9 +14,11 @@ NoteGridDisplay::NoteGridDisplay(MidiKeyboardProcessor& p)
 void NoteGridDisplay::timerCallback()
 {
     uint64_t current = processor.getNoteChangeCounter();
-    if (current != lastSeenCounter)
+    const bool loading = processor.areSamplesLoading();
+    if (current != lastSeenCounter || loading || wasLoading)
     {
         lastSeenCounter = current;
+        wasLoading = loading;
         repaint();
     }
 }
@@ -54,6 +56,7 @@ void NoteGridDisplay::paint(juce::Graphics& g)
         // Get current state for this note
         bool noteAvailable = processor.isNoteAvailable(midiNote);
         bool noteIsOn = processor.isNoteOn(midiNote);
+        const float loadProgress = processor.getNoteLoadProgress(midiNote);
 
         // Draw velocity layer rows (top = highest velocity, bottom = lowest)
         // Only draw the active layers (up to velLayerLimit)
@@ -91,6 +94,8 @@ void NoteGridDisplay::paint(juce::Graphics& g)
 
                 if (!noteAvailable || !layerExists)
                     g.setColour(juce::Colour(0xff252525));  // Very dark gray for unavailable
+                else if (loadProgress < 1.0f)
+                    g.setColour(juce::Colour(0xff2e2e2e));  // Between the two - preloads still loading
                 else if (rrActive)
                     g.setColour(juce::Colour(0xff4a9eff));  // Blue - this (layer, RR) was triggered
                 else
@@ -145,9 +150,11 @@ KeyboardDisplay::KeyboardDisplay(MidiKeyboardProcessor& p)
 void KeyboardDisplay::timerCallback()
 {
     uint64_t current = processor.getNoteChangeCounter();
-    if (current != lastSeenCounter)
+    const bool loading = processor.areSamplesLoading();
+    if (current != lastSeenCounter || loading || wasLoading)
     {
         lastSeenCounter = current;
+        wasLoading = loading;
         repaint();
     }
 }
@@ -225,6 +232,18 @@ void KeyboardDisplay::paint(juce::Graphics& g)
             g.setColour(juce::Colours::black);
             g.drawRect(keyRect, 1.0f);
 
+            // Progressive loading: strip along the bottom fills as the note's preloads land
+            const float loadProgress = processor.getNoteLoadProgress(midiNote);
+            if (isAvailable && loadProgress < 1.0f)
+            {
+                auto strip = keyRect.reduced(2.0f, 0.0f).withTrimmedBottom(2.0f);
+                strip = strip.removeFromBottom(4.0f);
+                g.setColour(juce::Colour(0xff888888));
+                g.fillRect(strip);
+                g.setColour(juce::Colour(0xff4a9eff));
+                g.fillRect(strip.withWidth(strip.getWidth() * loadProgress));
+            }
+
             ++whiteKeyIdx;
         }
     }
@@ -254,6 +273,17 @@ void KeyboardDisplay::paint(juce::Graphics& g)
 
             g.fillRect(keyRect);
 
+            const float loadProgress = processor.getNoteLoadProgress(midiNote);
+            if (isAvailable && loadProgress < 1.0f)
+            {
+                auto strip = keyRect.reduced(2.0f, 0.0f).withTrimmedBottom(2.0f);
+                strip = strip.removeFromBottom(4.0f);
+                g.setColour(juce::Colour(0xff555555));
+                g.fillRect(strip);
+                g.setColour(juce::Colour(0xff4a9eff));
+                g.fillRect(strip.withWidth(strip.getWidth() * loadProgress));
+            }
+
             if (isPressed)
             {
                 g.setColour(juce::Colours::white);
@@ -420,6 +450,25 @@ MidiKeyboardEditor::MidiKeyboardEditor(MidiKeyboardProcessor& p)
     sameNoteReleaseLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
     addAndMakeVisible(sameNoteReleaseLabel);
 
+    // Interpolation quality selectors (item IDs are InterpolationQuality + 1)
+    for (auto* box : { &qualityBox, &bounceQualityBox })
+    {
+        box->addItem("Linear", 1);
+        box->addItem("Cubic", 2);
+        box->addItem("Sinc", 3);
+        box->onChange = [this] { updateInterpolationQuality(); };
+        addAndMakeVisible(*box);
+    }
+    qualityBox.setSelectedId(static_cast<int>(processorRef.getInterpolationQuality()) + 1, juce::dontSendNotification);
+    bounceQualityBox.setSelectedId(static_cast<int>(processorRef.getBounceInterpolationQuality()) + 1, juce::dontSendNotification);
+
+    for (auto* label : { &qualityLabel, &bounceQualityLabel })
+    {
+        label->setJustificationType(juce::Justification::centred);
+        label->setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+        addAndMakeVisible(*label);
+    }
+
     // Start timer for async loading status updates
     startTimerHz(2);  // Low rate for status updates
 
@@ -478,7 +527,14 @@ void MidiKeyboardEditor::timerCallback()
                 rrLimitSlider.setValue(processorRef.getRoundRobinLimit(), juce::dontSendNotification);
             }
         }
-        else if (!processorRef.areSamplesLoading())
+        else if (processorRef.areSamplesLoading())
+        {
+            // Progressive loading: notes become playable while this climbs
+            const int percent = juce::roundToInt(processorRef.getLoadProgress() * 100.0f);
+            statusLabel.setText("Loading: " + pendingLoadFolder + "... " + juce::String(percent) + "%",
+                                juce::dontSendNotification);
+        }
+        else
         {
             statusLabel.setText("No valid samples found", juce::dontSendNotification);
             fileSizeLabel.setText("", juce::dontSendNotification);
@@ -604,6 +660,12 @@ void MidiKeyboardEditor::updateSameNoteRelease()
     processorRef.setSameNoteReleaseTime(static_cast<float>(sameNoteReleaseSlider.getValue()));
 }
 
+void MidiKeyboardEditor::updateInterpolationQuality()
+{
+    processorRef.setInterpolationQuality(static_cast<InterpolationQuality>(qualityBox.getSelectedId() - 1));
+    processorRef.setBounceInterpolationQuality(static_cast<InterpolationQuality>(bounceQualityBox.getSelectedId() - 1));
+}
+
 void MidiKeyboardEditor::preloadSliderChanged()
 {
     // Debounce: store pending value, will apply after 1 second of no changes
@@ -731,6 +793,20 @@ void MidiKeyboardEditor::resized()
     sameNoteReleaseLabel.setBounds(sameNoteReleaseArea.removeFromTop(labelHeight));
     sameNoteReleaseSlider.setBounds(sameNoteReleaseArea);
 
+    // Add some spacing before interpolation quality selectors
+    adsrArea.removeFromLeft(20);
+
+    // Interpolation quality selectors (live, then offline bounce)
+    auto qualityArea = adsrArea.removeFromLeft(80);
+    qualityLabel.setBounds(qualityArea.removeFromTop(labelHeight));
+    qualityBox.setBounds(qualityArea.removeFromTop(24));
+
+    adsrArea.removeFromLeft(10);
+
+    auto bounceQualityArea = adsrArea.removeFromLeft(80);
+    bounceQualityLabel.setBounds(bounceQualityArea.removeFromTop(labelHeight));
+    bounceQualityBox.setBounds(bounceQualityArea.removeFromTop(24));
+
     bounds.removeFromTop(gap);
 
     // Bottom keyboard
@@ -12,6 +12,7 @@ public:
 private:
     MidiKeyboardProcessor& processor;
     uint64_t lastSeenCounter = 0;
+    bool wasLoading = false;  // Repaint while preloads land, and once after
 
     static constexpr int startNote = 21;  // A0
     static constexpr int endNote = 109;   // C8+1 (exclusive, so 88 notes)
@@ -28,6 +29,7 @@ public:
 private:
     MidiKeyboardProcessor& processor;
     uint64_t lastSeenCounter = 0;
+    bool wasLoading = false;  // Repaint while preloads land, and once after
 
     void drawOctave(juce::Graphics& g, juce::Rectangle<float> bounds, int startNote);
 
@@ -101,6 +103,11 @@ private:
     juce::Label sameNoteReleaseLabel{"", "SN Rel"};
     void updateSameNoteRelease();
 
+    // Interpolation quality selectors (live playback and offline bounce)
+    juce::ComboBox qualityBox, bounceQualityBox;
+    juce::Label qualityLabel{"", "Quality"}, bounceQualityLabel{"", "Bounce"};
+    void updateInterpolationQuality();
+
     // Async loading state
     juce::String pendingLoadFolder;
 
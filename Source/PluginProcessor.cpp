@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "DebugLog.h"
 
 MidiKeyboardProcessor::MidiKeyboardProcessor()
     : AudioProcessor(BusesProperties()
@@ -30,23 +31,165 @@ void MidiKeyboardProcessor::prepareToPlay(double sampleRate, int samplesPerBlock
     currentRoundRobin = 1;
     sustainPedalDown = false;
 
-    samplerEngine.prepareToPlay(sampleRate, samplesPerBlock);
+    preparedSampleRate = sampleRate;
+    preparedBlockSize = samplesPerBlock;
+    samplerEngine.prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
+
+    if (remoteEngine.isConnected() && remoteEngine.prepare(sampleRate, samplesPerBlock))
+        setLatencySamples(remoteEngine.getLatencySamples());
 }
 
 void MidiKeyboardProcessor::loadSamplesFromFolder(const juce::File& folder)
 {
+    // The local engine still scans the folder: the UI reads note/layer layout from it
     samplerEngine.loadSamplesFromFolder(folder);
+    remoteEngine.loadSamplesFromFolder(folder.getFullPathName());
 }
 
 void MidiKeyboardProcessor::setADSR(float attack, float decay, float sustain, float release)
 {
     samplerEngine.setADSR(attack, decay, sustain, release);
+    remoteEngine.setADSR(attack, decay, sustain, release);
+}
+
+void MidiKeyboardProcessor::reloadPreloadBuffers()
+{
+    samplerEngine.reloadPreloadBuffers();
+    remoteEngine.setPreloadSizeKB(samplerEngine.getPreloadSizeKB());
+}
+
+void MidiKeyboardProcessor::setVelocityLayerLimit(int limit)
+{
+    samplerEngine.setVelocityLayerLimit(limit);
+    remoteEngine.setVelocityLayerLimit(limit);
+}
+
+void MidiKeyboardProcessor::setRoundRobinLimit(int limit)
+{
+    samplerEngine.setRoundRobinLimit(limit);
+    remoteEngine.setRoundRobinLimit(limit);
+}
+
+void MidiKeyboardProcessor::setColdStart(bool enabled)
+{
+    samplerEngine.setColdStart(enabled);
+    remoteEngine.setColdStart(enabled);
+}
+
+void MidiKeyboardProcessor::setHibernateAfterSeconds(int seconds)
+{
+    samplerEngine.setHibernateAfterSeconds(seconds);
+    remoteEngine.setHibernateAfterSeconds(seconds);
+}
+
+int64_t MidiKeyboardProcessor::getPreloadMemoryBytes() const
+{
+    return remoteEngine.isConnected() ? remoteEngine.getPreloadMemoryBytes() : samplerEngine.getPreloadMemoryBytes();
+}
+
+int MidiKeyboardProcessor::getActiveVoiceCount() const
+{
+    return remoteEngine.isConnected() ? remoteEngine.getActiveVoiceCount() : samplerEngine.getActiveVoiceCount();
+}
+
+int MidiKeyboardProcessor::getStreamingVoiceCount() const
+{
+    return remoteEngine.isConnected() ? remoteEngine.getStreamingVoiceCount() : samplerEngine.getStreamingVoiceCount();
+}
+
+float MidiKeyboardProcessor::getDiskThroughputMBps() const
+{
+    return remoteEngine.isConnected() ? remoteEngine.getDiskThroughputMBps() : samplerEngine.getDiskThroughputMBps();
+}
+
+int MidiKeyboardProcessor::getUnderrunCount() const
+{
+    return remoteEngine.isConnected() ? remoteEngine.getUnderrunCount() : samplerEngine.getUnderrunCount();
+}
+
+void MidiKeyboardProcessor::setRemoteEngine(bool enabled)
+{
+    remoteEngineEnabled = enabled;
+
+    if (enabled && !remoteEngine.isConnected() && remoteEngine.connect())
+        syncRemoteEngine();
+    else if (!enabled)
+        remoteEngine.disconnect();
+
+    // Without preloads the local engine can't play, so only drop them once the server can
+    samplerEngine.setMetadataOnly(remoteEngine.isConnected());
+    setLatencySamples(remoteEngine.isConnected() ? remoteEngine.getLatencySamples() : 0);
+
+    if (remoteEngine.isConnected())
+        startTimer(serverCheckIntervalMs);
+    else
+        stopTimer();
+}
+
+void MidiKeyboardProcessor::timerCallback()
+{
+    if (!remoteEngine.hasLostServer())
+        return;
+
+    // The audio thread already renders locally, from disk: bring back the preloads in the background
+    DebugLog::write("MidiKeyboardProcessor: engine server lost, falling back to the local engine");
+    stopTimer();
+    remoteEngine.disconnect();
+    samplerEngine.setMetadataOnly(false);
+    setLatencySamples(0);
+}
+
+void MidiKeyboardProcessor::syncRemoteEngine()
+{
+    if (preparedBlockSize > 0)
+        remoteEngine.prepare(preparedSampleRate, preparedBlockSize);
+
+    const auto adsr = samplerEngine.getADSR();
+    remoteEngine.setADSR(adsr.attack, adsr.decay, adsr.sustain, adsr.release);
+    remoteEngine.setPreloadSizeKB(samplerEngine.getPreloadSizeKB());
+    remoteEngine.setColdStart(samplerEngine.getColdStart());
+    remoteEngine.setHibernateAfterSeconds(samplerEngine.getHibernateAfterSeconds());
+
+    if (getLoadedFolderPath().isNotEmpty())
+        remoteEngine.loadSamplesFromFolder(getLoadedFolderPath());
+
+    // After the load: the server applies them to the library it is loading
+    if (samplerEngine.isLoaded())
+    {
+        remoteEngine.setVelocityLayerLimit(samplerEngine.getVelocityLayerLimit());
+        remoteEngine.setRoundRobinLimit(samplerEngine.getRoundRobinLimit());
+    }
+}
+
+void MidiKeyboardProcessor::queueNoteOn(int samplePosition, int midiNote, int velocity, int roundRobin, int sampleOffset)
+{
+    if (renderingRemotely)
+        remoteEngine.queueNoteOn(samplePosition, midiNote, velocity, roundRobin, sampleOffset);
+    else
+        samplerEngine.queueNoteOn(samplePosition, midiNote, velocity, roundRobin, sampleOffset);
+}
+
+void MidiKeyboardProcessor::queueNoteOff(int samplePosition, int midiNote)
+{
+    if (renderingRemotely)
+        remoteEngine.queueNoteOff(samplePosition, midiNote);
+    else
+        samplerEngine.queueNoteOff(samplePosition, midiNote);
 }
 
 void MidiKeyboardProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     buffer.clear();
 
+    // Cheap interpolation while playing live, band-limited sinc when the host bounces offline
+    const auto quality = isNonRealtime() ? bounceInterpolationQuality : liveInterpolationQuality;
+    samplerEngine.setInterpolationQuality(quality);
+    renderingRemotely = remoteEngine.isConnected();
+
+    // Any MIDI wakes a hibernating engine, before the notes reach it
+    if (!midiMessages.isEmpty())
+        samplerEngine.wakeUp();
+
     for (const auto metadata : midiMessages)
     {
         auto message = metadata.getMessage();
@@ -73,7 +216,7 @@ void MidiKeyboardProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
                         noteRRActivated[i].fill(false);
                         for (auto& layerArr : noteLayerRRActivated[i])
                             layerArr.fill(false);
-                        samplerEngine.noteOff(static_cast<int>(i));
+                        queueNoteOff(metadata.samplePosition, static_cast<int>(i));
 
                         // Signal UI to update
                         ++noteChangeCounter;
@@ -121,13 +264,13 @@ void MidiKeyboardProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
             }
 
             // Trigger sample playback
-            samplerEngine.noteOn(midiNote, velocity, currentRoundRobin, sampleOffsetAmount);
+            queueNoteOn(metadata.samplePosition, midiNote, velocity, currentRoundRobin, sampleOffsetAmount);
 
             // Signal UI to update
             ++noteChangeCounter;
 
-            // Advance round-robin: 1 -> 2 -> ... -> N -> 1 (limited by roundRobinLimit)
-            int rrLimit = samplerEngine.getRoundRobinLimit();
+            // Advance round-robin: 1 -> 2 -> ... -> N -> 1 (limited by roundRobinLimit unless cold starting)
+            int rrLimit = samplerEngine.getPlayableRoundRobins();
             currentRoundRobin = (currentRoundRobin % rrLimit) + 1;
         }
         else if (message.isNoteOff())
@@ -147,7 +290,7 @@ void MidiKeyboardProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
                 noteRRActivated[noteIndex].fill(false);
                 for (auto& layerArr : noteLayerRRActivated[noteIndex])
                     layerArr.fill(false);
-                samplerEngine.noteOff(midiNote);
+                queueNoteOff(metadata.samplePosition, midiNote);
 
                 // Signal UI to update
                 ++noteChangeCounter;
@@ -155,10 +298,36 @@ void MidiKeyboardProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
         }
     }
 
-    // Generate audio from sampler
+    // Generate audio from sampler (queued note events start at their sample position)
+    if (renderingRemotely && remoteEngine.renderBlock(buffer, static_cast<int>(quality)))
+        return;
+
+    if (renderingRemotely)
+    {
+        // The server is gone without playing this block's notes: the local engine plays them,
+        // from disk until the message thread has brought its preloads back
+        buffer.clear();
+        samplerEngine.playWithoutPreloads();
+        for (const auto& event : remoteEngine.getUnrenderedEvents())
+        {
+            if (event.type == NoteEventQueue::Type::NoteOn)
+                samplerEngine.queueNoteOn(event.samplePosition, event.midiNote, event.velocity, event.roundRobin, event.sampleOffset);
+            else
+                samplerEngine.queueNoteOff(event.samplePosition, event.midiNote);
+        }
+        remoteEngine.clearUnrenderedEvents();
+    }
+
     samplerEngine.processBlock(buffer);
 }
 
+void MidiKeyboardProcessor::processBlockBypassed(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    // A bypassed sampler is silent; the engine may hibernate meanwhile
+    buffer.clear();
+    samplerEngine.processBypassed();
+}
+
 juce::AudioProcessorEditor* MidiKeyboardProcessor::createEditor()
 {
     return new MidiKeyboardEditor(*this);
@@ -194,6 +363,45 @@ void MidiKeyboardProcessor::getStateInformation(juce::MemoryBlock& destData)
     // Save round robin limit
     xml.setAttribute("roundRobinLimit", samplerEngine.getRoundRobinLimit());
 
+    // Save interpolation quality (live and offline bounce)
+    xml.setAttribute("interpolationQuality", static_cast<int>(liveInterpolationQuality));
+    xml.setAttribute("bounceInterpolationQuality", static_cast<int>(bounceInterpolationQuality));
+
+    // Save voice-parallel rendering width
+    xml.setAttribute("voiceBatchLanes", getVoiceBatchLanes());
+
+    // Save render worker thread count
+    xml.setAttribute("renderThreads", getRenderThreads());
+
+    // Save preload RAM budget
+    xml.setAttribute("preloadBudgetMB", getPreloadBudgetMB());
+
+    // Save adaptive preload lengths
+    xml.setAttribute("adaptivePreloads", getAdaptivePreloads() ? 1 : 0);
+
+    // Save cold start
+    xml.setAttribute("coldStart", getColdStart() ? 1 : 0);
+
+    // Save learn & purge (the learned set is only useful with the folder it was learned on)
+    xml.setAttribute("purgeUnusedSamples", getPurgeUnusedSamples() ? 1 : 0);
+    xml.setAttribute("learnedSamples", samplerEngine.getLearnedSamples());
+
+    // Save hibernation
+    xml.setAttribute("hibernateAfterSeconds", getHibernateAfterSeconds());
+
+    // Save cross-process preload sharing
+    xml.setAttribute("sharedMemoryPreloads", getSharedMemoryPreloads() ? 1 : 0);
+
+    // Save host-rate rendering
+    xml.setAttribute("renderAtHostRate", getRenderAtHostRate() ? 1 : 0);
+
+    // Save audibility culling
+    xml.setAttribute("voiceCullThresholdDb", getVoiceCullThresholdDb());
+    xml.setAttribute("voiceCullHoldMs", getVoiceCullHoldMs());
+
+    // Save engine server mode
+    xml.setAttribute("remoteEngine", getRemoteEngine() ? 1 : 0);
+
     copyXmlToBinary(xml, destData);
 }
 
@@ -231,6 +439,49 @@ void MidiKeyboardProcessor::setStateInformation(const void* data, int sizeInByte
         int rrLimit = xml->getIntAttribute("roundRobinLimit", 99);
         samplerEngine.setRoundRobinLimit(rrLimit);
 
+        // Restore interpolation quality (live and offline bounce)
+        int liveQuality = juce::jlimit(0, 2, xml->getIntAttribute("interpolationQuality", 0));
+        int bounceQuality = juce::jlimit(0, 2, xml->getIntAttribute("bounceInterpolationQuality", 2));
+        setInterpolationQuality(static_cast<InterpolationQuality>(liveQuality));
+        setBounceInterpolationQuality(static_cast<InterpolationQuality>(bounceQuality));
+
+        // Restore voice-parallel rendering width
+        setVoiceBatchLanes(xml->getIntAttribute("voiceBatchLanes", 0));
+
+        // Restore render worker thread count
+        setRenderThreads(xml->getIntAttribute("renderThreads", 0));
+
+        // Restore preload RAM budget (process-wide; an instance saved without one leaves it alone)
+        if (xml->hasAttribute("preloadBudgetMB"))
+            setPreloadBudgetMB(xml->getIntAttribute("preloadBudgetMB", 0));
+
+        // Restore adaptive preload lengths
+        setAdaptivePreloads(xml->getBoolAttribute("adaptivePreloads", true));
+
+        // Restore cold start
+        setColdStart(xml->getBoolAttribute("coldStart", false));
+
+        // Restore learn & purge (before loading, so only the learned samples are preloaded)
+        samplerEngine.setLearnedSamples(juce::File(xml->getStringAttribute("sampleFolder", "")).getFullPathName(),
+                                        xml->getStringAttribute("learnedSamples", ""));
+        setPurgeUnusedSamples(xml->getBoolAttribute("purgeUnusedSamples", false));
+
+        // Restore hibernation
+        setHibernateAfterSeconds(xml->getIntAttribute("hibernateAfterSeconds", 0));
+
+        // Restore cross-process preload sharing (before loading, so the preloads use it)
+        setSharedMemoryPreloads(xml->getBoolAttribute("sharedMemoryPreloads", false));
+
+        // Restore host-rate rendering (before loading, so the library is rendered once)
+        setRenderAtHostRate(xml->getBoolAttribute("renderAtHostRate", false));
+
+        // Restore audibility culling
+        setVoiceCullThresholdDb(static_cast<float>(xml->getDoubleAttribute("voiceCullThresholdDb", -90.0)));
+        setVoiceCullHoldMs(xml->getIntAttribute("voiceCullHoldMs", 100));
+
+        // Restore engine server mode (before loading, so the server loads the folder too)
+        setRemoteEngine(xml->getBoolAttribute("remoteEngine", false));
+
         // Restore sample folder
         juce::String folderPath = xml->getStringAttribute("sampleFolder", "");
         if (folderPath.isNotEmpty())
@@ -5,8 +5,10 @@
 #include <atomic>
 #include <vector>
 #include "SamplerEngine.h"
+#include "RemoteEngineClient.h"
 
-class MidiKeyboardProcessor : public juce::AudioProcessor
+class MidiKeyboardProcessor : public juce::AudioProcessor,
+                              private juce::Timer
 {
 public:
     MidiKeyboardProcessor();
@@ -15,23 +17,26 @@ public:
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override {}
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     // Sample loading
     void loadSamplesFromFolder(const juce::File& folder);
     bool areSamplesLoaded() const { return samplerEngine.isLoaded(); }
     bool areSamplesLoading() const { return samplerEngine.isLoading(); }
+    float getLoadProgress() const { return samplerEngine.getLoadProgress(); }
+    float getNoteLoadProgress(int midiNote) const { return samplerEngine.getNoteLoadProgress(midiNote); }
     juce::String getLoadedFolderPath() const { return samplerEngine.getLoadedFolderPath(); }
     int64_t getTotalInstrumentFileSize() const { return samplerEngine.getTotalInstrumentFileSize(); }
-    int64_t getPreloadMemoryBytes() const { return samplerEngine.getPreloadMemoryBytes(); }
+    int64_t getPreloadMemoryBytes() const;
 
     // Streaming controls
     int getPreloadSizeKB() const { return samplerEngine.getPreloadSizeKB(); }
     void setPreloadSizeKB(int sizeKB) { samplerEngine.setPreloadSizeKB(sizeKB); }
-    void reloadPreloadBuffers() { samplerEngine.reloadPreloadBuffers(); }
-    int getActiveVoiceCount() const { return samplerEngine.getActiveVoiceCount(); }
-    int getStreamingVoiceCount() const { return samplerEngine.getStreamingVoiceCount(); }
-    float getDiskThroughputMBps() const { return samplerEngine.getDiskThroughputMBps(); }
-    int getUnderrunCount() const { return samplerEngine.getUnderrunCount(); }
+    void reloadPreloadBuffers();
+    int getActiveVoiceCount() const;
+    int getStreamingVoiceCount() const;
+    float getDiskThroughputMBps() const;
+    int getUnderrunCount() const;
     void resetUnderrunCount() { samplerEngine.resetUnderrunCount(); }
 
     // ADSR controls
@@ -56,15 +61,72 @@ public:
     int getVelocityLayerIndex(int midiNote, int velocity) const { return samplerEngine.getVelocityLayerIndex(midiNote, velocity); }
     int getMaxRoundRobins() const { return samplerEngine.getMaxRoundRobins(); }
     int getMaxVelocityLayersGlobal() const { return samplerEngine.getMaxVelocityLayersGlobal(); }
-    void setVelocityLayerLimit(int limit) { samplerEngine.setVelocityLayerLimit(limit); }
+    void setVelocityLayerLimit(int limit);
     int getVelocityLayerLimit() const { return samplerEngine.getVelocityLayerLimit(); }
-    void setRoundRobinLimit(int limit) { samplerEngine.setRoundRobinLimit(limit); }
+    void setRoundRobinLimit(int limit);
     int getRoundRobinLimit() const { return samplerEngine.getRoundRobinLimit(); }
 
     // Same-note retrigger release time (for experimentation)
     void setSameNoteReleaseTime(float seconds) { samplerEngine.setSameNoteReleaseTime(seconds); }
     float getSameNoteReleaseTime() const { return samplerEngine.getSameNoteReleaseTime(); }
 
+    // Voice-parallel rendering (0 = off, 4/8/16 voices per SIMD batch)
+    void setVoiceBatchLanes(int lanes) { samplerEngine.setVoiceBatchLanes(lanes); }
+    int getVoiceBatchLanes() const { return samplerEngine.getVoiceBatchLanes(); }
+
+    // Multi-core voice rendering (0 = audio thread only)
+    void setRenderThreads(int numThreads) { samplerEngine.setRenderThreads(numThreads); }
+    int getRenderThreads() const { return samplerEngine.getRenderThreads(); }
+
+    // Preload RAM budget shared by all instances in the process, in MB (0 = off: the preload knob applies)
+    void setPreloadBudgetMB(int megabytes) { samplerEngine.setPreloadBudgetBytes(static_cast<int64_t>(juce::jmax(0, megabytes)) * 1024 * 1024); }
+    int getPreloadBudgetMB() const { return static_cast<int>(samplerEngine.getPreloadBudgetBytes() / (1024 * 1024)); }
+
+    // Per-sample preload lengths from play counts, playback rate and device latency (on by default)
+    void setAdaptivePreloads(bool enabled) { samplerEngine.setAdaptivePreloads(enabled); }
+    bool getAdaptivePreloads() const { return samplerEngine.getAdaptivePreloads(); }
+
+    // Cold start for samples outside the preload set: the limits only set what's in RAM (off by default)
+    void setColdStart(bool enabled);
+    bool getColdStart() const { return samplerEngine.getColdStart(); }
+
+    // Learn & purge: keep only the samples this project has played resident (off by default)
+    void setPurgeUnusedSamples(bool enabled) { samplerEngine.setPurgeUnusedSamples(enabled); }
+    bool getPurgeUnusedSamples() const { return samplerEngine.getPurgeUnusedSamples(); }
+    void clearLearnedSamples() { samplerEngine.clearLearnedSamples(); }
+    int getLearnedSampleCount() const { return samplerEngine.getLearnedSampleCount(); }
+
+    // Hibernate after this many idle seconds or while bypassed: preloads parked on disk, no I/O (0 = never)
+    void setHibernateAfterSeconds(int seconds);
+    int getHibernateAfterSeconds() const { return samplerEngine.getHibernateAfterSeconds(); }
+    bool isHibernating() const { return samplerEngine.isHibernating(); }
+
+    // Cross-process preload sharing through shared memory (off by default)
+    void setSharedMemoryPreloads(bool enabled) { samplerEngine.setSharedMemoryPreloads(enabled); }
+    bool getSharedMemoryPreloads() const { return samplerEngine.getSharedMemoryPreloads(); }
+
+    // Play samples at another rate from copies rendered at the host rate (off by default)
+    void setRenderAtHostRate(bool enabled) { samplerEngine.setRenderAtHostRate(enabled); }
+    bool getRenderAtHostRate() const { return samplerEngine.getRenderAtHostRate(); }
+
+    // Retire voices that stay below a level for a hold time (SamplerEngine::voiceCullOffDb = off)
+    void setVoiceCullThresholdDb(float db) { samplerEngine.setVoiceCullThresholdDb(db); }
+    float getVoiceCullThresholdDb() const { return samplerEngine.getVoiceCullThresholdDb(); }
+    void setVoiceCullHoldMs(int ms) { samplerEngine.setVoiceCullHoldMs(ms); }
+    int getVoiceCullHoldMs() const { return samplerEngine.getVoiceCullHoldMs(); }
+
+    // Play through the engine server (HammerSamplerServer) instead of the local engine.
+    // Falls back to the local engine if no server is running; adds one block of latency.
+    void setRemoteEngine(bool enabled);
+    bool getRemoteEngine() const { return remoteEngineEnabled; }
+    bool isRemoteEngineConnected() const { return remoteEngine.isConnected(); }
+
+    // Interpolation quality: live playback vs offline bounce (host in non-realtime mode)
+    void setInterpolationQuality(InterpolationQuality quality) { liveInterpolationQuality = quality; }
+    InterpolationQuality getInterpolationQuality() const { return liveInterpolationQuality; }
+    void setBounceInterpolationQuality(InterpolationQuality quality) { bounceInterpolationQuality = quality; }
+    InterpolationQuality getBounceInterpolationQuality() const { return bounceInterpolationQuality; }
+
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
 
@@ -141,9 +203,27 @@ private:
     bool sustainPedalDown = false;
     int transposeAmount = 0;      // -12 to +12 semitones
     int sampleOffsetAmount = 0;   // -12 to +12 semitones (borrow samples, pitch-correct back)
+    InterpolationQuality liveInterpolationQuality = InterpolationQuality::Linear;
+    InterpolationQuality bounceInterpolationQuality = InterpolationQuality::Sinc;
 
     SamplerEngine samplerEngine;
 
+    // Engine server connection; the local engine then only keeps library metadata for the UI
+    RemoteEngineClient remoteEngine;
+    bool remoteEngineEnabled = false;
+    bool renderingRemotely = false;  // Audio thread, fixed for the current block
+    double preparedSampleRate = 0.0;
+    int preparedBlockSize = 0;
+    void syncRemoteEngine();
+
+    // Watches for a server lost mid-session while rendering remotely (message thread)
+    void timerCallback() override;
+    static constexpr int serverCheckIntervalMs = 250;
+
+    // Route the block's note events to the local or remote engine
+    void queueNoteOn(int samplePosition, int midiNote, int velocity, int roundRobin, int sampleOffset);
+    void queueNoteOff(int samplePosition, int midiNote);
+
     std::atomic<uint64_t> noteChangeCounter{0};
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiKeyboardProcessor)
@@ -0,0 +1,250 @@
+#include "PreloadBudget.h"
+#include "DebugLog.h"
+#include <algorithm>
+#include <cmath>
+
+PreloadBudget::MonitorThread::MonitorThread(PreloadBudget& owner)
+    : juce::Thread("Preload Budget"),
+      budget(owner)
+{
+}
+
+void PreloadBudget::MonitorThread::run()
+{
+    while (!threadShouldExit())
+    {
+        budget.checkMemoryPressure();
+        budget.serviceClients();
+        wait(pressurePollMs);
+    }
+}
+
+PreloadBudget::PreloadBudget()
+    : monitorThread(*this)
+{
+    monitorThread.startThread(juce::Thread::Priority::low);
+}
+
+PreloadBudget::~PreloadBudget()
+{
+    monitorThread.stopThread(2000);
+}
+
+PreloadBudget::ClientId PreloadBudget::registerClient(std::function<void(bool limitChanged)> callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    const ClientId id = nextClientId++;
+    clients[id].callback = std::move(callback);
+    return id;
+}
+
+void PreloadBudget::unregisterClient(ClientId client)
+{
+    std::lock_guard<std::mutex> callbackLock(callbackMutex);
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (clients.erase(client) > 0)
+        recompute();
+}
+
+void PreloadBudget::setDemand(ClientId client, std::vector<Demand> demand)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = clients.find(client);
+    if (it == clients.end() || it->second.demand == demand)
+        return;
+
+    it->second.demand = std::move(demand);
+    recompute();
+}
+
+void PreloadBudget::setBudgetBytes(int64_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    bytes = std::max<int64_t>(0, bytes);
+    if (bytes == budgetBytes.load(std::memory_order_relaxed))
+        return;
+
+    budgetBytes.store(bytes, std::memory_order_relaxed);
+    pressureScale = 1.0f;
+    recompute();
+
+    DebugLog::write("PreloadBudget: budget " + juce::String(static_cast<int>(bytes / (1024 * 1024))) + " MB");
+}
+
+int64_t PreloadBudget::getEffectiveBudgetBytes() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int64_t>(static_cast<double>(getBudgetBytes()) * pressureScale);
+}
+
+void PreloadBudget::recompute()
+{
+    int64_t limit = 0;
+    bool resident = false;
+
+    if (isEnabled())
+    {
+        // Instances of the same library want the same preloads: count each once
+        std::map<uint64_t, Demand> uniqueDemand;
+        for (const auto& [id, client] : clients)
+        {
+            for (const auto& demand : client.demand)
+            {
+                auto [it, inserted] = uniqueDemand.try_emplace(demand.key, demand);
+                if (!inserted)
+                {
+                    it->second.fullBytes = std::max(it->second.fullBytes, demand.fullBytes);
+                    it->second.weight = std::max(it->second.weight, demand.weight);
+                }
+            }
+        }
+
+        std::vector<Demand> demand;
+        demand.reserve(uniqueDemand.size());
+        double largestPerWeight = 0.0;
+        for (const auto& [key, merged] : uniqueDemand)
+        {
+            demand.push_back(merged);
+            largestPerWeight = std::max(largestPerWeight, static_cast<double>(merged.fullBytes) / merged.weight);
+        }
+
+        const auto effectiveBudget = static_cast<int64_t>(static_cast<double>(getBudgetBytes()) * pressureScale);
+        limit = computePreloadLimit(std::move(demand), effectiveBudget);
+        resident = static_cast<double>(limit) >= largestPerWeight;
+
+        if (!resident)
+            limit = quantiseLimit(limit);
+    }
+
+    fullyResident.store(resident, std::memory_order_relaxed);
+
+    if (limit != preloadLimitBytes.load(std::memory_order_relaxed))
+    {
+        preloadLimitBytes.store(limit, std::memory_order_relaxed);
+        limitChangedPending.store(true);
+        monitorThread.notify();
+
+        DebugLog::write("PreloadBudget: preload limit " + juce::String(static_cast<int>(limit / 1024)) + " KB"
+                        + (resident ? " (fully resident)" : ""));
+    }
+}
+
+int64_t PreloadBudget::computePreloadLimit(const std::vector<int64_t>& sizes, int64_t budget)
+{
+    std::vector<Demand> demand(sizes.size());
+    for (size_t i = 0; i < sizes.size(); ++i)
+        demand[i].fullBytes = sizes[i];
+
+    return computePreloadLimit(std::move(demand), budget);
+}
+
+int64_t PreloadBudget::computePreloadLimit(std::vector<Demand> demand, int64_t budget)
+{
+    if (demand.empty())
+        return std::max(budget, minimumPreloadBytes);
+
+    // Water-fill: samples that fit whole at the lowest limit first; once a sample is bigger
+    // than its weighted share of what is left, it and everything after it get that share
+    for (auto& sample : demand)
+        sample.weight = std::max(sample.weight, 1.0e-3f);
+
+    std::sort(demand.begin(), demand.end(), [](const Demand& a, const Demand& b)
+    {
+        return static_cast<double>(a.fullBytes) / a.weight < static_cast<double>(b.fullBytes) / b.weight;
+    });
+
+    double remainingWeight = 0.0;
+    for (const auto& sample : demand)
+        remainingWeight += sample.weight;
+
+    double remaining = static_cast<double>(budget);
+    for (const auto& sample : demand)
+    {
+        const double limit = remaining / remainingWeight;
+        if (static_cast<double>(sample.fullBytes) > limit * sample.weight)
+            return std::max(static_cast<int64_t>(limit), minimumPreloadBytes);
+
+        remaining -= static_cast<double>(sample.fullBytes);
+        remainingWeight -= sample.weight;
+    }
+
+    const auto& last = demand.back();
+    return std::max(static_cast<int64_t>(std::ceil(static_cast<double>(last.fullBytes) / last.weight)), minimumPreloadBytes);
+}
+
+int64_t PreloadBudget::quantiseLimit(int64_t bytes)
+{
+    if (bytes <= minimumPreloadBytes)
+        return minimumPreloadBytes;
+
+    const double steps = std::floor(std::log2(static_cast<double>(bytes) / static_cast<double>(minimumPreloadBytes)) * 8.0);
+    const auto quantised = static_cast<int64_t>(static_cast<double>(minimumPreloadBytes) * std::exp2(steps / 8.0));
+    return juce::jlimit(minimumPreloadBytes, bytes, quantised);
+}
+
+float PreloadBudget::readMemoryPressure()
+{
+   #if JUCE_LINUX
+    // "some avg10=1.23 avg60=... avg300=... total=..."
+    const auto pressure = juce::File("/proc/pressure/memory").loadFileAsString();
+    if (!pressure.startsWith("some"))
+        return -1.0f;
+
+    return pressure.fromFirstOccurrenceOf("avg10=", false, false).upToFirstOccurrenceOf(" ", false, false).getFloatValue();
+   #else
+    return -1.0f;
+   #endif
+}
+
+void PreloadBudget::checkMemoryPressure()
+{
+    const float pressure = readMemoryPressure();
+    memoryPressure.store(pressure, std::memory_order_relaxed);
+
+    if (pressure < 0.0f || !isEnabled())
+        return;
+
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    if (pressure >= recoverPressurePercent)
+        lastPressureTime = now;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    float newScale = pressureScale;
+
+    // Shrink before the kernel starts swapping the preloads out; grow back slowly once it's calm
+    if (pressure >= shrinkPressurePercent && now - lastScaleChangeTime >= shrinkIntervalMs)
+        newScale = std::max(minimumPressureScale, pressureScale * 0.75f);
+    else if (pressureScale < 1.0f && now - lastPressureTime >= recoveryDelayMs && now - lastScaleChangeTime >= recoveryDelayMs)
+        newScale = std::min(1.0f, pressureScale + 0.25f);
+
+    if (newScale != pressureScale)
+    {
+        DebugLog::write("PreloadBudget: memory pressure " + juce::String(pressure, 2) + "%, budget scale "
+                        + juce::String(pressureScale, 2) + " -> " + juce::String(newScale, 2));
+        pressureScale = newScale;
+        lastScaleChangeTime = now;
+        recompute();
+    }
+}
+
+void PreloadBudget::serviceClients()
+{
+    const bool limitChanged = limitChangedPending.exchange(false);
+
+    std::lock_guard<std::mutex> callbackLock(callbackMutex);
+
+    std::vector<std::function<void(bool)>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [id, client] : clients)
+            callbacks.push_back(client.callback);
+    }
+
+    // Clients reapply their preloads; new demand they publish only sets the flag again
+    for (auto& callback : callbacks)
+        if (callback)
+            callback(limitChanged);
+}
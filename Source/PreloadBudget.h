@@ -0,0 +1,146 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * PreloadBudget sizes preloads from a RAM budget instead of the per-instance preload knob.
+ * Process-wide, shared by every SamplerEngine (hold it through juce::SharedResourcePointer).
+ *
+ * - Each engine registers as a client and publishes its demand: the full size of every
+ *   sample it wants preloaded. Instances of the same library publish the same keys, so a
+ *   preload they share is counted once.
+ * - The budget is water-filled over the demand: one limit is chosen so the preloads, each
+ *   capped at limit x its weight, fit the budget. Samples smaller than their cap are held
+ *   whole; if everything fits, libraries are fully RAM-resident and never stream.
+ * - Weights let an engine give some samples longer preloads than others (hot samples,
+ *   high playback rates, slow devices); a weight of 1 is the plain per-sample limit.
+ * - On Linux a monitor thread watches memory pressure (PSI, /proc/pressure/memory) and
+ *   shrinks the effective budget while the kernel is stalling on memory, then grows it
+ *   back once the pressure has been gone for a while.
+ *
+ * Clients are called back on the monitor thread about once a second (to free preloads they
+ * replaced), and promptly when the limit moves (to reapply their preloads).
+ */
+class PreloadBudget
+{
+public:
+    using ClientId = int;
+    static constexpr ClientId invalidClient = -1;
+
+    // Never cut a preload below the smallest preload knob setting
+    static constexpr int64_t minimumPreloadBytes = 32 * 1024;
+
+    // Memory pressure: "some avg10" percentage of time tasks stalled on memory
+    static constexpr int pressurePollMs = 1000;
+    static constexpr float shrinkPressurePercent = 10.0f;
+    static constexpr float recoverPressurePercent = 1.0f;
+    static constexpr int shrinkIntervalMs = 5000;      // Let the last shrink take effect before the next
+    static constexpr int recoveryDelayMs = 30000;      // Pressure-free time before growing back
+    static constexpr float minimumPressureScale = 0.25f;
+
+    /** One preload a client wants; the key identifies the sample across instances */
+    struct Demand
+    {
+        uint64_t key = 0;
+        int64_t fullBytes = 0;   // The whole sample, as float frames
+        float weight = 1.0f;     // Share of the limit this sample gets
+
+        bool operator==(const Demand& other) const
+        {
+            return key == other.key && fullBytes == other.fullBytes && weight == other.weight;
+        }
+    };
+
+    PreloadBudget();
+    ~PreloadBudget();
+
+    /** Register an engine; its callback runs on the monitor thread, limitChanged says if the limit moved */
+    ClientId registerClient(std::function<void(bool limitChanged)> callback);
+
+    /** Unregister an engine (blocks while its callback runs) */
+    void unregisterClient(ClientId client);
+
+    /** Run the client callbacks now rather than at the next poll (any thread, the audio thread too) */
+    void serviceClientsSoon() { monitorThread.notify(); }
+
+    /** Replace a client's demand (any thread) */
+    void setDemand(ClientId client, std::vector<Demand> demand);
+
+    /** RAM the preloads of all instances may use, 0 = off (the preload knob applies) */
+    void setBudgetBytes(int64_t bytes);
+    int64_t getBudgetBytes() const { return budgetBytes.load(std::memory_order_relaxed); }
+    bool isEnabled() const { return getBudgetBytes() > 0; }
+
+    /** The budget after memory-pressure shrinking */
+    int64_t getEffectiveBudgetBytes() const;
+
+    /** Largest preload a sample of weight 1 may get (scale by the weight), 0 when the budget is off */
+    int64_t getPreloadLimitBytes() const { return preloadLimitBytes.load(std::memory_order_relaxed); }
+
+    /** True if every wanted sample fits whole (no streaming) */
+    bool isFullyResident() const { return fullyResident.load(std::memory_order_relaxed); }
+
+    /** Latest memory pressure in percent, -1 if the system doesn't report it */
+    float getMemoryPressure() const { return memoryPressure.load(std::memory_order_relaxed); }
+
+    /**
+     * Per-sample limit that fits the given full sample sizes into the budget.
+     * Returns the largest size if everything fits whole; never less than minimumPreloadBytes.
+     * Public static for unit testing.
+     */
+    static int64_t computePreloadLimit(const std::vector<int64_t>& sizes, int64_t budget);
+
+    /** Same for weighted demand: sample i gets min(fullBytes, limit x weight) */
+    static int64_t computePreloadLimit(std::vector<Demand> demand, int64_t budget);
+
+    /** Round a limit down to an eighth-octave step, so small demand changes don't reload every preload */
+    static int64_t quantiseLimit(int64_t bytes);
+
+    /** "some avg10" of /proc/pressure/memory in percent, -1 if unavailable */
+    static float readMemoryPressure();
+
+private:
+    class MonitorThread : public juce::Thread
+    {
+    public:
+        explicit MonitorThread(PreloadBudget& owner);
+        void run() override;
+
+    private:
+        PreloadBudget& budget;
+    };
+
+    /** Recompute the limit from demand and budget (mutex held) */
+    void recompute();
+
+    void checkMemoryPressure();
+    void serviceClients();
+
+    struct Client
+    {
+        std::function<void(bool)> callback;
+        std::vector<Demand> demand;
+    };
+
+    mutable std::mutex mutex;
+    std::map<ClientId, Client> clients;
+    ClientId nextClientId = 0;
+    float pressureScale = 1.0f;          // Mutex
+    double lastPressureTime = 0.0;       // Monitor thread
+    double lastScaleChangeTime = 0.0;    // Monitor thread
+
+    std::mutex callbackMutex;            // Held while client callbacks run
+    std::atomic<bool> limitChangedPending{false};
+
+    std::atomic<int64_t> budgetBytes{0};
+    std::atomic<int64_t> preloadLimitBytes{0};
+    std::atomic<bool> fullyResident{false};
+    std::atomic<float> memoryPressure{-1.0f};
+
+    MonitorThread monitorThread;
+};
@@ -0,0 +1,136 @@
+#include "PreloadPack.h"
+#include "DebugLog.h"
+#include <atomic>
+
+#if ! JUCE_WINDOWS
+ #include <sys/mman.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    // Owns the mapping the packed preloads refer into
+    struct PackMapping
+    {
+        juce::File file;
+        std::unique_ptr<juce::MemoryMappedFile> mapped;
+        std::vector<juce::AudioBuffer<float>> buffers;
+
+        ~PackMapping()
+        {
+            buffers.clear();
+            mapped.reset();
+            file.deleteFile();
+        }
+    };
+}
+
+juce::File PreloadPack::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("HammerSampler")
+               .getChildFile("Hibernation");
+}
+
+std::vector<PreloadPack::PreloadPtr> PreloadPack::create(const juce::File& directory,
+                                                        const std::vector<const juce::AudioBuffer<float>*>& buffers)
+{
+    int64_t totalFloats = 0;
+    for (const auto* buffer : buffers)
+        totalFloats += getPaddedFrames(buffer->getNumSamples()) * buffer->getNumChannels();
+
+    if (totalFloats == 0 || directory.createDirectory().failed())
+        return {};
+
+    auto mapping = std::make_shared<PackMapping>();
+    mapping->file = directory.getNonexistentChildFile("preloads", ".pack", false);
+
+    {
+        juce::FileOutputStream out(mapping->file);
+        if (out.failedToOpen())
+            return {};
+
+        const std::vector<float> padding(4, 0.0f);
+        for (const auto* buffer : buffers)
+        {
+            const int numFrames = buffer->getNumSamples();
+            for (int ch = 0; ch < buffer->getNumChannels(); ++ch)
+            {
+                out.write(buffer->getReadPointer(ch), static_cast<size_t>(numFrames) * sizeof(float));
+                out.write(padding.data(), static_cast<size_t>(getPaddedFrames(numFrames) - numFrames) * sizeof(float));
+            }
+        }
+
+        out.flush();
+        if (out.getStatus().failed())
+        {
+            DebugLog::write("PreloadPack: writing " + mapping->file.getFullPathName() + " failed: " + out.getStatus().getErrorMessage());
+            return {};
+        }
+    }
+
+    mapping->mapped = std::make_unique<juce::MemoryMappedFile>(mapping->file, juce::MemoryMappedFile::readOnly);
+    if (mapping->mapped->getData() == nullptr
+        || mapping->mapped->getSize() < static_cast<size_t>(totalFloats) * sizeof(float))
+    {
+        DebugLog::write("PreloadPack: mapping " + mapping->file.getFullPathName() + " failed");
+        return {};
+    }
+
+    // The pages are read-only: voices only ever read preloads
+    auto* data = static_cast<float*>(mapping->mapped->getData());
+    std::vector<float*> channels;
+    mapping->buffers.reserve(buffers.size());
+
+    for (const auto* buffer : buffers)
+    {
+        channels.clear();
+        for (int ch = 0; ch < buffer->getNumChannels(); ++ch)
+        {
+            channels.push_back(data);
+            data += getPaddedFrames(buffer->getNumSamples());
+        }
+
+        mapping->buffers.emplace_back(channels.data(), buffer->getNumChannels(), buffer->getNumSamples());
+    }
+
+    std::vector<PreloadPtr> packed;
+    packed.reserve(mapping->buffers.size());
+    for (const auto& buffer : mapping->buffers)
+        packed.push_back(PreloadPtr(mapping, &buffer));
+
+    DebugLog::write("PreloadPack: packed " + juce::String(static_cast<int>(buffers.size())) + " preloads ("
+                    + juce::String(totalFloats * static_cast<int64_t>(sizeof(float)) / 1024) + " KB) into "
+                    + mapping->file.getFullPathName());
+    return packed;
+}
+
+void PreloadPack::prefault(const juce::AudioBuffer<float>& preload)
+{
+   #if JUCE_WINDOWS
+    const uintptr_t pageSize = 4096;
+   #else
+    const auto pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+
+    // All channels' readahead is queued before the first touch waits on any of it
+    for (int ch = 0; ch < preload.getNumChannels(); ++ch)
+    {
+        const auto start = reinterpret_cast<uintptr_t>(preload.getReadPointer(ch)) & ~(pageSize - 1);
+        const auto end = reinterpret_cast<uintptr_t>(preload.getReadPointer(ch) + preload.getNumSamples());
+        madvise(reinterpret_cast<void*>(start), static_cast<size_t>(end - start), MADV_WILLNEED);
+    }
+   #endif
+
+    const int pageFloats = static_cast<int>(pageSize / sizeof(float));
+    float sum = 0.0f;
+    for (int ch = 0; ch < preload.getNumChannels(); ++ch)
+    {
+        const float* data = preload.getReadPointer(ch);
+        for (int i = 0; i < preload.getNumSamples(); i += pageFloats)
+            sum += data[i];
+    }
+
+    // Keeps the reads from being optimised away
+    static std::atomic<float> sink { 0.0f };
+    sink.store(sum, std::memory_order_relaxed);
+}
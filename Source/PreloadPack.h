@@ -0,0 +1,39 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <memory>
+#include <vector>
+
+/**
+ * PreloadPack writes a set of preload buffers into one file of packed float frames and
+ * maps it back read-only. Used to park the preloads of a hibernating engine: the mapped
+ * pages are clean and file-backed, so the kernel can drop them under memory pressure for
+ * free and reads them back from the file when they are touched again.
+ *
+ * - Each buffer's channels are stored one after the other, 16-byte aligned
+ * - The returned preloads refer into the mapping and keep it alive; the file is deleted
+ *   once the last of them is released
+ *
+ * Any failure (disk full, mapping refused) returns an empty vector and the caller keeps
+ * its buffers in RAM.
+ */
+class PreloadPack
+{
+public:
+    using PreloadPtr = std::shared_ptr<const juce::AudioBuffer<float>>;
+
+    /** Pack the buffers into a new file in directory and map it; one preload per buffer, in order */
+    static std::vector<PreloadPtr> create(const juce::File& directory,
+                                          const std::vector<const juce::AudioBuffer<float>*>& buffers);
+
+    /** Read a packed preload's pages back in (readahead, then a touch per page), so copying it
+        afterwards doesn't fault page by page. Blocks: call it off the audio thread. */
+    static void prefault(const juce::AudioBuffer<float>& preload);
+
+    /** Where engines park their preloads (not the temp directory: that is RAM on many Linux systems) */
+    static juce::File getDefaultDirectory();
+
+    /** Floats a channel of numFrames takes in the file, padded to the alignment */
+    static int64_t getPaddedFrames(int numFrames) { return (static_cast<int64_t>(numFrames) + 3) & ~int64_t(3); }
+};
@@ -0,0 +1,284 @@
+#include "RemoteEngineClient.h"
+#include "DebugLog.h"
+#include <thread>
+
+RemoteEngineClient::RemoteEngineClient() = default;
+
+RemoteEngineClient::~RemoteEngineClient()
+{
+    disconnect();
+}
+
+bool RemoteEngineClient::connect(const juce::String& socketPath)
+{
+    disconnect();
+
+    if (!EngineIPC::isSupported())
+        return false;
+
+    std::lock_guard<std::mutex> lock(controlMutex);
+
+    controlSocket = EngineIPC::connectToSocket(socketPath);
+    if (controlSocket < 0)
+        return false;
+
+    // HELLO -> "OK <session id> <shared memory name>"
+    juce::String reply;
+    juce::StringArray tokens;
+    if (EngineIPC::sendLine(controlSocket, "HELLO " + juce::String(EngineIPC::protocolVersion))
+        && EngineIPC::readLine(controlSocket, reply, replyTimeoutMs))
+    {
+        tokens.addTokens(reply, " ", {});
+    }
+
+    if (tokens.size() == 3 && tokens[0] == "OK")
+        session = EngineIPC::mapSessionBlock(tokens[2]);
+
+    // Second connection carries the per-block wake-ups; the server unlinks the memory name once it's up
+    if (session != nullptr)
+        wakeSocket = EngineIPC::connectToSocket(socketPath);
+
+    if (wakeSocket < 0
+        || !EngineIPC::sendLine(wakeSocket, "WAKE " + tokens[1])
+        || !EngineIPC::readLine(wakeSocket, reply, replyTimeoutMs) || !reply.startsWith("OK"))
+    {
+        DebugLog::write("RemoteEngineClient: could not open a session at " + socketPath + " (" + reply + ")");
+        EngineIPC::closeSocket(wakeSocket);
+        EngineIPC::closeSocket(controlSocket);
+        EngineIPC::unmapSessionBlock(session);
+        wakeSocket = controlSocket = -1;
+        session = nullptr;
+        return false;
+    }
+
+    DebugLog::write("RemoteEngineClient: connected to " + socketPath + " as session " + tokens[1]);
+    consecutiveUnderruns = 0;
+    serverLost.store(false);
+    connected.store(true);
+    return true;
+}
+
+void RemoteEngineClient::disconnect()
+{
+    std::lock_guard<std::mutex> lock(controlMutex);
+
+    // Same handshake as VoiceRenderPool::setNumWorkers: no render can be using the session after this
+    connected.store(false);
+    while (renderInProgress.load())
+        std::this_thread::yield();
+
+    if (controlSocket >= 0)
+        EngineIPC::sendLine(controlSocket, "BYE");
+
+    EngineIPC::closeSocket(wakeSocket);
+    EngineIPC::closeSocket(controlSocket);
+    EngineIPC::unmapSessionBlock(session);
+    wakeSocket = controlSocket = -1;
+    session = nullptr;
+    latencySamples = 0;
+    serverLost.store(false);
+
+    loadingState.store(0);
+    activeVoices.store(0);
+    streamingVoices.store(0);
+    preloadBytes.store(0);
+    diskThroughputMBps.store(0.0f);
+    underruns.store(0);
+}
+
+bool RemoteEngineClient::sendCommand(const juce::String& command)
+{
+    std::lock_guard<std::mutex> lock(controlMutex);
+    if (controlSocket < 0)
+        return false;
+
+    juce::String reply;
+    if (!EngineIPC::sendLine(controlSocket, command) || !EngineIPC::readLine(controlSocket, reply, replyTimeoutMs))
+        return false;
+
+    if (!reply.startsWith("OK"))
+        DebugLog::write("RemoteEngineClient: '" + command + "' refused: " + reply);
+    return reply.startsWith("OK");
+}
+
+bool RemoteEngineClient::prepare(double sampleRate, int samplesPerBlock)
+{
+    const int blockSize = juce::jlimit(1, EngineIPC::maxBlockSize, samplesPerBlock);
+    if (!sendCommand("PREPARE " + juce::String(sampleRate) + " " + juce::String(blockSize)))
+        return false;
+
+    latencySamples = blockSize;
+    return true;
+}
+
+bool RemoteEngineClient::loadSamplesFromFolder(const juce::String& folderPath)
+{
+    return sendCommand("LOAD " + folderPath);
+}
+
+bool RemoteEngineClient::setADSR(float attack, float decay, float sustain, float release)
+{
+    return sendCommand("ADSR " + juce::String(attack) + " " + juce::String(decay) + " "
+                       + juce::String(sustain) + " " + juce::String(release));
+}
+
+bool RemoteEngineClient::setPreloadSizeKB(int sizeKB)
+{
+    return sendCommand("PRELOAD " + juce::String(sizeKB));
+}
+
+bool RemoteEngineClient::setVelocityLayerLimit(int limit)
+{
+    return sendCommand("VELLIMIT " + juce::String(limit));
+}
+
+bool RemoteEngineClient::setRoundRobinLimit(int limit)
+{
+    return sendCommand("RRLIMIT " + juce::String(limit));
+}
+
+bool RemoteEngineClient::setColdStart(bool enabled)
+{
+    return sendCommand("COLDSTART " + juce::String(enabled ? 1 : 0));
+}
+
+bool RemoteEngineClient::setHibernateAfterSeconds(int seconds)
+{
+    return sendCommand("HIBERNATE " + juce::String(seconds));
+}
+
+void RemoteEngineClient::queueNoteOn(int samplePosition, int midiNote, int velocity, int roundRobin, int sampleOffset)
+{
+    NoteEventQueue::Event event;
+    event.samplePosition = samplePosition;
+    event.type = NoteEventQueue::Type::NoteOn;
+    event.midiNote = midiNote;
+    event.velocity = velocity;
+    event.roundRobin = roundRobin;
+    event.sampleOffset = sampleOffset;
+    events.push(event);
+}
+
+void RemoteEngineClient::queueNoteOff(int samplePosition, int midiNote)
+{
+    NoteEventQueue::Event event;
+    event.samplePosition = samplePosition;
+    event.type = NoteEventQueue::Type::NoteOff;
+    event.midiNote = midiNote;
+    events.push(event);
+}
+
+bool RemoteEngineClient::renderBlock(juce::AudioBuffer<float>& buffer, int interpolationQuality)
+{
+    renderInProgress.store(true);
+    if (!connected.load())
+    {
+        renderInProgress.store(false);
+        return false;
+    }
+
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), EngineIPC::numChannels);
+
+    // Hosts may exceed the block size they announced: send it in pieces the server can take
+    for (int start = 0; start < numSamples; start += EngineIPC::maxBlockSize)
+    {
+        const int length = juce::jmin(EngineIPC::maxBlockSize, numSamples - start);
+
+        if (start == 0 && length == numSamples)
+        {
+            session->pushRequest(length, interpolationQuality, events);
+        }
+        else
+        {
+            chunkEvents.clear();
+            for (auto event : events)
+            {
+                if (event.samplePosition >= start && event.samplePosition < start + length)
+                {
+                    event.samplePosition -= start;
+                    chunkEvents.push(event);
+                }
+            }
+            session->pushRequest(length, interpolationQuality, chunkEvents);
+        }
+
+        if (!EngineIPC::sendWake(wakeSocket))
+        {
+            consecutiveUnderruns = maxConsecutiveUnderruns;
+            break;
+        }
+
+        // The previous request's audio (the server primed one block of silence)
+        float* channels[EngineIPC::numChannels] = {};
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch] = buffer.getWritePointer(ch, start);
+
+        const int received = session->readAudio(channels, numChannels, length);
+        if (received < length)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::clear(channels[ch] + received, length - received);
+            session->audioUnderruns.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // A short block is a late server; a long run of empty ones is a dead one
+        consecutiveUnderruns = received > 0 ? 0 : consecutiveUnderruns + 1;
+    }
+
+    // The audio thread can't disconnect (that waits for it): stop using the session and let
+    // the message thread tear it down and bring the local engine back. The events stay for it.
+    if (consecutiveUnderruns >= maxConsecutiveUnderruns)
+    {
+        serverLost.store(true);
+        connected.store(false);
+        renderInProgress.store(false);
+        return false;
+    }
+
+    events.clear();
+
+    copyStats();
+    renderInProgress.store(false);
+    return true;
+}
+
+void RemoteEngineClient::copyStats()
+{
+    loadingState.store(session->loadingState.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    activeVoices.store(session->activeVoices.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    streamingVoices.store(session->streamingVoices.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    preloadBytes.store(session->preloadBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    diskThroughputMBps.store(session->diskThroughputMBps.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    underruns.store(static_cast<int>(session->audioUnderruns.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+}
+
+int RemoteEngineClient::getLoadingState() const
+{
+    return loadingState.load(std::memory_order_relaxed);
+}
+
+int RemoteEngineClient::getActiveVoiceCount() const
+{
+    return activeVoices.load(std::memory_order_relaxed);
+}
+
+int RemoteEngineClient::getStreamingVoiceCount() const
+{
+    return streamingVoices.load(std::memory_order_relaxed);
+}
+
+int64_t RemoteEngineClient::getPreloadMemoryBytes() const
+{
+    return preloadBytes.load(std::memory_order_relaxed);
+}
+
+float RemoteEngineClient::getDiskThroughputMBps() const
+{
+    return diskThroughputMBps.load(std::memory_order_relaxed);
+}
+
+int RemoteEngineClient::getUnderrunCount() const
+{
+    return underruns.load(std::memory_order_relaxed);
+}
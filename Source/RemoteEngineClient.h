@@ -0,0 +1,100 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <atomic>
+#include <mutex>
+#include "EngineIPC.h"
+#include "NoteEventQueue.h"
+
+/**
+ * RemoteEngineClient lets a plugin instance play through the engine server instead of its
+ * own SamplerEngine: note events go out and rendered audio comes back through shared memory,
+ * settings go over the control socket.
+ *
+ * Mirrors the SamplerEngine calls the processor makes (queueNoteOn/queueNoteOff, then one
+ * render per block), so the processor's MIDI handling is the same in both modes. Audio
+ * arrives one block late; report getLatencySamples() to the host.
+ */
+class RemoteEngineClient
+{
+public:
+    static constexpr int replyTimeoutMs = 2000;
+
+    /** Blocks in a row without any audio back before the server counts as gone */
+    static constexpr int maxConsecutiveUnderruns = 100;
+
+    RemoteEngineClient();
+    ~RemoteEngineClient();
+
+    /** Connect to a running server (message thread). False if none is listening. */
+    bool connect(const juce::String& socketPath = EngineIPC::getDefaultSocketPath());
+    void disconnect();
+    bool isConnected() const { return connected.load(); }
+
+    /**
+     * The audio thread found the server gone (its wake-up socket failed, or it stopped sending
+     * audio) and stopped rendering through it. Call disconnect() on the message thread.
+     */
+    bool hasLostServer() const { return serverLost.load(); }
+
+    // Control (message thread): false if not connected or the server refused
+    bool prepare(double sampleRate, int samplesPerBlock);
+    bool loadSamplesFromFolder(const juce::String& folderPath);
+    bool setADSR(float attack, float decay, float sustain, float release);
+    bool setPreloadSizeKB(int sizeKB);
+    bool setVelocityLayerLimit(int limit);
+    bool setRoundRobinLimit(int limit);
+    bool setColdStart(bool enabled);
+    bool setHibernateAfterSeconds(int seconds);
+
+    /** Audio arrives this many samples late */
+    int getLatencySamples() const { return latencySamples; }
+
+    // Audio thread: queue this block's note events, then render
+    void queueNoteOn(int samplePosition, int midiNote, int velocity, int roundRobin, int sampleOffset = 0);
+    void queueNoteOff(int samplePosition, int midiNote);
+
+    /** Send the queued events and fill the buffer with the server's audio. False if not connected or the server is gone. */
+    bool renderBlock(juce::AudioBuffer<float>& buffer, int interpolationQuality);
+
+    /** After renderBlock returned false: the block's note events, which no server played. Play them
+        some other way, then clear them. */
+    const NoteEventQueue& getUnrenderedEvents() const { return events; }
+    void clearUnrenderedEvents() { events.clear(); }
+
+    // Server engine status (for UI)
+    int getLoadingState() const;
+    int getActiveVoiceCount() const;
+    int getStreamingVoiceCount() const;
+    int64_t getPreloadMemoryBytes() const;
+    float getDiskThroughputMBps() const;
+    int getUnderrunCount() const;  // Blocks the server didn't deliver in time
+
+private:
+    bool sendCommand(const juce::String& command);
+    void copyStats();
+
+    std::mutex controlMutex;
+    int controlSocket = -1;
+    int wakeSocket = -1;
+    EngineIPC::SessionBlock* session = nullptr;
+
+    // Cleared before the session is unmapped; the audio thread marks itself inside renderBlock
+    std::atomic<bool> connected{false};
+    std::atomic<bool> renderInProgress{false};
+    std::atomic<bool> serverLost{false};
+    int consecutiveUnderruns = 0;  // Audio thread
+
+    // Copied out of the session by renderBlock, so the UI never reads a block disconnect() may unmap
+    std::atomic<int> loadingState{0};
+    std::atomic<int> activeVoices{0};
+    std::atomic<int> streamingVoices{0};
+    std::atomic<int64_t> preloadBytes{0};
+    std::atomic<float> diskThroughputMBps{0.0f};
+    std::atomic<int> underruns{0};
+
+    int latencySamples = 0;
+
+    NoteEventQueue events;       // Audio thread
+    NoteEventQueue chunkEvents;  // Audio thread, for host blocks larger than maxBlockSize
+};
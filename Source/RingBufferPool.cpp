@@ -0,0 +1,90 @@
+#include "RingBufferPool.h"
+
+RingBufferPool::RingBufferPool()
+{
+    lastBusyTime = juce::Time::getMillisecondCounterHiRes();
+}
+
+RingBufferPool::~RingBufferPool() = default;
+
+int RingBufferPool::acquire()
+{
+    const int start = searchHint.load(std::memory_order_relaxed);
+
+    for (int n = 0; n < maxSlabs; ++n)
+    {
+        const int index = (start + n) % maxSlabs;
+        auto& slab = slabs[static_cast<size_t>(index)];
+
+        int expected = Free;
+        if (slab.state.load(std::memory_order_relaxed) == Free
+            && slab.state.compare_exchange_strong(expected, InUse, std::memory_order_acquire))
+        {
+            searchHint.store((index + 1) % maxSlabs, std::memory_order_relaxed);
+            slabsInUse.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+    }
+
+    starvationCount.fetch_add(1, std::memory_order_relaxed);
+    return invalidSlab;
+}
+
+void RingBufferPool::release(int slab)
+{
+    if (slab < 0 || slab >= maxSlabs)
+        return;
+
+    slabs[static_cast<size_t>(slab)].state.store(Free, std::memory_order_release);
+    slabsInUse.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void RingBufferPool::maintain()
+{
+    const int inUse = slabsInUse.load(std::memory_order_relaxed);
+    const int allocated = allocatedSlabs.load(std::memory_order_relaxed);
+    const int freeSlabs = allocated - inUse;
+
+    // Keep headroom for a burst of note-ons: at least the minimum, more when many voices stream
+    const int reserve = juce::jmin(maxSlabs - inUse, juce::jmax(minimumReserve.load(std::memory_order_relaxed), inUse / 2));
+    const double now = juce::Time::getMillisecondCounterHiRes();
+
+    if (freeSlabs <= reserve)
+        lastBusyTime = now;
+
+    if (freeSlabs < reserve)
+    {
+        int toAllocate = reserve - freeSlabs;
+        for (auto& slab : slabs)
+        {
+            if (toAllocate == 0)
+                break;
+
+            if (slab.state.load(std::memory_order_acquire) != Empty)
+                continue;
+
+            // Cleared once: voices only read what the disk thread has written since they took the
+            // slab, so a reused slab's old contents are never heard either
+            slab.data.reset(new float[static_cast<size_t>(StreamingConstants::ringBufferFrames)]());
+            allocatedSlabs.fetch_add(1, std::memory_order_relaxed);
+            slab.state.store(Free, std::memory_order_release);
+            --toAllocate;
+        }
+        return;
+    }
+
+    if (freeSlabs > reserve && now - lastBusyTime > reclaimDelayMs)
+    {
+        // Give back one surplus slab per poll so memory drains gradually
+        for (auto& slab : slabs)
+        {
+            int expected = Free;
+            if (slab.state.compare_exchange_strong(expected, Empty, std::memory_order_acquire))
+            {
+                slab.data.reset();
+                allocatedSlabs.fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "DiskStreaming.h"
+
+/**
+ * RingBufferPool holds the ring buffer storage for all streaming voices of one engine.
+ *
+ * Storage is handed out in channel slabs of StreamingConstants::ringBufferFrames floats:
+ * a stereo streaming voice takes two, a mono one takes one, and voices playing
+ * fully RAM-resident samples take none. Memory therefore follows real streaming
+ * polyphony instead of being committed up front for every voice.
+ *
+ * Threading:
+ * - acquire() is lock-free and called from the audio thread at voice start
+ * - release() and maintain() are called from the disk thread, which is the only
+ *   thread that allocates or frees slab memory
+ * - maintain() keeps a reserve of free slabs ahead of demand and frees the surplus
+ *   after it has been idle for a while
+ */
+class RingBufferPool
+{
+public:
+    static constexpr int maxSlabs = StreamingConstants::maxStreamingVoices * 2;
+    static constexpr int invalidSlab = -1;
+
+    RingBufferPool();
+    ~RingBufferPool();
+
+    /** Minimum number of free slabs kept ready (0 when the loaded instrument never streams) */
+    void setMinimumReserve(int slabs) { minimumReserve.store(juce::jlimit(0, maxSlabs, slabs), std::memory_order_relaxed); }
+
+    /** Claim a free slab. Returns invalidSlab if none is ready (audio thread). */
+    int acquire();
+
+    /** Return a slab to the free list (disk thread) */
+    void release(int slab);
+
+    /** Storage for a claimed slab */
+    float* getSlabData(int slab) const { return slabs[static_cast<size_t>(slab)].data.get(); }
+
+    /** Grow the reserve or reclaim idle slabs (disk thread, called every poll) */
+    void maintain();
+
+    /** Bytes currently allocated for ring storage */
+    int64_t getAllocatedBytes() const { return static_cast<int64_t>(allocatedSlabs.load(std::memory_order_relaxed)) * slabBytes; }
+
+    /** Number of voice starts that found no free slab */
+    int getStarvationCount() const { return starvationCount.load(std::memory_order_relaxed); }
+
+    static constexpr int64_t slabBytes = static_cast<int64_t>(StreamingConstants::ringBufferFrames) * static_cast<int64_t>(sizeof(float));
+
+private:
+    enum SlabState : int { Empty, Free, InUse };
+
+    struct Slab
+    {
+        std::atomic<int> state{Empty};
+        std::unique_ptr<float[]> data;   // Only touched by the disk thread while Empty
+    };
+
+    std::array<Slab, maxSlabs> slabs;
+
+    std::atomic<int> allocatedSlabs{0};
+    std::atomic<int> slabsInUse{0};
+    std::atomic<int> minimumReserve{0};
+    std::atomic<int> starvationCount{0};
+    std::atomic<int> searchHint{0};
+
+    // Surplus free slabs are reclaimed once demand has stayed below them this long
+    static constexpr double reclaimDelayMs = 5000.0;
+    double lastBusyTime = 0.0;
+};
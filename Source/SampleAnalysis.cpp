@@ -0,0 +1,316 @@
+#include "SampleAnalysis.h"
+#include "DebugLog.h"
+#include "SampleContainer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    constexpr char indexMagic[4] = { 'H', 'S', 'S', 'A' };
+    constexpr int indexVersion = 2;
+
+    constexpr int analysisChunkFrames = 65536;
+    constexpr int analysisBlockFrames = 512;           // Resolution of the start and the end
+    constexpr float silenceDb = -96.0f;                // Absolute: quieter than this counts as silence
+    constexpr float trustedNoiseFloorDb = -50.0f;      // A tail level above this is the sample, not its noise floor
+    constexpr float noiseFloorMarginDb = 6.0f;         // The end is where the tail falls to this above the noise floor
+    constexpr double noiseFloorWindowMs = 100.0;       // Measured over the last stretch of the file
+    constexpr double onsetMarginMs = 2.0;
+    constexpr int resultsPerSave = 32;                 // Progress survives a quit mid-library
+
+    struct Block
+    {
+        float peak = 0.0f;
+        double sumOfSquares = 0.0;
+        int numValues = 0;
+
+        float getRms() const { return numValues > 0 ? static_cast<float>(std::sqrt(sumOfSquares / numValues)) : 0.0f; }
+    };
+}
+
+//==============================================================================
+SampleAnalysis::Worker::Worker(SampleAnalysis& owner)
+    : juce::Thread("Sample Analysis"),
+      analysis(owner)
+{
+    formatManager.registerBasicFormats();
+}
+
+void SampleAnalysis::Worker::run()
+{
+    while (!threadShouldExit())
+    {
+        Request request;
+        {
+            std::lock_guard<std::mutex> lock(analysis.mutex);
+            if (!analysis.queue.empty())
+            {
+                request = std::move(analysis.queue.front());
+                analysis.queue.pop_front();
+            }
+        }
+
+        if (request.folderPath.isEmpty())
+        {
+            wait(-1);
+            continue;
+        }
+
+        const double startTime = juce::Time::getMillisecondCounterHiRes();
+        std::map<uint64_t, Result> results;
+        int numAnalysed = 0;
+
+        for (const auto& job : request.jobs)
+        {
+            if (threadShouldExit())
+                break;
+
+            Result result;
+            if (analyse(formatManager, job.samplePath, result))
+            {
+                results[job.fingerprint] = std::move(result);
+                ++numAnalysed;
+            }
+
+            if (results.size() >= static_cast<size_t>(resultsPerSave))
+            {
+                addToIndex(request.folderPath, results);
+                results.clear();
+            }
+        }
+
+        if (!results.empty())
+            addToIndex(request.folderPath, results);
+
+        DebugLog::write("SampleAnalysis: " + request.folderPath + " - analysed " + juce::String(numAnalysed) + " of "
+                        + juce::String(static_cast<int>(request.jobs.size())) + " samples in "
+                        + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 0) + " ms");
+
+        std::lock_guard<std::mutex> lock(analysis.mutex);
+        analysis.pending.erase(request.folderPath);
+    }
+}
+
+//==============================================================================
+SampleAnalysis::SampleAnalysis()
+    : worker(*this)
+{
+    worker.startThread(juce::Thread::Priority::low);
+}
+
+SampleAnalysis::~SampleAnalysis()
+{
+    worker.signalThreadShouldExit();
+    worker.notify();
+    worker.stopThread(10000);
+}
+
+void SampleAnalysis::request(const juce::String& folderPath, std::vector<Job> jobs)
+{
+    if (jobs.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!pending.insert(folderPath).second)
+            return;
+
+        queue.push_back({ folderPath, std::move(jobs) });
+    }
+    worker.notify();
+}
+
+int SampleAnalysis::getNumPending() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(pending.size());
+}
+
+bool SampleAnalysis::analyse(juce::AudioFormatManager& formatManager, const juce::String& samplePath, Result& result)
+{
+    auto reader = SampleContainer::createReaderFor(formatManager, samplePath);
+    if (reader == nullptr || reader->numChannels == 0 || reader->lengthInSamples <= 0)
+        return false;
+
+    const int numChannels = static_cast<int>(reader->numChannels);
+    const auto totalFrames = static_cast<int64_t>(reader->lengthInSamples);
+
+    // One pass: peak and energy per block
+    std::vector<Block> blocks(static_cast<size_t>((totalFrames + analysisBlockFrames - 1) / analysisBlockFrames));
+    juce::AudioBuffer<float> buffer(numChannels, analysisChunkFrames);
+
+    for (int64_t first = 0; first < totalFrames; first += analysisChunkFrames)
+    {
+        if (juce::Thread::currentThreadShouldExit())
+            return false;
+
+        const int numFrames = static_cast<int>(std::min<int64_t>(analysisChunkFrames, totalFrames - first));
+        if (!reader->read(&buffer, 0, numFrames, first, true, true))
+            return false;
+
+        // Chunks are whole blocks, so a block never straddles two reads
+        for (int blockStart = 0; blockStart < numFrames; blockStart += analysisBlockFrames)
+        {
+            auto& block = blocks[static_cast<size_t>((first + blockStart) / analysisBlockFrames)];
+            const int blockFrames = std::min(analysisBlockFrames, numFrames - blockStart);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* data = buffer.getReadPointer(ch, blockStart);
+                for (int frame = 0; frame < blockFrames; ++frame)
+                {
+                    block.peak = std::max(block.peak, std::abs(data[frame]));
+                    block.sumOfSquares += static_cast<double>(data[frame]) * data[frame];
+                }
+            }
+            block.numValues += blockFrames * numChannels;
+        }
+    }
+
+    result.startFrame = 0;
+    result.endFrame = totalFrames;
+
+    // Level envelope: the loudest block RMS in each level block, then the loudest from there to the end
+    constexpr int blocksPerLevel = SampleAnalysis::levelBlockFrames / analysisBlockFrames;
+    static_assert(SampleAnalysis::levelBlockFrames % analysisBlockFrames == 0, "levels are made of whole analysis blocks");
+    result.levels.assign((blocks.size() + blocksPerLevel - 1) / blocksPerLevel, 0.0f);
+    for (size_t i = 0; i < blocks.size(); ++i)
+        result.levels[i / blocksPerLevel] = std::max(result.levels[i / blocksPerLevel], blocks[i].getRms());
+    for (size_t i = result.levels.size() - 1; i > 0; --i)
+        result.levels[i - 1] = std::max(result.levels[i - 1], result.levels[i]);
+
+    float peak = 0.0f;
+    for (const auto& block : blocks)
+        peak = std::max(peak, block.peak);
+
+    const float silence = juce::Decibels::decibelsToGain(silenceDb);
+    if (peak <= silence)
+        return true;
+
+    // Start: the onset, less a margin so the attack's first rise is kept
+    const float onsetLevel = std::max(silence, peak * juce::Decibels::decibelsToGain(onsetThresholdDb));
+    const auto onset = std::find_if(blocks.begin(), blocks.end(), [onsetLevel](const Block& block) { return block.peak > onsetLevel; });
+    const auto onsetMargin = static_cast<int64_t>(onsetMarginMs * 0.001 * reader->sampleRate);
+    result.startFrame = std::max<int64_t>(0, static_cast<int64_t>(onset - blocks.begin()) * analysisBlockFrames - onsetMargin);
+
+    // End: where the tail falls below the threshold, or close to a noise floor the file ends in
+    float tailLevel = std::max(silence, peak * juce::Decibels::decibelsToGain(tailThresholdDb));
+    const auto floorBlocks = std::max<size_t>(1, std::min(blocks.size() / 10,
+        static_cast<size_t>(noiseFloorWindowMs * 0.001 * reader->sampleRate / analysisBlockFrames)));
+    Block noiseFloor;
+    for (size_t i = blocks.size() - floorBlocks; i < blocks.size(); ++i)
+    {
+        noiseFloor.sumOfSquares += blocks[i].sumOfSquares;
+        noiseFloor.numValues += blocks[i].numValues;
+    }
+    if (noiseFloor.getRms() < peak * juce::Decibels::decibelsToGain(trustedNoiseFloorDb))
+        tailLevel = std::max(tailLevel, noiseFloor.getRms() * juce::Decibels::decibelsToGain(noiseFloorMarginDb));
+
+    auto lastAudible = blocks.size();
+    while (lastAudible > 0 && blocks[lastAudible - 1].getRms() <= tailLevel)
+        --lastAudible;
+
+    const auto tailMargin = static_cast<int64_t>(SampleAnalysis::tailMarginMs * 0.001 * reader->sampleRate);
+    result.endFrame = std::min(totalFrames, static_cast<int64_t>(lastAudible) * analysisBlockFrames + tailMargin);
+
+    if (result.endFrame <= result.startFrame)
+    {
+        result.startFrame = 0;
+        result.endFrame = totalFrames;
+    }
+    return true;
+}
+
+juce::File SampleAnalysis::getIndexFile(const juce::String& folderPath)
+{
+    return getDefaultDirectory().getChildFile(juce::String::toHexString(folderPath.hashCode64()) + ".idx");
+}
+
+std::map<uint64_t, SampleAnalysis::Result> SampleAnalysis::loadIndex(const juce::String& folderPath)
+{
+    std::map<uint64_t, Result> results;
+
+    juce::FileInputStream in(getIndexFile(folderPath));
+    if (in.failedToOpen())
+        return results;
+
+    char magic[4] {};
+    if (in.read(magic, 4) != 4 || std::memcmp(magic, indexMagic, 4) != 0 || in.readInt() != indexVersion
+        || in.readString() != folderPath)
+        return results;
+
+    const int numResults = in.readInt();
+    if (numResults < 0)
+        return results;
+
+    for (int i = 0; i < numResults; ++i)
+    {
+        const auto fingerprint = static_cast<uint64_t>(in.readInt64());
+        Result result;
+        result.startFrame = in.readInt64();
+        result.endFrame = in.readInt64();
+
+        const int numLevels = in.readInt();
+        if (numLevels < 0 || in.getNumBytesRemaining() < int64_t(numLevels) * 4)
+            return {};
+
+        result.levels.resize(static_cast<size_t>(numLevels));
+        for (auto& level : result.levels)
+            level = in.readFloat();
+
+        if (result.startFrame >= 0 && result.endFrame > result.startFrame)
+            results[fingerprint] = std::move(result);
+    }
+    return results;
+}
+
+bool SampleAnalysis::addToIndex(const juce::String& folderPath, const std::map<uint64_t, Result>& results)
+{
+    auto merged = loadIndex(folderPath);
+    for (const auto& [fingerprint, result] : results)
+        merged[fingerprint] = result;
+
+    const auto indexFile = getIndexFile(folderPath);
+    if (indexFile.getParentDirectory().createDirectory().failed())
+        return false;
+
+    juce::TemporaryFile temp(indexFile);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+            return false;
+
+        out.write(indexMagic, sizeof(indexMagic));
+        out.writeInt(indexVersion);
+        out.writeString(folderPath);
+        out.writeInt(static_cast<int>(merged.size()));
+        for (const auto& [fingerprint, result] : merged)
+        {
+            out.writeInt64(static_cast<juce::int64>(fingerprint));
+            out.writeInt64(result.startFrame);
+            out.writeInt64(result.endFrame);
+            out.writeInt(static_cast<int>(result.levels.size()));
+            for (float level : result.levels)
+                out.writeFloat(level);
+        }
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+    {
+        DebugLog::write("SampleAnalysis: could not write the index of " + folderPath);
+        return false;
+    }
+    return true;
+}
+
+juce::File SampleAnalysis::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("HammerSampler")
+               .getChildFile("Analysis");
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+
+/**
+ * SampleAnalysis finds the audible part of each sample of a library: where it rises above
+ * the noise floor and where its tail has decayed into it. Preloads and streaming voices then
+ * skip the pre-roll and stop at the effective end instead of reading silence.
+ *
+ * - Scanning a library applies the results in its analysis index and queues the samples that
+ *   have none; a background thread reads those once, front to back, and adds them to the index
+ * - The index is one file per library folder, with a result per sample fingerprint (file name,
+ *   size, modification time), so an edited sample is analysed again and the others are kept
+ * - Until a sample is analysed (in practice: until the library is next loaded) it plays whole
+ *
+ * The start is the first block whose peak is within onsetThresholdDb of the sample's peak,
+ * less a small margin, so no attack is cut. The end is the last block whose RMS is above
+ * tailThresholdDb below the peak, or above the recording's noise floor where that is
+ * measurably higher, plus tailMarginMs of decay that voices fade out over, so a tail cut
+ * well above silence (a noisy recording's) ends without a click. Silent samples are left whole.
+ *
+ * The analysis also keeps a coarse level envelope: for every levelBlockFrames of the file, the
+ * loudest RMS from there to the end. The engine multiplies it with a voice's envelope and
+ * velocity to tell when a voice can no longer become audible (audibility culling).
+ */
+class SampleAnalysis
+{
+public:
+    static constexpr float onsetThresholdDb = -60.0f;   // Relative to the sample's peak
+    static constexpr float tailThresholdDb = -80.0f;
+    static constexpr int levelBlockFrames = 4096;
+    static constexpr double tailMarginMs = 50.0;         // Kept past the tail's end; voices fade out over it
+
+    struct Result
+    {
+        int64_t startFrame = 0;     // First frame kept
+        int64_t endFrame = 0;       // One past the last frame kept
+        std::vector<float> levels;  // Per levelBlockFrames from file frame 0: loudest RMS from there on
+    };
+
+    struct Job
+    {
+        uint64_t fingerprint = 0;   // LibrarySample::fingerprint
+        juce::String samplePath;    // A file or a container entry
+    };
+
+    SampleAnalysis();
+    ~SampleAnalysis();
+
+    /** Queue the unanalysed samples of a library folder, unless that folder is already queued (any thread) */
+    void request(const juce::String& folderPath, std::vector<Job> jobs);
+
+    /** Library folders queued or being analysed */
+    int getNumPending() const;
+
+    /** Analyse one sample (reads it once); false if it can't be read */
+    static bool analyse(juce::AudioFormatManager& formatManager, const juce::String& samplePath, Result& result);
+
+    /** The analysis index of a library folder, by sample fingerprint (empty if there is none) */
+    static std::map<uint64_t, Result> loadIndex(const juce::String& folderPath);
+
+    /** Add results to a library folder's index (replaced atomically) */
+    static bool addToIndex(const juce::String& folderPath, const std::map<uint64_t, Result>& results);
+
+    static juce::File getDefaultDirectory();
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(SampleAnalysis& owner);
+        void run() override;
+
+    private:
+        SampleAnalysis& analysis;
+        juce::AudioFormatManager formatManager;
+    };
+
+    struct Request
+    {
+        juce::String folderPath;
+        std::vector<Job> jobs;
+    };
+
+    static juce::File getIndexFile(const juce::String& folderPath);
+
+    mutable std::mutex mutex;
+    std::deque<Request> queue;
+    std::set<juce::String> pending;      // Folders queued or in progress
+
+    Worker worker;
+};
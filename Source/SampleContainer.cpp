@@ -0,0 +1,713 @@
+#include "SampleContainer.h"
+#include "DebugLog.h"
+#include "SampleFileName.h"
+#include "FlacSeekIndex.h"
+#include "TranscodeCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+#if ! JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <unistd.h>
+ #include <cerrno>
+#endif
+
+namespace
+{
+    constexpr char containerMagic[4] = { 'H', 'S', 'P', 'K' };
+    constexpr int containerVersion = 2;   // 2 added compressed entries
+    constexpr int64_t headerBytes = 16;   // Magic, version, entry count, index size
+
+    int64_t alignUp(int64_t offset)
+    {
+        return (offset + SampleContainer::alignment - 1) / SampleContainer::alignment * SampleContainer::alignment;
+    }
+
+    // Containers open in this process, so every reader of one shares its descriptor
+    std::mutex registryMutex;
+    std::map<juce::String, std::weak_ptr<SampleContainer>> registry;
+
+    /** Where one compressed block is in the file */
+    struct BlockLocation
+    {
+        int64_t offset = 0;
+        uint32_t size = 0;
+    };
+
+    /** Reads one entry of a container as float */
+    class ContainerReader : public juce::AudioFormatReader
+    {
+    public:
+        ContainerReader(std::shared_ptr<SampleContainer> owner, int index, std::vector<BlockLocation> blockTable)
+            : juce::AudioFormatReader(nullptr, "Hammer Sampler Container"),
+              container(std::move(owner)),
+              entry(container->getEntries()[static_cast<size_t>(index)]),
+              blocks(std::move(blockTable))
+        {
+            sampleRate = entry.sampleRate;
+            numChannels = static_cast<unsigned int>(entry.numChannels);
+            lengthInSamples = entry.totalFrames;
+            bitsPerSample = 32;
+            usesFloatingPointData = true;
+
+            if (entry.compressed)
+            {
+                decoded.assign(static_cast<size_t>(entry.numChannels), std::vector<int32_t>(LosslessCodec::blockFrames));
+                for (auto& channel : decoded)
+                    decodedChannels.push_back(channel.data());
+            }
+        }
+
+        bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                         juce::int64 startSampleInFile, int numSamples) override
+        {
+            int done = 0;
+
+            while (done < numSamples)
+            {
+                const int64_t frame = startSampleInFile + done;
+                float* const* dest = reinterpret_cast<float* const*>(destChannels);
+                const int destOffset = startOffsetInDestBuffer + done;
+
+                // Before the start or past the end reads as silence
+                if (frame < 0 || frame >= entry.totalFrames)
+                {
+                    const int silent = frame < 0 ? static_cast<int>(std::min<int64_t>(-frame, numSamples - done))
+                                                 : numSamples - done;
+                    for (int ch = 0; ch < numDestChannels; ++ch)
+                        if (dest[ch] != nullptr)
+                            std::fill_n(dest[ch] + destOffset, silent, 0.0f);
+                    done += silent;
+                    continue;
+                }
+
+                const int frames = entry.compressed
+                                     ? readCompressed(frame, startSampleInFile + numSamples, dest, numDestChannels, destOffset)
+                                     : readPcm(frame, numSamples - done, dest, numDestChannels, destOffset);
+                if (frames <= 0)
+                    return false;
+
+                done += frames;
+            }
+
+            return true;
+        }
+
+    private:
+        static constexpr int64_t maxFramesPerRead = 16384;
+        static constexpr int maxBlocksPerRead = static_cast<int>(maxFramesPerRead / LosslessCodec::blockFrames);
+
+        /** Reads PCM frames up to the end of the region frame is in; returns the frames read or 0 on failure */
+        int readPcm(int64_t frame, int maxFrames, float* const* dest, int numDestChannels, int destOffset)
+        {
+            const int bytesPerFrame = entry.getBytesPerFrame();
+
+            // A read never crosses from the head region into the tail region
+            const bool inHead = frame < entry.headFrames;
+            const int64_t regionEnd = inHead ? entry.headFrames : entry.totalFrames;
+            const int frames = static_cast<int>(std::min<int64_t>({ static_cast<int64_t>(maxFrames), regionEnd - frame, maxFramesPerRead }));
+            const int64_t offset = inHead ? entry.headOffset + frame * bytesPerFrame
+                                          : entry.tailOffset + (frame - entry.headFrames) * bytesPerFrame;
+
+            scratch.resize(static_cast<size_t>(maxFramesPerRead * bytesPerFrame));
+            if (!container->readBytes(offset, scratch.data(), static_cast<size_t>(frames * bytesPerFrame)))
+                return 0;
+
+            for (int ch = 0; ch < numDestChannels; ++ch)
+            {
+                if (dest[ch] == nullptr)
+                    continue;
+
+                if (ch >= entry.numChannels)
+                    std::fill_n(dest[ch] + destOffset, frames, 0.0f);
+                else
+                    decodePcm(ch, frames, dest[ch] + destOffset);
+            }
+
+            return frames;
+        }
+
+        /** Reads frames from the block frame is in (decoding it unless it is the last one decoded);
+            endFrame is where the whole read ends, so following blocks come in with the same disk read */
+        int readCompressed(int64_t frame, int64_t endFrame, float* const* dest, int numDestChannels, int destOffset)
+        {
+            const int block = static_cast<int>(frame / LosslessCodec::blockFrames);
+            const int lastBlock = static_cast<int>((std::min(endFrame, entry.totalFrames) - 1) / LosslessCodec::blockFrames);
+            if (block != decodedBlock && !decodeBlock(block, lastBlock))
+                return 0;
+
+            const int64_t blockStart = int64_t(block) * LosslessCodec::blockFrames;
+            const int offsetInBlock = static_cast<int>(frame - blockStart);
+            const int framesInBlock = static_cast<int>(std::min<int64_t>(LosslessCodec::blockFrames, entry.totalFrames - blockStart));
+            const int frames = static_cast<int>(std::min<int64_t>(framesInBlock - offsetInBlock, endFrame - frame));
+            const float scale = 1.0f / static_cast<float>(1 << (entry.bitsPerSample - 1));
+
+            for (int ch = 0; ch < numDestChannels; ++ch)
+            {
+                if (dest[ch] == nullptr)
+                    continue;
+
+                if (ch >= entry.numChannels)
+                    std::fill_n(dest[ch] + destOffset, frames, 0.0f);
+                else
+                    LosslessCodec::toFloat(decoded[static_cast<size_t>(ch)].data() + offsetInBlock, dest[ch] + destOffset, frames, scale);
+            }
+
+            return frames;
+        }
+
+        bool decodeBlock(int block, int lastBlockWanted)
+        {
+            // Read the blocks this read needs in one go, as long as they are next to each other in the file
+            if (block < spanFirst || block > spanLast)
+            {
+                const int regionLast = block < entry.getHeadBlocks() ? entry.getHeadBlocks() - 1 : entry.getNumBlocks() - 1;
+                const int last = std::min({ lastBlockWanted, block + maxBlocksPerRead - 1, regionLast });
+                const auto& first = blocks[static_cast<size_t>(block)];
+                const auto& end = blocks[static_cast<size_t>(last)];
+
+                spanFirst = spanLast = -1;
+                scratch.resize(static_cast<size_t>(end.offset + end.size - first.offset));
+                if (!container->readBytes(first.offset, scratch.data(), scratch.size()))
+                    return false;
+
+                spanFirst = block;
+                spanLast = last;
+            }
+
+            const auto& location = blocks[static_cast<size_t>(block)];
+            const int64_t blockStart = int64_t(block) * LosslessCodec::blockFrames;
+            const int framesInBlock = static_cast<int>(std::min<int64_t>(LosslessCodec::blockFrames, entry.totalFrames - blockStart));
+
+            decodedBlock = -1;
+            if (!LosslessCodec::decodeBlock(scratch.data() + (location.offset - blocks[static_cast<size_t>(spanFirst)].offset),
+                                            location.size, entry.numChannels, framesInBlock, decodedChannels.data()))
+                return false;
+
+            decodedBlock = block;
+            return true;
+        }
+
+        void decodePcm(int channel, int frames, float* dest) const
+        {
+            const int bytesPerFrame = entry.getBytesPerFrame();
+            const uint8_t* source = scratch.data() + channel * (entry.bitsPerSample / 8);
+
+            if (entry.isFloat)
+            {
+                for (int i = 0; i < frames; ++i, source += bytesPerFrame)
+                    std::memcpy(dest + i, source, sizeof(float));
+            }
+            else if (entry.bitsPerSample == 16)
+            {
+                for (int i = 0; i < frames; ++i, source += bytesPerFrame)
+                    dest[i] = static_cast<float>(static_cast<int16_t>(source[0] | (source[1] << 8))) / 32768.0f;
+            }
+            else
+            {
+                for (int i = 0; i < frames; ++i, source += bytesPerFrame)
+                {
+                    // Sign-extend from the top of a 32-bit word
+                    const auto value = static_cast<int32_t>(static_cast<uint32_t>(source[0]) << 8
+                                                            | static_cast<uint32_t>(source[1]) << 16
+                                                            | static_cast<uint32_t>(source[2]) << 24) >> 8;
+                    dest[i] = static_cast<float>(value) / 8388608.0f;
+                }
+            }
+        }
+
+        std::shared_ptr<SampleContainer> container;
+        const SampleContainer::Entry& entry;
+        std::vector<uint8_t> scratch;   // One reader per voice and thread: no sharing
+
+        // Compressed entries
+        std::vector<BlockLocation> blocks;
+        std::vector<std::vector<int32_t>> decoded;
+        std::vector<int32_t*> decodedChannels;
+        int decodedBlock = -1;
+        int spanFirst = -1, spanLast = -1;   // Blocks held in scratch
+    };
+
+    /** Encode frames of a float buffer as an entry stores them */
+    void encode(const juce::AudioBuffer<float>& buffer, int numFrames, const SampleContainer::Entry& entry,
+                std::vector<uint8_t>& bytes)
+    {
+        const int bytesPerSample = entry.bitsPerSample / 8;
+        bytes.resize(static_cast<size_t>(numFrames * entry.getBytesPerFrame()));
+        uint8_t* out = bytes.data();
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            for (int ch = 0; ch < entry.numChannels; ++ch, out += bytesPerSample)
+            {
+                const float sample = buffer.getSample(ch, i);
+
+                if (entry.isFloat)
+                {
+                    std::memcpy(out, &sample, sizeof(float));
+                    continue;
+                }
+
+                // Integer sources decode to exact multiples of 2^-(bits-1), so this round trip is lossless
+                const double scale = entry.bitsPerSample == 16 ? 32768.0 : 8388608.0;
+                const auto value = static_cast<int32_t>(juce::jlimit(-scale, scale - 1.0, std::round(sample * scale)));
+                for (int b = 0; b < bytesPerSample; ++b)
+                    out[b] = static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * b));
+            }
+        }
+    }
+
+    void writeIndex(juce::OutputStream& out, const std::vector<SampleContainer::Entry>& entries)
+    {
+        for (const auto& entry : entries)
+        {
+            out.writeString(entry.name);
+            out.writeInt(entry.midiNote);
+            out.writeInt(entry.velocity);
+            out.writeInt(entry.roundRobin);
+            out.writeInt(entry.numChannels);
+            out.writeInt(entry.bitsPerSample);
+            out.writeInt(entry.isFloat ? 1 : 0);
+            out.writeInt(entry.compressed ? 1 : 0);
+            out.writeDouble(entry.sampleRate);
+            out.writeInt64(entry.totalFrames);
+            out.writeInt64(entry.headFrames);
+            out.writeInt64(entry.headOffset);
+            out.writeInt64(entry.tailOffset);
+        }
+    }
+}
+
+SampleContainer::~SampleContainer()
+{
+   #if ! JUCE_WINDOWS
+    if (fd >= 0)
+        ::close(fd);
+   #endif
+}
+
+std::shared_ptr<SampleContainer> SampleContainer::open(const juce::File& containerFile)
+{
+    const auto path = containerFile.getFullPathName();
+    const int64_t size = containerFile.getSize();
+    const int64_t modified = containerFile.getLastModificationTime().toMilliseconds();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    // Reuse the open container unless the file was repacked since
+    if (auto existing = registry[path].lock())
+        if (existing->fileSize == size && existing->modificationTime == modified)
+            return existing;
+
+    std::shared_ptr<SampleContainer> container(new SampleContainer());
+    container->file = containerFile;
+    container->fileSize = size;
+    container->modificationTime = modified;
+
+   #if JUCE_WINDOWS
+    container->stream = containerFile.createInputStream();
+    if (container->stream == nullptr)
+        return nullptr;
+   #else
+    container->fd = ::open(path.toRawUTF8(), O_RDONLY | O_CLOEXEC);
+    if (container->fd < 0)
+        return nullptr;
+   #endif
+
+    if (!container->readIndex())
+    {
+        DebugLog::write("SampleContainer: " + path + " is not a valid container");
+        return nullptr;
+    }
+
+    registry[path] = container;
+    return container;
+}
+
+bool SampleContainer::readIndex()
+{
+    uint8_t header[headerBytes];
+    if (!readBytes(0, header, sizeof(header)) || std::memcmp(header, containerMagic, sizeof(containerMagic)) != 0)
+        return false;
+
+    juce::MemoryInputStream headerStream(header + 4, sizeof(header) - 4, false);
+    const int version = headerStream.readInt();
+    const int numEntries = headerStream.readInt();
+    const int indexBytes = headerStream.readInt();
+
+    if (version < 1 || version > containerVersion || numEntries < 0 || indexBytes < 0 || headerBytes + indexBytes > fileSize)
+        return false;
+
+    juce::MemoryBlock index(static_cast<size_t>(indexBytes));
+    if (!readBytes(headerBytes, index.getData(), index.getSize()))
+        return false;
+
+    juce::MemoryInputStream in(index, false);
+    entries.resize(static_cast<size_t>(numEntries));
+
+    for (auto& entry : entries)
+    {
+        entry.name = in.readString();
+        entry.midiNote = in.readInt();
+        entry.velocity = in.readInt();
+        entry.roundRobin = in.readInt();
+        entry.numChannels = in.readInt();
+        entry.bitsPerSample = in.readInt();
+        entry.isFloat = in.readInt() != 0;
+        entry.compressed = version >= 2 && in.readInt() != 0;
+        entry.sampleRate = in.readDouble();
+        entry.totalFrames = in.readInt64();
+        entry.headFrames = in.readInt64();
+        entry.headOffset = in.readInt64();
+        entry.tailOffset = in.readInt64();
+
+        // Never read outside the file, whatever the index says
+        const bool validFormat = entry.isFloat ? entry.bitsPerSample == 32
+                                               : (entry.bitsPerSample == 16 || entry.bitsPerSample == 24);
+        const int64_t bytesPerFrame = entry.getBytesPerFrame();
+        if (!validFormat || entry.numChannels <= 0 || entry.totalFrames < 0
+            || entry.headFrames < 0 || entry.headFrames > entry.totalFrames
+            || entry.headOffset < 0 || entry.tailOffset < 0)
+            return false;
+
+        // Compressed heads are whole blocks; their extents are checked against the block table
+        const bool validExtents = entry.compressed
+            ? (entry.isFloat == false && entry.numChannels <= LosslessCodec::maxChannels
+               && (entry.headFrames == entry.totalFrames || entry.headFrames % LosslessCodec::blockFrames == 0)
+               && entry.headOffset + int64_t(entry.getNumBlocks()) * 4 <= fileSize && entry.tailOffset <= fileSize)
+            : (entry.headOffset + entry.headFrames * bytesPerFrame <= fileSize
+               && entry.tailOffset + (entry.totalFrames - entry.headFrames) * bytesPerFrame <= fileSize);
+        if (!validExtents)
+            return false;
+    }
+
+    return true;
+}
+
+bool SampleContainer::readBytes(int64_t offset, void* destination, size_t numBytes) const
+{
+   #if JUCE_WINDOWS
+    std::lock_guard<std::mutex> lock(streamMutex);
+    return stream->setPosition(offset)
+        && stream->read(destination, static_cast<int>(numBytes)) == static_cast<int>(numBytes);
+   #else
+    auto* dest = static_cast<char*>(destination);
+    while (numBytes > 0)
+    {
+        const auto bytesRead = ::pread(fd, dest, numBytes, static_cast<off_t>(offset));
+        if (bytesRead < 0 && errno == EINTR)
+            continue;
+        if (bytesRead <= 0)
+            return false;
+
+        dest += bytesRead;
+        offset += bytesRead;
+        numBytes -= static_cast<size_t>(bytesRead);
+    }
+    return true;
+   #endif
+}
+
+std::unique_ptr<juce::AudioFormatReader> SampleContainer::createReader(int entryIndex)
+{
+    if (entryIndex < 0 || entryIndex >= static_cast<int>(entries.size()))
+        return nullptr;
+
+    const auto& entry = entries[static_cast<size_t>(entryIndex)];
+    std::vector<BlockLocation> blocks;
+
+    if (entry.compressed)
+    {
+        // The table of block sizes sits in front of the head: head blocks follow it, tail blocks start at tailOffset
+        const int numBlocks = entry.getNumBlocks();
+        juce::MemoryBlock table(static_cast<size_t>(numBlocks) * 4);
+        if (!readBytes(entry.headOffset, table.getData(), table.getSize()))
+            return nullptr;
+
+        juce::MemoryInputStream in(table, false);
+        int64_t offset = entry.headOffset + static_cast<int64_t>(table.getSize());
+        const auto maxBlockBytes = static_cast<uint32_t>(1 + LosslessCodec::blockFrames * entry.numChannels * 3);
+
+        blocks.resize(static_cast<size_t>(numBlocks));
+        for (int b = 0; b < numBlocks; ++b)
+        {
+            if (b == entry.getHeadBlocks())
+                offset = entry.tailOffset;
+
+            auto& block = blocks[static_cast<size_t>(b)];
+            block.offset = offset;
+            block.size = static_cast<uint32_t>(in.readInt());
+            offset += block.size;
+
+            if (block.size == 0 || block.size > maxBlockBytes || offset > fileSize)
+            {
+                DebugLog::write("SampleContainer: bad block table for " + entry.name + " in " + file.getFullPathName());
+                return nullptr;
+            }
+        }
+    }
+
+    return std::make_unique<ContainerReader>(shared_from_this(), entryIndex, std::move(blocks));
+}
+
+juce::String SampleContainer::getEntryPath(const juce::File& container, int entryIndex)
+{
+    return container.getFullPathName() + "#" + juce::String(entryIndex);
+}
+
+bool SampleContainer::parseEntryPath(const juce::String& samplePath, juce::String& containerPath, int& entryIndex)
+{
+    const auto path = samplePath.upToLastOccurrenceOf("#", false, false);
+    const auto index = samplePath.fromLastOccurrenceOf("#", false, false);
+
+    if (path.length() == samplePath.length() || !path.endsWithIgnoreCase(fileExtension)
+        || index.isEmpty() || !index.containsOnly("0123456789"))
+        return false;
+
+    containerPath = path;
+    entryIndex = index.getIntValue();
+    return true;
+}
+
+std::unique_ptr<juce::AudioFormatReader> SampleContainer::createReaderFor(juce::AudioFormatManager& formatManager,
+                                                                         const juce::String& samplePath)
+{
+    juce::String containerPath;
+    int entryIndex = 0;
+    if (parseEntryPath(samplePath, containerPath, entryIndex))
+    {
+        auto container = open(juce::File(containerPath));
+        return container != nullptr ? container->createReader(entryIndex) : nullptr;
+    }
+
+    juce::File file(samplePath);
+    if (!file.existsAsFile())
+        return nullptr;
+
+    // FLAC indexed at scan time seeks through its frame table instead of searching the file
+    if (file.hasFileExtension("flac"))
+        if (auto index = FlacSeekIndex::open(file, false))
+            if (auto reader = index->createReader())
+                return reader;
+
+    // MP3 reads its decoded copy once the transcode cache has one
+    if (TranscodeCache::needsTranscode(file))
+        if (const auto copy = TranscodeCache::findCopy(file); copy != juce::File())
+            if (auto* reader = formatManager.createReaderFor(copy))
+                return std::unique_ptr<juce::AudioFormatReader>(reader);
+
+    return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+}
+
+juce::File SampleContainer::findInFolder(const juce::File& folder)
+{
+    auto containers = folder.findChildFiles(juce::File::findFiles, false, juce::String("*") + fileExtension);
+    if (containers.isEmpty())
+        return {};
+
+    containers.sort();
+    return containers[0];
+}
+
+juce::Result SampleContainer::pack(const juce::File& folder, const juce::File& destination, int64_t headBytes, bool compress)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    juce::Array<juce::File> audioFiles;
+    folder.findChildFiles(audioFiles, juce::File::findFiles, false, "*.wav;*.aif;*.aiff;*.flac;*.mp3");
+
+    struct Source
+    {
+        juce::File file;
+        Entry entry;
+        std::vector<uint32_t> blockSizes;   // Compressed entries
+    };
+    std::vector<Source> sources;
+
+    for (const auto& audioFile : audioFiles)
+    {
+        Source source { audioFile, {}, {} };
+        auto& entry = source.entry;
+        if (!SampleFileName::parse(audioFile.getFileName(), entry.midiNote, entry.velocity, entry.roundRobin))
+            continue;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(audioFile));
+        if (reader == nullptr || reader->numChannels == 0)
+            continue;
+
+        // Keep integer sources at their own depth; anything else (float, 32-bit, decoded mp3) as float
+        entry.name = audioFile.getFileNameWithoutExtension();
+        entry.numChannels = static_cast<int>(reader->numChannels);
+        entry.isFloat = reader->usesFloatingPointData || reader->bitsPerSample > 24;
+        entry.bitsPerSample = entry.isFloat ? 32 : (reader->bitsPerSample <= 16 ? 16 : 24);
+        entry.compressed = compress && !entry.isFloat && entry.numChannels <= LosslessCodec::maxChannels;
+        entry.sampleRate = reader->sampleRate;
+        entry.totalFrames = static_cast<int64_t>(reader->lengthInSamples);
+        entry.headFrames = std::min(entry.totalFrames, std::max<int64_t>(0, headBytes) / entry.getBytesPerFrame());
+
+        // Compressed heads hold whole blocks
+        if (entry.compressed)
+        {
+            const int64_t blockFrames = LosslessCodec::blockFrames;
+            entry.headFrames = std::min(entry.totalFrames, (entry.headFrames + blockFrames - 1) / blockFrames * blockFrames);
+        }
+
+        sources.push_back(std::move(source));
+    }
+
+    if (sources.empty())
+        return juce::Result::fail("No samples found in " + folder.getFullPathName());
+
+    // Playback-likely order: every note's first round robin before any note's second
+    std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b)
+    {
+        return std::make_tuple(a.entry.roundRobin, a.entry.midiNote, a.entry.velocity)
+             < std::make_tuple(b.entry.roundRobin, b.entry.midiNote, b.entry.velocity);
+    });
+
+    std::vector<Entry> entries;
+    for (const auto& source : sources)
+        entries.push_back(source.entry);
+
+    int64_t totalBytes = 0;
+    juce::TemporaryFile temp(destination);
+    {
+        juce::FileOutputStream out(temp.getFile());
+        if (out.failedToOpen())
+            return juce::Result::fail("Could not create " + temp.getFile().getFullPathName());
+
+        // Compressed sizes aren't known up front: the index and block tables are written as
+        // placeholders (same size whatever the offsets) and rewritten once the audio is in
+        juce::MemoryOutputStream sizingStream;
+        writeIndex(sizingStream, entries);
+        const auto indexBytes = static_cast<int64_t>(sizingStream.getDataSize());
+
+        out.write(containerMagic, sizeof(containerMagic));
+        out.writeInt(containerVersion);
+        out.writeInt(static_cast<int>(entries.size()));
+        out.writeInt(static_cast<int>(indexBytes));
+        writeIndex(out, entries);
+
+        juce::AudioBuffer<float> buffer;
+        std::vector<uint8_t> bytes;
+        std::vector<std::vector<int32_t>> samples;
+        std::vector<const int32_t*> sampleChannels;
+
+        auto padToAlignment = [&out]
+        {
+            const auto position = out.getPosition();
+            out.writeRepeatedByte(0, static_cast<size_t>(alignUp(position) - position));
+            return alignUp(position);
+        };
+
+        // Appends frames [start, end) of a source as PCM or compressed blocks (start and end on block boundaries)
+        auto writeFrames = [&](Source& source, const Entry& entry, int64_t start, int64_t end)
+        {
+            if (start >= end)
+                return true;
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(source.file));
+            if (reader == nullptr)
+                return false;
+
+            constexpr int framesPerRead = 16 * LosslessCodec::blockFrames;
+            buffer.setSize(entry.numChannels, framesPerRead, false, false, true);
+
+            for (int64_t frame = start; frame < end; frame += framesPerRead)
+            {
+                const int numFrames = static_cast<int>(std::min<int64_t>(framesPerRead, end - frame));
+                if (!reader->read(&buffer, 0, numFrames, frame, true, true))
+                    return false;
+
+                if (!entry.compressed)
+                {
+                    encode(buffer, numFrames, entry, bytes);
+                    if (!out.write(bytes.data(), bytes.size()))
+                        return false;
+                    continue;
+                }
+
+                // Integer sources decode to exact multiples of 2^-(bits-1)
+                const double scale = entry.bitsPerSample == 16 ? 32768.0 : 8388608.0;
+                samples.resize(static_cast<size_t>(entry.numChannels));
+                sampleChannels.clear();
+                for (int ch = 0; ch < entry.numChannels; ++ch)
+                {
+                    auto& channel = samples[static_cast<size_t>(ch)];
+                    channel.resize(static_cast<size_t>(numFrames));
+                    for (int i = 0; i < numFrames; ++i)
+                        channel[static_cast<size_t>(i)] = static_cast<int32_t>(juce::jlimit(-scale, scale - 1.0, std::round(buffer.getSample(ch, i) * scale)));
+                    sampleChannels.push_back(channel.data());
+                }
+
+                for (int blockStart = 0; blockStart < numFrames; blockStart += LosslessCodec::blockFrames)
+                {
+                    std::vector<const int32_t*> blockChannels;
+                    for (const auto* channel : sampleChannels)
+                        blockChannels.push_back(channel + blockStart);
+
+                    bytes.clear();
+                    LosslessCodec::encodeBlock(blockChannels.data(), entry.numChannels,
+                                               std::min(LosslessCodec::blockFrames, numFrames - blockStart), bytes);
+                    source.blockSizes.push_back(static_cast<uint32_t>(bytes.size()));
+                    if (!out.write(bytes.data(), bytes.size()))
+                        return false;
+                }
+            }
+            return true;
+        };
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            entries[i].headOffset = padToAlignment();
+            if (entries[i].compressed)
+                out.writeRepeatedByte(0, static_cast<size_t>(entries[i].getNumBlocks()) * 4);
+
+            if (!writeFrames(sources[i], entries[i], 0, entries[i].headFrames))
+                return juce::Result::fail("Could not read " + sources[i].file.getFullPathName());
+        }
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            entries[i].tailOffset = padToAlignment();
+            if (!writeFrames(sources[i], entries[i], entries[i].headFrames, entries[i].totalFrames))
+                return juce::Result::fail("Could not read " + sources[i].file.getFullPathName());
+        }
+
+        totalBytes = padToAlignment();
+
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            if (!entries[i].compressed)
+                continue;
+
+            out.setPosition(entries[i].headOffset);
+            for (auto size : sources[i].blockSizes)
+                out.writeInt(static_cast<int>(size));
+        }
+
+        out.setPosition(headerBytes);
+        writeIndex(out, entries);
+        out.flush();
+
+        if (out.getStatus().failed())
+            return juce::Result::fail("Writing " + temp.getFile().getFullPathName() + " failed: " + out.getStatus().getErrorMessage());
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+        return juce::Result::fail("Could not replace " + destination.getFullPathName());
+
+    int64_t pcmBytes = 0;
+    for (const auto& entry : entries)
+        pcmBytes += entry.totalFrames * entry.getBytesPerFrame();
+
+    DebugLog::write("SampleContainer: packed " + juce::String(static_cast<int>(entries.size())) + " samples from "
+                    + folder.getFullPathName() + " into " + destination.getFullPathName()
+                    + " (" + juce::String(totalBytes / (1024 * 1024)) + " MB, "
+                    + juce::String(pcmBytes / (1024 * 1024)) + " MB as PCM)");
+    return juce::Result::ok();
+}
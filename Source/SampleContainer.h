@@ -0,0 +1,110 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "LosslessCodec.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * SampleContainer is a whole library folder packed into one file (".hspack"): an index up
+ * front and every sample's audio behind it, so loading a library is one open and one index
+ * read instead of a directory scan and a header parse per sample file.
+ *
+ * Layout (little-endian):
+ * - Header (magic, version, entry count, index size), then the index
+ * - Head region: the first headFrames of every sample, back to back, each sector aligned.
+ *   Preloads come from here, so a preload pass reads one mostly sequential stretch.
+ * - Tail region: the rest of every sample, each page aligned, read by the disk streamer
+ * - Both regions are in playback-likely order: round robin 1 of every note first, then
+ *   round robin 2, and so on
+ * - Integer audio (16/24-bit) is stored losslessly compressed (see LosslessCodec) in blocks of
+ *   LosslessCodec::blockFrames, with a table of block sizes in front of each head. Float audio,
+ *   and everything in containers packed without compression, is interleaved PCM at the
+ *   source's bit depth.
+ *
+ * Every reader of a container shares its one file descriptor (positioned reads), which stays
+ * open while any reader or engine holds the container. A sample inside a container is named
+ * by an entry path, "<container path>#<entry index>", which goes wherever a sample file path
+ * goes (PreloadedSample::filePath); createReaderFor() opens either kind.
+ */
+class SampleContainer : public std::enable_shared_from_this<SampleContainer>
+{
+public:
+    static constexpr const char* fileExtension = ".hspack";
+    static constexpr int alignment = 4096;
+    static constexpr int64_t defaultHeadBytes = 256 * 1024;   // Covers the largest adaptive preload tier
+
+    struct Entry
+    {
+        juce::String name;          // Source file name without extension
+        int midiNote = 0;
+        int velocity = 0;
+        int roundRobin = 0;
+        int numChannels = 0;
+        int bitsPerSample = 16;     // 16, 24 or 32
+        bool isFloat = false;       // 32-bit float rather than integer
+        bool compressed = false;    // LosslessCodec blocks rather than PCM
+        double sampleRate = 44100.0;
+        int64_t totalFrames = 0;
+        int64_t headFrames = 0;     // Frames stored in the head region
+        int64_t headOffset = 0;     // File offset of the head
+        int64_t tailOffset = 0;     // File offset of frame headFrames onwards
+
+        int getBytesPerFrame() const { return numChannels * bitsPerSample / 8; }
+        int getNumBlocks() const { return static_cast<int>((totalFrames + LosslessCodec::blockFrames - 1) / LosslessCodec::blockFrames); }
+        int getHeadBlocks() const { return static_cast<int>((headFrames + LosslessCodec::blockFrames - 1) / LosslessCodec::blockFrames); }
+    };
+
+    ~SampleContainer();
+
+    /** Open a container and read its index, or nullptr if the file isn't a readable container.
+        Opening a container that is already open returns the same object. */
+    static std::shared_ptr<SampleContainer> open(const juce::File& file);
+
+    const juce::File& getFile() const { return file; }
+    const std::vector<Entry>& getEntries() const { return entries; }
+
+    /** Read bytes at a file offset (any thread, no shared file position) */
+    bool readBytes(int64_t offset, void* destination, size_t numBytes) const;
+
+    /** A float reader for one entry, keeping the container open */
+    std::unique_ptr<juce::AudioFormatReader> createReader(int entryIndex);
+
+    /** Entry paths: "<container>#<index>" */
+    static juce::String getEntryPath(const juce::File& container, int entryIndex);
+    static bool parseEntryPath(const juce::String& samplePath, juce::String& containerPath, int& entryIndex);
+
+    /** Open a reader for a sample path: a container entry or a plain audio file (FLAC through its
+        FlacSeekIndex, MP3 from its TranscodeCache copy, when they have one) */
+    static std::unique_ptr<juce::AudioFormatReader> createReaderFor(juce::AudioFormatManager& formatManager,
+                                                                    const juce::String& samplePath);
+
+    /** The container of a library folder (its first .hspack file), or File() if it has none */
+    static juce::File findInFolder(const juce::File& folder);
+
+    /** Pack the samples of a folder (named as SampleFileName::parse expects) into a container,
+        compressing integer audio unless compress is false */
+    static juce::Result pack(const juce::File& folder, const juce::File& destination,
+                             int64_t headBytes = defaultHeadBytes, bool compress = true);
+
+private:
+    SampleContainer() = default;
+
+    bool readIndex();
+
+    juce::File file;
+    int64_t fileSize = 0;
+    int64_t modificationTime = 0;
+    std::vector<Entry> entries;
+
+   #if JUCE_WINDOWS
+    // No positioned reads through JUCE on Windows: one stream, seek and read under a lock
+    std::unique_ptr<juce::FileInputStream> stream;
+    mutable std::mutex streamMutex;
+   #else
+    int fd = -1;
+   #endif
+};
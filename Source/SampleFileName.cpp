@@ -0,0 +1,87 @@
+#include "SampleFileName.h"
+
+int SampleFileName::parseNoteName(const juce::String& noteName)
+{
+    if (noteName.isEmpty())
+        return -1;
+
+    juce::String upper = noteName.toUpperCase();
+    int index = 0;
+
+    char noteLetter = static_cast<char>(upper[0]);
+    int noteBase = -1;
+    switch (noteLetter)
+    {
+        case 'C': noteBase = 0; break;
+        case 'D': noteBase = 2; break;
+        case 'E': noteBase = 4; break;
+        case 'F': noteBase = 5; break;
+        case 'G': noteBase = 7; break;
+        case 'A': noteBase = 9; break;
+        case 'B': noteBase = 11; break;
+        default: return -1;
+    }
+    index++;
+
+    if (index < upper.length())
+    {
+        if (upper[index] == '#')
+        {
+            noteBase++;
+            index++;
+        }
+        else if (upper[index] == 'B' && index + 1 < upper.length() && juce::CharacterFunctions::isDigit(upper[index + 1]))
+        {
+            noteBase--;
+            index++;
+        }
+        else if (noteName[index] == 'b' && index + 1 < noteName.length() && juce::CharacterFunctions::isDigit(noteName[index + 1]))
+        {
+            noteBase--;
+            index++;
+        }
+    }
+
+    juce::String octaveStr = noteName.substring(index);
+    if (octaveStr.isEmpty() || !octaveStr.containsOnly("0123456789-"))
+        return -1;
+
+    int octave = octaveStr.getIntValue();
+    int midiNote = (octave + 1) * 12 + noteBase;
+
+    if (midiNote < 0 || midiNote > 127)
+        return -1;
+
+    return midiNote;
+}
+
+bool SampleFileName::parse(const juce::String& fileName, int& note, int& velocity, int& roundRobin)
+{
+    juce::String baseName = fileName.upToLastOccurrenceOf(".", false, false);
+
+    juce::StringArray parts;
+    parts.addTokens(baseName, "_", "");
+
+    if (parts.size() < 3)
+        return false;
+
+    note = parseNoteName(parts[0]);
+    if (note < 0)
+        return false;
+
+    juce::String velStr = parts[1];
+    if (velStr.length() < 1 || !velStr.containsOnly("0123456789"))
+        return false;
+    velocity = velStr.getIntValue();
+    if (velocity < 1 || velocity > 127)
+        return false;
+
+    juce::String rrStr = parts[2];
+    if (rrStr.length() < 1 || !rrStr.containsOnly("0123456789"))
+        return false;
+    roundRobin = rrStr.getIntValue();
+    if (roundRobin < 1)
+        return false;
+
+    return true;
+}
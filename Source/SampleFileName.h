@@ -0,0 +1,18 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * Sample file naming: NOTE_VELOCITY_ROUNDROBIN.ext, e.g. "C#4_100_2.wav" or "Bb3_64_1.flac".
+ *
+ * Shared by the library scan (SharedSamplePool), the container packer (SampleContainer) and
+ * the pack tool, which builds without the engine.
+ */
+struct SampleFileName
+{
+    /** Note name to MIDI note number ("C4" -> 60, "G#6" -> 104), or -1 if it isn't one */
+    static int parseNoteName(const juce::String& noteName);
+
+    /** Fills note, velocity and round robin from a sample file name; false if it doesn't follow the scheme */
+    static bool parse(const juce::String& fileName, int& note, int& velocity, int& roundRobin);
+};
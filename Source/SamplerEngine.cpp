@@ -1,39 +1,85 @@
 #include "SamplerEngine.h"
+#include "DebugLog.h"
+#include "SharedPreloadStore.h"
+#include "PreloadPack.h"
+#include "SampleFileName.h"
 #include <algorithm>
 #include <cmath>
+#include <bitset>
 #include <cstdint>
 
 // Debug logging
-static void engineDebugLog(const juce::String& msg)
-{
-    auto logFile = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
-                       .getChildFile("sampler_streaming_debug.txt");
-    auto timestamp = juce::Time::getCurrentTime().toString(true, true, true, true);
-    logFile.appendText("[" + timestamp + "] " + msg + "\n");
-}
+const std::map<int, NoteMapping> SamplerEngine::noNoteMappings;
 
 SamplerEngine::SamplerEngine()
 {
-    formatManager.registerBasicFormats();
+    // Build the sinc interpolation tables now rather than on the audio thread at first note
+    Interpolation::SincTable::get();
 
-    // Initialize disk streamer
-    diskStreamer = std::make_unique<DiskStreamer>();
-    diskStreamer->setAudioFormatManager(&formatManager);
+    // Join the process-wide disk streamer and register streaming voices with it
+    streamingClient = diskStreamer->registerClient(&ringPool, &hibernating);
 
-    // Register streaming voices with disk streamer
     for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
     {
-        diskStreamer->registerVoice(i, &streamingVoices[static_cast<size_t>(i)]);
+        streamingVoices[static_cast<size_t>(i)].setRingBufferPool(&ringPool);
+        diskStreamer->registerVoice(streamingClient, i, &streamingVoices[static_cast<size_t>(i)]);
     }
+
+    // Resize preloads when the budget's limit or the usage tiers move; free replaced ones once they're safe to drop
+    budgetClient = preloadBudget->registerClient([this](bool limitChanged)
+    {
+        // A load in progress takes the budget's limit once its preload pass is done
+        if (loadingState == LoadingState::Loading)
+        {
+            releaseRetiredPreloads();
+            return;
+        }
+
+        // Hibernation: park the preloads once idle or bypassed, bring them back once woken
+        // (or once the engine plays again after metadata only)
+        if (wakeRequested.exchange(false))
+        {
+            updatePreloadedSamples();
+            return;
+        }
+
+        if (hibernating.load(std::memory_order_acquire))
+        {
+            releaseRetiredPreloads();
+            return;
+        }
+
+        if (shouldHibernate())
+        {
+            enterHibernation();
+            return;
+        }
+
+        bool tiersChanged = false;
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        if (now - lastTierUpdateTime >= preloadTierIntervalMs)
+        {
+            lastTierUpdateTime = now;
+            tiersChanged = updatePreloadTiers(true);
+        }
+
+        // Purging: preload what was played for the first time since the last update
+        const bool learnedChanged = learnedSamplesChanged.exchange(false) && purgeUnusedSamples;
+
+        if (limitChanged || tiersChanged || learnedChanged)
+            updatePreloadedSamples();
+        else
+            releaseRetiredPreloads();
+    });
 }
 
 SamplerEngine::~SamplerEngine()
 {
-    // Stop disk streaming thread
-    if (diskStreamer)
-    {
-        diskStreamer->stopThread();
-    }
+    // Leave the preload budget first: its callbacks touch the samples
+    preloadBudget->unregisterClient(budgetClient);
+
+    // Leave the shared disk streamer (waits for reads into our voices to finish)
+    diskStreamer->unregisterClient(streamingClient);
 
     // Wait for any loading thread to finish
     if (loadingThread && loadingThread->joinable())
@@ -42,7 +88,7 @@ SamplerEngine::~SamplerEngine()
     }
 }
 
-void SamplerEngine::prepareToPlay(double sampleRate, int samplesPerBlock)
+void SamplerEngine::prepareToPlay(double sampleRate, int samplesPerBlock, int numOutputChannels)
 {
     currentSampleRate = sampleRate;
 
@@ -52,11 +98,16 @@ void SamplerEngine::prepareToPlay(double sampleRate, int samplesPerBlock)
         voice.prepareToPlay(sampleRate, samplesPerBlock);
     }
 
-    // Start disk streamer
-    if (diskStreamer)
+    renderPool.prepare(sampleRate, samplesPerBlock, numOutputChannels);
+
+    // A library rendered at the previous host rate would be resampled per voice again
+    bool rateChanged = false;
     {
-        diskStreamer->startThread();
+        std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+        rateChanged = renderAtHostRate && library != nullptr && library->renderedRate != sampleRate;
     }
+    if (rateChanged && loadingState == LoadingState::Loaded)
+        loadSamplesFromFolder(juce::File(loadedFolderPath));
 }
 
 void SamplerEngine::setADSR(float attack, float decay, float sustain, float release)
@@ -65,20 +116,31 @@ void SamplerEngine::setADSR(float attack, float decay, float sustain, float rele
     adsrParams.decay = juce::jmax(0.001f, decay);
     adsrParams.sustain = juce::jlimit(0.0f, 1.0f, sustain);
     adsrParams.release = juce::jmax(0.001f, release);
+    adsrParamsVersion.fetch_add(1, std::memory_order_release);
+}
+
+juce::ADSR::Parameters SamplerEngine::getADSRParameters() const
+{
+    juce::ADSR::Parameters params;
+    params.attack = adsrParams.attack;
+    params.decay = adsrParams.decay;
+    params.sustain = adsrParams.sustain;
+    params.release = adsrParams.release;
+    return params;
 }
 
 bool SamplerEngine::isLoaded() const
 {
     std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
-    return loadingState == LoadingState::Loaded && !noteMappings.empty();
+    return loadingState == LoadingState::Loaded && !noteMappings->empty();
 }
 
 bool SamplerEngine::isNoteAvailable(int midiNote) const
 {
     std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
 
-    auto it = noteMappings.find(midiNote);
-    if (it == noteMappings.end())
+    auto it = noteMappings->find(midiNote);
+    if (it == noteMappings->end())
         return false;
 
     const auto& mapping = it->second;
@@ -89,8 +151,8 @@ bool SamplerEngine::noteHasOwnSamples(int midiNote) const
 {
     std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
 
-    auto it = noteMappings.find(midiNote);
-    if (it == noteMappings.end())
+    auto it = noteMappings->find(midiNote);
+    if (it == noteMappings->end())
         return false;
 
     return !it->second.velocityLayers.empty();
@@ -102,15 +164,15 @@ std::vector<int> SamplerEngine::getVelocityLayers(int midiNote) const
 
     std::vector<int> velocities;
 
-    auto it = noteMappings.find(midiNote);
-    if (it == noteMappings.end())
+    auto it = noteMappings->find(midiNote);
+    if (it == noteMappings->end())
         return velocities;
 
     const auto& mapping = it->second;
     int actualNote = (mapping.fallbackNote >= 0) ? mapping.fallbackNote : midiNote;
 
-    auto actualIt = noteMappings.find(actualNote);
-    if (actualIt == noteMappings.end())
+    auto actualIt = noteMappings->find(actualNote);
+    if (actualIt == noteMappings->end())
         return velocities;
 
     for (const auto& layer : actualIt->second.velocityLayers)
@@ -163,15 +225,15 @@ int SamplerEngine::getVelocityLayerIndex(int midiNote, int velocity) const
 {
     std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
 
-    auto it = noteMappings.find(midiNote);
-    if (it == noteMappings.end())
+    auto it = noteMappings->find(midiNote);
+    if (it == noteMappings->end())
         return -1;
 
     const auto& mapping = it->second;
     int actualNote = (mapping.fallbackNote >= 0) ? mapping.fallbackNote : midiNote;
 
-    auto actualIt = noteMappings.find(actualNote);
-    if (actualIt == noteMappings.end())
+    auto actualIt = noteMappings->find(actualNote);
+    if (actualIt == noteMappings->end())
         return -1;
 
     const auto& actualMapping = actualIt->second;
@@ -179,8 +241,8 @@ int SamplerEngine::getVelocityLayerIndex(int midiNote, int velocity) const
     if (totalLayers == 0)
         return -1;
 
-    // Apply velocity layer limit (same logic as findStreamingSample)
-    int effectiveLayers = std::min(velocityLayerLimit, totalLayers);
+    // Apply velocity layer limit (same logic as findStreamingSample; cold start plays every layer)
+    int effectiveLayers = coldStartEnabled ? totalLayers : std::min(velocityLayerLimit, totalLayers);
 
     // Map incoming velocity (1-127) to limited layer index evenly
     int layerIndex = ((velocity - 1) * effectiveLayers) / 127;
@@ -191,88 +253,12 @@ int SamplerEngine::getVelocityLayerIndex(int midiNote, int velocity) const
 
 int SamplerEngine::parseNoteName(const juce::String& noteName)
 {
-    if (noteName.isEmpty())
-        return -1;
-
-    juce::String upper = noteName.toUpperCase();
-    int index = 0;
-
-    char noteLetter = static_cast<char>(upper[0]);
-    int noteBase = -1;
-    switch (noteLetter)
-    {
-        case 'C': noteBase = 0; break;
-        case 'D': noteBase = 2; break;
-        case 'E': noteBase = 4; break;
-        case 'F': noteBase = 5; break;
-        case 'G': noteBase = 7; break;
-        case 'A': noteBase = 9; break;
-        case 'B': noteBase = 11; break;
-        default: return -1;
-    }
-    index++;
-
-    if (index < upper.length())
-    {
-        if (upper[index] == '#')
-        {
-            noteBase++;
-            index++;
-        }
-        else if (upper[index] == 'B' && index + 1 < upper.length() && juce::CharacterFunctions::isDigit(upper[index + 1]))
-        {
-            noteBase--;
-            index++;
-        }
-        else if (noteName[index] == 'b' && index + 1 < noteName.length() && juce::CharacterFunctions::isDigit(noteName[index + 1]))
-        {
-            noteBase--;
-            index++;
-        }
-    }
-
-    juce::String octaveStr = noteName.substring(index);
-    if (octaveStr.isEmpty() || !octaveStr.containsOnly("0123456789-"))
-        return -1;
-
-    int octave = octaveStr.getIntValue();
-    int midiNote = (octave + 1) * 12 + noteBase;
-
-    if (midiNote < 0 || midiNote > 127)
-        return -1;
-
-    return midiNote;
+    return SampleFileName::parseNoteName(noteName);
 }
 
 bool SamplerEngine::parseFileName(const juce::String& fileName, int& note, int& velocity, int& roundRobin)
 {
-    juce::String baseName = fileName.upToLastOccurrenceOf(".", false, false);
-
-    juce::StringArray parts;
-    parts.addTokens(baseName, "_", "");
-
-    if (parts.size() < 3)
-        return false;
-
-    note = parseNoteName(parts[0]);
-    if (note < 0)
-        return false;
-
-    juce::String velStr = parts[1];
-    if (velStr.length() < 1 || !velStr.containsOnly("0123456789"))
-        return false;
-    velocity = velStr.getIntValue();
-    if (velocity < 1 || velocity > 127)
-        return false;
-
-    juce::String rrStr = parts[2];
-    if (rrStr.length() < 1 || !rrStr.containsOnly("0123456789"))
-        return false;
-    roundRobin = rrStr.getIntValue();
-    if (roundRobin < 1)
-        return false;
-
-    return true;
+    return SampleFileName::parse(fileName, note, velocity, roundRobin);
 }
 
 void SamplerEngine::loadSamplesFromFolder(const juce::File& folder)
@@ -285,6 +271,12 @@ void SamplerEngine::loadSamplesFromFolder(const juce::File& folder)
 
     loadedFolderPath = folder.getFullPathName();
 
+    {
+        std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+        requestedVelocityLayerLimit = 0;
+        requestedRoundRobinLimit = 0;
+    }
+
     if (!folder.isDirectory())
         return;
 
@@ -295,213 +287,237 @@ void SamplerEngine::loadSamplesFromFolder(const juce::File& folder)
 
 void SamplerEngine::loadSamplesInBackground(const juce::String& folderPath)
 {
-    engineDebugLog("Loading samples from: " + folderPath);
+    DebugLog::write("Loading samples from: " + folderPath);
 
     // Reset underrun counter
     StreamingVoice::resetUnderrunCount();
 
-    // Stop all streaming voices and unregister from DiskStreamer
+    // Notes stay silent until their preloads from the new library have landed
+    for (int note = 0; note < 128; ++note)
+    {
+        notePlayable[static_cast<size_t>(note)].store(false, std::memory_order_release);
+        noteLoadProgress[static_cast<size_t>(note)].store(0.0f, std::memory_order_relaxed);
+    }
+    loadProgress.store(0.0f, std::memory_order_relaxed);
+
+    // Stop all streaming voices and unregister from DiskStreamer, so no new reads are queued.
+    // A read already in flight holds its sample through the ring lease, which keeps the old
+    // sample array alive once it's retired below.
     for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
     {
         streamingVoices[static_cast<size_t>(i)].stopVoice(false);
-        if (diskStreamer)
-            diskStreamer->unregisterVoice(i);
+        diskStreamer->unregisterVoice(streamingClient, i);
     }
 
-    juce::Thread::sleep(20);
-
-    juce::File folder(folderPath);
-
-    std::vector<StreamingSample> tempSamples;
-
     totalInstrumentFileSize = 0;
     preloadMemoryBytes = 0;
-    int64_t tempTotalSize = 0;
-    int tempMaxRoundRobins = 1;
+    ringPool.setMinimumReserve(0);
 
-    juce::Array<juce::File> audioFiles;
-    folder.findChildFiles(audioFiles, juce::File::findFiles, false, "*.wav;*.aif;*.aiff;*.flac;*.mp3");
+    // Scan the folder, or share the scan of another instance that already loaded it
+    // (with host-rate rendering, the copies of its samples at the host rate)
+    auto newLibrary = samplePool->acquireLibrary(folderPath, renderAtHostRate ? currentSampleRate : 0.0);
 
-    engineDebugLog("Found " + juce::String(audioFiles.size()) + " audio files");
+    std::vector<StreamingSample> tempSamples;
+    tempSamples.reserve(newLibrary->samples.size());
 
-    for (const auto& file : audioFiles)
+    for (size_t i = 0; i < newLibrary->samples.size(); ++i)
     {
-        int note, velocity, roundRobin;
-        if (!parseFileName(file.getFileName(), note, velocity, roundRobin))
-            continue;
-
-        // Track max round-robin found
-        if (roundRobin > tempMaxRoundRobins)
-            tempMaxRoundRobins = roundRobin;
-
-        tempTotalSize += file.getSize();
-
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
-        if (!reader)
-            continue;
+        const auto& ls = newLibrary->samples[i];
 
         StreamingSample ss;
-        ss.midiNote = note;
-        ss.velocity = velocity;
-        ss.roundRobin = roundRobin;
-        ss.velocityLayerIndex = -1;  // Will be set after building noteMappings
+        ss.preload = ls.metadata;
+        ss.midiNote = ls.midiNote;
+        ss.velocity = ls.velocity;
+        ss.roundRobin = ls.roundRobin;
+        ss.velocityLayerIndex = ls.velocityLayerIndex;
         ss.isPreloaded = false;      // Don't preload yet - will be done by updatePreloadedSamples
-
-        ss.preload.filePath = file.getFullPathName();
-        ss.preload.sampleRate = reader->sampleRate;
-        ss.preload.numChannels = static_cast<int>(reader->numChannels);
-        ss.preload.totalSampleFrames = static_cast<int64_t>(reader->lengthInSamples);
-        ss.preload.name = file.getFileNameWithoutExtension();
-        ss.preload.rootNote = note;
-        ss.preload.lowNote = note;
-        ss.preload.highNote = note;
-        ss.preload.lowVelocity = velocity;
-        ss.preload.highVelocity = velocity;
-        ss.preload.preloadSizeFrames = 0;  // Will be set when actually preloaded
+        ss.librarySampleIndex = static_cast<int>(i);
 
         tempSamples.push_back(std::move(ss));
     }
 
     {
         std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+
+        // The learned set carries over to a reload of the same folder only
+        syncLearnedSamples();
+        if (folderPath != learnedFolderPath)
+        {
+            learnedSamples.clear();
+            learnedFolderPath = folderPath;
+        }
+
+        for (auto& ss : tempSamples)
+            ss.playStats.learned.store(learnedSamples.count({ ss.midiNote, ss.velocity, ss.roundRobin }) > 0, std::memory_order_relaxed);
+
+        // The old library's preloads go the usual way: a voice may still be playing one. So does the
+        // array itself (cold-started voices and disk reads refer to its metadata) and the library.
+        for (auto& ss : streamingSamples)
+            retirePreload(ss);
+
+        RetiredPreload previous;
+        previous.samples = std::make_shared<const std::vector<StreamingSample>>(std::move(streamingSamples));
+        previous.library = std::move(library);
+        previous.audioBlockEpoch = audioBlockEpoch.load();
+        retiredPreloads.push_back(std::move(previous));
+
         streamingSamples = std::move(tempSamples);
+        library = newLibrary;
+        noteMappings = &library->noteMappings;
+
+        // Default to max, unless limits were set since the load began (an engine server's client syncing)
+        maxRoundRobins = library->maxRoundRobins;
+        maxVelocityLayersGlobal = library->maxVelocityLayers;
+        velocityLayerLimit = requestedVelocityLayerLimit > 0 ? juce::jlimit(1, juce::jmax(1, maxVelocityLayersGlobal), requestedVelocityLayerLimit)
+                                                             : maxVelocityLayersGlobal;
+        roundRobinLimit = requestedRoundRobinLimit > 0 ? juce::jlimit(1, juce::jmax(1, maxRoundRobins), requestedRoundRobinLimit)
+                                                       : maxRoundRobins;
     }
 
-    // Build noteMappings for UI
-    std::map<int, NoteMapping> tempMappings;
-    for (const auto& ss : streamingSamples)
-    {
-        auto& noteMapping = tempMappings[ss.midiNote];
-        noteMapping.midiNote = ss.midiNote;
+    totalInstrumentFileSize = library->totalFileSize;
 
-        auto it = std::find_if(noteMapping.velocityLayers.begin(), noteMapping.velocityLayers.end(),
-            [&ss](const VelocityLayer& layer) { return layer.velocityValue == ss.velocity; });
+    DebugLog::write("Loaded " + juce::String(streamingSamples.size()) + " samples (metadata only)");
 
-        if (it == noteMapping.velocityLayers.end())
-        {
-            VelocityLayer newLayer;
-            newLayer.velocityValue = ss.velocity;
-            noteMapping.velocityLayers.push_back(newLayer);
-        }
+    // Re-register voices with DiskStreamer: notes play as their preloads land
+    for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
+    {
+        diskStreamer->registerVoice(streamingClient, i, &streamingVoices[static_cast<size_t>(i)]);
     }
 
-    // Build velocity ranges
-    for (auto& [note, mapping] : tempMappings)
+    // Preload samples that are within the current limits (no play statistics yet: tiers from rate and device)
+    updatePreloadTiers(false);
+    loadPreloadsProgressively();
+
+    loadingState = LoadingState::Loaded;
+}
+
+void SamplerEngine::loadPreloadsProgressively()
+{
+    struct PendingPreload
     {
-        std::sort(mapping.velocityLayers.begin(), mapping.velocityLayers.end(),
-            [](const VelocityLayer& a, const VelocityLayer& b) {
-                return a.velocityValue < b.velocityValue;
-            });
+        size_t sample = 0;
+        int numFrames = 0;
+    };
 
-        for (size_t i = 0; i < mapping.velocityLayers.size(); ++i)
-        {
-            auto& layer = mapping.velocityLayers[i];
-            if (i == 0)
-                layer.velocityRangeStart = 1;
-            else
-                layer.velocityRangeStart = mapping.velocityLayers[i - 1].velocityValue + 1;
-            layer.velocityRangeEnd = layer.velocityValue;
-        }
-    }
+    std::vector<PendingPreload> pending;
+    std::array<int, 128> wanted {};
+    std::array<int, 128> processed {};
+    std::array<std::bitset<128>, 128> layersWanted;
+    std::array<std::bitset<128>, 128> layersProcessed;
+    auto noteIndex = [](int midiNote) { return static_cast<size_t>(juce::jlimit(0, 127, midiNote)); };
 
-    // Build fallbacks
-    for (int n = 0; n < 128; ++n)
     {
-        if (tempMappings.find(n) == tempMappings.end())
+        std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+
+        // Tell the budget what this instance wants before asking it how long each preload may be
+        updatePurgeStandIns();
+        publishPreloadDemand();
+
+        int lowestNote = 127, highestNote = 0;
+        for (size_t i = 0; i < streamingSamples.size(); ++i)
         {
-            int fallback = -1;
-            for (int higher = n + 1; higher < 128; ++higher)
-            {
-                if (tempMappings.find(higher) != tempMappings.end())
-                {
-                    fallback = higher;
-                    break;
-                }
-            }
-            if (fallback >= 0)
-            {
-                tempMappings[n].midiNote = n;
-                tempMappings[n].fallbackNote = fallback;
-            }
+            const auto& ss = streamingSamples[i];
+            lowestNote = std::min(lowestNote, ss.midiNote);
+            highestNote = std::max(highestNote, ss.midiNote);
+
+            if (!shouldSampleBePreloaded(ss))
+                continue;
+
+            pending.push_back({ i, getPreloadFrames(ss) });
+            ++wanted[noteIndex(ss.midiNote)];
+            layersWanted[noteIndex(ss.midiNote)].set(static_cast<size_t>(juce::jlimit(0, 127, ss.velocityLayerIndex)));
         }
-        else
+
+        // Learned samples (the project's recorded usage) first, then round robin by round robin
+        // from the middle of the keyboard outwards, so every note gets one playable round robin early
+        const int centreNote = (lowestNote + highestNote) / 2;
+        auto priority = [this, centreNote](const PendingPreload& preload)
         {
-            tempMappings[n].fallbackNote = -1;
+            const auto& ss = streamingSamples[preload.sample];
+            return std::make_tuple(ss.playStats.learned.load(std::memory_order_relaxed) ? 0 : 1,
+                                   ss.roundRobin, std::abs(ss.midiNote - centreNote), ss.velocityLayerIndex);
+        };
+        std::stable_sort(pending.begin(), pending.end(),
+                         [&priority](const PendingPreload& a, const PendingPreload& b) { return priority(a) < priority(b); });
+
+        // Notes with nothing to preload (metadata only, everything purged) play right away
+        for (const auto& [note, mapping] : *noteMappings)
+        {
+            if (!mapping.velocityLayers.empty() && wanted[noteIndex(note)] == 0)
+                publishNoteLoadState(note, 1.0f, true);
         }
-    }
 
-    {
-        std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
-        noteMappings = std::move(tempMappings);
+        // Playable notes may stream before the pass is done
+        ringPool.setMinimumReserve(ringReserveSlabs);
     }
 
-    totalInstrumentFileSize = tempTotalSize;
-    maxRoundRobins = tempMaxRoundRobins;
+    DebugLog::write("Progressive load: " + juce::String(static_cast<int>(pending.size())) + " preloads");
 
-    // Calculate max velocity layers across all notes
-    int tempMaxVelLayers = 1;
-    for (const auto& [note, mapping] : noteMappings)
+    for (size_t i = 0; i < pending.size(); ++i)
     {
-        int layers = static_cast<int>(mapping.velocityLayers.size());
-        if (layers > tempMaxVelLayers)
-            tempMaxVelLayers = layers;
-    }
-    maxVelocityLayersGlobal = tempMaxVelLayers;
-    velocityLayerLimit = maxVelocityLayersGlobal;  // Default to max
-    roundRobinLimit = maxRoundRobins;  // Default to max
+        const auto& preload = pending[i];
+
+        // Read without the lock, so the UI and settings stay responsive. Only this thread
+        // replaces streamingSamples, so the entry stays put.
+        auto buffer = samplePool->acquirePreload(*library, streamingSamples[preload.sample].librarySampleIndex, preload.numFrames);
 
-    // Calculate velocityLayerIndex for each sample based on its position in the note's sorted layers
-    {
-        std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
-        for (auto& ss : streamingSamples)
         {
-            auto noteIt = noteMappings.find(ss.midiNote);
-            if (noteIt != noteMappings.end())
+            std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+            auto& ss = streamingSamples[preload.sample];
+
+            // A settings change meanwhile may have preloaded it already, or dropped it
+            if (buffer != nullptr && !ss.isPreloaded && shouldSampleBePreloaded(ss))
             {
-                const auto& layers = noteIt->second.velocityLayers;
-                for (size_t i = 0; i < layers.size(); ++i)
-                {
-                    if (layers[i].velocityValue == ss.velocity)
-                    {
-                        ss.velocityLayerIndex = static_cast<int>(i);
-                        break;
-                    }
-                }
+                setSamplePreload(ss, std::move(buffer));
+                ss.isPreloaded = true;
             }
+
+            const auto note = noteIndex(ss.midiNote);
+            ++processed[note];
+            layersProcessed[note].set(static_cast<size_t>(juce::jlimit(0, 127, ss.velocityLayerIndex)));
+            publishNoteLoadState(ss.midiNote, static_cast<float>(processed[note]) / static_cast<float>(wanted[note]),
+                                 layersProcessed[note] == layersWanted[note]);
         }
+
+        loadProgress.store(static_cast<float>(i + 1) / static_cast<float>(pending.size()), std::memory_order_relaxed);
     }
 
-    engineDebugLog("Loaded " + juce::String(streamingSamples.size()) + " samples (metadata only)");
-    engineDebugLog("Max round-robins: " + juce::String(maxRoundRobins));
-    engineDebugLog("Max velocity layers: " + juce::String(maxVelocityLayersGlobal));
-    engineDebugLog("Total file size: " + juce::String(tempTotalSize / (1024 * 1024)) + " MB");
+    for (int note = 0; note < 128; ++note)
+    {
+        noteLoadProgress[static_cast<size_t>(note)].store(1.0f, std::memory_order_relaxed);
+        notePlayable[static_cast<size_t>(note)].store(true, std::memory_order_release);
+    }
+    loadProgress.store(1.0f, std::memory_order_relaxed);
 
-    // Preload samples that are within the current limits
+    // Pick up limit changes from the budget during the pass, account memory, size the ring reserve
     updatePreloadedSamples();
+}
 
-    // Re-register voices with DiskStreamer
-    if (diskStreamer)
+void SamplerEngine::publishNoteLoadState(int midiNote, float progress, bool playable)
+{
+    // Notes without samples of their own follow the note they borrow from
+    for (const auto& [note, mapping] : *noteMappings)
     {
-        for (int i = 0; i < StreamingConstants::maxStreamingVoices; ++i)
-        {
-            diskStreamer->registerVoice(i, &streamingVoices[static_cast<size_t>(i)]);
-        }
-    }
+        if (note != midiNote && mapping.fallbackNote != midiNote)
+            continue;
 
-    loadingState = LoadingState::Loaded;
+        noteLoadProgress[static_cast<size_t>(juce::jlimit(0, 127, note))].store(progress, std::memory_order_relaxed);
+        if (playable)
+            notePlayable[static_cast<size_t>(juce::jlimit(0, 127, note))].store(true, std::memory_order_release);
+    }
 }
 
-const SamplerEngine::StreamingSample* SamplerEngine::findStreamingSample(int midiNote, int velocity, int roundRobin) const
+const SamplerEngine::StreamingSample* SamplerEngine::findStreamingSample(int midiNote, int velocity, int roundRobin, SampleLookup lookup) const
 {
     int actualNote = midiNote;
-    auto it = noteMappings.find(midiNote);
-    if (it != noteMappings.end() && it->second.fallbackNote >= 0)
+    auto it = noteMappings->find(midiNote);
+    if (it != noteMappings->end() && it->second.fallbackNote >= 0)
     {
         actualNote = it->second.fallbackNote;
     }
 
-    auto noteIt = noteMappings.find(actualNote);
-    if (noteIt == noteMappings.end())
+    auto noteIt = noteMappings->find(actualNote);
+    if (noteIt == noteMappings->end())
         return nullptr;
 
     const auto& layers = noteIt->second.velocityLayers;
@@ -510,7 +526,7 @@ const SamplerEngine::StreamingSample* SamplerEngine::findStreamingSample(int mid
         return nullptr;
 
     // Apply velocity layer limit (use first N layers, redistribute velocity evenly)
-    int effectiveLayers = std::min(velocityLayerLimit, totalLayers);
+    int effectiveLayers = lookup == SampleLookup::AllLayers ? totalLayers : std::min(velocityLayerLimit, totalLayers);
 
     // Map incoming velocity (1-127) to limited layer index
     // Evenly distribute: velocity 1-127 maps to layers 0 to (effectiveLayers-1)
@@ -521,11 +537,12 @@ const SamplerEngine::StreamingSample* SamplerEngine::findStreamingSample(int mid
     int targetVelocity = layers[static_cast<size_t>(layerIndex)].velocityValue;
 
     // Find the sample with matching note, velocity, and round-robin
-    // Only return preloaded samples
+    // Only return preloaded samples (unless cold starting)
+    const bool preloadedOnly = lookup == SampleLookup::Preloaded;
     const StreamingSample* fallbackSample = nullptr;
     for (const auto& ss : streamingSamples)
     {
-        if (ss.midiNote == actualNote && ss.velocity == targetVelocity && ss.isPreloaded)
+        if (ss.midiNote == actualNote && ss.velocity == targetVelocity && (!preloadedOnly || ss.published.get() != nullptr))
         {
             if (ss.roundRobin == roundRobin)
                 return &ss;
@@ -535,6 +552,17 @@ const SamplerEngine::StreamingSample* SamplerEngine::findStreamingSample(int mid
         }
     }
 
+    // Purged layer: the nearest resident layer of the note (at least its stand-in) takes its place
+    if (fallbackSample == nullptr && preloadedOnly && purgeUnusedSamples)
+    {
+        for (const auto& ss : streamingSamples)
+        {
+            if (ss.midiNote == actualNote && ss.published.get() != nullptr
+                && (fallbackSample == nullptr || std::abs(ss.velocity - targetVelocity) < std::abs(fallbackSample->velocity - targetVelocity)))
+                fallbackSample = &ss;
+        }
+    }
+
     return fallbackSample;
 }
 
@@ -542,10 +570,53 @@ void SamplerEngine::noteOn(int midiNote, int velocity, int roundRobin, int sampl
 {
     // Find sample from offset note (for sample borrowing), but play at original midiNote pitch
     int sampleNote = juce::jlimit(0, 127, midiNote + sampleOffset);
+
+    // Progressive loading: silent until the note's preloads have landed
+    if (!isNotePlayable(sampleNote))
+        return;
     const StreamingSample* ss = findStreamingSample(sampleNote, velocity, roundRobin);
-    if (!ss)
+
+    // The preload version the voice starts from, read once (the budget thread may swap it meanwhile)
+    const PreloadedSample* preload = ss != nullptr ? ss->published.get() : nullptr;
+
+    // Cold start (or a purged sample): the sample all layers and round robins pick, or the limits
+    // if only purging; if it isn't preloaded it streams, with the preloaded sample as a stand-in
+    // until its attack arrives
+    const StreamingSample* coldSample = nullptr;
+    if ((coldStartEnabled || purgeUnusedSamples) && !metadataOnly)
+    {
+        const auto lookup = coldStartEnabled ? SampleLookup::AllLayers : SampleLookup::WithinLimits;
+        if (const auto* exact = findStreamingSample(sampleNote, velocity, roundRobin, lookup))
+        {
+            if (const auto* exactPreload = exact->published.get())
+            {
+                ss = exact;
+                preload = exactPreload;
+            }
+            else
+            {
+                coldSample = exact;
+            }
+        }
+    }
+
+    // Preloads on their way back to RAM: stream the sample within the limits from disk instead
+    if (preloadsRestoring.load(std::memory_order_acquire))
+    {
+        coldSample = findStreamingSample(sampleNote, velocity, roundRobin, SampleLookup::WithinLimits);
+        preload = nullptr;
+    }
+
+    const StreamingSample* played = coldSample != nullptr ? coldSample : (preload != nullptr ? ss : nullptr);
+    if (!played)
         return;
 
+    // Usage statistics for adaptive preloads (same playback rate the voice will compute),
+    // and the learned set for purging
+    const double pitchRatio = std::exp2((midiNote - played->preload.rootNote) / 12.0) * played->preload.sampleRate / currentSampleRate;
+    if (played->playStats.recordPlay(static_cast<float>(pitchRatio)))
+        learnedSamplesChanged.store(true);
+
     // Polyphonic same-note: send existing voices to release phase (realistic piano behavior)
     // This lets the old sound decay naturally while the new attack plays
     for (auto& voice : streamingVoices)
@@ -590,26 +661,49 @@ void SamplerEngine::noteOn(int midiNote, int velocity, int roundRobin, int sampl
         }
     }
 
-    // Increment global voice counter for age tracking
-    ++voiceStartCounterGlobal;
+    if (coldSample == nullptr)
+    {
+        startVoice(allocateVoice(), *preload, midiNote, velocity);
+        return;
+    }
 
-    // Find a free streaming voice
-    for (size_t i = 0; i < streamingVoices.size(); ++i)
+    // The stand-in plays right away; the cold voice shadows it and takes over once its data lands
+    StreamingVoice* substitute = nullptr;
+    if (preload != nullptr)
     {
-        if (!streamingVoices[i].isActive())
-        {
-            juce::ADSR::Parameters adsrJuceParams;
-            adsrJuceParams.attack = adsrParams.attack;
-            adsrJuceParams.decay = adsrParams.decay;
-            adsrJuceParams.sustain = adsrParams.sustain;
-            adsrJuceParams.release = adsrParams.release;
-            streamingVoices[i].setADSRParameters(adsrJuceParams);
+        substitute = &allocateVoice();
+        startVoice(*substitute, *preload, midiNote, velocity);
+        if (!substitute->isActive())
+            substitute = nullptr;
+    }
 
-            streamingVoices[i].startVoice(&ss->preload, midiNote,
-                                           static_cast<float>(velocity) / 127.0f, currentSampleRate,
-                                           voiceStartCounterGlobal);
-            return;
-        }
+    auto& voice = allocateVoice();
+    voice.setColdStart(substitute != nullptr ? StreamingVoice::ColdStart::Shadow : StreamingVoice::ColdStart::Wait);
+    startVoice(voice, coldSample->preload, midiNote, velocity);
+    if (!voice.isColdStarting())
+        return;
+
+    auto& pending = pendingColdStarts[static_cast<size_t>(&voice - streamingVoices.data())];
+    if (pending.voiceCounter == 0)
+        ++numPendingColdStarts;
+
+    pending.voiceCounter = voice.getVoiceStartCounter();
+    pending.substitute = substitute != nullptr ? static_cast<int>(substitute - streamingVoices.data()) : -1;
+    pending.substituteCounter = substitute != nullptr ? substitute->getVoiceStartCounter() : 0;
+
+    diskStreamer->notifyColdStart();
+}
+
+StreamingVoice& SamplerEngine::allocateVoice()
+{
+    // A voice is free once it's inactive and no disk read still holds its ring (reads finish within a chunk or so)
+    auto isFree = [](const StreamingVoice& voice) { return !voice.isActive() && !voice.isRingLeased(); };
+
+    // Find a free streaming voice
+    for (auto& voice : streamingVoices)
+    {
+        if (isFree(voice))
+            return voice;
     }
 
     // No free voice - steal the oldest voice globally (with 10ms fade)
@@ -625,140 +719,437 @@ void SamplerEngine::noteOn(int midiNote, int velocity, int roundRobin, int sampl
         }
     }
 
-    juce::ADSR::Parameters adsrJuceParams;
-    adsrJuceParams.attack = adsrParams.attack;
-    adsrJuceParams.decay = adsrParams.decay;
-    adsrJuceParams.sustain = adsrParams.sustain;
-    adsrJuceParams.release = adsrParams.release;
-    streamingVoices[oldestIndex].setADSRParameters(adsrJuceParams);
     streamingVoices[oldestIndex].startQuickFadeOut(currentSampleRate);
 
     // Start the new voice after a brief delay would be ideal, but for simplicity
     // we find another free voice or use a different slot
     // Actually, let's just start it - the old voice will fade out
-    for (size_t i = 0; i < streamingVoices.size(); ++i)
+    for (auto& voice : streamingVoices)
     {
-        if (!streamingVoices[i].isActive())
-        {
-            streamingVoices[i].setADSRParameters(adsrJuceParams);
-            streamingVoices[i].startVoice(&ss->preload, midiNote,
-                                           static_cast<float>(velocity) / 127.0f, currentSampleRate,
-                                           voiceStartCounterGlobal);
-            return;
-        }
+        if (isFree(voice))
+            return voice;
     }
 
-    // Still no free voice - force steal the oldest one immediately
-    streamingVoices[oldestIndex].stopVoice(false);
-    streamingVoices[oldestIndex].startVoice(&ss->preload, midiNote,
-                                             static_cast<float>(velocity) / 127.0f, currentSampleRate,
-                                             voiceStartCounterGlobal);
-}
+    // Still no free voice - force steal the oldest one immediately (one the disk isn't writing into,
+    // or startVoice would refuse it)
+    uint64_t oldestUnleasedCounter = UINT64_MAX;
+    size_t stealIndex = oldestIndex;
 
-void SamplerEngine::noteOff(int midiNote)
-{
-    for (auto& voice : streamingVoices)
+    for (size_t i = 0; i < streamingVoices.size(); ++i)
     {
-        if (voice.isActive() && voice.getPlayingNote() == midiNote)
+        if (!streamingVoices[i].isRingLeased() && streamingVoices[i].getVoiceStartCounter() < oldestUnleasedCounter)
         {
-            voice.stopVoice(true);  // Allow tail off
+            oldestUnleasedCounter = streamingVoices[i].getVoiceStartCounter();
+            stealIndex = i;
         }
     }
+
+    streamingVoices[stealIndex].stopVoice(false);
+    return streamingVoices[stealIndex];
 }
 
-void SamplerEngine::processBlock(juce::AudioBuffer<float>& buffer)
+void SamplerEngine::startVoice(StreamingVoice& voice, const PreloadedSample& sample, int midiNote, int velocity)
 {
-    const int numSamples = buffer.getNumSamples();
+    // Increment global voice counter for age tracking
+    ++voiceStartCounterGlobal;
 
-    juce::ADSR::Parameters adsrJuceParams;
-    adsrJuceParams.attack = adsrParams.attack;
-    adsrJuceParams.decay = adsrParams.decay;
-    adsrJuceParams.sustain = adsrParams.sustain;
-    adsrJuceParams.release = adsrParams.release;
+    const uint32_t adsrVersion = adsrParamsVersion.load(std::memory_order_acquire);
+    voice.updateADSRParameters(getADSRParameters(), adsrVersion);
+    voice.setInterpolationQuality(interpolationQuality);
+    voice.startVoice(&sample, midiNote, static_cast<float>(velocity) / 127.0f, currentSampleRate,
+                     voiceStartCounterGlobal);
+}
 
-    for (auto& voice : streamingVoices)
+void SamplerEngine::serviceColdStarts()
+{
+    const int maxWaitSamples = static_cast<int>(maxColdStartWaitMs * 0.001 * currentSampleRate);
+
+    for (size_t i = 0; i < streamingVoices.size() && numPendingColdStarts > 0; ++i)
     {
-        voice.setADSRParameters(adsrJuceParams);
+        auto& pending = pendingColdStarts[i];
+        if (pending.voiceCounter == 0)
+            continue;
 
-        if (voice.isActive())
+        auto& voice = streamingVoices[i];
+        StreamingVoice* substitute = nullptr;
+        if (pending.substitute >= 0)
         {
-            voice.renderNextBlock(buffer, 0, numSamples);
+            substitute = &streamingVoices[static_cast<size_t>(pending.substitute)];
+            if (!substitute->isActive() || substitute->getVoiceStartCounter() != pending.substituteCounter)
+                substitute = nullptr;
         }
-    }
-}
 
-int SamplerEngine::getActiveVoiceCount() const
-{
-    int count = 0;
-    for (const auto& voice : streamingVoices)
-    {
-        if (voice.isActive())
-            ++count;
+        if (!voice.isActive() || voice.getVoiceStartCounter() != pending.voiceCounter || !voice.isColdStarting())
+        {
+            // Released or stolen while waiting
+        }
+        else if (voice.isColdStartDataReady())
+        {
+            const float latencyMs = static_cast<float>(voice.getColdStartWaitSamples() * 1000.0 / currentSampleRate);
+            const float average = coldStartLatencyMs.load(std::memory_order_relaxed);
+            coldStartLatencyMs.store(average + coldStartLatencySmoothing * (latencyMs - average), std::memory_order_relaxed);
+
+            voice.finishColdStart(currentSampleRate);
+            if (substitute != nullptr)
+                substitute->startQuickFadeOut(currentSampleRate);
+        }
+        else if (voice.getColdStartWaitSamples() >= maxWaitSamples || voice.hasReadError())
+        {
+            // Too late to be worth switching: the stand-in plays the note, or it's dropped
+            voice.reset();
+            coldStartMisses.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            continue;
+        }
+
+        pending = {};
+        --numPendingColdStarts;
     }
-    return count;
 }
 
-int SamplerEngine::getStreamingVoiceCount() const
+void SamplerEngine::setColdStart(bool enabled)
 {
-    int count = 0;
-    for (const auto& voice : streamingVoices)
+    if (enabled != coldStartEnabled)
     {
-        if (voice.isActive() && voice.needsMoreData())
-            ++count;
+        coldStartEnabled = enabled;
+        updatePreloadedSamples();  // Ring storage is needed once any sample may stream
     }
-    return count;
 }
 
-float SamplerEngine::getDiskThroughputMBps() const
+void SamplerEngine::setRenderAtHostRate(bool enabled)
 {
-    if (!diskStreamer)
-        return 0.0f;
+    if (enabled == renderAtHostRate)
+        return;
 
-    return diskStreamer->getThroughputMBps();
+    renderAtHostRate = enabled;
+
+    // The samples' files and lengths change: load the library again
+    if (loadingState != LoadingState::Idle && loadedFolderPath.isNotEmpty())
+        loadSamplesFromFolder(juce::File(loadedFolderPath));
 }
 
-int SamplerEngine::getUnderrunCount() const
+void SamplerEngine::noteOff(int midiNote)
 {
-    return StreamingVoice::getUnderrunCount();
+    for (auto& voice : streamingVoices)
+    {
+        if (voice.isActive() && voice.getPlayingNote() == midiNote)
+        {
+            voice.stopVoice(true);  // Allow tail off
+        }
+    }
 }
 
-void SamplerEngine::resetUnderrunCount()
+void SamplerEngine::processBlock(juce::AudioBuffer<float>& buffer)
 {
-    StreamingVoice::resetUnderrunCount();
+    const int numSamples = buffer.getNumSamples();
+    audioBlockEpoch.fetch_add(1);
+
+    // Note events and the end of a bypass wake a hibernating engine
+    const bool wasBypassed = bypassed.exchange(false, std::memory_order_relaxed);
+    if (wasBypassed || !noteEvents.isEmpty())
+        wakeUp();
+
+    // Push ADSR changes to voices only when setADSR() published a new version
+    const uint32_t adsrVersion = adsrParamsVersion.load(std::memory_order_acquire);
+    if (adsrVersion != appliedADSRVersion)
+    {
+        const juce::ADSR::Parameters adsrJuceParams = getADSRParameters();
+        for (auto& voice : streamingVoices)
+        {
+            voice.updateADSRParameters(adsrJuceParams, adsrVersion);
+        }
+        appliedADSRVersion = adsrVersion;
+    }
+
+    // Render uninterrupted spans between event timestamps, applying each event where it falls
+    int spanStart = 0;
+    for (const auto& event : noteEvents)
+    {
+        const int eventPosition = juce::jlimit(0, numSamples, event.samplePosition);
+        if (eventPosition > spanStart)
+        {
+            renderVoices(buffer, spanStart, eventPosition - spanStart);
+            spanStart = eventPosition;
+        }
+
+        applyNoteEvent(event);
+    }
+    noteEvents.clear();
+
+    if (spanStart < numSamples)
+        renderVoices(buffer, spanStart, numSamples - spanStart);
+
+    cullInaudibleVoices(numSamples);
+
+    // Idle time towards hibernation: nothing left sounding
+    if (getHibernateAfterSeconds() > 0)
+    {
+        if (getActiveVoiceCount() > 0)
+            idleSamples.store(0, std::memory_order_relaxed);
+        else
+            idleSamples.fetch_add(numSamples, std::memory_order_relaxed);
+    }
+
+    audioBlockEpoch.fetch_add(1);
 }
 
-void SamplerEngine::reloadPreloadBuffers()
+void SamplerEngine::wakeUp()
+{
+    idleSamples.store(0, std::memory_order_relaxed);
+
+    // Pairs with the fence in enterHibernation: it either sees the reset and backs off, or this sees it hibernating
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!hibernating.load(std::memory_order_relaxed))
+        return;
+
+    // Ring storage for what the wake-up plays, and the disk streamer serves this engine again.
+    // The budget's thread restores the preloads now rather than at its next poll; notes stream
+    // from disk until then (preloadsRestoring).
+    ringPool.setMinimumReserve(ringReserveSlabs);
+    hibernating.store(false, std::memory_order_release);
+    wakeRequested.store(true, std::memory_order_release);
+    diskStreamer->notifyColdStart();
+    preloadBudget->serviceClientsSoon();
+}
+
+void SamplerEngine::processBypassed()
+{
+    bypassed.store(true, std::memory_order_relaxed);
+
+    // The host has muted the instance: with hibernation on, cut what's still sounding so it can hibernate
+    if (getHibernateAfterSeconds() == 0)
+        return;
+
+    for (auto& voice : streamingVoices)
+    {
+        if (voice.isActive())
+            voice.reset();
+    }
+
+    if (numPendingColdStarts > 0)
+    {
+        pendingColdStarts.fill({});
+        numPendingColdStarts = 0;
+    }
+}
+
+void SamplerEngine::cullInaudibleVoices(int numSamples)
+{
+    const float thresholdDb = getVoiceCullThresholdDb();
+    if (thresholdDb <= voiceCullOffDb)
+        return;
+
+    const float thresholdGain = juce::Decibels::decibelsToGain(thresholdDb);
+    const int holdSamples = static_cast<int>(getVoiceCullHoldMs() * 0.001 * currentSampleRate);
+
+    for (auto& voice : streamingVoices)
+    {
+        if (voice.isActive() && voice.updateAudibility(thresholdGain, numSamples, holdSamples))
+        {
+            voice.reset();
+            culledVoices.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool SamplerEngine::shouldHibernate() const
+{
+    const int seconds = getHibernateAfterSeconds();
+    if (seconds == 0 || loadingState == LoadingState::Loading || getActiveVoiceCount() > 0)
+        return false;
+
+    return bypassed.load(std::memory_order_relaxed)
+        || static_cast<double>(idleSamples.load(std::memory_order_relaxed)) >= seconds * currentSampleRate;
+}
+
+void SamplerEngine::enterHibernation()
 {
     std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
 
-    int64_t totalPreloadBytes = 0;
-    int reloadedCount = 0;
+    // From here on a note (or a settings change) wakes the engine again. One started since
+    // shouldHibernate() said yes reset the idle time before wakeUp looked at the flag: back off,
+    // or its voice would get no disk reads.
+    hibernating.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!shouldHibernate())
+    {
+        hibernating.store(false, std::memory_order_release);
+        return;
+    }
 
+    // Park the preloads in one file-backed mapping; the RAM copies go once retired
+    std::vector<StreamingSample*> samples;
+    std::vector<const juce::AudioBuffer<float>*> buffers;
     for (auto& ss : streamingSamples)
     {
-        if (ss.isPreloaded)
+        if (ss.isPreloaded && ss.sharedPreload != nullptr)
         {
-            // Reload this sample's preload buffer with new size
-            loadSamplePreloadBuffer(ss);
-            reloadedCount++;
+            samples.push_back(&ss);
+            buffers.push_back(ss.sharedPreload.get());
         }
+    }
+
+    auto packed = PreloadPack::create(PreloadPack::getDefaultDirectory(), buffers);
+    if (!packed.empty() && packed.size() == samples.size())
+    {
+        for (size_t i = 0; i < samples.size(); ++i)
+            setSamplePreload(*samples[i], std::move(packed[i]));
+
+        preloadsParked = true;
+        preloadMemoryBytes = 0;
+
+        // Reading the mapping could fault on the audio thread: notes stream until the copies are back
+        preloadsRestoring.store(true, std::memory_order_release);
+    }
+
+    // Leave the budget to the instances still playing; the disk thread frees the surplus rings
+    // (unless a note has woken the engine meanwhile)
+    preloadBudget->setDemand(budgetClient, {});
+    if (hibernating.load(std::memory_order_acquire))
+        ringPool.setMinimumReserve(hibernationRingReserveSlabs);
+
+    DebugLog::write("SamplerEngine: hibernating" + juce::String(bypassed.load() ? " (bypassed)" : "")
+                    + ", parked " + juce::String(preloadsParked ? static_cast<int>(samples.size()) : 0) + " preloads");
+}
+
+void SamplerEngine::queueNoteOn(int samplePosition, int midiNote, int velocity, int roundRobin, int sampleOffset)
+{
+    NoteEventQueue::Event event;
+    event.samplePosition = samplePosition;
+    event.type = NoteEventQueue::Type::NoteOn;
+    event.midiNote = midiNote;
+    event.velocity = velocity;
+    event.roundRobin = roundRobin;
+    event.sampleOffset = sampleOffset;
+
+    // Queue full: fall back to applying at the start of the block
+    if (!noteEvents.push(event))
+        applyNoteEvent(event);
+}
+
+void SamplerEngine::queueNoteOff(int samplePosition, int midiNote)
+{
+    NoteEventQueue::Event event;
+    event.samplePosition = samplePosition;
+    event.type = NoteEventQueue::Type::NoteOff;
+    event.midiNote = midiNote;
+
+    if (!noteEvents.push(event))
+        applyNoteEvent(event);
+}
+
+void SamplerEngine::applyNoteEvent(const NoteEventQueue::Event& event)
+{
+    if (event.type == NoteEventQueue::Type::NoteOn)
+        noteOn(event.midiNote, event.velocity, event.roundRobin, event.sampleOffset);
+    else
+        noteOff(event.midiNote);
+}
+
+void SamplerEngine::renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // Switch cold-starting voices whose attack has arrived (or give up on them)
+    if (numPendingColdStarts > 0)
+        serviceColdStarts();
+
+    if (voiceBatchLanes > 0)
+    {
+        batchRenderer.render(streamingVoices, buffer, startSample, numSamples);
+        return;
+    }
 
-        if (ss.isPreloaded)
+    if (renderPool.getNumWorkers() > 0)
+    {
+        renderPool.render(streamingVoices, buffer, startSample, numSamples);
+        return;
+    }
+
+    for (auto& voice : streamingVoices)
+    {
+        if (voice.isActive())
         {
-            totalPreloadBytes += static_cast<int64_t>(ss.preload.preloadBuffer.getNumSamples()) *
-                                 static_cast<int64_t>(ss.preload.numChannels) * static_cast<int64_t>(sizeof(float));
+            voice.renderNextBlock(buffer, startSample, numSamples);
         }
     }
+}
 
-    preloadMemoryBytes = totalPreloadBytes;
+void SamplerEngine::setVoiceBatchLanes(int lanes)
+{
+    if (lanes <= 0)
+    {
+        voiceBatchLanes = 0;
+        return;
+    }
+
+    batchRenderer.setLaneWidth(lanes);
+    voiceBatchLanes = batchRenderer.getLaneWidth();
+}
+
+int SamplerEngine::getActiveVoiceCount() const
+{
+    int count = 0;
+    for (const auto& voice : streamingVoices)
+    {
+        if (voice.isActive())
+            ++count;
+    }
+    return count;
+}
+
+int SamplerEngine::getStreamingVoiceCount() const
+{
+    int count = 0;
+    for (const auto& voice : streamingVoices)
+    {
+        if (voice.isActive() && voice.needsMoreData())
+            ++count;
+    }
+    return count;
+}
+
+float SamplerEngine::getDiskThroughputMBps() const
+{
+    return diskStreamer->getClientThroughputMBps(streamingClient);
+}
+
+float SamplerEngine::getTotalDiskThroughputMBps() const
+{
+    return diskStreamer->getThroughputMBps();
+}
+
+void SamplerEngine::setDiskIOThreads(int numThreads)
+{
+    diskStreamer->setNumIOThreads(juce::jmax(1, numThreads));
+}
+
+int SamplerEngine::getDiskIOThreads() const
+{
+    return diskStreamer->getNumIOThreads();
+}
+
+int SamplerEngine::getUnderrunCount() const
+{
+    return StreamingVoice::getUnderrunCount();
+}
 
-    engineDebugLog("reloadPreloadBuffers: preloadSizeKB=" + juce::String(preloadSizeKB) +
-                   " reloaded=" + juce::String(reloadedCount) +
-                   " preloadMem=" + juce::String(totalPreloadBytes / 1024) + " KB");
+void SamplerEngine::resetUnderrunCount()
+{
+    StreamingVoice::resetUnderrunCount();
+}
+
+void SamplerEngine::reloadPreloadBuffers()
+{
+    // Preloads whose length changed with preloadSizeKB are reloaded
+    updatePreloadedSamples();
 }
 
 void SamplerEngine::setVelocityLayerLimit(int limit)
 {
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+    requestedVelocityLayerLimit = limit;
+
     int newLimit = juce::jlimit(1, juce::jmax(1, maxVelocityLayersGlobal), limit);
     if (newLimit != velocityLayerLimit)
     {
@@ -769,6 +1160,9 @@ void SamplerEngine::setVelocityLayerLimit(int limit)
 
 void SamplerEngine::setRoundRobinLimit(int limit)
 {
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+    requestedRoundRobinLimit = limit;
+
     int newLimit = juce::jlimit(1, juce::jmax(1, maxRoundRobins), limit);
     if (newLimit != roundRobinLimit)
     {
@@ -777,74 +1171,491 @@ void SamplerEngine::setRoundRobinLimit(int limit)
     }
 }
 
-bool SamplerEngine::shouldSampleBePreloaded(const StreamingSample& ss) const
+void SamplerEngine::setMetadataOnly(bool enabled)
+{
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+    if (enabled == metadataOnly)
+        return;
+
+    metadataOnly = enabled;
+    if (enabled)
+    {
+        preloadsRestoring.store(false, std::memory_order_release);
+        updatePreloadedSamples();
+        return;
+    }
+
+    // Called when the engine server is lost, with the audio thread already playing here: don't
+    // decode every preload on this thread. Notes stream from disk until the budget's thread has them.
+    preloadsRestoring.store(true, std::memory_order_release);
+    ringPool.setMinimumReserve(ringReserveSlabs);
+    wakeRequested.store(true, std::memory_order_release);
+    preloadBudget->serviceClientsSoon();
+}
+
+void SamplerEngine::playWithoutPreloads()
+{
+    preloadsRestoring.store(true, std::memory_order_release);
+    ringPool.setMinimumReserve(ringReserveSlabs);
+    diskStreamer->notifyColdStart();
+}
+
+bool SamplerEngine::isWithinLimits(const StreamingSample& ss) const
 {
-    // Sample should be preloaded if:
-    // 1. Its velocity layer index is within the limit (0 to velocityLayerLimit-1)
-    // 2. Its round robin is within the limit (1 to roundRobinLimit)
     return (ss.velocityLayerIndex >= 0 &&
             ss.velocityLayerIndex < velocityLayerLimit &&
             ss.roundRobin >= 1 &&
             ss.roundRobin <= roundRobinLimit);
 }
 
-void SamplerEngine::loadSamplePreloadBuffer(StreamingSample& ss)
+bool SamplerEngine::shouldSampleBePreloaded(const StreamingSample& ss) const
+{
+    // Sample should be preloaded if:
+    // 1. Its velocity layer index is within the limit (0 to velocityLayerLimit-1)
+    // 2. Its round robin is within the limit (1 to roundRobinLimit)
+    // 3. This engine plays (not metadata only)
+    // 4. When purging: it has been played, or it's its note's stand-in
+    return (!metadataOnly &&
+            isWithinLimits(ss) &&
+            (!purgeUnusedSamples || ss.playStats.learned.load(std::memory_order_relaxed) || ss.purgeStandIn));
+}
+
+void SamplerEngine::setPurgeUnusedSamples(bool enabled)
 {
-    auto reader = std::unique_ptr<juce::AudioFormatReader>(
-        formatManager.createReaderFor(juce::File(ss.preload.filePath)));
-    if (!reader)
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+
+    if (enabled != purgeUnusedSamples)
+    {
+        purgeUnusedSamples = enabled;
+        updatePreloadedSamples();
+    }
+}
+
+void SamplerEngine::clearLearnedSamples()
+{
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+
+    learnedSamples.clear();
+    for (auto& ss : streamingSamples)
+        ss.playStats.learned.store(false, std::memory_order_relaxed);
+
+    if (purgeUnusedSamples)
+        updatePreloadedSamples();
+}
+
+int SamplerEngine::getLearnedSampleCount() const
+{
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+    syncLearnedSamples();
+    return static_cast<int>(learnedSamples.size());
+}
+
+juce::String SamplerEngine::getLearnedSamples() const
+{
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+    syncLearnedSamples();
+    return formatSampleKeys(learnedSamples);
+}
+
+void SamplerEngine::setLearnedSamples(const juce::String& folderPath, const juce::String& learned)
+{
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+
+    learnedSamples = parseSampleKeys(learned);
+    learnedFolderPath = folderPath;
+
+    // Already loaded: apply now (otherwise the load picks it up)
+    if (library == nullptr || library->folderPath != folderPath)
         return;
 
-    int bytesPerSample = sizeof(float);
-    int preloadBytes = preloadSizeKB * 1024;
-    int framesToPreload = preloadBytes / (ss.preload.numChannels * bytesPerSample);
-    framesToPreload = std::min(framesToPreload, static_cast<int>(ss.preload.totalSampleFrames));
+    for (auto& ss : streamingSamples)
+        ss.playStats.learned.store(learnedSamples.count({ ss.midiNote, ss.velocity, ss.roundRobin }) > 0, std::memory_order_relaxed);
+
+    if (purgeUnusedSamples)
+        updatePreloadedSamples();
+}
+
+void SamplerEngine::syncLearnedSamples() const
+{
+    if (library == nullptr || library->folderPath != learnedFolderPath)
+        return;
 
-    ss.preload.preloadBuffer.setSize(ss.preload.numChannels, framesToPreload);
-    reader->read(&ss.preload.preloadBuffer, 0, framesToPreload, 0, true, true);
-    ss.preload.preloadSizeFrames = framesToPreload;
+    for (const auto& ss : streamingSamples)
+    {
+        if (ss.playStats.learned.load(std::memory_order_relaxed))
+            learnedSamples.insert({ ss.midiNote, ss.velocity, ss.roundRobin });
+    }
+}
+
+void SamplerEngine::updatePurgeStandIns()
+{
+    // Notes with a learned sample already have a resident layer to stand in for the others
+    std::array<bool, 128> noteLearned {};
+    for (auto& ss : streamingSamples)
+    {
+        ss.purgeStandIn = false;
+        if (purgeUnusedSamples && isWithinLimits(ss) && ss.playStats.learned.load(std::memory_order_relaxed))
+            noteLearned[static_cast<size_t>(juce::jlimit(0, 127, ss.midiNote))] = true;
+    }
+
+    if (!purgeUnusedSamples)
+        return;
+
+    // The others keep their middle layer's first round robin, at the shortest preload
+    for (auto& ss : streamingSamples)
+    {
+        if (noteLearned[static_cast<size_t>(juce::jlimit(0, 127, ss.midiNote))] || !isWithinLimits(ss) || ss.roundRobin != 1)
+            continue;
+
+        auto mapping = noteMappings->find(ss.midiNote);
+        if (mapping == noteMappings->end())
+            continue;
+
+        const int layers = std::min(velocityLayerLimit, static_cast<int>(mapping->second.velocityLayers.size()));
+        ss.purgeStandIn = ss.velocityLayerIndex == layers / 2;
+    }
+}
+
+juce::String SamplerEngine::formatSampleKeys(const std::set<SampleKey>& keys)
+{
+    juce::StringArray tokens;
+    for (const auto& [note, velocity, roundRobin] : keys)
+        tokens.add(juce::String(note) + "/" + juce::String(velocity) + "/" + juce::String(roundRobin));
+
+    return tokens.joinIntoString(" ");
+}
+
+std::set<SamplerEngine::SampleKey> SamplerEngine::parseSampleKeys(const juce::String& text)
+{
+    std::set<SampleKey> keys;
+
+    auto isNumber = [](const juce::String& part) { return part.isNotEmpty() && part.containsOnly("0123456789"); };
+
+    for (const auto& token : juce::StringArray::fromTokens(text, " ", ""))
+    {
+        auto parts = juce::StringArray::fromTokens(token, "/", "");
+        if (parts.size() != 3 || !isNumber(parts[0]) || !isNumber(parts[1]) || !isNumber(parts[2]))
+            continue;
+
+        const int note = parts[0].getIntValue();
+        const int velocity = parts[1].getIntValue();
+        const int roundRobin = parts[2].getIntValue();
+        if (note <= 127 && velocity >= 1 && velocity <= 127 && roundRobin >= 1)
+            keys.insert({ note, velocity, roundRobin });
+    }
+
+    return keys;
+}
+
+void SamplerEngine::setAdaptivePreloads(bool enabled)
+{
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+
+    if (enabled != adaptivePreloads)
+    {
+        adaptivePreloads = enabled;
+        updatePreloadTiers(false);
+        updatePreloadedSamples();
+    }
+}
+
+bool SamplerEngine::updatePreloadTiers(bool decayPlayCounts)
+{
+    std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
+
+    // Usage tiers are relative to the mean plays of the samples this instance preloads
+    uint64_t totalPlays = 0;
+    int numWanted = 0;
+    for (const auto& ss : streamingSamples)
+    {
+        if (shouldSampleBePreloaded(ss))
+        {
+            totalPlays += ss.playStats.playCount.load(std::memory_order_relaxed);
+            ++numWanted;
+        }
+    }
+
+    const bool enoughPlays = numWanted > 0 && totalPlays >= static_cast<uint64_t>(minPlaysForUsageTiers);
+    const double meanPlays = numWanted > 0 ? static_cast<double>(totalPlays) / numWanted : 0.0;
+
+    bool changed = false;
+    double wantedWeight = 0.0;
+    int numPerTier[maxPreloadTier - minPreloadTier + 1] = {};
+
+    for (auto& ss : streamingSamples)
+    {
+        int tier = 0;
+
+        if (adaptivePreloads)
+        {
+            // Hot samples get more, rarely hit layers and round-robins less
+            if (enoughPlays)
+            {
+                const double share = ss.playStats.playCount.load(std::memory_order_relaxed) / meanPlays;
+                ss.usageWeight = share >= 2.0 ? 2.0 : (share >= 0.5 ? 1.0 : (share > 0.0 ? 0.5 : 0.25));
+            }
+
+            // A voice consumes source frames at its playback rate: pitched up, the preload covers less time
+            const double sampleRateRatio = ss.preload.sampleRate / currentSampleRate;
+            const double rate = juce::jlimit(1.0, 4.0, juce::jmax(sampleRateRatio, static_cast<double>(ss.playStats.peakPitchRatio.load(std::memory_order_relaxed))));
+
+            // The preload has to bridge the wait for the first streamed chunk
+            const float latencyMs = diskStreamer->getDeviceLatencyMs(ss.preload.deviceId);
+            const double device = latencyMs > 0.0f ? juce::jlimit(1.0, 4.0, static_cast<double>(latencyMs / referenceDeviceLatencyMs)) : 1.0;
+
+            tier = juce::jlimit(minPreloadTier, maxPreloadTier, juce::roundToInt(std::log2(ss.usageWeight * rate * device)));
+        }
+
+        changed = changed || tier != ss.preloadTier;
+        ss.preloadTier = tier;
+
+        if (shouldSampleBePreloaded(ss))
+        {
+            wantedWeight += std::exp2(tier);
+            ++numPerTier[tier - minPreloadTier];
+        }
+
+        if (decayPlayCounts)
+            ss.playStats.decay();
+    }
+
+    // Without a budget, keep the preload knob's total RAM: scale the mean weight back to 1
+    // (in eighth-octave steps, so the scale doesn't reload everything on every small change)
+    const double scale = wantedWeight > 0.0 ? numWanted / wantedWeight : 1.0;
+    const double quantisedScale = std::exp2(std::round(std::log2(scale) * 8.0) / 8.0);
+    changed = changed || quantisedScale != tierWeightScale;
+    tierWeightScale = quantisedScale;
+
+    if (changed)
+    {
+        juce::String tiers;
+        for (int tier = minPreloadTier; tier <= maxPreloadTier; ++tier)
+            tiers << " x" << juce::String(std::exp2(tier), 2) << "=" << numPerTier[tier - minPreloadTier];
+
+        DebugLog::write("updatePreloadTiers: plays=" + juce::String(static_cast<int>(totalPlays)) + tiers
+                        + " scale=" + juce::String(tierWeightScale, 3));
+    }
+
+    return changed;
+}
+
+float SamplerEngine::getPreloadWeight(const StreamingSample& ss) const
+{
+    return adaptivePreloads ? static_cast<float>(std::exp2(ss.preloadTier)) : 1.0f;
+}
+
+int SamplerEngine::getPreloadFrames(const StreamingSample& ss) const
+{
+    // A stand-in only has to cover a cold start
+    if (ss.purgeStandIn && !ss.playStats.learned.load(std::memory_order_relaxed))
+        return SharedSamplePool::getPreloadFrames(ss.preload, PreloadBudget::minimumPreloadBytes);
+
+    const int64_t budgetLimit = preloadBudget->getPreloadLimitBytes();
+    const double weight = getPreloadWeight(ss);
+
+    // The budget already balances the weights; the knob needs them normalised
+    const double preloadBytes = budgetLimit > 0 ? static_cast<double>(budgetLimit) * weight
+                                                : static_cast<double>(preloadSizeKB) * 1024.0 * weight * tierWeightScale;
+
+    return SharedSamplePool::getPreloadFrames(ss.preload, juce::jmax(PreloadBudget::minimumPreloadBytes,
+                                                                     static_cast<int64_t>(preloadBytes)));
+}
+
+void SamplerEngine::publishPreloadDemand()
+{
+    std::vector<PreloadBudget::Demand> demand;
+
+    if (library != nullptr)
+    {
+        // Keyed like the shared pool's buffers, so instances sharing a preload count it once
+        const uint64_t libraryKey = SharedPreloadStore::hash(library->key);
+
+        for (const auto& ss : streamingSamples)
+        {
+            if (!shouldSampleBePreloaded(ss))
+                continue;
+
+            PreloadBudget::Demand sampleDemand;
+            sampleDemand.key = SharedPreloadStore::hash(&ss.librarySampleIndex, sizeof(ss.librarySampleIndex), libraryKey);
+            sampleDemand.fullBytes = ss.preload.totalSampleFrames * juce::jmax(1, ss.preload.numChannels)
+                                   * static_cast<int64_t>(sizeof(float));
+            if (ss.purgeStandIn && !ss.playStats.learned.load(std::memory_order_relaxed))
+                sampleDemand.fullBytes = std::min(sampleDemand.fullBytes, PreloadBudget::minimumPreloadBytes);
+            sampleDemand.weight = getPreloadWeight(ss);
+            demand.push_back(sampleDemand);
+        }
+    }
+
+    preloadBudget->setDemand(budgetClient, std::move(demand));
+}
+
+void SamplerEngine::loadSamplePreloadBuffer(StreamingSample& ss, int numFrames)
+{
+    // Shared with other instances using the same library and preload length; a parked
+    // preload of that length is copied back instead of decoded again
+    const auto* parked = preloadsParked ? ss.sharedPreload.get() : nullptr;
+    auto shared = samplePool->acquirePreload(*library, ss.librarySampleIndex, numFrames, parked);
+    if (shared == nullptr)
+        return;
+
+    setSamplePreload(ss, std::move(shared));
+}
+
+void SamplerEngine::setSamplePreload(StreamingSample& ss, SharedSamplePool::PreloadPtr buffer)
+{
+    // A new version that refers to the shared data (read-only in practice), published in one store
+    auto version = std::make_shared<PreloadedSample>(ss.preload);
+    version->preloadBuffer.setDataToReferTo(const_cast<float* const*>(buffer->getArrayOfReadPointers()),
+                                            buffer->getNumChannels(), buffer->getNumSamples());
+    version->preloadSizeFrames = buffer->getNumSamples();
+
+    ss.published.current.store(version.get());
+    retirePreload(std::move(ss.sharedPreload), std::move(ss.published.owner));
+    ss.sharedPreload = std::move(buffer);
+    ss.published.owner = std::move(version);
+}
+
+void SamplerEngine::retirePreload(StreamingSample& ss)
+{
+    ss.published.current.store(nullptr);
+    retirePreload(std::move(ss.sharedPreload), std::move(ss.published.owner));
+    ss.sharedPreload = nullptr;
+    ss.published.owner = nullptr;
+}
+
+void SamplerEngine::retirePreload(SharedSamplePool::PreloadPtr buffer, std::shared_ptr<const PreloadedSample> version)
+{
+    if (buffer == nullptr && version == nullptr)
+        return;
+
+    // Read after the version was swapped out: a block running now may still have picked it up
+    RetiredPreload retired;
+    retired.buffer = std::move(buffer);
+    retired.version = std::move(version);
+    retired.audioBlockEpoch = audioBlockEpoch.load();
+    retiredPreloads.push_back(std::move(retired));
+}
+
+void SamplerEngine::releaseRetiredPreloads()
+{
+    // Called every second by the budget: skip a round rather than wait out a long preload update
+    std::unique_lock<std::recursive_mutex> lock(mappingsMutex, std::try_to_lock);
+    if (!lock.owns_lock() || retiredPreloads.empty())
+        return;
+
+    // Entries retired during a block become checkable once it ends; whatever that block started
+    // is visible in the voices after this load
+    const uint64_t epoch = audioBlockEpoch.load();
+
+    // What the voices and the disk reads leasing their rings refer to
+    std::vector<std::uintptr_t> inUse;
+    for (const auto& voice : streamingVoices)
+    {
+        for (const auto* sample : voice.getSamplesInUse())
+        {
+            if (sample != nullptr)
+                inUse.push_back(reinterpret_cast<std::uintptr_t>(sample));
+        }
+    }
+    std::sort(inUse.begin(), inUse.end());
+
+    auto isReferenced = [&inUse](const void* object, size_t size)
+    {
+        const auto begin = reinterpret_cast<std::uintptr_t>(object);
+        const auto first = std::lower_bound(inUse.begin(), inUse.end(), begin);
+        return first != inUse.end() && *first < begin + size;
+    };
+
+    auto isReleasable = [epoch, &isReferenced](const RetiredPreload& retired)
+    {
+        const bool blockEnded = (retired.audioBlockEpoch & 1) == 0 || retired.audioBlockEpoch != epoch;
+        if (!blockEnded || (retired.version != nullptr && isReferenced(retired.version.get(), sizeof(PreloadedSample))))
+            return false;
+
+        return retired.samples == nullptr
+            || !isReferenced(retired.samples->data(), retired.samples->size() * sizeof(StreamingSample));
+    };
+
+    retiredPreloads.erase(std::remove_if(retiredPreloads.begin(), retiredPreloads.end(), isReleasable),
+                          retiredPreloads.end());
 }
 
 void SamplerEngine::updatePreloadedSamples()
 {
     std::lock_guard<std::recursive_mutex> lock(mappingsMutex);
 
+    // Settings changes and loads wake a hibernating engine
+    if (hibernating.exchange(false))
+        idleSamples.store(0, std::memory_order_relaxed);
+
+    // Tell the budget what this instance wants before asking it how long each preload may be
+    updatePurgeStandIns();
+    publishPreloadDemand();
+    releaseRetiredPreloads();
+
+    // Parked preloads are copied back below: read the pack file in at once rather than fault page by page
+    if (preloadsParked)
+    {
+        for (const auto& ss : streamingSamples)
+            if (ss.isPreloaded && ss.sharedPreload != nullptr)
+                PreloadPack::prefault(*ss.sharedPreload);
+    }
+
     int64_t totalPreloadBytes = 0;
     int loadedCount = 0;
     int unloadedCount = 0;
+    bool anyStreaming = false;
 
     for (auto& ss : streamingSamples)
     {
         bool shouldBeLoaded = shouldSampleBePreloaded(ss);
 
-        if (shouldBeLoaded && !ss.isPreloaded)
+        if (shouldBeLoaded)
         {
-            // Load this sample's preload buffer from disk
-            loadSamplePreloadBuffer(ss);
-            ss.isPreloaded = true;
-            loadedCount++;
+            // Load this sample's preload buffer, or reload it if the preload size or budget changed its length
+            const int numFrames = getPreloadFrames(ss);
+            const int preloadedFrames = ss.sharedPreload != nullptr ? ss.sharedPreload->getNumSamples() : 0;
+            if (!ss.isPreloaded || numFrames != preloadedFrames || preloadsParked)
+            {
+                loadSamplePreloadBuffer(ss, numFrames);
+                ss.isPreloaded = true;
+                loadedCount++;
+            }
         }
-        else if (!shouldBeLoaded && ss.isPreloaded)
+        else if (ss.isPreloaded)
         {
             // Unload this sample's preload buffer
-            ss.preload.preloadBuffer.setSize(0, 0);  // Free memory
-            ss.preload.preloadSizeFrames = 0;
+            retirePreload(ss);  // Freed once no voice or other instance holds it
             ss.isPreloaded = false;
             unloadedCount++;
         }
 
-        if (ss.isPreloaded)
+        // Cold starts stream every sample left out
+        if (!ss.isPreloaded && (coldStartEnabled || purgeUnusedSamples) && !metadataOnly)
+            anyStreaming = true;
+
+        if (ss.isPreloaded && ss.published.owner != nullptr)
         {
-            totalPreloadBytes += static_cast<int64_t>(ss.preload.preloadBuffer.getNumSamples()) *
+            totalPreloadBytes += static_cast<int64_t>(ss.published.owner->preloadSizeFrames) *
                                  static_cast<int64_t>(ss.preload.numChannels) * static_cast<int64_t>(sizeof(float));
+            anyStreaming = anyStreaming || ss.published.owner->needsStreaming();
         }
     }
 
     preloadMemoryBytes = totalPreloadBytes;
-
-    engineDebugLog("updatePreloadedSamples: velLimit=" + juce::String(velocityLayerLimit) +
-                   " rrLimit=" + juce::String(roundRobinLimit) +
-                   " loaded=" + juce::String(loadedCount) +
-                   " unloaded=" + juce::String(unloadedCount) +
-                   " preloadMem=" + juce::String(totalPreloadBytes / 1024) + " KB");
+    preloadsParked = false;
+    if (!metadataOnly)
+        preloadsRestoring.store(false, std::memory_order_release);
+
+    // Instruments that fit entirely in the preload never need ring storage
+    ringPool.setMinimumReserve(anyStreaming ? ringReserveSlabs : 0);
+
+    DebugLog::write("updatePreloadedSamples: velLimit=" + juce::String(velocityLayerLimit) +
+                    " rrLimit=" + juce::String(roundRobinLimit) +
+                    " coldStart=" + juce::String(coldStartEnabled ? "on" : "off") +
+                    " purge=" + juce::String(purgeUnusedSamples ? "on" : "off") +
+                    " budgetLimit=" + juce::String(static_cast<int>(preloadBudget->getPreloadLimitBytes() / 1024)) + " KB" +
+                    " loaded=" + juce::String(loadedCount) +
+                    " unloaded=" + juce::String(unloadedCount) +
+                    " preloadMem=" + juce::String(totalPreloadBytes / 1024) + " KB");
 }
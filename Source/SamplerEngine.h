@@ -3,6 +3,8 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <map>
+#include <set>
+#include <tuple>
 #include <vector>
 #include <array>
 #include <memory>
@@ -12,6 +14,11 @@
 #include "DiskStreaming.h"
 #include "StreamingVoice.h"
 #include "DiskStreamer.h"
+#include "VoiceBatchRenderer.h"
+#include "VoiceRenderPool.h"
+#include "NoteEventQueue.h"
+#include "SharedSamplePool.h"
+#include "PreloadBudget.h"
 
 struct ADSRParams
 {
@@ -21,20 +28,6 @@ struct ADSRParams
     float release = 0.3f;   // seconds
 };
 
-struct VelocityLayer
-{
-    int velocityValue;      // The actual velocity value from the file name
-    int velocityRangeStart; // Computed: lowest velocity that triggers this layer
-    int velocityRangeEnd;   // Computed: highest velocity that triggers this layer
-};
-
-struct NoteMapping
-{
-    int midiNote;
-    std::vector<VelocityLayer> velocityLayers; // Sorted by velocity ascending
-    int fallbackNote = -1; // If this note has no samples, use this note instead
-};
-
 enum class LoadingState { Idle, Loading, Loaded };
 
 class SamplerEngine
@@ -43,18 +36,32 @@ public:
     SamplerEngine();
     ~SamplerEngine();
 
-    void prepareToPlay(double sampleRate, int samplesPerBlock);
+    void prepareToPlay(double sampleRate, int samplesPerBlock, int numOutputChannels = 2);
     void loadSamplesFromFolder(const juce::File& folder);
     void noteOn(int midiNote, int velocity, int roundRobin, int sampleOffset = 0);
     void noteOff(int midiNote);
     void processBlock(juce::AudioBuffer<float>& buffer);
 
+    // Sample-accurate note events: queued during the block, applied by processBlock()
+    // at their sample position (audio thread)
+    void queueNoteOn(int samplePosition, int midiNote, int velocity, int roundRobin, int sampleOffset = 0);
+    void queueNoteOff(int samplePosition, int midiNote);
+
     bool isLoaded() const;
     bool isLoading() const { return loadingState == LoadingState::Loading; }
+
+    // Progressive loading: the library layout is published first, then preloads land in priority
+    // order (learned samples, then round robin by round robin from the middle of the keyboard
+    // outwards). A note plays as soon as each of its velocity layers has a preload; until then
+    // it's silent. Any thread.
+    bool isNotePlayable(int midiNote) const { return notePlayable[static_cast<size_t>(juce::jlimit(0, 127, midiNote))].load(std::memory_order_acquire); }
+    float getNoteLoadProgress(int midiNote) const { return noteLoadProgress[static_cast<size_t>(juce::jlimit(0, 127, midiNote))].load(std::memory_order_relaxed); }
+    float getLoadProgress() const { return loadProgress.load(std::memory_order_relaxed); }  // All preloads of the load in progress
     LoadingState getLoadingState() const { return loadingState; }
     juce::String getLoadedFolderPath() const { return loadedFolderPath; }
     int64_t getTotalInstrumentFileSize() const { return totalInstrumentFileSize.load(); }
     int64_t getPreloadMemoryBytes() const { return preloadMemoryBytes.load(); }
+    int64_t getRingBufferMemoryBytes() const { return ringPool.getAllocatedBytes(); }
 
     // ADSR controls
     void setADSR(float attack, float decay, float sustain, float release);
@@ -65,10 +72,84 @@ public:
     void setPreloadSizeKB(int sizeKB) { preloadSizeKB = juce::jlimit(32, 1024, sizeKB); }
     void reloadPreloadBuffers();  // Reload all preloaded samples with current preloadSizeKB
 
+    // Metadata only: keep the library layout (for the UI) but no preloads, so this engine
+    // can't play. Used while a plugin instance renders through the engine server. Leaving it
+    // returns at once: the preloads load on the budget's thread and notes stream from disk until then.
+    void setMetadataOnly(bool enabled);
+    bool isMetadataOnly() const { return metadataOnly; }
+
+    // Audio thread: play notes from disk from now on, until the preloads are back (the engine
+    // server just went away; setMetadataOnly(false) follows on the message thread)
+    void playWithoutPreloads();
+
+    // RAM budget for the preloads of all instances in the process (0 = off: the preload knob applies).
+    // Picks each sample's preload length to fit; libraries that fit are held whole and never stream.
+    void setPreloadBudgetBytes(int64_t bytes) { preloadBudget->setBudgetBytes(bytes); }
+    int64_t getPreloadBudgetBytes() const { return preloadBudget->getBudgetBytes(); }
+    bool isPreloadBudgetFullyResident() const { return preloadBudget->isEnabled() && preloadBudget->isFullyResident(); }
+
+    // Adaptive preloads: vary each sample's preload length with how often it's played, the rate
+    // it's played at and its storage device's latency (on by default). Same total RAM.
+    void setAdaptivePreloads(bool enabled);
+    bool getAdaptivePreloads() const { return adaptivePreloads; }
+
+    // Cold start: notes on samples outside the preload set (beyond the velocity layer and round
+    // robin limits) stream their attack from disk instead of falling back to a preloaded sample,
+    // so the limits only decide what's held in RAM. Off by default.
+    void setColdStart(bool enabled);
+    bool getColdStart() const { return coldStartEnabled; }
+    float getColdStartLatencyMs() const { return coldStartLatencyMs.load(std::memory_order_relaxed); }  // Recent average
+    int getColdStartMissCount() const { return coldStartMisses.load(std::memory_order_relaxed); }        // Gave up after maxColdStartWaitMs
+
+    // Learn & purge: every note-on marks the (note, layer, round robin) sample it played. With
+    // purging on, only learned samples keep their preload; the rest cold start, with one short
+    // stand-in per note kept resident. The learned set is saved with the project.
+    void setPurgeUnusedSamples(bool enabled);
+    bool getPurgeUnusedSamples() const { return purgeUnusedSamples; }
+    void clearLearnedSamples();
+    int getLearnedSampleCount() const;
+    juce::String getLearnedSamples() const;  // For the plugin state
+    void setLearnedSamples(const juce::String& folderPath, const juce::String& learned);  // Applies to that folder once loaded
+
+    // Hibernation: after hibernateAfterSeconds with nothing playing, or while the host bypasses
+    // the plugin, the engine parks its preloads in a file-backed mapping the kernel can drop,
+    // gives back its ring storage and drops out of the disk streamer's scans. MIDI or the end
+    // of the bypass wakes it: notes play from the parked preloads at once, and the preloads are
+    // copied back into RAM within a second. 0 = never hibernate (the default).
+    void setHibernateAfterSeconds(int seconds) { hibernateAfterSeconds.store(juce::jmax(0, seconds), std::memory_order_relaxed); }
+    int getHibernateAfterSeconds() const { return hibernateAfterSeconds.load(std::memory_order_relaxed); }
+    bool isHibernating() const { return hibernating.load(std::memory_order_relaxed); }
+    void wakeUp();           // Audio thread: MIDI arrived (processBlock also wakes on note events)
+    void processBypassed();  // Audio thread: called instead of processBlock while the host bypasses the plugin
+
+    // Share preloads with other processes (sandboxed hosts) through POSIX shared memory.
+    // Process-wide; applies to preloads loaded afterwards.
+    void setSharedMemoryPreloads(bool enabled) { samplePool->setCrossProcessSharing(enabled); }
+    bool getSharedMemoryPreloads() const { return samplePool->isCrossProcessSharingEnabled(); }
+
+    // Host-rate rendering: samples recorded at another rate than the host's play from copies
+    // resampled to it offline (HostRateCache), rendered on all cores when the library loads and
+    // cached on disk. Root-pitch notes then skip interpolation and 96 kHz sources stream half
+    // the bytes at 48 kHz. Changing it, or the host rate while it's on, reloads the library. Off by default.
+    void setRenderAtHostRate(bool enabled);
+    bool getRenderAtHostRate() const { return renderAtHostRate; }
+
+    // Audibility culling: a voice that can't get louder than the threshold for the hold time is
+    // retired early, freeing its slot and its disk reads. Its ceiling is velocity x envelope x the
+    // loudest the rest of its sample gets (SampleAnalysis level envelope; unanalysed samples count
+    // as full scale). At or below voiceCullOffDb culling is off. Default -90 dBFS for 100 ms.
+    static constexpr float voiceCullOffDb = -140.0f;
+    void setVoiceCullThresholdDb(float db) { voiceCullThresholdDb.store(juce::jlimit(voiceCullOffDb, 0.0f, db), std::memory_order_relaxed); }
+    float getVoiceCullThresholdDb() const { return voiceCullThresholdDb.load(std::memory_order_relaxed); }
+    void setVoiceCullHoldMs(int ms) { voiceCullHoldMs.store(juce::jlimit(0, 5000, ms), std::memory_order_relaxed); }
+    int getVoiceCullHoldMs() const { return voiceCullHoldMs.load(std::memory_order_relaxed); }
+    int getCulledVoiceCount() const { return culledVoices.load(std::memory_order_relaxed); }
+
     // Streaming activity info (for UI)
     int getActiveVoiceCount() const;
     int getStreamingVoiceCount() const;  // Voices actively reading from disk
-    float getDiskThroughputMBps() const; // Current disk throughput in MB/s
+    float getDiskThroughputMBps() const; // Current disk throughput in MB/s (this instance)
+    float getTotalDiskThroughputMBps() const; // Disk throughput of all instances in the process
     int getUnderrunCount() const;        // Total buffer underruns
     void resetUnderrunCount();           // Reset underrun counter
 
@@ -81,16 +162,33 @@ public:
     int getMaxVelocityLayers(int startNote, int endNote) const;  // Max layers in range
     int getVelocityLayerIndex(int midiNote, int velocity) const;  // Index of layer for velocity (0-based)
     int getMaxRoundRobins() const { return maxRoundRobins; }  // Max RR positions found in samples
+    int getPlayableRoundRobins() const { return coldStartEnabled ? maxRoundRobins : roundRobinLimit; }  // RR positions notes cycle through
     int getMaxVelocityLayersGlobal() const { return maxVelocityLayersGlobal; }  // Max velocity layers found across all notes
 
-    // Velocity layer limit (1 to maxVelocityLayersGlobal)
+    // Velocity layer limit (1 to maxVelocityLayersGlobal). Set while a library loads, it applies to that library.
     void setVelocityLayerLimit(int limit);
     int getVelocityLayerLimit() const { return velocityLayerLimit; }
 
-    // Round robin limit (1 to maxRoundRobins)
+    // Round robin limit (1 to maxRoundRobins), likewise
     void setRoundRobinLimit(int limit);
     int getRoundRobinLimit() const { return roundRobinLimit; }
 
+    // Interpolation quality for pitched voices (applies to notes started after the change)
+    void setInterpolationQuality(InterpolationQuality quality) { interpolationQuality = quality; }
+    InterpolationQuality getInterpolationQuality() const { return interpolationQuality; }
+
+    // Voice-parallel rendering: 0 = render voices one by one, 4/8/16 = voices per SIMD batch
+    void setVoiceBatchLanes(int lanes);
+    int getVoiceBatchLanes() const { return voiceBatchLanes; }
+
+    // Multi-core rendering: worker threads that share the voices with the audio thread (0 = off)
+    void setRenderThreads(int numThreads) { renderPool.setNumWorkers(numThreads); }
+    int getRenderThreads() const { return renderPool.getNumWorkers(); }
+
+    // Disk I/O threads of the shared streamer (process-wide: affects every instance)
+    void setDiskIOThreads(int numThreads);
+    int getDiskIOThreads() const;
+
     // Same-note retrigger release time (for experimentation)
     void setSameNoteReleaseTime(float seconds) { sameNoteReleaseTime = juce::jlimit(0.01f, 5.0f, seconds); }
     float getSameNoteReleaseTime() const { return sameNoteReleaseTime; }
@@ -103,24 +201,50 @@ public:
     // Public static for unit testing
     static bool parseFileName(const juce::String& fileName, int& note, int& velocity, int& roundRobin);
 
+    // Learned samples as (note, velocity, round robin), stable across rescans of the folder.
+    // Written to the state as "60/100/1 62/80/2 ...". Public static for unit testing
+    using SampleKey = std::tuple<int, int, int>;
+    static juce::String formatSampleKeys(const std::set<SampleKey>& keys);
+    static std::set<SampleKey> parseSampleKeys(const juce::String& text);
+
 private:
 
-    std::map<int, NoteMapping> noteMappings; // Key: MIDI note number
+    // Library data shared with every other instance that loaded the same folder
+    juce::SharedResourcePointer<SharedSamplePool> samplePool;
+    SharedSamplePool::LibraryPtr library;
+
+    const std::map<int, NoteMapping>* noteMappings = &noNoteMappings; // Key: MIDI note number (points into library)
+    static const std::map<int, NoteMapping> noNoteMappings;
 
     ADSRParams adsrParams;
 
+    // Bumped by setADSR(); the audio thread pushes parameters to voices only when it changes
+    std::atomic<uint32_t> adsrParamsVersion{1};
+    uint32_t appliedADSRVersion = 0;  // Audio thread only
+    juce::ADSR::Parameters getADSRParameters() const;
+
     double currentSampleRate = 44100.0;
+    bool renderAtHostRate = false;
     juce::String loadedFolderPath;
     std::atomic<int64_t> totalInstrumentFileSize{0};  // Total file size in bytes
     std::atomic<int64_t> preloadMemoryBytes{0};       // RAM used by preload buffers
 
     // Async loading
     std::atomic<LoadingState> loadingState{LoadingState::Idle};
+
+    // Progressive loading: written by the loading thread, gates note-ons on the audio thread
+    std::array<std::atomic<bool>, 128> notePlayable {};
+    std::array<std::atomic<float>, 128> noteLoadProgress {};
+    std::atomic<float> loadProgress{0.0f};
+    void loadPreloadsProgressively();
+    void publishNoteLoadState(int midiNote, float progress, bool playable);  // mappingsMutex
     std::unique_ptr<std::thread> loadingThread;
     mutable std::recursive_mutex mappingsMutex;  // mutable + recursive for nested const method calls
 
     // Preload size
     int preloadSizeKB = 64;  // Default 64KB, configurable 32-1024KB
+    bool metadataOnly = false;
+    std::atomic<bool> preloadsRestoring{false};  // Preloads on their way back to RAM: notes stream from disk meanwhile
 
     // Max round-robin positions found in loaded samples
     int maxRoundRobins = 1;
@@ -134,38 +258,212 @@ private:
     // Round robin limit (user-adjustable, 1 to maxRoundRobins)
     int roundRobinLimit = 1;
 
+    // Limits asked for since the last load began (mappingsMutex, 0 = none): the load applies them
+    int requestedVelocityLayerLimit = 0;
+    int requestedRoundRobinLimit = 0;
+
     // Polyphonic same-note: max voices allowed per note before oldest is faded out
     static constexpr int maxVoicesPerNote = 4;
     uint64_t voiceStartCounterGlobal = 0;  // Incremented each time a voice starts
     float sameNoteReleaseTime = 0.3f;      // Release time for same-note retrigger (seconds)
 
+    // Interpolation quality for pitched playback
+    InterpolationQuality interpolationQuality = InterpolationQuality::Linear;
+
+    // Ring storage shared by the streaming voices, grown and reclaimed by the disk thread
+    RingBufferPool ringPool;
+    static constexpr int ringReserveSlabs = 16;  // 8 stereo note-ons of headroom (2 MB)
+
     // Streaming voices
     std::array<StreamingVoice, StreamingConstants::maxStreamingVoices> streamingVoices;
 
-    // Background disk streaming thread
-    std::unique_ptr<DiskStreamer> diskStreamer;
+    // Lane-parallel renderer used when voiceBatchLanes > 0
+    VoiceBatchRenderer batchRenderer;
+    int voiceBatchLanes = 0;
+
+    // Worker pool used when render threads are enabled (and batching is off)
+    VoiceRenderPool renderPool;
+
+    // Cold start
+    static constexpr double maxColdStartWaitMs = 40.0;  // Longer and the note plays the stand-in (or is dropped)
+    static constexpr float coldStartLatencySmoothing = 0.1f;
+    bool coldStartEnabled = false;
+    std::atomic<float> coldStartLatencyMs{0.0f};
+    std::atomic<int> coldStartMisses{0};
+
+    // Cold-starting voices by voice index (audio thread); start counters spot voices stolen meanwhile
+    struct PendingColdStart
+    {
+        uint64_t voiceCounter = 0;         // 0 = no cold start pending on this voice
+        int substitute = -1;               // Voice playing a preloaded stand-in, -1 if the note waits
+        uint64_t substituteCounter = 0;
+    };
+    std::array<PendingColdStart, StreamingConstants::maxStreamingVoices> pendingColdStarts {};
+    int numPendingColdStarts = 0;
+    void serviceColdStarts();
+
+    // Voice allocation (steals the oldest voice if none is free) and start
+    StreamingVoice& allocateVoice();
+    void startVoice(StreamingVoice& voice, const PreloadedSample& sample, int midiNote, int velocity);
+
+    // Note events for the current block, in sample order
+    NoteEventQueue noteEvents;
+    void applyNoteEvent(const NoteEventQueue::Event& event);
+    void renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // Disk streaming service shared by all instances in the process
+    juce::SharedResourcePointer<DiskStreamer> diskStreamer;
+    DiskStreamer::ClientId streamingClient = DiskStreamer::invalidClient;
+
+    // Process-wide preload RAM budget (sizes preloads when enabled)
+    juce::SharedResourcePointer<PreloadBudget> preloadBudget;
+    PreloadBudget::ClientId budgetClient = PreloadBudget::invalidClient;
+
+    // Play statistics of one sample, recorded by the audio thread at note-on
+    struct PlayStats
+    {
+        std::atomic<uint32_t> playCount{0};
+        std::atomic<float> peakPitchRatio{0.0f};
+        std::atomic<bool> learned{false};  // Played at least once (learn & purge), never decays
+
+        PlayStats() = default;
+        PlayStats(const PlayStats& other) { *this = other; }
+        PlayStats& operator=(const PlayStats& other)
+        {
+            playCount.store(other.playCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            peakPitchRatio.store(other.peakPitchRatio.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            learned.store(other.learned.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        // Returns true the first time the sample is played
+        bool recordPlay(float pitchRatio)
+        {
+            playCount.fetch_add(1, std::memory_order_relaxed);
+            if (pitchRatio > peakPitchRatio.load(std::memory_order_relaxed))
+                peakPitchRatio.store(pitchRatio, std::memory_order_relaxed);
+
+            return !learned.load(std::memory_order_relaxed) && !learned.exchange(true, std::memory_order_relaxed);
+        }
+
+        // Fade old plays out so tiers follow recent playing (a note-on racing with this may be lost)
+        void decay()
+        {
+            const uint32_t count = playCount.load(std::memory_order_relaxed);
+            playCount.store(count - count / 8, std::memory_order_relaxed);
+        }
+    };
+
+    // The preload voices start from. Each preload is published as its own immutable PreloadedSample
+    // and swapped in whole, so the audio thread never sees a buffer and length from different loads.
+    // Written under mappingsMutex, read lock-free by the audio thread.
+    struct PublishedPreload
+    {
+        std::shared_ptr<const PreloadedSample> owner;  // mappingsMutex
+        std::atomic<const PreloadedSample*> current{nullptr};
+
+        PublishedPreload() = default;
+        PublishedPreload(const PublishedPreload& other) { *this = other; }
+        PublishedPreload& operator=(const PublishedPreload& other)
+        {
+            owner = other.owner;
+            current.store(other.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        // Sequentially consistent against retirement, which reads audioBlockEpoch after swapping it out
+        const PreloadedSample* get() const { return current.load(); }
+    };
 
     // Preloaded samples for streaming
     struct StreamingSample
     {
-        PreloadedSample preload;
+        PreloadedSample preload;      // Metadata only, never preloaded: cold starts stream from it
         int midiNote = 0;
         int velocity = 0;
         int roundRobin = 0;
         int velocityLayerIndex = -1;  // Which layer this sample belongs to (0-based)
-        bool isPreloaded = false;     // Whether preload buffer is currently loaded
+        bool isPreloaded = false;     // Whether preload buffer is currently loaded (mappingsMutex; the audio thread checks published)
+        int librarySampleIndex = -1;  // Index into library->samples
+        SharedSamplePool::PreloadPtr sharedPreload;  // Keeps the shared preload that the published version refers to
+        PublishedPreload published;   // Null while not preloaded
+        mutable PlayStats playStats;  // Audio thread (through const lookups)
+        int preloadTier = 0;          // Preload weight is 2^tier (adaptive preloads)
+        bool purgeStandIn = false;    // Kept at the minimum preload for a note with nothing learned
+        double usageWeight = 1.0;     // Usage part of the weight, kept while there are too few plays to judge
     };
     std::vector<StreamingSample> streamingSamples;
 
-    // Format manager for streaming
-    juce::AudioFormatManager formatManager;
-
     // Internal methods
     void loadSamplesInBackground(const juce::String& folderPath);
-    const StreamingSample* findStreamingSample(int midiNote, int velocity, int roundRobin) const;
+    // Preloaded samples within the limits, or for cold starts any sample within the limits / over all layers
+    enum class SampleLookup { Preloaded, WithinLimits, AllLayers };
+    const StreamingSample* findStreamingSample(int midiNote, int velocity, int roundRobin,
+                                               SampleLookup lookup = SampleLookup::Preloaded) const;
+
+    // Replaced preload versions (and the buffers they refer to) stay alive until no voice, nor a
+    // disk read leasing a voice's ring, refers to them. A note can only start from a version that
+    // was still published when its block began, so they're checked once that block has ended.
+    // A reload retires the previous sample array the same way: cold starts play its metadata.
+    struct RetiredPreload
+    {
+        SharedSamplePool::PreloadPtr buffer;
+        std::shared_ptr<const PreloadedSample> version;
+        std::shared_ptr<const std::vector<StreamingSample>> samples;
+        SharedSamplePool::LibraryPtr library;  // noteMappings of the block in flight point into it
+        uint64_t audioBlockEpoch = 0;          // When it was retired
+    };
+    std::vector<RetiredPreload> retiredPreloads;  // mappingsMutex
+    std::atomic<uint64_t> audioBlockEpoch{0};      // Bumped as processBlock starts and ends: odd while it runs
+
+    // Adaptive preload tiers
+    static constexpr int minPreloadTier = -2;                 // A quarter of the normal length
+    static constexpr int maxPreloadTier = 3;                  // Eight times
+    static constexpr int minPlaysForUsageTiers = 64;          // Before that, play counts don't move tiers
+    static constexpr double preloadTierIntervalMs = 30000.0;
+    static constexpr float referenceDeviceLatencyMs = 5.0f;   // Devices slower than this get longer preloads
+    bool adaptivePreloads = true;
+    double tierWeightScale = 1.0;     // Keeps the mean weight at 1 without a budget (mappingsMutex)
+    double lastTierUpdateTime = 0.0;  // Budget monitor thread
+
+    /** Re-tier every sample from its play statistics; true if any preload length changes */
+    bool updatePreloadTiers(bool decayPlayCounts);
+    float getPreloadWeight(const StreamingSample& ss) const;
+
+    // Learn & purge
+    bool purgeUnusedSamples = false;
+    mutable std::set<SampleKey> learnedSamples;      // mappingsMutex; flags on the samples are newer
+    juce::String learnedFolderPath;                  // Library the learned set belongs to
+    std::atomic<bool> learnedSamplesChanged{false};  // Audio thread: a sample was played for the first time
+    void syncLearnedSamples() const;                 // Sample flags into learnedSamples (mappingsMutex)
+    void updatePurgeStandIns();
+
+    // Hibernation
+    static constexpr int hibernationRingReserveSlabs = 8;  // A four-note stereo chord can wake the engine without being dropped
+    std::atomic<int> hibernateAfterSeconds{0};
+    std::atomic<bool> hibernating{false};    // Also read by the disk streamer: skip this client while set
+    std::atomic<bool> wakeRequested{false};  // Woken (or metadata only left), preloads not back yet
+    std::atomic<bool> bypassed{false};       // Audio thread: the host bypassed the last block
+    std::atomic<int64_t> idleSamples{0};     // Audio thread: samples rendered since anything played
+    bool preloadsParked = false;             // mappingsMutex: preloads refer into a PreloadPack
+    bool shouldHibernate() const;
+    void enterHibernation();
+
+    // Audibility culling (audio thread)
+    std::atomic<float> voiceCullThresholdDb{-90.0f};
+    std::atomic<int> voiceCullHoldMs{100};
+    std::atomic<int> culledVoices{0};
+    void cullInaudibleVoices(int numSamples);
 
     // Selective preloading methods
+    bool isWithinLimits(const StreamingSample& ss) const;
     bool shouldSampleBePreloaded(const StreamingSample& ss) const;
+    int getPreloadFrames(const StreamingSample& ss) const;  // From the budget if enabled, else preloadSizeKB (times the weight)
+    void publishPreloadDemand();
     void updatePreloadedSamples();
-    void loadSamplePreloadBuffer(StreamingSample& ss);
+    void loadSamplePreloadBuffer(StreamingSample& ss, int numFrames);
+    void setSamplePreload(StreamingSample& ss, SharedSamplePool::PreloadPtr buffer);
+    void retirePreload(StreamingSample& ss);
+    void retirePreload(SharedSamplePool::PreloadPtr buffer, std::shared_ptr<const PreloadedSample> version);
+    void releaseRetiredPreloads();
 };
@@ -0,0 +1,345 @@
+#include "SharedPreloadStore.h"
+#include "DebugLog.h"
+
+#if ! JUCE_WINDOWS
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #include <cerrno>
+ #include <cstring>
+ #include <new>
+#endif
+
+uint64_t SharedPreloadStore::hash(const void* data, size_t numBytes, uint64_t seed)
+{
+    auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+        h ^= bytes[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t SharedPreloadStore::hash(const juce::String& text, uint64_t seed)
+{
+    const char* utf8 = text.toRawUTF8();
+    return hash(utf8, std::strlen(utf8), seed);
+}
+
+juce::String SharedPreloadStore::getSegmentName(uint64_t key)
+{
+    return "/hmr" + juce::String::toHexString(static_cast<juce::int64>(key)).paddedLeft('0', 16);
+}
+
+#if JUCE_WINDOWS
+
+bool SharedPreloadStore::isSupported() { return false; }
+
+SharedPreloadStore::PreloadPtr SharedPreloadStore::acquire(uint64_t, int, int, const Loader&) { return {}; }
+
+int SharedPreloadStore::getAttachedProcessCount(uint64_t) { return 0; }
+
+#else
+
+namespace
+{
+    enum SegmentState : uint32_t
+    {
+        Uninitialised = 0,  // Zero-filled by ftruncate, builder hasn't written the header yet
+        Building,
+        Ready,
+        Failed
+    };
+
+    constexpr uint32_t segmentMagic = 0x484d5250;  // "HMRP"
+    constexpr uint32_t segmentLayoutVersion = 1;
+
+    /** Lives at the start of every segment. Atomics must be lock-free to work across processes. */
+    struct SegmentHeader
+    {
+        uint32_t magic;
+        uint32_t layoutVersion;
+        std::atomic<uint32_t> state;
+        std::atomic<int32_t> builderPid;
+        uint64_t key;
+        int32_t numChannels;
+        int32_t numFrames;
+        std::atomic<int32_t> attached[SharedPreloadStore::maxAttachedProcesses];  // PIDs, 0 = free
+    };
+
+    static_assert(std::atomic<int32_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "Shared-memory preloads need address-free atomics");
+    static_assert(sizeof(SegmentHeader) <= 4096, "Segment header must fit in one page");
+
+    size_t getHeaderBytes()
+    {
+        return static_cast<size_t>(juce::jmax(4096L, sysconf(_SC_PAGESIZE)));
+    }
+
+    bool isProcessAlive(int32_t pid)
+    {
+        // EPERM: alive but owned by someone we can't signal. A sandbox in its own PID
+        // namespace can look dead, which only costs an early unlink (mappings stay valid).
+        return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+    }
+
+    void sweepDeadProcesses(SegmentHeader& header)
+    {
+        for (auto& slot : header.attached)
+        {
+            int32_t pid = slot.load(std::memory_order_acquire);
+            if (pid != 0 && !isProcessAlive(pid))
+                slot.compare_exchange_strong(pid, 0, std::memory_order_acq_rel);
+        }
+    }
+
+    int countAttached(const SegmentHeader& header)
+    {
+        int count = 0;
+        for (const auto& slot : header.attached)
+        {
+            if (slot.load(std::memory_order_acquire) != 0)
+                ++count;
+        }
+        return count;
+    }
+
+    int attach(SegmentHeader& header)
+    {
+        sweepDeadProcesses(header);
+
+        const auto pid = static_cast<int32_t>(getpid());
+        for (int i = 0; i < SharedPreloadStore::maxAttachedProcesses; ++i)
+        {
+            int32_t expected = 0;
+            if (header.attached[i].compare_exchange_strong(expected, pid, std::memory_order_acq_rel))
+                return i;
+        }
+        return -1;
+    }
+
+    /** One process's mapping of a segment. Detaches (and unlinks if last) on destruction. */
+    struct Attachment
+    {
+        juce::String name;
+        SegmentHeader* header = nullptr;
+        size_t headerBytes = 0;
+        float* data = nullptr;
+        size_t dataBytes = 0;
+        int slot = -1;
+        bool unlinked = false;  // Name already removed by us (and maybe reused by a new segment)
+        juce::AudioBuffer<float> buffer;
+
+        ~Attachment()
+        {
+            if (data != nullptr)
+                munmap(data, dataBytes);
+
+            if (header == nullptr)
+                return;
+
+            if (slot >= 0)
+                header->attached[slot].store(0, std::memory_order_release);
+
+            sweepDeadProcesses(*header);
+            if (!unlinked && countAttached(*header) == 0)
+            {
+                // A process attaching right now keeps its mapping; later ones build a fresh segment
+                shm_unlink(name.toRawUTF8());
+                DebugLog::write("SharedPreloadStore: unlinked " + name);
+            }
+
+            munmap(header, headerBytes);
+        }
+
+        void referToData(int numChannels, int numFrames)
+        {
+            float* channels[2] = { data, data + numFrames };
+            buffer.setDataToReferTo(channels, numChannels, numFrames);
+        }
+    };
+
+    template <typename Predicate>
+    bool waitFor(Predicate&& condition)
+    {
+        const auto start = juce::Time::getMillisecondCounter();
+        while (!condition())
+        {
+            if (juce::Time::getMillisecondCounter() - start > static_cast<juce::uint32>(SharedPreloadStore::readyTimeoutMs))
+                return false;
+            juce::Thread::sleep(1);
+        }
+        return true;
+    }
+}
+
+bool SharedPreloadStore::isSupported()
+{
+    return true;
+}
+
+SharedPreloadStore::PreloadPtr SharedPreloadStore::acquire(uint64_t key, int numChannels, int numFrames, const Loader& loader)
+{
+    if (numChannels < 1 || numChannels > 2 || numFrames <= 0)
+        return {};
+
+    const juce::String name = getSegmentName(key);
+    const size_t headerBytes = getHeaderBytes();
+    const size_t dataBytes = static_cast<size_t>(numChannels) * static_cast<size_t>(numFrames) * sizeof(float);
+    const auto totalBytes = static_cast<off_t>(headerBytes + dataBytes);
+
+    // A few attempts: the segment can be unlinked between our open and attach, or found stale
+    for (int attempt = 0; attempt < 3; ++attempt)
+    {
+        auto attachment = std::make_shared<Attachment>();
+        attachment->name = name;
+        attachment->headerBytes = headerBytes;
+        attachment->dataBytes = dataBytes;
+
+        int fd = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd >= 0)
+        {
+            // We create it: size, initialise the header, decode, then publish read-only
+            bool mapped = ftruncate(fd, totalBytes) == 0;
+            void* header = mapped ? mmap(nullptr, headerBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+            void* data = mapped ? mmap(nullptr, dataBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(headerBytes)) : MAP_FAILED;
+            close(fd);
+
+            if (header == MAP_FAILED || data == MAP_FAILED)
+            {
+                if (header != MAP_FAILED) munmap(header, headerBytes);
+                if (data != MAP_FAILED) munmap(data, dataBytes);
+                shm_unlink(name.toRawUTF8());
+                return {};
+            }
+
+            auto* h = new (header) SegmentHeader();
+            h->magic = segmentMagic;
+            h->layoutVersion = segmentLayoutVersion;
+            h->key = key;
+            h->numChannels = numChannels;
+            h->numFrames = numFrames;
+            h->builderPid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+
+            attachment->header = h;
+            attachment->data = static_cast<float*>(data);
+            attachment->slot = attach(*h);
+            h->state.store(Building, std::memory_order_release);
+
+            attachment->referToData(numChannels, numFrames);
+            if (!loader(attachment->buffer))
+            {
+                h->state.store(Failed, std::memory_order_release);
+                return {};
+            }
+
+            mprotect(data, dataBytes, PROT_READ);
+            h->state.store(Ready, std::memory_order_release);
+
+            DebugLog::write("SharedPreloadStore: built " + name + " (" + juce::String(static_cast<int>(dataBytes / 1024)) + " KB)");
+            return PreloadPtr(attachment, &attachment->buffer);
+        }
+
+        if (errno != EEXIST)
+            return {};  // No shared memory here (sandbox policy, limits): use a private buffer
+
+        fd = shm_open(name.toRawUTF8(), O_RDWR, 0);
+        if (fd < 0)
+            continue;  // Unlinked by its last user since our create attempt
+
+        struct stat info {};
+        const bool sized = waitFor([&] { return fstat(fd, &info) == 0 && info.st_size > 0; });
+        if (!sized || info.st_size != totalBytes)
+        {
+            close(fd);
+            return {};
+        }
+
+        void* header = mmap(nullptr, headerBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        void* data = mmap(nullptr, dataBytes, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(headerBytes));
+        close(fd);
+
+        if (header == MAP_FAILED || data == MAP_FAILED)
+        {
+            if (header != MAP_FAILED) munmap(header, headerBytes);
+            if (data != MAP_FAILED) munmap(data, dataBytes);
+            return {};
+        }
+
+        auto* h = static_cast<SegmentHeader*>(header);
+        attachment->header = h;
+        attachment->data = static_cast<float*>(data);
+
+        if (!waitFor([h] { return h->state.load(std::memory_order_acquire) != Uninitialised; }))
+        {
+            // Creator died before writing the header: nobody can ever use this segment
+            shm_unlink(name.toRawUTF8());
+            attachment->unlinked = true;
+            continue;
+        }
+
+        if (h->magic != segmentMagic || h->layoutVersion != segmentLayoutVersion || h->key != key
+            || h->numChannels != numChannels || h->numFrames != numFrames)
+        {
+            return {};
+        }
+
+        attachment->slot = attach(*h);
+        if (attachment->slot < 0)
+            return {};
+
+        bool stale = false;
+        const bool ready = waitFor([h, &stale]
+        {
+            const auto state = h->state.load(std::memory_order_acquire);
+            stale = state == Building && !isProcessAlive(h->builderPid.load(std::memory_order_relaxed));
+            return state != Building || stale;
+        });
+
+        if (stale)
+        {
+            // Builder died mid-decode: remove the name so the next attempt rebuilds it
+            shm_unlink(name.toRawUTF8());
+            attachment->unlinked = true;
+            continue;
+        }
+
+        if (!ready || h->state.load(std::memory_order_acquire) != Ready)
+            return {};
+
+        attachment->referToData(numChannels, numFrames);
+        return PreloadPtr(attachment, &attachment->buffer);
+    }
+
+    return {};
+}
+
+int SharedPreloadStore::getAttachedProcessCount(uint64_t key)
+{
+    const juce::String name = getSegmentName(key);
+    int fd = shm_open(name.toRawUTF8(), O_RDONLY, 0);
+    if (fd < 0)
+        return 0;
+
+    const size_t headerBytes = getHeaderBytes();
+    void* header = mmap(nullptr, headerBytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (header == MAP_FAILED)
+        return 0;
+
+    int count = 0;
+    for (const auto& slot : static_cast<const SegmentHeader*>(header)->attached)
+    {
+        if (isProcessAlive(slot.load(std::memory_order_acquire)))
+            ++count;
+    }
+
+    munmap(header, headerBytes);
+    return count;
+}
+
+#endif
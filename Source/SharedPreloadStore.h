@@ -0,0 +1,49 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+/**
+ * SharedPreloadStore keeps decoded preload buffers in POSIX shared memory so that
+ * independent processes (plugin hosts that sandbox every instance) map the same pages
+ * instead of each decoding its own copy.
+ *
+ * - One segment per preload, named from a 64-bit key (library fingerprint, sample, preload size)
+ * - The first process to create a segment decodes into it; everyone else maps the audio
+ *   read-only once the builder marks it ready
+ * - The segment header holds a table of attached process IDs: the last process to detach
+ *   unlinks the segment, and slots of processes that died without detaching are swept
+ *
+ * Not supported on Windows. Any failure (no shm in the sandbox, table full, builder died)
+ * returns nullptr and the caller falls back to a private buffer.
+ */
+class SharedPreloadStore
+{
+public:
+    using PreloadPtr = std::shared_ptr<const juce::AudioBuffer<float>>;
+
+    /** Decodes the preload into the buffer it is given. Returns false on read failure. */
+    using Loader = std::function<bool(juce::AudioBuffer<float>&)>;
+
+    static constexpr int maxAttachedProcesses = 256;
+    static constexpr int readyTimeoutMs = 10000;
+
+    /** Whether shared-memory preloads can work on this platform */
+    static bool isSupported();
+
+    /** Map the shared preload for a key, decoding it with loader if no process has it yet */
+    static PreloadPtr acquire(uint64_t key, int numChannels, int numFrames, const Loader& loader);
+
+    /** Name of the shm segment for a key (short enough for macOS's 31 character limit) */
+    static juce::String getSegmentName(uint64_t key);
+
+    /** Number of live processes attached to a key's segment (0 if none exists) */
+    static int getAttachedProcessCount(uint64_t key);
+
+    /** FNV-1a, stable across processes and builds (std::hash isn't) */
+    static uint64_t hash(const void* data, size_t numBytes, uint64_t seed = 14695981039346656037ull);
+    static uint64_t hash(const juce::String& text, uint64_t seed = 14695981039346656037ull);
+};
@@ -0,0 +1,572 @@
+#include "SharedSamplePool.h"
+#include "DebugLog.h"
+#include "SampleFileName.h"
+#include "SharedPreloadStore.h"
+#include "DiskStreamer.h"
+#include "SampleContainer.h"
+#include "FlacSeekIndex.h"
+#include "HostRateCache.h"
+#include <algorithm>
+
+namespace
+{
+    const char* const sampleFileWildcard = "*.wav;*.aif;*.aiff;*.flac;*.mp3";
+
+    // File name, size and modification time: changes whenever the file is replaced or edited
+    uint64_t getFileFingerprint(const juce::File& file, const juce::String& name)
+    {
+        const int64_t fileSize = file.getSize();
+        const int64_t modified = file.getLastModificationTime().toMilliseconds();
+        uint64_t fingerprint = SharedPreloadStore::hash(name);
+        fingerprint = SharedPreloadStore::hash(&fileSize, sizeof(fileSize), fingerprint);
+        return SharedPreloadStore::hash(&modified, sizeof(modified), fingerprint);
+    }
+}
+
+SharedSamplePool::SharedSamplePool()
+{
+    formatManager.registerBasicFormats();
+}
+
+SharedSamplePool::~SharedSamplePool() = default;
+
+SharedSamplePool::LibraryPtr SharedSamplePool::acquireLibrary(const juce::String& folderPath, double renderRate)
+{
+    // The folder's current contents are part of the key, so a reload after editing the files rescans
+    auto key = folderPath + "#" + juce::String::toHexString(static_cast<juce::int64>(getFolderStamp(folderPath)));
+    if (renderRate > 0.0)
+        key += "@" + juce::String(juce::roundToInt(renderRate));
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Another instance is scanning this folder: wait for its result
+    loadFinished.wait(lock, [this, &key]
+    {
+        const auto it = libraries.find(key);
+        return it == libraries.end() || !it->second.loading;
+    });
+
+    pruneReleasedEntries();
+    auto& entry = libraries[key];
+
+    if (auto existing = entry.library.lock())
+    {
+        DebugLog::write("SharedSamplePool: reusing library " + key);
+        return existing;
+    }
+
+    entry.loading = true;
+    lock.unlock();
+
+    // A rendering starts from the original library (shared with instances that play it as it is)
+    LibraryPtr library = renderRate > 0.0 ? renderLibrary(*acquireLibrary(folderPath), key, renderRate)
+                                          : scanLibrary(folderPath, key);
+
+    lock.lock();
+    auto& finishedEntry = libraries[key];
+    finishedEntry.library = library;
+    finishedEntry.loading = false;
+    lock.unlock();
+
+    loadFinished.notify_all();
+    return library;
+}
+
+SharedSamplePool::PreloadPtr SharedSamplePool::acquirePreload(const Library& library, int sampleIndex, int numFrames,
+                                                              const juce::AudioBuffer<float>* source)
+{
+    if (sampleIndex < 0 || sampleIndex >= static_cast<int>(library.samples.size()) || numFrames <= 0)
+        return {};
+
+    const auto& librarySample = library.samples[static_cast<size_t>(sampleIndex)];
+    const PreloadKey key { library.key, sampleIndex, librarySample.fingerprint, librarySample.metadata.startFrame, numFrames };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    loadFinished.wait(lock, [this, &key]
+    {
+        const auto it = preloads.find(key);
+        return it == preloads.end() || !it->second.loading;
+    });
+
+    auto& entry = preloads[key];
+    if (auto existing = entry.buffer.lock())
+        return existing;
+
+    entry.loading = true;
+    lock.unlock();
+
+    PreloadPtr buffer = loadPreload(library, librarySample, numFrames, source);
+
+    lock.lock();
+    auto& finishedEntry = preloads[key];
+    finishedEntry.buffer = buffer;
+    finishedEntry.loading = false;
+
+    // Drop this sample's entries for preload lengths (or earlier starts) nobody holds any more
+    const auto sampleEnd = preloads.lower_bound({ library.key, sampleIndex + 1, 0, 0, 0 });
+    for (auto it = preloads.lower_bound({ library.key, sampleIndex, 0, 0, 0 }); it != sampleEnd;)
+    {
+        if (!it->second.loading && it->second.buffer.expired())
+            it = preloads.erase(it);
+        else
+            ++it;
+    }
+    lock.unlock();
+
+    loadFinished.notify_all();
+    return buffer;
+}
+
+uint64_t SharedSamplePool::getFolderStamp(const juce::String& folderPath)
+{
+    // What scanLibrary would read, without opening anything: the container, or else the sample files
+    const juce::File folder(folderPath);
+    const auto containerFile = SampleContainer::findInFolder(folder);
+    if (containerFile.existsAsFile())
+        return getFileFingerprint(containerFile, containerFile.getFileName());
+
+    juce::Array<juce::File> audioFiles;
+    folder.findChildFiles(audioFiles, juce::File::findFiles, false, sampleFileWildcard);
+
+    std::vector<uint64_t> fingerprints;
+    for (const auto& file : audioFiles)
+        fingerprints.push_back(getFileFingerprint(file, file.getFileName()));
+    std::sort(fingerprints.begin(), fingerprints.end());
+    return SharedPreloadStore::hash(fingerprints.data(), fingerprints.size() * sizeof(uint64_t));
+}
+
+void SharedSamplePool::pruneReleasedEntries()
+{
+    // Libraries and preloads no instance holds any more (including older scans of an edited folder)
+    for (auto it = libraries.begin(); it != libraries.end();)
+    {
+        if (!it->second.loading && it->second.library.expired())
+            it = libraries.erase(it);
+        else
+            ++it;
+    }
+
+    for (auto it = preloads.begin(); it != preloads.end();)
+    {
+        if (!it->second.loading && it->second.buffer.expired())
+            it = preloads.erase(it);
+        else
+            ++it;
+    }
+}
+
+int SharedSamplePool::getPreloadFrames(const PreloadedSample& sample, int64_t preloadBytes)
+{
+    const int64_t bytesPerFrame = static_cast<int64_t>(juce::jmax(1, sample.numChannels)) * static_cast<int64_t>(sizeof(float));
+    return static_cast<int>(std::min(preloadBytes / bytesPerFrame, sample.totalSampleFrames));
+}
+
+SharedSamplePool::PreloadPtr SharedSamplePool::loadPreload(const Library& library, const LibrarySample& librarySample,
+                                                           int framesToPreload, const juce::AudioBuffer<float>* source)
+{
+    const auto& sample = librarySample.metadata;
+
+    // A copy of the same frames is a memcpy rather than a decode
+    if (source != nullptr && (source->getNumSamples() != framesToPreload || source->getNumChannels() != sample.numChannels))
+        source = nullptr;
+
+    auto readInto = [this, &sample, framesToPreload, source](juce::AudioBuffer<float>& buffer)
+    {
+        if (source != nullptr)
+        {
+            for (int ch = 0; ch < sample.numChannels; ++ch)
+                buffer.copyFrom(ch, 0, *source, ch, 0, framesToPreload);
+            return true;
+        }
+
+        auto reader = SampleContainer::createReaderFor(formatManager, sample.filePath);
+        return reader != nullptr && reader->read(&buffer, 0, framesToPreload, sample.startFrame, true, true);
+    };
+
+    if (crossProcessSharing.load(std::memory_order_relaxed) && SharedPreloadStore::isSupported())
+    {
+        // Only the first process on the machine decodes; the others map its pages
+        uint64_t key = SharedPreloadStore::hash(&library.fingerprint, sizeof(library.fingerprint));
+        key = SharedPreloadStore::hash(&librarySample.fingerprint, sizeof(librarySample.fingerprint), key);
+        key = SharedPreloadStore::hash(&framesToPreload, sizeof(framesToPreload), key);
+        key = SharedPreloadStore::hash(&sample.startFrame, sizeof(sample.startFrame), key);   // Untrimmed before analysis
+
+        if (auto shared = SharedPreloadStore::acquire(key, sample.numChannels, framesToPreload, readInto))
+            return trackPreloadMemory(std::move(shared));
+
+        DebugLog::write("SharedSamplePool: shared memory unavailable for " + sample.name + ", using a private preload");
+    }
+
+    auto buffer = std::make_shared<juce::AudioBuffer<float>>(sample.numChannels, framesToPreload);
+    if (!readInto(*buffer))
+        return {};
+
+    return trackPreloadMemory(std::move(buffer));
+}
+
+SharedSamplePool::PreloadPtr SharedSamplePool::trackPreloadMemory(PreloadPtr buffer)
+{
+    // Track preload memory for as long as any instance holds the buffer
+    const int64_t bytes = static_cast<int64_t>(buffer->getNumSamples()) * buffer->getNumChannels()
+                        * static_cast<int64_t>(sizeof(float));
+    preloadBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    auto* raw = buffer.get();
+    return PreloadPtr(raw, [this, bytes, owner = std::move(buffer)](const juce::AudioBuffer<float>*) mutable
+    {
+        preloadBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        owner.reset();
+    });
+}
+
+std::unique_ptr<SharedSamplePool::Library> SharedSamplePool::scanLibrary(const juce::String& folderPath, const juce::String& key)
+{
+    DebugLog::write("SharedSamplePool: scanning library " + folderPath);
+
+    auto library = std::make_unique<Library>();
+    library->folderPath = folderPath;
+    library->key = key;
+
+    juce::File folder(folderPath);
+
+    // A packed library: everything comes from the container's index, no per-file opens
+    const auto containerFile = SampleContainer::findInFolder(folder);
+    if (auto container = containerFile.existsAsFile() ? SampleContainer::open(containerFile) : nullptr)
+        scanContainer(*library, std::move(container));
+    else
+        scanSampleFiles(*library, folder);
+
+    // Skip leading silence and inaudible tails found by earlier analysis; the rest is analysed in the background
+    applySampleAnalysis(*library);
+
+    // Fingerprint the library independently of folder path and directory listing order
+    std::vector<uint64_t> fingerprints;
+    for (const auto& ls : library->samples)
+        fingerprints.push_back(ls.fingerprint);
+    std::sort(fingerprints.begin(), fingerprints.end());
+    library->fingerprint = SharedPreloadStore::hash(fingerprints.data(), fingerprints.size() * sizeof(uint64_t));
+
+    // Build noteMappings
+    auto& mappings = library->noteMappings;
+    for (const auto& ls : library->samples)
+    {
+        auto& noteMapping = mappings[ls.midiNote];
+        noteMapping.midiNote = ls.midiNote;
+
+        auto it = std::find_if(noteMapping.velocityLayers.begin(), noteMapping.velocityLayers.end(),
+            [&ls](const VelocityLayer& layer) { return layer.velocityValue == ls.velocity; });
+
+        if (it == noteMapping.velocityLayers.end())
+        {
+            VelocityLayer newLayer;
+            newLayer.velocityValue = ls.velocity;
+            noteMapping.velocityLayers.push_back(newLayer);
+        }
+    }
+
+    // Build velocity ranges
+    for (auto& [note, mapping] : mappings)
+    {
+        std::sort(mapping.velocityLayers.begin(), mapping.velocityLayers.end(),
+            [](const VelocityLayer& a, const VelocityLayer& b) {
+                return a.velocityValue < b.velocityValue;
+            });
+
+        for (size_t i = 0; i < mapping.velocityLayers.size(); ++i)
+        {
+            auto& layer = mapping.velocityLayers[i];
+            if (i == 0)
+                layer.velocityRangeStart = 1;
+            else
+                layer.velocityRangeStart = mapping.velocityLayers[i - 1].velocityValue + 1;
+            layer.velocityRangeEnd = layer.velocityValue;
+        }
+    }
+
+    // Build fallbacks
+    for (int n = 0; n < 128; ++n)
+    {
+        if (mappings.find(n) == mappings.end())
+        {
+            int fallback = -1;
+            for (int higher = n + 1; higher < 128; ++higher)
+            {
+                if (mappings.find(higher) != mappings.end())
+                {
+                    fallback = higher;
+                    break;
+                }
+            }
+            if (fallback >= 0)
+            {
+                mappings[n].midiNote = n;
+                mappings[n].fallbackNote = fallback;
+            }
+        }
+        else
+        {
+            mappings[n].fallbackNote = -1;
+        }
+    }
+
+    // Calculate max velocity layers across all notes
+    for (const auto& [note, mapping] : mappings)
+    {
+        int layers = static_cast<int>(mapping.velocityLayers.size());
+        if (layers > library->maxVelocityLayers)
+            library->maxVelocityLayers = layers;
+    }
+
+    // Calculate velocityLayerIndex for each sample based on its position in the note's sorted layers
+    for (auto& ls : library->samples)
+    {
+        auto noteIt = mappings.find(ls.midiNote);
+        if (noteIt == mappings.end())
+            continue;
+
+        const auto& layers = noteIt->second.velocityLayers;
+        for (size_t i = 0; i < layers.size(); ++i)
+        {
+            if (layers[i].velocityValue == ls.velocity)
+            {
+                ls.velocityLayerIndex = static_cast<int>(i);
+                break;
+            }
+        }
+    }
+
+    DebugLog::write("Loaded " + juce::String(static_cast<int>(library->samples.size())) + " samples (metadata only)");
+    DebugLog::write("Max round-robins: " + juce::String(library->maxRoundRobins));
+    DebugLog::write("Max velocity layers: " + juce::String(library->maxVelocityLayers));
+    DebugLog::write("Total file size: " + juce::String(library->totalFileSize / (1024 * 1024)) + " MB");
+
+    return library;
+}
+
+std::unique_ptr<SharedSamplePool::Library> SharedSamplePool::renderLibrary(const Library& source, const juce::String& key,
+                                                                          double renderRate)
+{
+    auto library = std::make_unique<Library>(source);
+    library->key = key;
+    library->renderedRate = renderRate;
+    library->fingerprint = SharedPreloadStore::hash(&renderRate, sizeof(renderRate), source.fingerprint);
+
+    // Samples already at the rate play as they are; the rest need a copy, rendered now unless cached
+    const auto directory = HostRateCache::getDefaultDirectory();
+    const auto now = juce::Time::getCurrentTime();
+    std::vector<std::pair<size_t, juce::File>> copies;
+    std::vector<HostRateCache::Job> jobs;
+
+    for (size_t i = 0; i < library->samples.size(); ++i)
+    {
+        const auto& ls = library->samples[i];
+        if (std::abs(ls.metadata.sampleRate - renderRate) < 0.5)
+            continue;
+
+        const auto copy = HostRateCache::getCopyFile(directory, ls.metadata.filePath, ls.fingerprint, renderRate);
+        if (copy.existsAsFile())
+            copy.setLastAccessTime(now);   // In use: trimming keeps it
+        else
+            jobs.push_back({ ls.metadata.filePath, copy });
+
+        copies.emplace_back(i, copy);
+    }
+
+    if (!jobs.empty())
+    {
+        DebugLog::write("SharedSamplePool: rendering " + juce::String(static_cast<int>(jobs.size())) + " samples of "
+                        + source.folderPath + " at " + juce::String(renderRate, 0) + " Hz");
+        const double startTime = juce::Time::getMillisecondCounterHiRes();
+        const int numRendered = HostRateCache::renderAll(jobs, renderRate);
+        DebugLog::write("SharedSamplePool: rendered " + juce::String(numRendered) + " samples in "
+                        + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 0) + " ms");
+
+        // Copies other loaded libraries stream from, and this one's, stay whatever their age
+        juce::StringArray inUse;
+        for (const auto& [index, copy] : copies)
+            inUse.add(copy.getFullPathName());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const auto& [otherKey, entry] : libraries)
+                if (const auto other = entry.library.lock(); other != nullptr && other->renderedRate > 0.0)
+                    for (const auto& otherSample : other->samples)
+                        inUse.add(otherSample.metadata.filePath);
+        }
+
+        TranscodeCache::trim(directory, HostRateCache::defaultMaxBytes, inUse);
+    }
+
+    for (const auto& [index, copy] : copies)
+    {
+        // A sample whose copy failed keeps its source, resampled per voice as before
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(copy));
+        if (reader == nullptr)
+            continue;
+
+        // The copy holds the whole file: the trimmed start, length and end fade scale with the rate
+        auto& ls = library->samples[index];
+        const double ratio = reader->sampleRate / ls.metadata.sampleRate;
+        ls.metadata.filePath = copy.getFullPathName();
+        ls.metadata.sampleRate = reader->sampleRate;
+        ls.metadata.startFrame = static_cast<int64_t>(std::llround(static_cast<double>(ls.metadata.startFrame) * ratio));
+        ls.metadata.levelBlockFrames *= ratio;
+        ls.metadata.endFadeFrames = static_cast<int64_t>(std::llround(static_cast<double>(ls.metadata.endFadeFrames) * ratio));
+        ls.metadata.totalSampleFrames = std::min(static_cast<int64_t>(std::llround(static_cast<double>(ls.metadata.totalSampleFrames) * ratio)),
+                                                 static_cast<int64_t>(reader->lengthInSamples) - ls.metadata.startFrame);
+        ls.metadata.deviceId = DiskStreamer::getDeviceId(ls.metadata.filePath);
+        ls.fingerprint = SharedPreloadStore::hash(&renderRate, sizeof(renderRate), ls.fingerprint);
+    }
+
+    return library;
+}
+
+void SharedSamplePool::applySampleAnalysis(Library& library)
+{
+    const auto results = SampleAnalysis::loadIndex(library.folderPath);
+
+    std::vector<SampleAnalysis::Job> unanalysed;
+    int64_t trimmedFrames = 0;
+
+    for (auto& ls : library.samples)
+    {
+        const auto it = results.find(ls.fingerprint);
+        if (it == results.end())
+        {
+            unanalysed.push_back({ ls.fingerprint, ls.metadata.filePath });
+            continue;
+        }
+
+        const auto& result = it->second;
+        if (result.endFrame > ls.metadata.totalSampleFrames)
+            continue;
+
+        // A tail cut before the file ends fades out over the analysis' margin
+        if (result.endFrame < ls.metadata.totalSampleFrames)
+            ls.metadata.endFadeFrames = std::min(result.endFrame - result.startFrame,
+                                                 static_cast<int64_t>(SampleAnalysis::tailMarginMs * 0.001 * ls.metadata.sampleRate));
+
+        trimmedFrames += ls.metadata.totalSampleFrames - (result.endFrame - result.startFrame);
+        ls.metadata.startFrame = result.startFrame;
+        ls.metadata.totalSampleFrames = result.endFrame - result.startFrame;
+
+        if (!result.levels.empty())
+        {
+            ls.metadata.levelEnvelope = std::make_shared<const std::vector<float>>(result.levels);
+            ls.metadata.levelBlockFrames = SampleAnalysis::levelBlockFrames;
+        }
+    }
+
+    DebugLog::write("SharedSamplePool: silence trimming skips " + juce::String(trimmedFrames) + " frames, "
+                    + juce::String(static_cast<int>(unanalysed.size())) + " samples left to analyse");
+
+    sampleAnalysis.request(library.folderPath, std::move(unanalysed));
+}
+
+void SharedSamplePool::scanSampleFiles(Library& library, const juce::File& folder)
+{
+    juce::Array<juce::File> audioFiles;
+    folder.findChildFiles(audioFiles, juce::File::findFiles, false, sampleFileWildcard);
+
+    DebugLog::write("Found " + juce::String(audioFiles.size()) + " audio files");
+
+    for (const auto& file : audioFiles)
+    {
+        int note, velocity, roundRobin;
+        if (!SampleFileName::parse(file.getFileName(), note, velocity, roundRobin))
+            continue;
+
+        // Track max round-robin found
+        if (roundRobin > library.maxRoundRobins)
+            library.maxRoundRobins = roundRobin;
+
+        library.totalFileSize += file.getSize();
+
+        const uint64_t fingerprint = getFileFingerprint(file, file.getFileName());
+
+        // FLAC gets its frame table now (cached on disk after the first scan), so streaming never searches the file
+        if (file.hasFileExtension("flac"))
+            if (auto index = FlacSeekIndex::open(file, true))
+                library.flacIndexes.push_back(std::move(index));
+
+        // MP3 gets a decoded copy in the background; reads switch to it once it's there
+        if (TranscodeCache::needsTranscode(file))
+            transcodeCache.request(file);
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (!reader)
+            continue;
+
+        LibrarySample ls;
+        ls.midiNote = note;
+        ls.velocity = velocity;
+        ls.roundRobin = roundRobin;
+        ls.velocityLayerIndex = -1;  // Will be set after building noteMappings
+        ls.fingerprint = fingerprint;
+
+        ls.metadata.filePath = file.getFullPathName();
+        ls.metadata.sampleRate = reader->sampleRate;
+        ls.metadata.numChannels = static_cast<int>(reader->numChannels);
+        ls.metadata.deviceId = DiskStreamer::getDeviceId(ls.metadata.filePath);
+        ls.metadata.totalSampleFrames = static_cast<int64_t>(reader->lengthInSamples);
+        ls.metadata.name = file.getFileNameWithoutExtension();
+        ls.metadata.rootNote = note;
+        ls.metadata.lowNote = note;
+        ls.metadata.highNote = note;
+        ls.metadata.lowVelocity = velocity;
+        ls.metadata.highVelocity = velocity;
+        ls.metadata.preloadSizeFrames = 0;  // Set per instance when actually preloaded
+
+        library.samples.push_back(std::move(ls));
+    }
+}
+
+void SharedSamplePool::scanContainer(Library& library, std::shared_ptr<SampleContainer> container)
+{
+    const auto& containerFile = container->getFile();
+    const int64_t containerSize = containerFile.getSize();
+    const int64_t modified = containerFile.getLastModificationTime().toMilliseconds();
+    const uint64_t deviceId = DiskStreamer::getDeviceId(containerFile.getFullPathName());
+
+    DebugLog::write("Found container " + containerFile.getFullPathName() + " with "
+                    + juce::String(static_cast<int>(container->getEntries().size())) + " samples");
+
+    for (size_t i = 0; i < container->getEntries().size(); ++i)
+    {
+        const auto& entry = container->getEntries()[i];
+
+        if (entry.roundRobin > library.maxRoundRobins)
+            library.maxRoundRobins = entry.roundRobin;
+
+        library.totalFileSize += entry.totalFrames * entry.getBytesPerFrame();
+
+        uint64_t fingerprint = SharedPreloadStore::hash(entry.name);
+        fingerprint = SharedPreloadStore::hash(&containerSize, sizeof(containerSize), fingerprint);
+        fingerprint = SharedPreloadStore::hash(&modified, sizeof(modified), fingerprint);
+
+        LibrarySample ls;
+        ls.midiNote = entry.midiNote;
+        ls.velocity = entry.velocity;
+        ls.roundRobin = entry.roundRobin;
+        ls.velocityLayerIndex = -1;  // Will be set after building noteMappings
+        ls.fingerprint = fingerprint;
+
+        ls.metadata.filePath = SampleContainer::getEntryPath(containerFile, static_cast<int>(i));
+        ls.metadata.sampleRate = entry.sampleRate;
+        ls.metadata.numChannels = entry.numChannels;
+        ls.metadata.deviceId = deviceId;
+        ls.metadata.totalSampleFrames = entry.totalFrames;
+        ls.metadata.name = entry.name;
+        ls.metadata.rootNote = entry.midiNote;
+        ls.metadata.lowNote = entry.midiNote;
+        ls.metadata.highNote = entry.midiNote;
+        ls.metadata.lowVelocity = entry.velocity;
+        ls.metadata.highVelocity = entry.velocity;
+        ls.metadata.preloadSizeFrames = 0;  // Set per instance when actually preloaded
+
+        library.samples.push_back(std::move(ls));
+    }
+
+    // The library holds the container, so its descriptor and index outlive individual readers
+    library.container = std::move(container);
+}
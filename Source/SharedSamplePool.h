@@ -0,0 +1,151 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include "DiskStreaming.h"
+#include "TranscodeCache.h"
+#include "SampleAnalysis.h"
+
+class SampleContainer;
+class FlacSeekIndex;
+
+struct VelocityLayer
+{
+    int velocityValue;      // The actual velocity value from the file name
+    int velocityRangeStart; // Computed: lowest velocity that triggers this layer
+    int velocityRangeEnd;   // Computed: highest velocity that triggers this layer
+};
+
+struct NoteMapping
+{
+    int midiNote;
+    std::vector<VelocityLayer> velocityLayers; // Sorted by velocity ascending
+    int fallbackNote = -1; // If this note has no samples, use this note instead
+};
+
+/**
+ * SharedSamplePool is a process-wide cache of sample libraries, shared by every
+ * SamplerEngine in the process (hold it through juce::SharedResourcePointer).
+ *
+ * - Libraries (folder scan, sample metadata, note mappings) are keyed by folder path and a stamp
+ *   of its files (names, sizes, modification times), so a reload after editing the folder rescans
+ *   it; host-rate renderings are keyed by the same plus the rate
+ * - Preload buffers are keyed by library, sample (index, fingerprint and start frame) and preload length
+ * - Both are reference counted: they stay alive while any instance holds them, and their
+ *   entries are dropped once none does
+ * - Concurrent requests for the same library or preload wait for the one load in
+ *   flight instead of reading the files again
+ *
+ * Each engine keeps its own velocity layer / round-robin limits and picks which
+ * shared preloads it holds; the pool never copies audio between instances.
+ */
+class SharedSamplePool
+{
+public:
+    /** One sample file of a library (metadata only, preloadBuffer stays empty) */
+    struct LibrarySample
+    {
+        PreloadedSample metadata;
+        int midiNote = 0;
+        int velocity = 0;
+        int roundRobin = 0;
+        int velocityLayerIndex = -1;
+        uint64_t fingerprint = 0;   // File name, size and modification time
+    };
+
+    /** Everything about a library folder that doesn't depend on per-instance settings */
+    struct Library
+    {
+        juce::String folderPath;
+        juce::String key;           // Pool key: the folder path and stamp, plus the rate of a host-rate rendering
+        double renderedRate = 0.0;  // Rate its samples were rendered at (HostRateCache), 0 for the originals
+        std::vector<LibrarySample> samples;
+        std::map<int, NoteMapping> noteMappings;  // Including fallbacks for missing notes
+        int64_t totalFileSize = 0;
+        int maxRoundRobins = 1;
+        int maxVelocityLayers = 1;
+        uint64_t fingerprint = 0;   // Same files give the same value in every process, wherever the folder is mounted
+        std::shared_ptr<SampleContainer> container;   // Packed library (see SampleContainer), or null for loose files
+        std::vector<std::shared_ptr<FlacSeekIndex>> flacIndexes;   // Frame tables of its FLAC files, resident while loaded
+    };
+
+    using LibraryPtr = std::shared_ptr<const Library>;
+    using PreloadPtr = std::shared_ptr<const juce::AudioBuffer<float>>;
+
+    SharedSamplePool();
+    ~SharedSamplePool();
+
+    /** Get the library for a folder, scanning it only if no instance holds it yet (blocks while loading).
+        With a render rate, samples recorded at another rate are replaced by copies resampled to it
+        (HostRateCache), rendering the ones not in the cache yet first: that render runs on the calling
+        thread, and other callers asking for the same rendering wait for it. */
+    LibraryPtr acquireLibrary(const juce::String& folderPath, double renderRate = 0.0);
+
+    /** Get the first numFrames of one library sample (blocks while loading). If no instance holds
+        it and source has those frames (a hibernated preload), they are copied instead of decoded. */
+    PreloadPtr acquirePreload(const Library& library, int sampleIndex, int numFrames,
+                              const juce::AudioBuffer<float>* source = nullptr);
+
+    /** Bytes held by preload buffers across all instances */
+    int64_t getPreloadMemoryBytes() const { return preloadBytes.load(std::memory_order_relaxed); }
+
+    /** Frames a preload of the given size holds for this sample (the whole sample if it fits) */
+    static int getPreloadFrames(const PreloadedSample& sample, int64_t preloadBytes);
+
+    /** Also share preloads with other processes through shared memory (see SharedPreloadStore).
+        Affects preloads loaded after the call. */
+    void setCrossProcessSharing(bool enabled) { crossProcessSharing.store(enabled, std::memory_order_relaxed); }
+    bool isCrossProcessSharingEnabled() const { return crossProcessSharing.load(std::memory_order_relaxed); }
+
+    /** Decoded copies of the libraries' MP3 samples, made in the background after a scan */
+    TranscodeCache& getTranscodeCache() { return transcodeCache; }
+
+    /** Audible start and end of the libraries' samples, found in the background after a scan */
+    SampleAnalysis& getSampleAnalysis() { return sampleAnalysis; }
+
+private:
+    std::unique_ptr<Library> scanLibrary(const juce::String& folderPath, const juce::String& key);
+    std::unique_ptr<Library> renderLibrary(const Library& source, const juce::String& key, double renderRate);
+    void scanSampleFiles(Library& library, const juce::File& folder);
+    void scanContainer(Library& library, std::shared_ptr<SampleContainer> container);
+    void applySampleAnalysis(Library& library);
+    PreloadPtr loadPreload(const Library& library, const LibrarySample& sample, int framesToPreload,
+                           const juce::AudioBuffer<float>* source);
+    PreloadPtr trackPreloadMemory(PreloadPtr buffer);
+    static uint64_t getFolderStamp(const juce::String& folderPath);
+    void pruneReleasedEntries();   // Mutex held
+
+    struct LibraryEntry
+    {
+        std::weak_ptr<const Library> library;
+        bool loading = false;
+    };
+
+    struct PreloadEntry
+    {
+        std::weak_ptr<const juce::AudioBuffer<float>> buffer;
+        bool loading = false;
+    };
+
+    // (library key, sample index, sample fingerprint, start frame, frames): a sample whose file changed or
+    // whose start was trimmed by analysis never shares a preload with its earlier self
+    using PreloadKey = std::tuple<juce::String, int, uint64_t, int64_t, int>;
+
+    std::mutex mutex;
+    std::condition_variable loadFinished;
+    std::map<juce::String, LibraryEntry> libraries;
+    std::map<PreloadKey, PreloadEntry> preloads;
+
+    juce::AudioFormatManager formatManager;
+    std::atomic<int64_t> preloadBytes{0};
+    std::atomic<bool> crossProcessSharing{false};
+    TranscodeCache transcodeCache;
+    SampleAnalysis sampleAnalysis;
+};
@@ -1,34 +1,35 @@
 #include "StreamingVoice.h"
+#include "DebugLog.h"
+#include <algorithm>
+#include <cmath>
 
 // Static underrun counter definition
 std::atomic<int> StreamingVoice::underrunCount{0};
 
-// Debug logging to file
-static void voiceDebugLog(const juce::String& msg)
-{
-    auto logFile = juce::File::getSpecialLocation(juce::File::userDesktopDirectory)
-                       .getChildFile("sampler_streaming_debug.txt");
-    auto timestamp = juce::Time::getCurrentTime().toString(true, true, true, true);
-    logFile.appendText("[" + timestamp + "] " + msg + "\n");
-}
-
 StreamingVoice::StreamingVoice()
 {
-    // Allocate ring buffer for stereo audio
-    ringBuffer.setSize(2, StreamingConstants::ringBufferFrames);
-    ringBuffer.clear();
+    // Ring storage is drawn from the engine's RingBufferPool when a streaming note starts
 }
 
 StreamingVoice::~StreamingVoice() = default;
 
 void StreamingVoice::prepareToPlay(double sampleRate, int /*samplesPerBlock*/)
 {
-    adsr.setSampleRate(sampleRate);
+    envelope.setSampleRate(sampleRate);
 }
 
 void StreamingVoice::setADSRParameters(const juce::ADSR::Parameters& params)
 {
-    adsr.setParameters(params);
+    envelope.setParameters(params);
+}
+
+void StreamingVoice::updateADSRParameters(const juce::ADSR::Parameters& params, uint32_t version)
+{
+    if (version == envelopeParametersVersion)
+        return;
+
+    envelope.setParameters(params);
+    envelopeParametersVersion = version;
 }
 
 void StreamingVoice::startVoice(const PreloadedSample* sample, int midiNote, float vel, double hostSampleRate, uint64_t startCounter)
@@ -36,7 +37,28 @@ void StreamingVoice::startVoice(const PreloadedSample* sample, int midiNote, flo
     if (sample == nullptr || !sample->isValid())
         return;
 
+    // A disk read still writing into the last note's ring keeps the voice until it finishes
+    if ((ringState.fetch_or(ringSettingUpBit, std::memory_order_acquire) & ringLeasedBit) != 0)
+    {
+        ringState.fetch_and(~ringSettingUpBit, std::memory_order_release);
+        DebugLog::write("StreamingVoice::startVoice - ring still leased by a disk read, dropping note=" + juce::String(midiNote));
+        return;
+    }
+
+    // Streaming samples need ring storage; if the pool has none ready the note is dropped
+    const bool sampleStreams = sample->needsStreaming();
+    if (sampleStreams && !acquireRing(std::min(sample->numChannels, 2)))
+    {
+        ringState.fetch_add(ringGenerationStep - ringSettingUpBit, std::memory_order_release);
+        DebugLog::write("StreamingVoice::startVoice - no ring buffer available, dropping note=" + juce::String(midiNote));
+        return;
+    }
+
     currentSample = sample;
+    playingSample.store(sample, std::memory_order_release);
+    if (sampleStreams)
+        ringSample.store(sample, std::memory_order_release);
+    streaming = sampleStreams;
     playingNote = midiNote;
     velocity = vel;
     voiceStartCounter = startCounter;
@@ -49,8 +71,18 @@ void StreamingVoice::startVoice(const PreloadedSample* sample, int midiNote, flo
     // Adjust for sample rate difference
     pitchRatio *= sample->sampleRate / hostSampleRate;
 
+    // A tail trimmed above silence fades out rather than stopping dead
+    const int64_t endFadeFrames = std::min(sample->endFadeFrames, sample->totalSampleFrames);
+    endFadeStartFrame = endFadeFrames > 0 ? sample->totalSampleFrames - endFadeFrames : sample->totalSampleFrames;
+    endFadeGainPerFrame = endFadeFrames > 0 ? 1.0f / static_cast<float>(endFadeFrames) : 0.0f;
+
+    // Integer phase increment, fixed for the lifetime of the note
+    phaseIncrement = static_cast<uint64_t>(std::llround(pitchRatio * static_cast<double>(unityPhaseIncrement)));
+    if (phaseIncrement == 0)
+        phaseIncrement = 1;
+
     // Reset positions
-    sourceSamplePosition = 0.0;
+    phase = 0;
     readPosition.store(0, std::memory_order_release);
     writePosition.store(0, std::memory_order_release);
     fileReadPosition.store(0, std::memory_order_release);
@@ -64,47 +96,80 @@ void StreamingVoice::startVoice(const PreloadedSample* sample, int midiNote, flo
     isQuickFading = false;
     quickFadeLevel = 1.0f;
     quickFadeDecrement = 0.0f;
+    isFadingIn = false;
+    fadeInLevel = 1.0f;
+    coldStartWaitSamples = 0;
+    inaudibleSamples = 0;
 
-    // Copy preload buffer into beginning of ring buffer
+    // Copy preload buffer into beginning of ring buffer (RAM-resident samples play straight from the preload)
     const auto& preload = sample->preloadBuffer;
     int preloadFrames = preload.getNumSamples();
     int framesToCopy = std::min(preloadFrames, StreamingConstants::ringBufferFrames);
 
-    ringBuffer.clear();
-    for (int ch = 0; ch < std::min(preload.getNumChannels(), ringBuffer.getNumChannels()); ++ch)
+    if (streaming)
+    {
+        for (int ch = 0; ch < std::min(preload.getNumChannels(), 2); ++ch)
+        {
+            std::copy(preload.getReadPointer(ch), preload.getReadPointer(ch) + framesToCopy, ringChannels[static_cast<size_t>(ch)]);
+        }
+    }
+    else
     {
-        ringBuffer.copyFrom(ch, 0, preload, ch, 0, framesToCopy);
+        // Keep reading the buffer the note started with, even if the engine swaps the preload meanwhile
+        residentChannels[0] = preload.getReadPointer(0);
+        residentChannels[1] = preload.getReadPointer(std::min(preload.getNumChannels(), 2) - 1);
     }
 
     // Set initial write position after preloaded data
     writePosition.store(framesToCopy, std::memory_order_release);
     fileReadPosition.store(framesToCopy, std::memory_order_release);
 
+    // Nothing preloaded: the engine asked for a cold start, the first chunk comes from disk
+    coldStartMode = (streaming && framesToCopy == 0) ? nextColdStart : ColdStart::Off;
+    nextColdStart = ColdStart::Off;
+    coldStarting.store(coldStartMode != ColdStart::Off, std::memory_order_release);
+
+    // Pick the specialized render loop for this voice once, instead of branching per sample
+    const bool isUnityPitch = (phaseIncrement == unityPhaseIncrement);
+    renderKernel = selectRenderKernel(sample->numChannels > 1, streaming, isUnityPitch, interpolationQuality);
+    sincTable = &Interpolation::SincTable::get().tableForPitchRatio(pitchRatio);
+
+    switch (isUnityPitch ? InterpolationQuality::Linear : interpolationQuality)
+    {
+        case InterpolationQuality::Linear: kernelHistoryFrames = Interpolation::KernelTraits<InterpolationQuality::Linear>::history; break;
+        case InterpolationQuality::Cubic:  kernelHistoryFrames = Interpolation::KernelTraits<InterpolationQuality::Cubic>::history; break;
+        case InterpolationQuality::Sinc:   kernelHistoryFrames = Interpolation::KernelTraits<InterpolationQuality::Sinc>::history; break;
+    }
+
     // Start envelope
-    adsr.noteOn();
+    envelope.noteOn();
 
     // Signal that we need more data (disk thread will start filling)
-    if (sample->needsStreaming())
+    if (streaming)
     {
         needsData.store(true, std::memory_order_release);
     }
 
+    // New note generation: requests queued for the previous note can no longer lease the ring
+    ringState.fetch_add(ringGenerationStep - ringSettingUpBit, std::memory_order_release);
+
     // Mark voice as active last (ensures all state is visible to disk thread)
     active.store(true, std::memory_order_release);
 
-    voiceDebugLog("StreamingVoice::startVoice - note=" + juce::String(midiNote)
-                 + " sample=" + sample->name
-                 + " totalFrames=" + juce::String(sample->totalSampleFrames)
-                 + " preloadFrames=" + juce::String(sample->preloadSizeFrames)
-                 + " needsStreaming=" + juce::String(sample->needsStreaming() ? "YES" : "no")
-                 + " pitchRatio=" + juce::String(pitchRatio, 4));
+    DebugLog::write("StreamingVoice::startVoice - note=" + juce::String(midiNote)
+                   + " sample=" + sample->name
+                   + " totalFrames=" + juce::String(sample->totalSampleFrames)
+                   + " preloadFrames=" + juce::String(sample->preloadSizeFrames)
+                   + " needsStreaming=" + juce::String(streaming ? "YES" : "no")
+                   + (coldStartMode != ColdStart::Off ? " COLD" : "")
+                   + " pitchRatio=" + juce::String(pitchRatio, 4));
 }
 
 void StreamingVoice::stopVoice(bool allowTailOff)
 {
     if (allowTailOff)
     {
-        adsr.noteOff();
+        envelope.noteOff();
     }
     else
     {
@@ -114,12 +179,9 @@ void StreamingVoice::stopVoice(bool allowTailOff)
 
 void StreamingVoice::stopVoiceWithCustomRelease(float releaseSeconds, double sampleRate)
 {
-    // Temporarily modify the ADSR release time for same-note retrigger
-    auto params = adsr.getParameters();
-    params.release = juce::jmax(0.001f, releaseSeconds);
-    adsr.setParameters(params);
-    adsr.setSampleRate(sampleRate);
-    adsr.noteOff();
+    // One-off release time for same-note retrigger (the voice's ADSR parameters stay untouched)
+    juce::ignoreUnused(sampleRate);
+    envelope.noteOff(juce::jmax(0.001f, releaseSeconds));
 }
 
 void StreamingVoice::startQuickFadeOut(double sampleRate)
@@ -136,16 +198,43 @@ void StreamingVoice::reset()
 {
     active.store(false, std::memory_order_release);
     needsData.store(false, std::memory_order_release);
-    adsr.reset();
+    coldStarting.store(false, std::memory_order_release);
+
+    // Retire the note: a read in flight stops at its next check, queued ones never lease the ring
+    ringState.fetch_add(ringGenerationStep, std::memory_order_release);
+    parkRing();
+    envelope.reset();
     playingNote = -1;
     sustainedByPedal = false;
     currentSample = nullptr;
+    playingSample.store(nullptr, std::memory_order_release);  // After the generation: see getSamplesInUse
+    renderKernel = nullptr;
     isQuickFading = false;
     quickFadeLevel = 1.0f;
     quickFadeDecrement = 0.0f;
     voiceStartCounter = 0;
 }
 
+bool StreamingVoice::updateAudibility(float thresholdGain, int numSamples, int holdSamples)
+{
+    // A cold-starting voice has played nothing yet; leave it to the cold start logic
+    if (!isActive() || currentSample == nullptr || isColdStarting())
+    {
+        inaudibleSamples = 0;
+        return false;
+    }
+
+    const float level = velocity * envelope.getPeakRemainingLevel() * currentSample->getRemainingLevel(getPhaseFrame());
+    if (level >= thresholdGain)
+    {
+        inaudibleSamples = 0;
+        return false;
+    }
+
+    inaudibleSamples = std::min(inaudibleSamples + numSamples, holdSamples);
+    return inaudibleSamples >= holdSamples;
+}
+
 void StreamingVoice::noteReleasedWithPedal(bool pedalDown)
 {
     if (pedalDown)
@@ -154,7 +243,7 @@ void StreamingVoice::noteReleasedWithPedal(bool pedalDown)
     }
     else
     {
-        adsr.noteOff();
+        envelope.noteOff();
     }
 }
 
@@ -163,7 +252,7 @@ void StreamingVoice::setSustainPedal(bool isDown)
     if (!isDown && sustainedByPedal)
     {
         sustainedByPedal = false;
-        adsr.noteOff();
+        envelope.noteOff();
     }
 }
 
@@ -179,9 +268,143 @@ int StreamingVoice::spaceAvailable() const
     return StreamingConstants::ringBufferFrames - samplesAvailable();
 }
 
-float* StreamingVoice::getWritePointer(int channel)
+bool StreamingVoice::beginRingLease(uint32_t generation, RingLease& lease)
+{
+    // Only from the idle state of that generation: not while startVoice is setting up the next note
+    uint32_t expected = generation;
+    if (!ringState.compare_exchange_strong(expected, generation | ringLeasedBit, std::memory_order_acquire))
+        return false;
+
+    // Both were last written by startVoice, which can't run again until the lease ends
+    lease.channels = ringChannels;
+    lease.sample = ringSample.load(std::memory_order_acquire);
+    lease.generation = generation;
+
+    if (lease.sample == nullptr)
+    {
+        endRingLease();
+        return false;
+    }
+    return true;
+}
+
+std::array<const PreloadedSample*, 2> StreamingVoice::getSamplesInUse() const
 {
-    return ringBuffer.getWritePointer(channel);
+    // The note first: reset() clears it after retiring the generation, so a read that leased the
+    // ring before the note ended still shows as leased below
+    const auto* playing = playingSample.load(std::memory_order_acquire);
+    const auto* leased = isRingLeased() ? ringSample.load(std::memory_order_acquire) : nullptr;
+    return { playing, leased };
+}
+
+bool StreamingVoice::acquireRing(int numChannels)
+{
+    if (ringPool == nullptr)
+        return false;
+
+    // Take back our own slabs if the disk thread hasn't returned them to the pool yet
+    const uint32_t parked = parkedRing.exchange(0, std::memory_order_acq_rel);
+    if (parked != 0)
+    {
+        ringSlabs[0] = static_cast<int>(parked & 0xffff) - 1;
+        ringSlabs[1] = static_cast<int>(parked >> 16) - 1;
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& slab = ringSlabs[static_cast<size_t>(ch)];
+        if (slab == RingBufferPool::invalidSlab)
+            slab = ringPool->acquire();
+
+        if (slab == RingBufferPool::invalidSlab)
+        {
+            parkRing();
+            return false;
+        }
+
+        ringChannels[static_cast<size_t>(ch)] = ringPool->getSlabData(slab);
+    }
+
+    return true;
+}
+
+void StreamingVoice::parkRing()
+{
+    if (ringSlabs[0] == RingBufferPool::invalidSlab && ringSlabs[1] == RingBufferPool::invalidSlab)
+        return;
+
+    // ringChannels keep pointing at the parked slabs for a disk read that leased them; the
+    // scheduler only returns parked slabs to the pool while no read is in flight for the voice
+    const uint32_t packed = static_cast<uint32_t>(ringSlabs[0] + 1) | (static_cast<uint32_t>(ringSlabs[1] + 1) << 16);
+    ringSlabs = { RingBufferPool::invalidSlab, RingBufferPool::invalidSlab };
+    parkedRing.store(packed, std::memory_order_release);
+}
+
+void StreamingVoice::releaseParkedRing()
+{
+    if (ringPool == nullptr || parkedRing.load(std::memory_order_relaxed) == 0)
+        return;
+
+    const uint32_t parked = parkedRing.exchange(0, std::memory_order_acq_rel);
+    if (parked == 0)
+        return;
+
+    ringPool->release(static_cast<int>(parked & 0xffff) - 1);
+    ringPool->release(static_cast<int>(parked >> 16) - 1);
+}
+
+bool StreamingVoice::isColdStartDataReady() const
+{
+    // Enough of the first chunk ahead of the note's position, or all there is of the sample
+    const int64_t ahead = writePosition.load(std::memory_order_acquire) - getPhaseFrame();
+    return ahead >= coldStartReadyFrames || (hasReachedEndOfFile() && ahead > 0);
+}
+
+void StreamingVoice::finishColdStart(double sampleRate)
+{
+    // The ring holds the sample from frame 0, so a shadowing voice picks up where it is
+    readPosition.store(std::max<int64_t>(0, getPhaseFrame() - kernelHistoryFrames), std::memory_order_release);
+
+    if (coldStartMode == ColdStart::Shadow)
+    {
+        isFadingIn = true;
+        fadeInLevel = 0.0f;
+        fadeInIncrement = 1.0f / ((quickFadeTimeMs / 1000.0f) * static_cast<float>(sampleRate));
+    }
+
+    coldStartMode = ColdStart::Off;
+    coldStarting.store(false, std::memory_order_release);
+}
+
+void StreamingVoice::renderColdStart(int numSamples)
+{
+    coldStartWaitSamples += numSamples;
+
+    // Stolen before a note was heard: nothing to fade
+    if (isQuickFading)
+    {
+        reset();
+        return;
+    }
+
+    if (coldStartMode != ColdStart::Shadow)
+        return;
+
+    // Keep the note's clock running alongside the stand-in
+    for (int done = 0; done < numSamples;)
+    {
+        const int chunk = std::min(envelopeBlockSize, numSamples - done);
+        if (envelope.process(envelopeGains.data(), chunk) < chunk)
+        {
+            reset();
+            return;
+        }
+        done += chunk;
+    }
+
+    phase += phaseIncrement * static_cast<uint64_t>(numSamples);
+    if (getPhaseFrame() >= currentSample->totalSampleFrames)
+        reset();
 }
 
 void StreamingVoice::advanceWritePosition(int frames)
@@ -191,7 +414,7 @@ void StreamingVoice::advanceWritePosition(int frames)
 
 void StreamingVoice::checkAndRequestData()
 {
-    if (currentSample == nullptr || !currentSample->needsStreaming())
+    if (currentSample == nullptr || !streaming)
         return;
 
     if (hasReachedEndOfFile() || hasReadError())
@@ -206,31 +429,93 @@ void StreamingVoice::checkAndRequestData()
 
 float StreamingVoice::readFromRingBuffer(int channel, int ringPos)
 {
-    // Wrap position within ring buffer
-    int wrappedPos = ringPos % StreamingConstants::ringBufferFrames;
-    if (wrappedPos < 0)
-        wrappedPos += StreamingConstants::ringBufferFrames;
+    // Wrap position within ring buffer (mask also maps negative positions correctly)
+    int wrappedPos = ringPos & StreamingConstants::ringBufferMask;
 
-    return ringBuffer.getSample(channel, wrappedPos);
+    return ringChannels[static_cast<size_t>(channel)][wrappedPos];
 }
 
-void StreamingVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+StreamingVoice::RenderKernel StreamingVoice::selectRenderKernel(bool isStereo, bool isStreaming, bool isUnityPitch, InterpolationQuality quality)
 {
-    if (!active.load(std::memory_order_acquire) || currentSample == nullptr)
-        return;
+    using Q = InterpolationQuality;
+
+    // Dispatch table indexed by [stereo][streaming][mode], mode 0 = unity pitch, 1-3 = interpolation quality
+    static constexpr RenderKernel kernels[2][2][4] = {
+        { { &StreamingVoice::renderKernelImpl<false, false, true,  Q::Linear>,
+            &StreamingVoice::renderKernelImpl<false, false, false, Q::Linear>,
+            &StreamingVoice::renderKernelImpl<false, false, false, Q::Cubic>,
+            &StreamingVoice::renderKernelImpl<false, false, false, Q::Sinc> },
+          { &StreamingVoice::renderKernelImpl<false, true,  true,  Q::Linear>,
+            &StreamingVoice::renderKernelImpl<false, true,  false, Q::Linear>,
+            &StreamingVoice::renderKernelImpl<false, true,  false, Q::Cubic>,
+            &StreamingVoice::renderKernelImpl<false, true,  false, Q::Sinc> } },
+        { { &StreamingVoice::renderKernelImpl<true,  false, true,  Q::Linear>,
+            &StreamingVoice::renderKernelImpl<true,  false, false, Q::Linear>,
+            &StreamingVoice::renderKernelImpl<true,  false, false, Q::Cubic>,
+            &StreamingVoice::renderKernelImpl<true,  false, false, Q::Sinc> },
+          { &StreamingVoice::renderKernelImpl<true,  true,  true,  Q::Linear>,
+            &StreamingVoice::renderKernelImpl<true,  true,  false, Q::Linear>,
+            &StreamingVoice::renderKernelImpl<true,  true,  false, Q::Cubic>,
+            &StreamingVoice::renderKernelImpl<true,  true,  false, Q::Sinc> } }
+    };
+
+    const int mode = isUnityPitch ? 0 : 1 + static_cast<int>(quality);
+    return kernels[isStereo ? 1 : 0][isStreaming ? 1 : 0][mode];
+}
+
+template <bool IsStereo, bool IsStreaming, bool IsUnityPitch, InterpolationQuality Quality>
+void StreamingVoice::renderKernelImpl(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    using Traits = Interpolation::KernelTraits<Quality>;
+    constexpr int numTaps = Traits::numTaps;
 
     const int numOutputChannels = outputBuffer.getNumChannels();
-    const int numSourceChannels = currentSample->numChannels;
+    if (numOutputChannels == 0)
+        return;
+
+    float* outLeft = outputBuffer.getWritePointer(0, startSample);
+    float* outRight = numOutputChannels > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
+
     const int64_t totalSourceFrames = currentSample->totalSampleFrames;
-    const bool isStreaming = currentSample->needsStreaming();
+    const int64_t lastSourceFrame = totalSourceFrames - 1;
+
+    // Resolve source channel pointers once per block (mono voices only ever touch channel 0)
+    const float* srcLeft = IsStreaming ? ringChannels[0] : residentChannels[0];
+    const float* srcRight = IsStereo ? (IsStreaming ? ringChannels[1] : residentChannels[1]) : srcLeft;
 
-    int64_t currentReadPos = readPosition.load(std::memory_order_acquire);
-    int64_t currentWritePos = writePosition.load(std::memory_order_acquire);
+    // A streaming voice reads no further than the disk thread has written: past that the slab
+    // holds another note's data (an underrun fades out over frames that haven't arrived)
+    const int64_t currentWritePos = writePosition.load(std::memory_order_acquire);
+    const int64_t lastReadableFrame = IsStreaming ? std::max<int64_t>(0, std::min(lastSourceFrame, currentWritePos - 1))
+                                                  : lastSourceFrame;
+
+    // Map a source frame to a buffer index (ring wraps, frames outside the sample clamp to its edges)
+    auto bufferIndex = [lastReadableFrame](int64_t frame) -> int
+    {
+        frame = std::clamp(frame, static_cast<int64_t>(0), lastReadableFrame);
+        if constexpr (IsStreaming)
+            return static_cast<int>(frame & StreamingConstants::ringBufferMask);
+        else
+            return static_cast<int>(frame);
+    };
+
+    constexpr float phaseToFraction = 1.0f / static_cast<float>(unityPhaseIncrement);
+
+    uint64_t localPhase = phase;
+    int64_t currentReadPos = static_cast<int64_t>(localPhase >> phaseFractionBits);
+    int envelopeSamples = 0;
 
     for (int sample = 0; sample < numSamples; ++sample)
     {
+        // Render the envelope a chunk at a time
+        const int envelopeIndex = sample & (envelopeBlockSize - 1);
+        if (envelopeIndex == 0)
+            envelopeSamples = envelope.process(envelopeGains.data(), std::min(envelopeBlockSize, numSamples - sample));
+
+        const int64_t pos0 = static_cast<int64_t>(localPhase >> phaseFractionBits);
+
         // Check if we've reached end of sample
-        if (sourceSamplePosition >= totalSourceFrames)
+        if (pos0 >= totalSourceFrames)
         {
             reset();
             return;
@@ -248,18 +533,18 @@ void StreamingVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int
         }
 
         // Get envelope value
-        float envelopeValue = adsr.getNextSample();
-        if (!adsr.isActive() && !isQuickFading)
+        if (envelopeIndex >= envelopeSamples)
         {
             reset();
             return;
         }
+        const float envelopeValue = envelopeGains[static_cast<size_t>(envelopeIndex)];
 
-        // Handle underrun
-        if (isStreaming)
+        // Handle underrun (kernel needs its look-ahead frames to be in the ring)
+        if constexpr (IsStreaming)
         {
             int available = static_cast<int>(currentWritePos - currentReadPos);
-            if (available <= 2 && !hasReachedEndOfFile())
+            if (available <= Traits::lookahead + 1 && !hasReachedEndOfFile())
             {
                 // Buffer underrun - fade out to avoid click
                 if (!isUnderrunning)
@@ -285,57 +570,85 @@ void StreamingVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int
             underrunFadePosition++;
         }
 
-        // Calculate interpolated sample position
-        int64_t pos0 = static_cast<int64_t>(sourceSamplePosition);
-        int64_t pos1 = pos0 + 1;
-        float frac = static_cast<float>(sourceSamplePosition - static_cast<double>(pos0));
+        // Apply velocity, envelope, underrun fade, and quick fade
+        float finalGain = velocity * envelopeValue * underrunFade;
+        if (isQuickFading)
+            finalGain *= quickFadeLevel;
+        if (pos0 >= endFadeStartFrame)
+            finalGain *= static_cast<float>(totalSourceFrames - pos0) * endFadeGainPerFrame;
+
+        // Fade in over a cold start's stand-in
+        if (isFadingIn)
+        {
+            fadeInLevel = std::min(1.0f, fadeInLevel + fadeInIncrement);
+            isFadingIn = fadeInLevel < 1.0f;
+            finalGain *= fadeInLevel;
+        }
 
-        // Clamp pos1 to valid range
-        if (pos1 >= totalSourceFrames)
-            pos1 = pos0;
+        float left, right;
 
-        // Read from appropriate source (preload buffer or ring buffer)
-        for (int ch = 0; ch < numOutputChannels; ++ch)
+        if constexpr (IsUnityPitch)
+        {
+            // Integer positions only - straight copy-and-scale
+            const int index = IsStreaming ? bufferIndex(pos0) : static_cast<int>(pos0);
+            left = srcLeft[index];
+            right = IsStereo ? srcRight[index] : left;
+        }
+        else
         {
-            float sample0, sample1;
+            const float frac = static_cast<float>(localPhase & phaseFractionMask) * phaseToFraction;
+
+            // Gather the kernel's window of source frames
+            float windowLeft[numTaps];
+            float windowRight[numTaps];
+            const int64_t firstFrame = pos0 - Traits::history;
 
-            int sourceChannel = std::min(ch, numSourceChannels - 1);
+            for (int tap = 0; tap < numTaps; ++tap)
+            {
+                const int index = bufferIndex(firstFrame + tap);
+                windowLeft[tap] = srcLeft[index];
+                if constexpr (IsStereo)
+                    windowRight[tap] = srcRight[index];
+            }
 
-            if (!isStreaming)
+            if constexpr (Quality == InterpolationQuality::Sinc)
+            {
+                left = Interpolation::sinc(windowLeft, frac, *sincTable);
+                right = IsStereo ? Interpolation::sinc(windowRight, frac, *sincTable) : left;
+            }
+            else if constexpr (Quality == InterpolationQuality::Cubic)
             {
-                // Small sample - read directly from preload buffer
-                const auto& preload = currentSample->preloadBuffer;
-                sample0 = preload.getSample(sourceChannel, static_cast<int>(pos0));
-                sample1 = preload.getSample(sourceChannel, static_cast<int>(pos1));
+                left = Interpolation::hermite(windowLeft, frac);
+                right = IsStereo ? Interpolation::hermite(windowRight, frac) : left;
             }
             else
             {
-                // Streaming - read from ring buffer with wraparound
-                int ringPos0 = static_cast<int>(pos0 % StreamingConstants::ringBufferFrames);
-                int ringPos1 = static_cast<int>(pos1 % StreamingConstants::ringBufferFrames);
-
-                sample0 = ringBuffer.getSample(sourceChannel, ringPos0);
-                sample1 = ringBuffer.getSample(sourceChannel, ringPos1);
+                left = Interpolation::linear(windowLeft, frac);
+                right = IsStereo ? Interpolation::linear(windowRight, frac) : left;
             }
+        }
 
-            // Linear interpolation
-            float interpolated = sample0 + frac * (sample1 - sample0);
-
-            // Apply velocity, envelope, underrun fade, and quick fade
-            float finalGain = velocity * envelopeValue * underrunFade;
-            if (isQuickFading)
-                finalGain *= quickFadeLevel;
+        // Scale, then add: a voice rendered into a scratch bus (VoiceRenderPool) sums to the same bits
+        const float scaledLeft = left * finalGain;
+        const float scaledRight = right * finalGain;
+        outLeft[sample] += scaledLeft;
+        if (outRight != nullptr)
+            outRight[sample] += scaledRight;
 
-            outputBuffer.addSample(ch, startSample + sample, interpolated * finalGain);
-        }
+        // Any extra output channels mirror the last source channel
+        for (int ch = 2; ch < numOutputChannels; ++ch)
+            outputBuffer.addSample(ch, startSample + sample, scaledRight);
 
         // Advance source position
-        sourceSamplePosition += pitchRatio;
+        if constexpr (IsUnityPitch)
+            localPhase += unityPhaseIncrement;
+        else
+            localPhase += phaseIncrement;
 
         // Update read position for ring buffer (whole frames consumed)
-        if (isStreaming)
+        if constexpr (IsStreaming)
         {
-            int64_t newReadFrame = static_cast<int64_t>(sourceSamplePosition);
+            int64_t newReadFrame = static_cast<int64_t>(localPhase >> phaseFractionBits);
             if (newReadFrame > currentReadPos)
             {
                 currentReadPos = newReadFrame;
@@ -343,22 +656,135 @@ void StreamingVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int
         }
     }
 
+    phase = localPhase;
+}
+
+void StreamingVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    if (!active.load(std::memory_order_acquire) || currentSample == nullptr || renderKernel == nullptr)
+        return;
+
+    // Waiting for the first chunk of a cold start: silent until the engine switches it over
+    if (coldStarting.load(std::memory_order_relaxed))
+    {
+        renderColdStart(numSamples);
+        return;
+    }
+
+    (this->*renderKernel)(outputBuffer, startSample, numSamples);
+
+    // Kernel resets the voice when the sample, envelope or fade finishes
+    if (!active.load(std::memory_order_acquire))
+        return;
+
+    finishBlock();
+}
+
+void StreamingVoice::finishBlock()
+{
+    if (!streaming)
+        return;
+
     // Update atomic read position after processing block
-    if (isStreaming)
+    // Keep the kernel's history frames behind readPosition so the disk thread can't overwrite them
+    const int64_t consumedFrame = getPhaseFrame() - kernelHistoryFrames;
+    readPosition.store(std::max(readPosition.load(std::memory_order_relaxed), consumedFrame), std::memory_order_release);
+    checkAndRequestData();
+
+    // Periodic debug logging of ring buffer state
+    static std::atomic<int> debugBlockCounter{0};  // Voices may render on pool workers
+    if (++debugBlockCounter % 100 == 0)  // Every ~2 seconds at 512 samples/block
+    {
+        DebugLog::write("Voice render: readPos=" + juce::String(readPosition.load())
+                       + " writePos=" + juce::String(writePosition.load())
+                       + " available=" + juce::String(samplesAvailable())
+                       + " sourcePos=" + juce::String(getPhaseFrame())
+                       + " / " + juce::String(currentSample->totalSampleFrames)
+                       + " needsData=" + juce::String(needsData.load() ? "yes" : "no"));
+    }
+}
+
+bool StreamingVoice::canRenderBatched(int numSamples) const
+{
+    if (!active.load(std::memory_order_acquire) || currentSample == nullptr || renderKernel == nullptr)
+        return false;
+
+    // Batch lanes only implement unity and linear interpolation
+    const bool isUnityPitch = (phaseIncrement == unityPhaseIncrement);
+    if (!isUnityPitch && interpolationQuality != InterpolationQuality::Linear)
+        return false;
+
+    if (isUnderrunning || isFadingIn || coldStarting.load(std::memory_order_relaxed))
+        return false;
+
+    if (!streaming || hasReachedEndOfFile())
+        return true;
+
+    // Every frame the block will touch (plus the linear look-ahead) must already be in the ring
+    const uint64_t endPhase = phase + phaseIncrement * static_cast<uint64_t>(numSamples);
+    const int64_t lastFrameNeeded = static_cast<int64_t>(endPhase >> phaseFractionBits) + 1;
+    return lastFrameNeeded + 1 < writePosition.load(std::memory_order_acquire);
+}
+
+int StreamingVoice::prepareBatchBlock(float* gains, int numSamples, BatchLane& lane)
+{
+    const bool isStreaming = streaming;
+    const bool isStereo = currentSample->numChannels > 1;
+
+    lane.phase = phase;
+    lane.phaseIncrement = phaseIncrement;
+    lane.left = isStreaming ? ringChannels[0] : residentChannels[0];
+    lane.right = isStereo ? (isStreaming ? ringChannels[1] : residentChannels[1]) : lane.left;
+    lane.lastFrame = currentSample->totalSampleFrames - 1;
+    lane.indexMask = isStreaming ? static_cast<int64_t>(StreamingConstants::ringBufferMask) : int64_t(-1);
+
+    // Same control flow as the scalar kernel, minus the audio
+    const int64_t totalSourceFrames = currentSample->totalSampleFrames;
+    uint64_t samplePhase = phase;
+    int rendered = 0;
+
+    // Envelope for the whole block in one go
+    const int envelopeSamples = envelope.process(gains, numSamples);
+
+    for (; rendered < envelopeSamples; ++rendered)
     {
-        readPosition.store(static_cast<int64_t>(sourceSamplePosition), std::memory_order_release);
-        checkAndRequestData();
+        if (static_cast<int64_t>(samplePhase >> phaseFractionBits) >= totalSourceFrames)
+            break;
 
-        // Periodic debug logging of ring buffer state
-        static int debugBlockCounter = 0;
-        if (++debugBlockCounter % 100 == 0)  // Every ~2 seconds at 512 samples/block
+        if (isQuickFading)
         {
-            voiceDebugLog("Voice render: readPos=" + juce::String(readPosition.load())
-                         + " writePos=" + juce::String(writePosition.load())
-                         + " available=" + juce::String(samplesAvailable())
-                         + " sourcePos=" + juce::String(static_cast<int64_t>(sourceSamplePosition))
-                         + " / " + juce::String(totalSourceFrames)
-                         + " needsData=" + juce::String(needsData.load() ? "yes" : "no"));
+            quickFadeLevel -= quickFadeDecrement;
+            if (quickFadeLevel <= 0.0f)
+                break;
         }
+
+        float gain = velocity * gains[rendered];
+        if (isQuickFading)
+            gain *= quickFadeLevel;
+
+        const int64_t frame = static_cast<int64_t>(samplePhase >> phaseFractionBits);
+        if (frame >= endFadeStartFrame)
+            gain *= static_cast<float>(totalSourceFrames - frame) * endFadeGainPerFrame;
+
+        gains[rendered] = gain;
+        samplePhase += phaseIncrement;
     }
+
+    for (int i = rendered; i < numSamples; ++i)
+        gains[i] = 0.0f;
+
+    return rendered;
+}
+
+void StreamingVoice::finishBatchBlock(int renderedSamples, int numSamples)
+{
+    phase += phaseIncrement * static_cast<uint64_t>(renderedSamples);
+
+    if (renderedSamples < numSamples)
+    {
+        reset();
+        return;
+    }
+
+    finishBlock();
 }
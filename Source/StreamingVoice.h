@@ -2,8 +2,12 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_audio_formats/juce_audio_formats.h>
+#include <array>
 #include <atomic>
 #include "DiskStreaming.h"
+#include "Interpolation.h"
+#include "BlockEnvelope.h"
+#include "RingBufferPool.h"
 
 /**
  * StreamingVoice implements a voice that plays audio from a ring buffer
@@ -34,6 +38,7 @@ public:
     // Audio thread interface
     void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
     bool isActive() const { return active.load(std::memory_order_acquire); }
+    double getPitchRatio() const { return pitchRatio; }  // Playback rate (used by the disk streamer to rank urgency)
     int getPlayingNote() const { return playingNote; }
 
     // Sustain pedal support
@@ -43,17 +48,112 @@ public:
 
     // ADSR
     void setADSRParameters(const juce::ADSR::Parameters& params);
+
+    /** Applies published parameters only if their version differs from what this voice already has */
+    void updateADSRParameters(const juce::ADSR::Parameters& params, uint32_t version);
+
     void prepareToPlay(double sampleRate, int samplesPerBlock);
 
+    // Interpolation quality for pitched playback (applied at next startVoice)
+    void setInterpolationQuality(InterpolationQuality quality) { interpolationQuality = quality; }
+
+    /**
+     * Cold start: a note on a sample without a preload starts with an empty ring and waits
+     * for its first disk chunk. Wait holds the note until the chunk lands; Shadow keeps its
+     * position and envelope running silently (while the engine plays a preloaded stand-in),
+     * so it can be faded in time-aligned. The engine decides when it's ready or too late.
+     */
+    enum class ColdStart { Off, Wait, Shadow };
+
+    /** Cold start mode for the next startVoice only (ignored if the sample has a preload) */
+    void setColdStart(ColdStart mode) { nextColdStart = mode; }
+
+    bool isColdStarting() const { return coldStarting.load(std::memory_order_acquire); }
+    bool isColdStartDataReady() const;
+    int getColdStartWaitSamples() const { return coldStartWaitSamples; }
+
+    /** Play what has arrived: from the start (Wait) or fading in at the current position (Shadow) */
+    void finishColdStart(double sampleRate);
+
+    /**
+     * Audibility culling: call once per block after rendering. The voice's loudest possible
+     * level from here on is its velocity times the envelope's peak remaining level times the
+     * sample's remaining level (PreloadedSample::getRemainingLevel). Returns true once that has
+     * stayed below thresholdGain for holdSamples; the engine then retires the voice.
+     */
+    bool updateAudibility(float thresholdGain, int numSamples, int holdSamples);
+
+    /**
+     * Per-voice state exported to VoiceBatchRenderer, which renders several voices
+     * lane-parallel (one voice per SIMD lane) with linear interpolation.
+     */
+    struct BatchLane
+    {
+        uint64_t phase = 0;
+        uint64_t phaseIncrement = 0;
+        const float* left = nullptr;
+        const float* right = nullptr;
+        int64_t lastFrame = 0;       // Reads are clamped to this source frame
+        int64_t indexMask = -1;      // Ring mask for streaming voices, all ones for RAM voices
+    };
+
+    /** True if the next numSamples can go through the batch path (linear/unity, no underrun risk) */
+    bool canRenderBatched(int numSamples) const;
+
+    /**
+     * Runs the per-sample control logic (end of sample, quick fade, envelope) for the next
+     * numSamples and writes the resulting gains. Gains after the voice ends are zero.
+     * Returns the number of samples the voice actually plays.
+     */
+    int prepareBatchBlock(float* gains, int numSamples, BatchLane& lane);
+
+    /** Commits a batch-rendered block: advances the phase and releases the voice if it ended */
+    void finishBatchBlock(int renderedSamples, int numSamples);
+
+    // Ring storage comes from the engine's pool (set once before any voice starts)
+    void setRingBufferPool(RingBufferPool* pool) { ringPool = pool; }
+
+    /** Hands the slabs of a finished voice back to the pool (disk thread) */
+    void releaseParkedRing();
+
     // Ring buffer access for disk thread (thread-safe)
     int samplesAvailable() const;
     int spaceAvailable() const;
     bool needsMoreData() const { return needsData.load(std::memory_order_acquire); }
     void clearNeedsData() { needsData.store(false, std::memory_order_release); }
 
-    // Disk thread fills buffer here
-    float* getWritePointer(int channel);
-    int getWritePosition() const { return static_cast<int>(writePosition.load(std::memory_order_acquire) % StreamingConstants::ringBufferFrames); }
+    /**
+     * Disk side of the ring. A read leases the ring of the note it was queued for, and writes
+     * through the lease's pointers rather than the voice's. While the lease is held the ring's
+     * slabs stay put: the voice can't start another note (startVoice refuses, the engine picks
+     * another voice) and parked slabs only go back to the pool between reads. reset() retires
+     * the note at once; the read sees it through isRingLeaseCurrent() and stops.
+     */
+    struct RingLease
+    {
+        std::array<float*, 2> channels {};
+        const PreloadedSample* sample = nullptr;
+        uint32_t generation = 0;
+    };
+
+    /** The note a disk request is queued for (disk scheduler) */
+    uint32_t getRingGeneration() const { return ringState.load(std::memory_order_acquire) & ~ringFlagsMask; }
+
+    /** Lease the ring if the voice still plays that note and isn't being restarted (disk thread) */
+    bool beginRingLease(uint32_t generation, RingLease& lease);
+    bool isRingLeaseCurrent(const RingLease& lease) const { return getRingGeneration() == lease.generation; }
+    void endRingLease() { ringState.fetch_and(~ringLeasedBit, std::memory_order_release); }
+
+    /** A disk read still holds this voice's ring: don't start a note on it yet (engine) */
+    bool isRingLeased() const { return (ringState.load(std::memory_order_acquire) & ringLeasedBit) != 0; }
+
+    /**
+     * The samples this voice may still read: the playing note's, and while a disk read leases
+     * the ring, the one it reads for (any thread; the engine frees replaced preloads once unused)
+     */
+    std::array<const PreloadedSample*, 2> getSamplesInUse() const;
+
+    int getWritePosition() const { return static_cast<int>(writePosition.load(std::memory_order_acquire) & StreamingConstants::ringBufferMask); }
     void advanceWritePosition(int frames);
 
     // File position tracking for disk thread
@@ -70,15 +170,40 @@ public:
     static int getUnderrunCount() { return underrunCount.load(std::memory_order_relaxed); }
     static void resetUnderrunCount() { underrunCount.store(0, std::memory_order_relaxed); }
 
-    // Sample info for disk thread
-    const PreloadedSample* getCurrentSample() const { return currentSample; }
-
 private:
-    // Current sample being played (set at voice start, read by disk thread)
+    // Current sample being played (set at voice start, cleared by reset), and its copy for other threads
     const PreloadedSample* currentSample = nullptr;
+    std::atomic<const PreloadedSample*> playingSample{nullptr};
+
+    // Streaming sample the ring was last set up for; outlives reset for a disk read's RingLease
+    std::atomic<const PreloadedSample*> ringSample{nullptr};
+
+    // Ring buffer for streaming audio: one pool slab per source channel (mono voices take one,
+    // RAM-resident voices none). Owned by the audio thread while the voice plays.
+    RingBufferPool* ringPool = nullptr;
+    std::array<int, 2> ringSlabs { RingBufferPool::invalidSlab, RingBufferPool::invalidSlab };
+    std::array<float*, 2> ringChannels {};
 
-    // Ring buffer for streaming audio (stereo capable)
-    juce::AudioBuffer<float> ringBuffer;
+    // Fixed at voice start: whether the voice streams, and the preload data a RAM-resident
+    // voice reads (the engine may resize the sample's preload while the note plays)
+    bool streaming = false;
+    std::array<const float*, 2> residentChannels {};
+
+    // Slabs of a finished voice, packed as (slab + 1) per 16 bits. The disk thread returns them
+    // to the pool, since it may still be writing to them when the voice ends.
+    std::atomic<uint32_t> parkedRing{0};
+
+    bool acquireRing(int numChannels);
+    void parkRing();
+
+    // Ring ownership between the audio thread and a disk read: the note generation in the upper
+    // bits (bumped by every reset and start), a leased bit held by the disk thread for a read, and
+    // a setting-up bit held by startVoice, during which no lease is granted
+    static constexpr uint32_t ringLeasedBit = 1;
+    static constexpr uint32_t ringSettingUpBit = 2;
+    static constexpr uint32_t ringFlagsMask = ringLeasedBit | ringSettingUpBit;
+    static constexpr uint32_t ringGenerationStep = 4;
+    std::atomic<uint32_t> ringState{0};
 
     // Lock-free SPSC (Single Producer Single Consumer) positions
     std::atomic<int64_t> readPosition{0};   // Audio thread owns writes
@@ -97,13 +222,36 @@ private:
     int playingNote = -1;
     float velocity = 0.0f;
     double pitchRatio = 1.0;
-    double sourceSamplePosition = 0.0;  // Fractional position for interpolation
+    InterpolationQuality interpolationQuality = InterpolationQuality::Linear;
+    const Interpolation::SincTable::Table* sincTable = nullptr;  // Band-limited for this voice's pitchRatio
+
+    // Playback position as a 32.32 fixed-point phase: upper 32 bits are the source frame,
+    // lower 32 bits the fraction. The increment is computed once per note, so renders are
+    // bit-reproducible and long notes don't drift.
+    static constexpr int phaseFractionBits = 32;
+    static constexpr uint64_t phaseFractionMask = (uint64_t(1) << phaseFractionBits) - 1;
+    static constexpr uint64_t unityPhaseIncrement = uint64_t(1) << phaseFractionBits;
+    uint64_t phase = 0;
+    uint64_t phaseIncrement = unityPhaseIncrement;
+
+    int64_t getPhaseFrame() const { return static_cast<int64_t>(phase >> phaseFractionBits); }
     uint64_t voiceStartCounter = 0;     // For tracking voice age (polyphonic same-note)
 
-    // Envelope
-    juce::ADSR adsr;
+    // Envelope, rendered a chunk at a time into envelopeGains
+    static constexpr int envelopeBlockSize = 128;
+    static_assert((envelopeBlockSize & (envelopeBlockSize - 1)) == 0, "envelopeBlockSize must be a power of two");
+    BlockEnvelope envelope;
+    std::array<float, envelopeBlockSize> envelopeGains {};
+    uint32_t envelopeParametersVersion = 0;
     bool sustainedByPedal = false;
 
+    // Samples the voice has been below the engine's audibility threshold (see updateAudibility)
+    int inaudibleSamples = 0;
+
+    // Fade-out before a trimmed end (PreloadedSample::endFadeFrames); starts past the end if there's none
+    int64_t endFadeStartFrame = 0;
+    float endFadeGainPerFrame = 0.0f;
+
     // Underrun protection
     bool isUnderrunning = false;
     int underrunFadePosition = 0;
@@ -114,10 +262,41 @@ private:
     float quickFadeDecrement = 0.0f;
     static constexpr float quickFadeTimeMs = 10.0f;
 
+    // Cold start (see ColdStart); the fade-in crossfades from a stand-in over quickFadeTimeMs
+    ColdStart nextColdStart = ColdStart::Off;
+    ColdStart coldStartMode = ColdStart::Off;
+    std::atomic<bool> coldStarting{false};  // Read by the disk thread to rank the request first
+    int coldStartWaitSamples = 0;
+    bool isFadingIn = false;
+    float fadeInLevel = 1.0f;
+    float fadeInIncrement = 0.0f;
+    static constexpr int coldStartReadyFrames = StreamingConstants::diskReadFrames / 2;
+
     // Static underrun counter (shared across all voices)
     static std::atomic<int> underrunCount;
 
+    // Render kernel selected once per voice in startVoice() (see selectRenderKernel)
+    using RenderKernel = void (StreamingVoice::*)(juce::AudioBuffer<float>&, int, int);
+    RenderKernel renderKernel = nullptr;
+
+    /**
+     * Compile-time specialized render loop.
+     * - IsStereo:     source has 2+ channels (mono sources skip the per-channel lookup)
+     * - IsStreaming:  read from the ring buffer instead of the preload buffer
+     * - IsUnityPitch: pitchRatio == 1.0, so no interpolation (straight copy-and-scale)
+     * - Quality:      interpolation kernel for pitched voices (ignored at unity pitch)
+     */
+    template <bool IsStereo, bool IsStreaming, bool IsUnityPitch, InterpolationQuality Quality>
+    void renderKernelImpl(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+    static RenderKernel selectRenderKernel(bool isStereo, bool isStreaming, bool isUnityPitch, InterpolationQuality quality);
+
+    // Interpolation history frames the current kernel keeps behind readPosition
+    int kernelHistoryFrames = 0;
+
     // Internal helpers
+    void renderColdStart(int numSamples);
+    void finishBlock();
     void checkAndRequestData();
     float readFromRingBuffer(int channel, int ringPos);
 };
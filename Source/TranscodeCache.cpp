@@ -0,0 +1,199 @@
+#include "TranscodeCache.h"
+#include "DebugLog.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    constexpr int transcodeChunkFrames = 65536;
+}
+
+//==============================================================================
+TranscodeCache::Worker::Worker(TranscodeCache& owner)
+    : juce::Thread("Transcode Cache"),
+      cache(owner)
+{
+    formatManager.registerBasicFormats();
+}
+
+void TranscodeCache::Worker::run()
+{
+    const auto directory = getDefaultDirectory();
+
+    while (!threadShouldExit())
+    {
+        juce::File source;
+        {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            if (!cache.queue.empty())
+            {
+                source = cache.queue.front();
+                cache.queue.pop_front();
+            }
+        }
+
+        if (source == juce::File())
+        {
+            wait(-1);
+            continue;
+        }
+
+        const auto destination = getCopyFile(directory, source);
+        if (!destination.existsAsFile())
+        {
+            const double startTime = juce::Time::getMillisecondCounterHiRes();
+            if (transcode(formatManager, source, destination))
+            {
+                DebugLog::write("TranscodeCache: " + source.getFullPathName() + " -> " + destination.getFileName()
+                                + " in " + juce::String(juce::Time::getMillisecondCounterHiRes() - startTime, 0) + " ms");
+                trim(directory, cache.getMaxBytes());
+            }
+            else
+            {
+                DebugLog::write("TranscodeCache: could not transcode " + source.getFullPathName());
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.pending.erase(source.getFullPathName());
+    }
+}
+
+//==============================================================================
+TranscodeCache::TranscodeCache()
+    : worker(*this)
+{
+    worker.startThread(juce::Thread::Priority::low);
+}
+
+TranscodeCache::~TranscodeCache()
+{
+    worker.signalThreadShouldExit();
+    worker.notify();
+    worker.stopThread(10000);
+}
+
+void TranscodeCache::request(const juce::File& source)
+{
+    if (getCopyFile(getDefaultDirectory(), source).existsAsFile())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!pending.insert(source.getFullPathName()).second)
+            return;
+
+        queue.push_back(source);
+    }
+    worker.notify();
+}
+
+int TranscodeCache::getNumPending() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return static_cast<int>(pending.size());
+}
+
+bool TranscodeCache::needsTranscode(const juce::File& source)
+{
+    return source.hasFileExtension("mp3");
+}
+
+juce::File TranscodeCache::findCopy(const juce::File& source)
+{
+    const auto copy = getCopyFile(getDefaultDirectory(), source);
+    if (!copy.existsAsFile())
+        return {};
+
+    // Least recently used goes first when the folder is trimmed
+    copy.setLastAccessTime(juce::Time::getCurrentTime());
+    return copy;
+}
+
+juce::File TranscodeCache::getCopyFile(const juce::File& directory, const juce::File& source)
+{
+    const auto key = source.getFullPathName() + "|" + juce::String(source.getSize())
+                   + "|" + juce::String(source.getLastModificationTime().toMilliseconds());
+    return directory.getChildFile(juce::String::toHexString(key.hashCode64()) + ".wav");
+}
+
+bool TranscodeCache::transcode(juce::AudioFormatManager& formatManager, const juce::File& source, const juce::File& destination)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(source));
+    if (reader == nullptr || reader->numChannels == 0 || destination.getParentDirectory().createDirectory().failed())
+        return false;
+
+    juce::TemporaryFile temp(destination);
+    {
+        auto stream = std::make_unique<juce::FileOutputStream>(temp.getFile());
+        if (stream->failedToOpen())
+            return false;
+
+        // 32-bit float: the copy holds exactly what the decoder produced
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), reader->sampleRate, reader->numChannels,
+                                                                            32, {}, 0));
+        if (writer == nullptr)
+            return false;
+        stream.release();
+
+        // Front to back, the one way an MP3 decodes exactly; the copy keeps the reader's length
+        const int numChannels = static_cast<int>(reader->numChannels);
+        const auto totalFrames = static_cast<int64_t>(reader->lengthInSamples);
+        juce::AudioBuffer<float> buffer(numChannels, transcodeChunkFrames);
+
+        for (int64_t frame = 0; frame < totalFrames; frame += transcodeChunkFrames)
+        {
+            if (juce::Thread::currentThreadShouldExit())
+                return false;
+
+            const int numFrames = static_cast<int>(std::min<int64_t>(transcodeChunkFrames, totalFrames - frame));
+            if (!reader->read(&buffer, 0, numFrames, frame, true, true)
+                || !writer->writeFromAudioSampleBuffer(buffer, 0, numFrames))
+                return false;
+        }
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+void TranscodeCache::trim(const juce::File& directory, int64_t maxBytes, const juce::StringArray& keep)
+{
+    auto copies = directory.findChildFiles(juce::File::findFiles, false, "*.wav");
+
+    int64_t totalBytes = 0;
+    for (const auto& copy : copies)
+        totalBytes += copy.getSize();
+
+    if (totalBytes <= maxBytes)
+        return;
+
+    std::vector<juce::File> oldestFirst(copies.begin(), copies.end());
+    std::sort(oldestFirst.begin(), oldestFirst.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return a.getLastAccessTime() < b.getLastAccessTime();
+    });
+
+    for (const auto& copy : oldestFirst)
+    {
+        if (totalBytes <= maxBytes)
+            break;
+
+        if (keep.contains(copy.getFullPathName()))
+            continue;
+
+        const int64_t size = copy.getSize();
+        if (copy.deleteFile())
+            totalBytes -= size;
+    }
+
+    DebugLog::write("TranscodeCache: trimmed " + directory.getFullPathName() + " to "
+                    + juce::String(totalBytes / (1024 * 1024)) + " MB");
+}
+
+juce::File TranscodeCache::getDefaultDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("HammerSampler")
+               .getChildFile("TranscodeCache");
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <set>
+
+/**
+ * TranscodeCache keeps decoded copies of samples whose format can't be read at a random
+ * position quickly or exactly (MP3). Each one is decoded once, front to back, into a float
+ * WAV in a local cache folder, and from then on preloads and streaming read the copy.
+ *
+ * - Scanning a library queues its MP3 files; a background thread transcodes them one by one
+ * - A copy is named after its source's path, size and modification time, so a changed source
+ *   misses and is transcoded again, and its old copy ages out
+ * - The folder is bounded: after each transcode the least recently used copies are deleted
+ *   until it fits. Opening a copy counts as using it.
+ * - Until its copy is ready a sample reads from the source as before
+ *
+ * SharedSamplePool owns the queue; findCopy() is static so every reader open
+ * (SampleContainer::createReaderFor) can switch to a copy once it exists.
+ */
+class TranscodeCache
+{
+public:
+    static constexpr int64_t defaultMaxBytes = int64_t(4) * 1024 * 1024 * 1024;
+
+    TranscodeCache();
+    ~TranscodeCache();
+
+    /** Queue a source for transcoding, unless it has a copy or is already queued (any thread) */
+    void request(const juce::File& source);
+
+    /** Sources queued or being transcoded */
+    int getNumPending() const;
+
+    /** Size the cache folder is trimmed to */
+    void setMaxBytes(int64_t bytes) { maxBytes.store(std::max<int64_t>(0, bytes), std::memory_order_relaxed); }
+    int64_t getMaxBytes() const { return maxBytes.load(std::memory_order_relaxed); }
+
+    /** True for formats that are transcoded (lossy, no exact random access) */
+    static bool needsTranscode(const juce::File& source);
+
+    /** The finished copy of a source in the default folder (marking it used), or File() if there is none */
+    static juce::File findCopy(const juce::File& source);
+
+    /** Where the copy of a source goes in a cache folder */
+    static juce::File getCopyFile(const juce::File& directory, const juce::File& source);
+
+    /** Decode source into a float WAV at destination (replaced atomically; false on failure) */
+    static bool transcode(juce::AudioFormatManager& formatManager, const juce::File& source, const juce::File& destination);
+
+    /** Delete the least recently used copies in a folder until it holds at most maxBytes.
+        Copies in keep (full paths) are still being read and stay, though they count toward the size. */
+    static void trim(const juce::File& directory, int64_t maxBytes, const juce::StringArray& keep = {});
+
+    static juce::File getDefaultDirectory();
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        explicit Worker(TranscodeCache& owner);
+        void run() override;
+
+    private:
+        TranscodeCache& cache;
+        juce::AudioFormatManager formatManager;
+    };
+
+    mutable std::mutex mutex;
+    std::deque<juce::File> queue;
+    std::set<juce::String> pending;      // Paths queued or in progress
+    std::atomic<int64_t> maxBytes{defaultMaxBytes};
+
+    Worker worker;
+};
@@ -0,0 +1,138 @@
+#include "VoiceBatchRenderer.h"
+#include <algorithm>
+
+namespace
+{
+    // Silent source for padding lanes in a partially filled group
+    alignas(16) const float silentFrames[2] = { 0.0f, 0.0f };
+}
+
+void VoiceBatchRenderer::setLaneWidth(int lanes)
+{
+    if (lanes >= 16)
+        laneWidth = 16;
+    else if (lanes >= 8)
+        laneWidth = 8;
+    else
+        laneWidth = 4;
+}
+
+void VoiceBatchRenderer::render(VoiceArray& voices, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += chunkSize)
+    {
+        const int chunkSamples = std::min(chunkSize, numSamples - chunkStart);
+        const int chunkOffset = startSample + chunkStart;
+
+        // Split voices into batchable and scalar for this chunk
+        int numBatchVoices = 0;
+        for (auto& voice : voices)
+        {
+            if (!voice.isActive())
+                continue;
+
+            if (voice.canRenderBatched(chunkSamples))
+                batchVoices[static_cast<size_t>(numBatchVoices++)] = &voice;
+            else
+                voice.renderNextBlock(outputBuffer, chunkOffset, chunkSamples);
+        }
+
+        for (int first = 0; first < numBatchVoices; first += laneWidth)
+        {
+            const int groupSize = std::min(laneWidth, numBatchVoices - first);
+            StreamingVoice* const* group = batchVoices.data() + first;
+
+            switch (laneWidth)
+            {
+                case 16: renderGroup<16>(group, groupSize, outputBuffer, chunkOffset, chunkSamples); break;
+                case 8:  renderGroup<8>(group, groupSize, outputBuffer, chunkOffset, chunkSamples); break;
+                default: renderGroup<4>(group, groupSize, outputBuffer, chunkOffset, chunkSamples); break;
+            }
+        }
+    }
+}
+
+template <int Lanes>
+void VoiceBatchRenderer::renderGroup(StreamingVoice* const* group, int groupSize, juce::AudioBuffer<float>& outputBuffer,
+                                     int startSample, int numSamples)
+{
+    static_assert(Lanes <= maxLanes, "Lane width exceeds scratch storage");
+
+    // Structure-of-arrays lane state
+    alignas(64) uint64_t phase[Lanes];
+    alignas(64) uint64_t increment[Lanes];
+    alignas(64) int64_t lastFrame[Lanes];
+    alignas(64) int64_t indexMask[Lanes];
+    alignas(64) const float* left[Lanes];
+    alignas(64) const float* right[Lanes];
+    int renderedSamples[Lanes];
+
+    for (int lane = 0; lane < Lanes; ++lane)
+    {
+        float* gains = laneGains.data() + lane * chunkSize;
+
+        if (lane < groupSize)
+        {
+            StreamingVoice::BatchLane state;
+            renderedSamples[lane] = group[lane]->prepareBatchBlock(gains, numSamples, state);
+            phase[lane] = state.phase;
+            increment[lane] = state.phaseIncrement;
+            lastFrame[lane] = state.lastFrame;
+            indexMask[lane] = state.indexMask;
+            left[lane] = state.left;
+            right[lane] = state.right;
+        }
+        else
+        {
+            // Padding lane: reads silence with zero gain
+            renderedSamples[lane] = 0;
+            phase[lane] = 0;
+            increment[lane] = 0;
+            lastFrame[lane] = 1;
+            indexMask[lane] = -1;
+            left[lane] = silentFrames;
+            right[lane] = silentFrames;
+            std::fill(gains, gains + numSamples, 0.0f);
+        }
+    }
+
+    constexpr float phaseToFraction = 1.0f / 4294967296.0f;
+    const int numOutputChannels = outputBuffer.getNumChannels();
+    float* outLeft = outputBuffer.getWritePointer(0, startSample);
+    float* outRight = numOutputChannels > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float sumLeft = 0.0f;
+        float sumRight = 0.0f;
+
+        // One voice per lane: the compiler vectorizes this across lanes
+        for (int lane = 0; lane < Lanes; ++lane)
+        {
+            const int64_t pos0 = std::min(static_cast<int64_t>(phase[lane] >> 32), lastFrame[lane]);
+            const int64_t pos1 = std::min(pos0 + 1, lastFrame[lane]);
+            const int64_t index0 = pos0 & indexMask[lane];
+            const int64_t index1 = pos1 & indexMask[lane];
+            const float frac = static_cast<float>(phase[lane] & 0xffffffffu) * phaseToFraction;
+            const float gain = laneGains[static_cast<size_t>(lane * chunkSize + sample)];
+
+            const float l0 = left[lane][index0], l1 = left[lane][index1];
+            const float r0 = right[lane][index0], r1 = right[lane][index1];
+
+            sumLeft += (l0 + frac * (l1 - l0)) * gain;
+            sumRight += (r0 + frac * (r1 - r0)) * gain;
+
+            phase[lane] += increment[lane];
+        }
+
+        outLeft[sample] += sumLeft;
+        if (outRight != nullptr)
+            outRight[sample] += sumRight;
+
+        for (int ch = 2; ch < numOutputChannels; ++ch)
+            outputBuffer.addSample(ch, startSample + sample, sumRight);
+    }
+
+    for (int lane = 0; lane < groupSize; ++lane)
+        group[lane]->finishBatchBlock(renderedSamples[lane], numSamples);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include "DiskStreaming.h"
+#include "StreamingVoice.h"
+
+/**
+ * VoiceBatchRenderer is an alternative to rendering voices one at a time.
+ *
+ * It packs the state of 4, 8 or 16 active voices into structure-of-arrays form
+ * (phase, increment, gain, ring pointers) and renders them lane-parallel, one voice
+ * per SIMD lane. Per-voice SIMD leaves lanes idle on tiny host buffers; spreading
+ * voices across lanes keeps the vector units busy when 100+ voices are sounding.
+ *
+ * Voices that can't use the batch path this block (non-linear interpolation, ring
+ * close to underrun) fall back to StreamingVoice::renderNextBlock.
+ */
+class VoiceBatchRenderer
+{
+public:
+    using VoiceArray = std::array<StreamingVoice, StreamingConstants::maxStreamingVoices>;
+
+    static constexpr int maxLanes = 16;
+
+    /** Samples rendered per batch pass (longer blocks are split into chunks) */
+    static constexpr int chunkSize = 256;
+
+    /** Lanes per batch: 4, 8 or 16. Other values are rounded down to the nearest supported width. */
+    void setLaneWidth(int lanes);
+    int getLaneWidth() const { return laneWidth; }
+
+    /** Render all active voices into outputBuffer */
+    void render(VoiceArray& voices, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+private:
+    template <int Lanes>
+    void renderGroup(StreamingVoice* const* group, int groupSize, juce::AudioBuffer<float>& outputBuffer,
+                     int startSample, int numSamples);
+
+    int laneWidth = 8;
+
+    // Voices eligible for the batch path in the current chunk
+    std::array<StreamingVoice*, StreamingConstants::maxStreamingVoices> batchVoices {};
+
+    // Per-lane gains for one chunk (lane-major)
+    alignas(64) std::array<float, maxLanes * chunkSize> laneGains {};
+};
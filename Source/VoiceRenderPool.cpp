@@ -0,0 +1,239 @@
+#include "VoiceRenderPool.h"
+#include <algorithm>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #include <immintrin.h>
+#endif
+
+namespace
+{
+    // Hint to the CPU that we're in a spin-wait loop
+    inline void cpuRelax()
+    {
+       #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+       #elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+       #endif
+    }
+}
+
+//==============================================================================
+VoiceRenderPool::Worker::Worker(VoiceRenderPool& owner, int partitionIndex)
+    : juce::Thread("VoiceRenderWorker " + juce::String(partitionIndex)),
+      pool(owner),
+      partition(partitionIndex)
+{
+}
+
+void VoiceRenderPool::Worker::run()
+{
+    auto lastJobTime = juce::Time::getMillisecondCounterHiRes();
+    int spins = 0;
+
+    while (!threadShouldExit())
+    {
+        const uint32_t generation = pool.jobGeneration.load(std::memory_order_acquire);
+        if (generation != seenGeneration)
+        {
+            seenGeneration = generation;
+
+            // Jobs published before this worker was enabled don't count on it
+            if (partition <= pool.jobWorkers.load(std::memory_order_relaxed))
+            {
+                pool.renderPartition(partition);
+                pool.partitionsRemaining.fetch_sub(1, std::memory_order_acq_rel);
+            }
+
+            lastJobTime = juce::Time::getMillisecondCounterHiRes();
+            spins = 0;
+            continue;
+        }
+
+        // Short spin catches back-to-back blocks without a context switch
+        if (spins < spinIterations)
+        {
+            ++spins;
+            cpuRelax();
+            continue;
+        }
+
+        if (juce::Time::getMillisecondCounterHiRes() - lastJobTime < yieldPeriodMs)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Idle: block until render() wakes us. Re-check the generation after raising
+        // the flag so a job published in between isn't missed.
+        sleeping.store(true);
+        if (pool.jobGeneration.load() == seenGeneration)
+            wait(idleWaitMs);
+        sleeping.store(false);
+        spins = 0;
+    }
+}
+
+//==============================================================================
+VoiceRenderPool::VoiceRenderPool()
+{
+    for (int i = 0; i < maxWorkers; ++i)
+        workers[static_cast<size_t>(i)] = std::make_unique<Worker>(*this, i + 1);
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    setNumWorkers(0);
+}
+
+void VoiceRenderPool::prepare(double sampleRate, int maxBlockSize, int numChannels)
+{
+    const bool periodChanged = sampleRate != blockSampleRate || juce::jmax(1, maxBlockSize) != scratchBlockSize;
+
+    scratchBlockSize = juce::jmax(1, maxBlockSize);
+    scratchChannels = juce::jmax(1, numChannels);
+    blockSampleRate = sampleRate;
+    for (auto& bus : scratchBuses)
+        bus.setSize(scratchChannels, scratchBlockSize);
+
+    // Running workers were scheduled for the old block period: restart them with the new one
+    const int numWorkers = getNumWorkers();
+    if (periodChanged && numWorkers > 0)
+    {
+        setNumWorkers(0);
+        setNumWorkers(numWorkers);
+    }
+}
+
+void VoiceRenderPool::startWorker(Worker& worker)
+{
+    // Jobs from here on are new to this worker
+    worker.seenGeneration = jobGeneration.load();
+
+    const auto options = juce::Thread::RealtimeOptions{}
+                             .withPriority(workerRealtimePriority)
+                             .withApproximateAudioProcessingTime(scratchBlockSize, blockSampleRate);
+
+    // Without real-time scheduling rights (e.g. no rtprio limit on Linux) fall back to the top normal priority
+    if (!worker.startRealtimeThread(options))
+        worker.startThread(juce::Thread::Priority::highest);
+}
+
+void VoiceRenderPool::setNumWorkers(int numWorkers)
+{
+    numWorkers = juce::jlimit(0, maxWorkers, numWorkers);
+
+    // Start new workers before the audio thread can hand them jobs
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto& worker = *workers[static_cast<size_t>(i)];
+        if (!worker.isThreadRunning())
+            startWorker(worker);
+    }
+
+    activeWorkers.store(numWorkers);
+
+    // A render that started with the old count may still be waiting on workers we're about to stop
+    while (renderInProgress.load())
+        juce::Thread::sleep(1);
+
+    for (int i = numWorkers; i < maxWorkers; ++i)
+    {
+        auto& worker = *workers[static_cast<size_t>(i)];
+        if (worker.isThreadRunning())
+        {
+            worker.signalThreadShouldExit();
+            worker.notify();
+            worker.stopThread(1000);
+        }
+    }
+}
+
+void VoiceRenderPool::render(VoiceArray& voices, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    renderInProgress.store(true);
+    const int numWorkers = activeWorkers.load();
+
+    int numVoices = 0;
+    for (auto& voice : voices)
+    {
+        if (voice.isActive())
+            jobVoices[static_cast<size_t>(numVoices++)] = &voice;
+    }
+
+    const int numPartitions = juce::jmin(numWorkers + 1, numVoices / minVoicesPerPartition);
+    const int numChannels = outputBuffer.getNumChannels();
+
+    // Also inline if the output has more channels than the buses were prepared for
+    if (numPartitions < 2 || scratchBlockSize == 0 || numChannels > scratchChannels)
+    {
+        // Too few voices to be worth the handoff: render on the audio thread
+        for (int i = 0; i < numVoices; ++i)
+            jobVoices[static_cast<size_t>(i)]->renderNextBlock(outputBuffer, startSample, numSamples);
+
+        renderInProgress.store(false);
+        return;
+    }
+
+    // Contiguous partitions keep each voice on the same thread from block to block
+    for (int p = 0; p <= numPartitions; ++p)
+        partitionStarts[static_cast<size_t>(p)] = (numVoices * p) / numPartitions;
+    for (int p = numPartitions + 1; p < static_cast<int>(partitionStarts.size()); ++p)
+        partitionStarts[static_cast<size_t>(p)] = numVoices;
+
+    for (int chunkStart = 0; chunkStart < numSamples; chunkStart += scratchBlockSize)
+    {
+        jobNumSamples = juce::jmin(scratchBlockSize, numSamples - chunkStart);
+
+        // Publish the job; workers beyond numPartitions find an empty partition and return at once
+        jobWorkers.store(numWorkers, std::memory_order_relaxed);
+        partitionsRemaining.store(numWorkers, std::memory_order_relaxed);
+        jobGeneration.fetch_add(1);
+
+        for (int i = 0; i < numWorkers; ++i)
+        {
+            auto& worker = *workers[static_cast<size_t>(i)];
+            if (worker.sleeping.load())
+                worker.notify();
+        }
+
+        renderPartition(0);
+
+        // Deadline is a few ms away, so spin then yield rather than sleep
+        for (int spins = 0; partitionsRemaining.load(std::memory_order_acquire) > 0; ++spins)
+        {
+            if (spins < spinIterations)
+                cpuRelax();
+            else
+                std::this_thread::yield();
+        }
+
+        // Voice-order summation: the same additions as rendering the voices one by one
+        for (int i = 0; i < numVoices; ++i)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+                outputBuffer.addFrom(ch, startSample + chunkStart, scratchBuses[static_cast<size_t>(i)], ch, 0, jobNumSamples);
+        }
+    }
+
+    renderInProgress.store(false);
+}
+
+void VoiceRenderPool::renderPartition(int partition)
+{
+    const int first = partitionStarts[static_cast<size_t>(partition)];
+    const int last = partitionStarts[static_cast<size_t>(partition + 1)];
+    if (first >= last)
+        return;
+
+    for (int i = first; i < last; ++i)
+    {
+        auto& bus = scratchBuses[static_cast<size_t>(i)];
+        bus.clear(0, jobNumSamples);
+
+        auto* voice = jobVoices[static_cast<size_t>(i)];
+        if (voice->isActive())
+            voice->renderNextBlock(bus, 0, jobNumSamples);
+    }
+}
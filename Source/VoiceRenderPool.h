@@ -0,0 +1,96 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "DiskStreaming.h"
+#include "StreamingVoice.h"
+
+/**
+ * VoiceRenderPool spreads voice rendering across real-time worker threads.
+ *
+ * Each block, active voices are split into contiguous partitions. The audio thread
+ * renders partition 0 itself and the workers render the rest. Every voice renders
+ * into its own scratch bus, and the buses are summed into the output in voice order:
+ * each output sample gets the same additions in the same order as rendering the
+ * voices one by one, so the result is bit-identical to single-threaded rendering.
+ *
+ * Workers are real-time threads (startRealtimeThread, with the block's period where
+ * the platform uses it), so the OS treats them like the host's audio thread.
+ *
+ * Handoff is lock-free: the audio thread bumps a job generation counter, workers
+ * spin briefly, then yield, and only block on their thread event after sitting idle
+ * for a while. The audio thread never sleeps while waiting for the workers.
+ *
+ * Small voice counts are rendered inline on the audio thread (minVoicesPerPartition).
+ */
+class VoiceRenderPool
+{
+public:
+    using VoiceArray = std::array<StreamingVoice, StreamingConstants::maxStreamingVoices>;
+
+    static constexpr int maxWorkers = 7;                // Plus the audio thread itself
+    static constexpr int minVoicesPerPartition = 8;     // Below this, threading costs more than it saves
+
+    VoiceRenderPool();
+    ~VoiceRenderPool();
+
+    /** Allocate scratch buses for every output channel (call from prepareToPlay, not while rendering) */
+    void prepare(double sampleRate, int maxBlockSize, int numChannels);
+
+    /** Number of worker threads, 0 = render on the audio thread only (call from message thread) */
+    void setNumWorkers(int numWorkers);
+    int getNumWorkers() const { return activeWorkers.load(std::memory_order_acquire); }
+
+    /** Render all active voices into outputBuffer (audio thread) */
+    void render(VoiceArray& voices, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(VoiceRenderPool& owner, int partitionIndex);
+        void run() override;
+
+        std::atomic<bool> sleeping{false};
+        uint32_t seenGeneration = 0;    // Set before the thread starts
+
+    private:
+        VoiceRenderPool& pool;
+        const int partition;
+    };
+
+    void renderPartition(int partition);
+    void startWorker(Worker& worker);
+
+    std::array<std::unique_ptr<Worker>, maxWorkers> workers;
+
+    // Worker count the audio thread may use; render() marks itself busy so
+    // setNumWorkers() can wait before stopping threads it might still be using
+    std::atomic<int> activeWorkers{0};
+    std::atomic<bool> renderInProgress{false};
+
+    // Current job (written by the audio thread before bumping jobGeneration)
+    std::array<StreamingVoice*, StreamingConstants::maxStreamingVoices> jobVoices {};
+    std::array<int, maxWorkers + 2> partitionStarts {};
+    int jobNumSamples = 0;
+    std::atomic<int> jobWorkers{0};     // Workers taking part in the current job
+    std::atomic<uint32_t> jobGeneration{0};
+    std::atomic<int> partitionsRemaining{0};
+
+    // One scratch bus per voice of the job (indexed like jobVoices)
+    std::array<juce::AudioBuffer<float>, StreamingConstants::maxStreamingVoices> scratchBuses;
+    int scratchBlockSize = 0;
+    int scratchChannels = 0;
+    double blockSampleRate = 44100.0;
+
+    // Worker thread priority within the real-time band (JUCE's 0-10 scale)
+    static constexpr int workerRealtimePriority = 8;
+
+    // Worker idle policy: spin, then yield, then block until the next job
+    static constexpr int spinIterations = 2000;
+    static constexpr double yieldPeriodMs = 20.0;
+    static constexpr int idleWaitMs = 100;
+};
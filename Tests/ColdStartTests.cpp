@@ -0,0 +1,124 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <memory>
+#include "../Source/StreamingVoice.h"
+
+//==============================================================================
+// Cold Start Tests (a voice on a sample without a preload, fed by hand)
+//==============================================================================
+class ColdStartTests : public juce::UnitTest
+{
+public:
+    ColdStartTests() : juce::UnitTest("Cold Start") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+
+        RingBufferPool pool;
+        pool.setMinimumReserve(4);
+        pool.maintain();
+
+        PreloadedSample sample;
+        sample.filePath = "cold.wav";
+        sample.totalSampleFrames = 100000;
+        sample.sampleRate = sampleRate;
+        sample.numChannels = 1;
+        sample.rootNote = 60;
+
+        auto makeVoice = [&pool]
+        {
+            auto voice = std::make_unique<StreamingVoice>();
+            voice->setRingBufferPool(&pool);
+            voice->prepareToPlay(sampleRate, 512);
+            voice->setADSRParameters({ 0.001f, 0.1f, 1.0f, 0.3f });
+            return voice;
+        };
+
+        // What the disk thread would write: frame f of the sample holds f / 4096
+        auto deliver = [](StreamingVoice& voice, int frames)
+        {
+            StreamingVoice::RingLease lease;
+            if (!voice.beginRingLease(voice.getRingGeneration(), lease))
+                return;
+
+            const int start = voice.getWritePosition();
+            for (int i = 0; i < frames; ++i)
+                lease.channels[0][(start + i) & StreamingConstants::ringBufferMask] = static_cast<float>(start + i) / 4096.0f;
+            voice.advanceWritePosition(frames);
+            voice.endRingLease();
+        };
+
+        juce::AudioBuffer<float> output(1, 512);
+
+        beginTest("Waiting voice stays silent and holds its position until the data lands");
+        {
+            auto voice = makeVoice();
+            voice->setColdStart(StreamingVoice::ColdStart::Wait);
+            voice->startVoice(&sample, 60, 1.0f, sampleRate);
+            expect(voice->isColdStarting());
+
+            output.clear();
+            voice->renderNextBlock(output, 0, 256);
+            expectEquals(output.getMagnitude(0, 0, 256), 0.0f);
+            expectEquals(voice->getColdStartWaitSamples(), 256);
+            expect(!voice->isColdStartDataReady());
+
+            deliver(*voice, StreamingConstants::diskReadFrames);
+            expect(voice->isColdStartDataReady());
+            voice->finishColdStart(sampleRate);
+            expect(!voice->isColdStarting());
+
+            // Plays from the start of the sample: frame 100 after 100 samples
+            output.clear();
+            voice->renderNextBlock(output, 0, 101);
+            expectWithinAbsoluteError(output.getSample(0, 100), 100.0f / 4096.0f, 1.0e-4f);
+        }
+
+        beginTest("Shadowing voice keeps time and fades in where the note has got to");
+        {
+            auto voice = makeVoice();
+            voice->setColdStart(StreamingVoice::ColdStart::Shadow);
+            voice->startVoice(&sample, 60, 1.0f, sampleRate);
+
+            output.clear();
+            voice->renderNextBlock(output, 0, 500);
+            voice->renderNextBlock(output, 0, 500);
+            expectEquals(output.getMagnitude(0, 0, 500), 0.0f);
+
+            deliver(*voice, StreamingConstants::diskReadFrames);
+            expect(voice->isColdStartDataReady());
+            voice->finishColdStart(sampleRate);
+
+            // 10 ms fade-in (441 samples), then frame 1000 + 500
+            output.clear();
+            voice->renderNextBlock(output, 0, 501);
+            expect(std::abs(output.getSample(0, 0)) < 0.01f);
+            expectWithinAbsoluteError(output.getSample(0, 500), 1500.0f / 4096.0f, 1.0e-3f);
+        }
+
+        beginTest("A cold voice stolen before it was heard just stops");
+        {
+            auto voice = makeVoice();
+            voice->setColdStart(StreamingVoice::ColdStart::Wait);
+            voice->startVoice(&sample, 60, 1.0f, sampleRate);
+            voice->startQuickFadeOut(sampleRate);
+
+            voice->renderNextBlock(output, 0, 64);
+            expect(!voice->isActive());
+        }
+
+        beginTest("The cold start mode applies to one note only");
+        {
+            auto voice = makeVoice();
+            voice->setColdStart(StreamingVoice::ColdStart::Wait);
+            voice->startVoice(&sample, 60, 1.0f, sampleRate);
+            voice->stopVoice(false);
+
+            voice->startVoice(&sample, 60, 1.0f, sampleRate);
+            expect(!voice->isColdStarting());
+            voice->stopVoice(false);
+        }
+    }
+};
+
+static ColdStartTests coldStartTests;
@@ -0,0 +1,106 @@
+#include <juce_core/juce_core.h>
+#include <memory>
+#include <vector>
+#include "../Source/EngineIPC.h"
+
+//==============================================================================
+// Engine IPC Tests (session rings, exercised in-process)
+//==============================================================================
+class EngineIPCTests : public juce::UnitTest
+{
+public:
+    EngineIPCTests() : juce::UnitTest("EngineIPC") {}
+
+    void runTest() override
+    {
+        auto makeEvents = [](int count)
+        {
+            NoteEventQueue queue;
+            for (int i = 0; i < count; ++i)
+            {
+                NoteEventQueue::Event event;
+                event.samplePosition = i;
+                event.midiNote = 60 + (i % 12);
+                queue.push(event);
+            }
+            return queue;
+        };
+
+        beginTest("Requests arrive in order with their events");
+        {
+            auto session = std::make_unique<EngineIPC::SessionBlock>();
+            expect(session->peekRequest() == nullptr);
+
+            expect(session->pushRequest(256, 1, makeEvents(3)));
+            expect(session->pushRequest(128, 2, makeEvents(0)));
+
+            const auto* first = session->peekRequest();
+            expect(first != nullptr);
+            expectEquals(static_cast<int>(first->numSamples), 256);
+            expectEquals(static_cast<int>(first->interpolationQuality), 1);
+            expectEquals(static_cast<int>(first->numEvents), 3);
+            expectEquals(first->events[2].midiNote, 62);
+            session->popRequest();
+
+            expectEquals(static_cast<int>(session->peekRequest()->numSamples), 128);
+            session->popRequest();
+            expect(session->peekRequest() == nullptr);
+        }
+
+        beginTest("Full request ring drops and counts, excess events are cut");
+        {
+            auto session = std::make_unique<EngineIPC::SessionBlock>();
+            for (int i = 0; i < EngineIPC::requestRingSize; ++i)
+                expect(session->pushRequest(64, 0, makeEvents(0)));
+
+            expect(!session->pushRequest(64, 0, makeEvents(0)));
+            expectEquals(static_cast<int>(session->droppedRequests.load()), 1);
+
+            session->popRequest();
+            expect(session->pushRequest(64, 0, makeEvents(EngineIPC::maxEventsPerRequest + 10)));
+
+            for (int i = 0; i < EngineIPC::requestRingSize - 1; ++i)
+                session->popRequest();
+            expectEquals(static_cast<int>(session->peekRequest()->numEvents), EngineIPC::maxEventsPerRequest);
+        }
+
+        beginTest("Audio ring wraps and primes the latency with silence");
+        {
+            auto session = std::make_unique<EngineIPC::SessionBlock>();
+            session->reset(512);
+            expectEquals(session->getBufferedFrames(), 512);
+
+            std::vector<float> left(EngineIPC::maxBlockSize), right(EngineIPC::maxBlockSize);
+            float* out[2] = { left.data(), right.data() };
+
+            // Drain the priming, then push blocks across the wrap point
+            expectEquals(session->readAudio(out, 2, 512), 512);
+            expectEquals(left[100], 0.0f);
+
+            std::vector<float> source(EngineIPC::maxBlockSize);
+            const float* in[2] = { source.data(), source.data() };
+            float value = 0.0f;
+            for (int block = 0; block < 10; ++block)
+            {
+                for (auto& sample : source)
+                    sample = value++;
+
+                expectEquals(session->writeAudio(in, EngineIPC::maxBlockSize), EngineIPC::maxBlockSize);
+                expectEquals(session->readAudio(out, 2, EngineIPC::maxBlockSize), EngineIPC::maxBlockSize);
+                expectEquals(left[0], source[0]);
+                expectEquals(right[EngineIPC::maxBlockSize - 1], source[EngineIPC::maxBlockSize - 1]);
+            }
+
+            // A full ring refuses more than its capacity, an empty one returns nothing
+            for (int i = 0; i < EngineIPC::audioRingFrames / EngineIPC::maxBlockSize; ++i)
+                session->writeAudio(in, EngineIPC::maxBlockSize);
+            expectEquals(session->writeAudio(in, EngineIPC::maxBlockSize), 0);
+
+            for (int i = 0; i < EngineIPC::audioRingFrames / EngineIPC::maxBlockSize; ++i)
+                session->readAudio(out, 2, EngineIPC::maxBlockSize);
+            expectEquals(session->readAudio(out, 2, 64), 0);
+        }
+    }
+};
+
+static EngineIPCTests engineIPCTests;
@@ -0,0 +1,91 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/BlockEnvelope.h"
+#include <vector>
+
+//==============================================================================
+// Block Envelope Tests
+//==============================================================================
+class EnvelopeTests : public juce::UnitTest
+{
+public:
+    EnvelopeTests() : juce::UnitTest("BlockEnvelope") {}
+
+    void runTest() override
+    {
+        juce::ADSR::Parameters params;
+        params.attack = 0.1f;
+        params.decay = 0.2f;
+        params.sustain = 0.5f;
+        params.release = 0.3f;
+
+        beginTest("Attack and decay end on time");
+        {
+            BlockEnvelope envelope;
+            envelope.setSampleRate(1000.0);
+            envelope.setParameters(params);
+            envelope.noteOn();
+
+            std::vector<float> gains(400);
+            expectEquals(envelope.process(gains.data(), static_cast<int>(gains.size())), 400);
+
+            expectWithinAbsoluteError(gains[99], 1.0f, 1.0e-6f);
+            expect(gains[98] < 1.0f);
+            expect(gains[200] > 0.5f);
+            expectWithinAbsoluteError(gains[299], 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError(gains[399], 0.5f, 1.0e-6f);
+        }
+
+        beginTest("Release finishes and zero-fills the rest of the block");
+        {
+            BlockEnvelope envelope;
+            envelope.setSampleRate(1000.0);
+            envelope.setParameters(params);
+            envelope.noteOn();
+
+            std::vector<float> gains(512);
+            envelope.process(gains.data(), 400);
+            envelope.noteOff();
+
+            expectEquals(envelope.process(gains.data(), 512), 300);
+            expect(!envelope.isActive());
+            expectEquals(gains[300], 0.0f);
+            expectEquals(gains[511], 0.0f);
+        }
+
+        beginTest("Block size does not change the output");
+        {
+            BlockEnvelope whole, chunked;
+            for (auto* envelope : { &whole, &chunked })
+            {
+                envelope->setSampleRate(1000.0);
+                envelope->setParameters(params);
+                envelope->noteOn();
+            }
+
+            std::vector<float> expected(400), actual(400);
+            whole.process(expected.data(), 400);
+            for (int start = 0; start < 400; start += 7)
+                chunked.process(actual.data() + start, juce::jmin(7, 400 - start));
+
+            for (size_t i = 0; i < expected.size(); ++i)
+                expectWithinAbsoluteError(actual[i], expected[i], 1.0e-5f);
+        }
+
+        beginTest("Custom release time overrides the parameter release");
+        {
+            BlockEnvelope envelope;
+            envelope.setSampleRate(1000.0);
+            envelope.setParameters(params);
+            envelope.noteOn();
+
+            std::vector<float> gains(400);
+            envelope.process(gains.data(), 400);
+            envelope.noteOff(0.05f);
+
+            expectEquals(envelope.process(gains.data(), 400), 50);
+            expectWithinAbsoluteError(envelope.getParameters().release, 0.3f, 1.0e-6f);
+        }
+    }
+};
+
+static EnvelopeTests envelopeTests;
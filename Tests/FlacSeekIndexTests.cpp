@@ -0,0 +1,183 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/FlacSeekIndex.h"
+#include "TestAudioFiles.h"
+#include <cmath>
+
+//==============================================================================
+// FLAC Seek Index Tests (frame tables and the indexed FLAC reader)
+//==============================================================================
+class FlacSeekIndexTests : public juce::UnitTest
+{
+public:
+    FlacSeekIndexTests() : juce::UnitTest("FLAC Seek Index") {}
+
+    void runTest() override
+    {
+        const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                .getChildFile("HammerSamplerFlacIndexTests");
+        folder.deleteRecursively();
+        folder.createDirectory();
+
+        juce::Random random(7);
+        auto tone = [&random](int channel, int frame)
+        {
+            return 0.5f * std::sin(0.013f * static_cast<float>(frame) * static_cast<float>(channel + 1))
+                 + 0.01f * (random.nextFloat() - 0.5f);
+        };
+
+        const auto stereo16 = folder.getChildFile("C4_100_1.flac");
+        const auto mono24 = folder.getChildFile("D4_80_1.flac");
+        writeFlac(stereo16, 2, 16, 100000, tone);
+        writeFlac(mono24, 1, 24, 50001, tone);
+
+        beginTest("Scanning indexes every frame");
+        {
+            auto index = FlacSeekIndex::open(stereo16, true);
+            expect(index != nullptr);
+            if (index == nullptr)
+                return;
+
+            expectEquals(index->getNumChannels(), 2);
+            expectEquals(index->getBitsPerSample(), 16);
+            expectEquals(index->getTotalSamples(), int64_t(100000));
+
+            const auto& frames = index->getFrames();
+            expect(frames.size() > 1);
+            expectEquals(frames.front().firstSample, int64_t(0));
+            expectEquals(index->findFrame(0), 0);
+            expectEquals(index->findFrame(frames[1].firstSample), 1);
+            expectEquals(index->findFrame(frames[1].firstSample - 1), 0);
+            expectEquals(index->findFrame(100000), -1);
+        }
+
+        beginTest("Indexed reads match the JUCE FLAC reader, sequential and seeking");
+        {
+            for (const auto& file : { stereo16, mono24 })
+                expectMatchesReference(file, random);
+        }
+
+        // libFLAC at every compression level, on material that makes it pick each subframe type
+        // (constant, verbatim, fixed and LPC of several orders, stereo decorrelation)
+        beginTest("Indexed reads match the JUCE FLAC reader at every compression level");
+        {
+            constexpr int segmentFrames = 6000;
+            auto mixed = [&random, &tone](int channel, int frame)
+            {
+                switch (frame / segmentFrames)
+                {
+                    case 0:  return 0.0f;                                                     // Silence
+                    case 1:  return tone(channel, frame);
+                    case 2:  return 0.99f * (2.0f * random.nextFloat() - 1.0f);               // Full-scale noise
+                    case 3:  return std::round(tone(channel, frame) * 256.0f) / 256.0f;       // Coarse steps
+                    default: return 0.7f * std::sin(0.002f * static_cast<float>(frame));      // Same in every channel
+                }
+            };
+
+            for (int level = 0; level <= 8; ++level)
+            {
+                for (const auto& [numChannels, bits] : { std::pair<int, int>{ 1, 16 }, { 2, 16 }, { 2, 24 } })
+                {
+                    const auto file = folder.getChildFile("G4_" + juce::String(level) + "_" + juce::String(numChannels)
+                                                          + "x" + juce::String(bits) + ".flac");
+                    writeFlac(file, numChannels, bits, 5 * segmentFrames + 777, mixed, level);
+                    expectMatchesReference(file, random);
+                }
+            }
+        }
+
+        beginTest("Indexes come back from the cache and follow file changes");
+        {
+            expect(FlacSeekIndex::open(mono24, false) != nullptr);
+
+            const auto other = folder.getChildFile("E4_80_1.flac");
+            writeFlac(other, 1, 16, 3000, tone);
+            expect(FlacSeekIndex::open(other, false) == nullptr);
+            expect(FlacSeekIndex::open(other, true) != nullptr);
+
+            // Rewritten with a different length: the cached table no longer applies
+            writeFlac(other, 1, 16, 7000, tone);
+            auto rebuilt = FlacSeekIndex::open(other, true);
+            expect(rebuilt != nullptr && rebuilt->getTotalSamples() == 7000);
+        }
+
+        beginTest("Other files get no index");
+        {
+            expect(FlacSeekIndex::open(folder.getChildFile("missing.flac"), true) == nullptr);
+
+            const auto notFlac = folder.getChildFile("F4_80_1.flac");
+            notFlac.replaceWithText("not a FLAC file");
+            expect(FlacSeekIndex::open(notFlac, true) == nullptr);
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    template <typename Value>
+    void writeFlac(const juce::File& file, int numChannels, int bitsPerSample, int numFrames, Value value, int compressionLevel = 5)
+    {
+        juce::FlacAudioFormat flac;
+        expect(TestAudioFiles::write(flac, file, TestAudioFiles::makeBuffer(numChannels, numFrames, value), 44100.0,
+                                     bitsPerSample, compressionLevel));
+    }
+
+    /** Decode the whole file through its index in streaming-sized reads, then at random
+        positions (some running off either end), and compare with the JUCE reader */
+    void expectMatchesReference(const juce::File& file, juce::Random& random)
+    {
+        auto index = FlacSeekIndex::open(file, true);
+        expect(index != nullptr, file.getFileName());
+        if (index == nullptr)
+            return;
+
+        juce::FlacAudioFormat flac;
+        std::unique_ptr<juce::AudioFormatReader> reference(flac.createReaderFor(file.createInputStream().release(), true));
+        const int numChannels = static_cast<int>(reference->numChannels);
+        const int numFrames = static_cast<int>(reference->lengthInSamples);
+        expectEquals(index->getTotalSamples(), static_cast<int64_t>(numFrames));
+
+        juce::AudioBuffer<float> expected(numChannels, numFrames);
+        reference->read(&expected, 0, numFrames, 0, true, true);
+
+        auto reader = index->createReader();
+        juce::AudioBuffer<float> actual(numChannels, numFrames);
+
+        for (int start = 0; start < numFrames; start += 1000)
+        {
+            const int count = std::min(1000, numFrames - start);
+            expect(reader->read(&actual, start, count, start, true, true));
+        }
+        expectEquals(countMismatches(expected, actual, 0, numFrames), 0, file.getFileName());
+
+        int mismatches = 0;
+        for (int i = 0; i < 50; ++i)
+        {
+            const int start = random.nextInt(numFrames + 200) - 100;
+            const int count = 1 + random.nextInt(9000);
+            juce::AudioBuffer<float> part(numChannels, count);
+            expect(reader->read(&part, 0, count, start, true, true));
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int frame = 0; frame < count; ++frame)
+                {
+                    const int position = start + frame;
+                    const float want = position >= 0 && position < numFrames ? expected.getSample(ch, position) : 0.0f;
+                    mismatches += part.getSample(ch, frame) != want ? 1 : 0;
+                }
+        }
+        expectEquals(mismatches, 0, file.getFileName());
+    }
+
+    static int countMismatches(const juce::AudioBuffer<float>& expected, const juce::AudioBuffer<float>& actual,
+                               int start, int numFrames)
+    {
+        int mismatches = 0;
+        for (int ch = 0; ch < expected.getNumChannels(); ++ch)
+            for (int frame = start; frame < start + numFrames; ++frame)
+                mismatches += actual.getSample(ch, frame) != expected.getSample(ch, frame) ? 1 : 0;
+        return mismatches;
+    }
+};
+
+static FlacSeekIndexTests flacSeekIndexTests;
@@ -0,0 +1,147 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/HostRateCache.h"
+#include "TestAudioFiles.h"
+#include <cmath>
+
+//==============================================================================
+// Host Rate Cache Tests (samples resampled offline to the host rate)
+//==============================================================================
+class HostRateCacheTests : public juce::UnitTest
+{
+public:
+    HostRateCacheTests() : juce::UnitTest("Host Rate Cache") {}
+
+    void runTest() override
+    {
+        const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                .getChildFile("HammerSamplerRateCacheTests");
+        folder.deleteRecursively();
+        folder.createDirectory();
+        const auto cacheFolder = folder.getChildFile("Cache");
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        beginTest("Downsampling keeps the passband and removes what's above the new Nyquist");
+        {
+            const auto source = folder.getChildFile("C4_100_1.wav");
+            writeTone(source, 96000.0, 96000, { 1000.0, 30000.0 });
+
+            const auto copy = cacheFolder.getChildFile("down.wav");
+            expect(HostRateCache::render(formatManager, source.getFullPathName(), copy, 48000.0));
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(copy));
+            expect(reader != nullptr);
+            if (reader != nullptr)
+            {
+                expectEquals(reader->sampleRate, 48000.0);
+                expectEquals(reader->lengthInSamples, juce::int64(48000));
+
+                // Only the 1 kHz tone is left (the 30 kHz one would alias to 18 kHz)
+                expectLessThan(maxErrorAgainstTone(*reader, 1000.0), 1.0e-4);
+            }
+        }
+
+        beginTest("Upsampling keeps the tone and the length in time");
+        {
+            const auto source = folder.getChildFile("D4_100_1.wav");
+            writeTone(source, 44100.0, 44100, { 1000.0 });
+
+            const auto copy = cacheFolder.getChildFile("up.wav");
+            expect(HostRateCache::render(formatManager, source.getFullPathName(), copy, 48000.0));
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(copy));
+            expect(reader != nullptr);
+            if (reader != nullptr)
+            {
+                expectEquals(reader->lengthInSamples, juce::int64(48000));
+                expectLessThan(maxErrorAgainstTone(*reader, 1000.0), 1.0e-4);
+            }
+        }
+
+        beginTest("Copies keep the source bit depth, at most 24-bit integer");
+        {
+            const auto source16 = folder.getChildFile("F4_100_1.wav");
+            writeTone(source16, 96000.0, 9600, { 1000.0 }, 16);
+
+            const auto copy16 = cacheFolder.getChildFile("depth16.wav");
+            expect(HostRateCache::render(formatManager, source16.getFullPathName(), copy16, 48000.0));
+
+            const auto copyFloat = cacheFolder.getChildFile("depthFloat.wav");
+            expect(HostRateCache::render(formatManager, folder.getChildFile("C4_100_1.wav").getFullPathName(), copyFloat, 48000.0));
+
+            std::unique_ptr<juce::AudioFormatReader> reader16(formatManager.createReaderFor(copy16));
+            std::unique_ptr<juce::AudioFormatReader> readerFloat(formatManager.createReaderFor(copyFloat));
+            expect(reader16 != nullptr && readerFloat != nullptr);
+            if (reader16 != nullptr && readerFloat != nullptr)
+            {
+                expectEquals(static_cast<int>(reader16->bitsPerSample), 16);
+                expectEquals(static_cast<int>(readerFloat->bitsPerSample), 24);
+                expect(!readerFloat->usesFloatingPointData);
+            }
+        }
+
+        beginTest("Copies are named after the sample, its fingerprint and the rate");
+        {
+            const auto copy = HostRateCache::getCopyFile(cacheFolder, "/samples/C4_100_1.wav", 1, 48000.0);
+            expect(copy == HostRateCache::getCopyFile(cacheFolder, "/samples/C4_100_1.wav", 1, 48000.0));
+            expect(copy != HostRateCache::getCopyFile(cacheFolder, "/samples/C4_100_1.wav", 1, 44100.0));
+            expect(copy != HostRateCache::getCopyFile(cacheFolder, "/samples/C4_100_1.wav", 2, 48000.0));
+            expect(copy != HostRateCache::getCopyFile(cacheFolder, "/samples/D4_100_1.wav", 1, 48000.0));
+        }
+
+        beginTest("Rendering many samples uses every job and reports failures");
+        {
+            std::vector<HostRateCache::Job> jobs;
+            for (int i = 0; i < 6; ++i)
+            {
+                const auto source = folder.getChildFile("E4_100_" + juce::String(i + 1) + ".wav");
+                writeTone(source, 96000.0, 20000, { 440.0 * (i + 1) });
+                jobs.push_back({ source.getFullPathName(), cacheFolder.getChildFile("job" + juce::String(i) + ".wav") });
+            }
+            jobs.push_back({ folder.getChildFile("missing.wav").getFullPathName(), cacheFolder.getChildFile("missing.wav") });
+
+            expectEquals(HostRateCache::renderAll(jobs, 48000.0), 6);
+            for (int i = 0; i < 6; ++i)
+                expect(jobs[static_cast<size_t>(i)].destination.existsAsFile());
+            expect(!jobs.back().destination.existsAsFile());
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static constexpr double toneLevel = 0.4;
+
+    void writeTone(const juce::File& file, double sampleRate, int numFrames, std::initializer_list<double> frequencies,
+                   int bitsPerSample = 32)
+    {
+        const auto tone = TestAudioFiles::makeBuffer(1, numFrames, [&](int, int frame)
+        {
+            double value = 0.0;
+            for (double frequency : frequencies)
+                value += toneLevel * std::sin(juce::MathConstants<double>::twoPi * frequency * frame / sampleRate);
+            return value;
+        });
+        expect(TestAudioFiles::writeWav(file, tone, sampleRate, bitsPerSample));
+    }
+
+    // Largest difference from a pure tone, away from the edges where the kernel runs off the sample
+    static double maxErrorAgainstTone(juce::AudioFormatReader& reader, double frequency)
+    {
+        const int numFrames = static_cast<int>(reader.lengthInSamples);
+        juce::AudioBuffer<float> buffer(1, numFrames);
+        reader.read(&buffer, 0, numFrames, 0, true, true);
+
+        double maxError = 0.0;
+        for (int frame = 500; frame < numFrames - 500; ++frame)
+        {
+            const double expected = toneLevel * std::sin(juce::MathConstants<double>::twoPi * frequency * frame / reader.sampleRate);
+            maxError = std::max(maxError, std::abs(buffer.getSample(0, frame) - expected));
+        }
+        return maxError;
+    }
+};
+
+static HostRateCacheTests hostRateCacheTests;
@@ -0,0 +1,71 @@
+#include <juce_core/juce_core.h>
+#include "../Source/Interpolation.h"
+#include <cmath>
+
+//==============================================================================
+// Interpolation Kernel Tests
+//==============================================================================
+class InterpolationTests : public juce::UnitTest
+{
+public:
+    InterpolationTests() : juce::UnitTest("Interpolation") {}
+
+    void runTest() override
+    {
+        beginTest("Kernels pass through sample points at zero fraction");
+        {
+            const float linearWindow[] = { 0.25f, -0.5f };
+            const float cubicWindow[] = { 1.0f, 0.25f, -0.5f, 0.75f };
+
+            expectWithinAbsoluteError(Interpolation::linear(linearWindow, 0.0f), 0.25f, 1.0e-6f);
+            expectWithinAbsoluteError(Interpolation::hermite(cubicWindow, 0.0f), 0.25f, 1.0e-6f);
+        }
+
+        beginTest("Sinc reconstructs a low-frequency sine between samples");
+        {
+            constexpr int history = Interpolation::KernelTraits<InterpolationQuality::Sinc>::history;
+            const auto& table = Interpolation::SincTable::get().tableForPitchRatio(1.0);
+            float window[Interpolation::SincTable::numTaps];
+
+            for (int tap = 0; tap < Interpolation::SincTable::numTaps; ++tap)
+                window[tap] = std::sin(0.3f * static_cast<float>(tap - history));
+
+            expectWithinAbsoluteError(Interpolation::sinc(window, 0.4f, table), std::sin(0.3f * 0.4f), 1.0e-3f);
+        }
+
+        beginTest("Kernels preserve DC");
+        {
+            float window[Interpolation::SincTable::numTaps];
+            for (auto& s : window)
+                s = 0.5f;
+
+            for (float frac : { 0.0f, 0.3f, 0.5f, 0.99f })
+            {
+                expectWithinAbsoluteError(Interpolation::linear(window, frac), 0.5f, 1.0e-6f);
+                expectWithinAbsoluteError(Interpolation::hermite(window, frac), 0.5f, 1.0e-6f);
+
+                for (double ratio : { 0.5, 1.0, 1.5, 3.0 })
+                {
+                    const auto& table = Interpolation::SincTable::get().tableForPitchRatio(ratio);
+                    expectWithinAbsoluteError(Interpolation::sinc(window, frac, table), 0.5f, 1.0e-4f);
+                }
+            }
+        }
+
+        beginTest("Hermite reproduces a linear ramp");
+        {
+            const float ramp[] = { -1.0f, 0.0f, 1.0f, 2.0f };
+            expectWithinAbsoluteError(Interpolation::hermite(ramp, 0.5f), 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError(Interpolation::hermite(ramp, 0.25f), 0.25f, 1.0e-6f);
+        }
+
+        beginTest("Pitched-up voices get a lower sinc cutoff");
+        {
+            const auto& sincTable = Interpolation::SincTable::get();
+            expect(&sincTable.tableForPitchRatio(1.0) == &sincTable.tableForPitchRatio(0.5));
+            expect(&sincTable.tableForPitchRatio(2.0) != &sincTable.tableForPitchRatio(1.0));
+        }
+    }
+};
+
+static InterpolationTests interpolationTests;
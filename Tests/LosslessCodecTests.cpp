@@ -0,0 +1,116 @@
+#include <juce_core/juce_core.h>
+#include "../Source/LosslessCodec.h"
+#include <cmath>
+
+//==============================================================================
+// Lossless Codec Tests (compressed container blocks)
+//==============================================================================
+class LosslessCodecTests : public juce::UnitTest
+{
+public:
+    LosslessCodecTests() : juce::UnitTest("Lossless Codec") {}
+
+    void runTest() override
+    {
+        juce::Random random(42);
+
+        beginTest("Silence, tones, noise and full-scale extremes decode exactly");
+        {
+            expect(roundTrips(1, LosslessCodec::blockFrames, [](int, int) { return 0; }));
+
+            expect(roundTrips(2, LosslessCodec::blockFrames, [](int ch, int i)
+            {
+                return static_cast<int32_t>(std::lround(20000.0 * std::sin(0.01 * i + ch)));
+            }));
+
+            expect(roundTrips(2, LosslessCodec::blockFrames, [&random](int, int)
+            {
+                return random.nextInt(1 << 24) - (1 << 23);
+            }));
+
+            expect(roundTrips(1, 1000, [](int, int i) { return i % 2 == 0 ? 8388607 : -8388608; }));
+        }
+
+        beginTest("Short and odd-sized blocks");
+        {
+            for (int numFrames : { 1, 2, 3, 5, 255, 257, 1000 })
+                expect(roundTrips(3, numFrames, [](int ch, int i) { return (i * 37 + ch * 11) % 700 - 350; }));
+        }
+
+        beginTest("Tonal audio compresses, noise doesn't grow");
+        {
+            const auto toneBytes = encodedSize(2, [](int ch, int i)
+            {
+                return static_cast<int32_t>(std::lround(8000.0 * std::sin(0.02 * i + 0.1 * ch)));
+            });
+            expect(toneBytes < LosslessCodec::blockFrames * 2 * 2 / 2);
+
+            const auto noiseBytes = encodedSize(2, [&random](int, int) { return random.nextInt(1 << 24) - (1 << 23); });
+            expect(noiseBytes <= 1 + static_cast<size_t>(LosslessCodec::blockFrames * 2 * 3));
+        }
+
+        beginTest("Truncated or corrupt blocks are rejected");
+        {
+            std::vector<int32_t> left(LosslessCodec::blockFrames), right(LosslessCodec::blockFrames);
+            for (int i = 0; i < LosslessCodec::blockFrames; ++i)
+            {
+                left[static_cast<size_t>(i)] = (i * 13) % 900;
+                right[static_cast<size_t>(i)] = (i * 7) % 500;
+            }
+
+            const int32_t* channels[] = { left.data(), right.data() };
+            std::vector<uint8_t> encoded;
+            LosslessCodec::encodeBlock(channels, 2, LosslessCodec::blockFrames, encoded);
+
+            std::vector<int32_t> decodedLeft(LosslessCodec::blockFrames), decodedRight(LosslessCodec::blockFrames);
+            int32_t* decoded[] = { decodedLeft.data(), decodedRight.data() };
+            expect(!LosslessCodec::decodeBlock(encoded.data(), encoded.size() / 2, 2, LosslessCodec::blockFrames, decoded));
+
+            encoded[0] = 7;
+            expect(!LosslessCodec::decodeBlock(encoded.data(), encoded.size(), 2, LosslessCodec::blockFrames, decoded));
+        }
+    }
+
+private:
+    template <typename Value>
+    bool roundTrips(int numChannels, int numFrames, Value value)
+    {
+        std::vector<std::vector<int32_t>> source(static_cast<size_t>(numChannels), std::vector<int32_t>(static_cast<size_t>(numFrames)));
+        std::vector<std::vector<int32_t>> decoded = source;
+        std::vector<const int32_t*> sourceChannels;
+        std::vector<int32_t*> decodedChannels;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < numFrames; ++i)
+                source[static_cast<size_t>(ch)][static_cast<size_t>(i)] = value(ch, i);
+            sourceChannels.push_back(source[static_cast<size_t>(ch)].data());
+            decodedChannels.push_back(decoded[static_cast<size_t>(ch)].data());
+        }
+
+        std::vector<uint8_t> encoded;
+        LosslessCodec::encodeBlock(sourceChannels.data(), numChannels, numFrames, encoded);
+
+        return LosslessCodec::decodeBlock(encoded.data(), encoded.size(), numChannels, numFrames, decodedChannels.data())
+            && decoded == source;
+    }
+
+    template <typename Value>
+    size_t encodedSize(int numChannels, Value value)
+    {
+        std::vector<std::vector<int32_t>> source(static_cast<size_t>(numChannels), std::vector<int32_t>(LosslessCodec::blockFrames));
+        std::vector<const int32_t*> channels;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            for (int i = 0; i < LosslessCodec::blockFrames; ++i)
+                source[static_cast<size_t>(ch)][static_cast<size_t>(i)] = value(ch, i);
+            channels.push_back(source[static_cast<size_t>(ch)].data());
+        }
+
+        std::vector<uint8_t> encoded;
+        LosslessCodec::encodeBlock(channels.data(), numChannels, LosslessCodec::blockFrames, encoded);
+        return encoded.size();
+    }
+};
+
+static LosslessCodecTests losslessCodecTests;
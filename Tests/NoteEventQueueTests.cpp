@@ -0,0 +1,66 @@
+#include <juce_core/juce_core.h>
+#include "../Source/NoteEventQueue.h"
+
+//==============================================================================
+// Note Event Queue Tests
+//==============================================================================
+class NoteEventQueueTests : public juce::UnitTest
+{
+public:
+    NoteEventQueueTests() : juce::UnitTest("NoteEventQueue") {}
+
+    void runTest() override
+    {
+        auto makeEvent = [](int position, NoteEventQueue::Type type, int note)
+        {
+            NoteEventQueue::Event event;
+            event.samplePosition = position;
+            event.type = type;
+            event.midiNote = note;
+            return event;
+        };
+
+        beginTest("Events come out in sample order");
+        {
+            NoteEventQueue queue;
+            queue.push(makeEvent(300, NoteEventQueue::Type::NoteOn, 60));
+            queue.push(makeEvent(10, NoteEventQueue::Type::NoteOn, 62));
+            queue.push(makeEvent(128, NoteEventQueue::Type::NoteOff, 64));
+
+            int lastPosition = -1;
+            for (const auto& event : queue)
+            {
+                expect(event.samplePosition >= lastPosition);
+                lastPosition = event.samplePosition;
+            }
+            expectEquals(queue.size(), 3);
+        }
+
+        beginTest("Events at the same position keep arrival order");
+        {
+            NoteEventQueue queue;
+            queue.push(makeEvent(64, NoteEventQueue::Type::NoteOff, 60));
+            queue.push(makeEvent(64, NoteEventQueue::Type::NoteOn, 60));
+            queue.push(makeEvent(0, NoteEventQueue::Type::NoteOn, 48));
+
+            const auto* event = queue.begin();
+            expectEquals(event[0].midiNote, 48);
+            expect(event[1].type == NoteEventQueue::Type::NoteOff);
+            expect(event[2].type == NoteEventQueue::Type::NoteOn);
+        }
+
+        beginTest("Push fails when full and clear empties the queue");
+        {
+            NoteEventQueue queue;
+            for (int i = 0; i < NoteEventQueue::capacity; ++i)
+                expect(queue.push(makeEvent(i, NoteEventQueue::Type::NoteOn, 60)));
+
+            expect(!queue.push(makeEvent(0, NoteEventQueue::Type::NoteOn, 60)));
+
+            queue.clear();
+            expect(queue.isEmpty());
+        }
+    }
+};
+
+static NoteEventQueueTests noteEventQueueTests;
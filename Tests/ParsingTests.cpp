@@ -203,11 +203,46 @@ public:
     }
 };
 
+//==============================================================================
+// Learned Sample Set Tests (learn & purge state)
+//==============================================================================
+class LearnedSampleParsingTests : public juce::UnitTest
+{
+public:
+    LearnedSampleParsingTests() : juce::UnitTest("Learned Sample Parsing") {}
+
+    void runTest() override
+    {
+        beginTest("Round trip");
+        {
+            const std::set<SamplerEngine::SampleKey> keys { { 60, 100, 1 }, { 62, 80, 2 }, { 0, 1, 1 } };
+            const auto text = SamplerEngine::formatSampleKeys(keys);
+            expectEquals(text, juce::String("0/1/1 60/100/1 62/80/2"));
+            expect(SamplerEngine::parseSampleKeys(text) == keys);
+        }
+
+        beginTest("Empty set");
+        {
+            expectEquals(SamplerEngine::formatSampleKeys({}), juce::String());
+            expect(SamplerEngine::parseSampleKeys("").empty());
+        }
+
+        beginTest("Malformed and out-of-range entries are skipped");
+        {
+            const auto keys = SamplerEngine::parseSampleKeys("60/100/1 x/100/1 61/100 62//1 128/100/1 63/0/1 64/128/1 65/90/0  66/90/2");
+            expectEquals(static_cast<int>(keys.size()), 2);
+            expect(keys.count({ 60, 100, 1 }) == 1);
+            expect(keys.count({ 66, 90, 2 }) == 1);
+        }
+    }
+};
+
 //==============================================================================
 // Static test instances (auto-registered with JUCE)
 //==============================================================================
 static NoteNameParsingTests noteNameParsingTests;
 static FileNameParsingTests fileNameParsingTests;
+static LearnedSampleParsingTests learnedSampleParsingTests;
 
 //==============================================================================
 // Main test runner
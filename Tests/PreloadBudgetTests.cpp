@@ -0,0 +1,99 @@
+#include <juce_core/juce_core.h>
+#include <vector>
+#include "../Source/PreloadBudget.h"
+
+//==============================================================================
+// Preload Budget Tests
+//==============================================================================
+class PreloadBudgetTests : public juce::UnitTest
+{
+public:
+    PreloadBudgetTests() : juce::UnitTest("Preload Budget") {}
+
+    void runTest() override
+    {
+        constexpr int64_t kb = 1024;
+        constexpr int64_t mb = 1024 * 1024;
+
+        beginTest("Everything fits: the limit is the largest sample");
+        {
+            expectEquals(PreloadBudget::computePreloadLimit({ 100 * kb, 300 * kb, 200 * kb }, 1 * mb), 300 * kb);
+        }
+
+        beginTest("Water-fill: small samples whole, large ones share the rest");
+        {
+            // 1 MB: 100 KB whole, then 924 KB over three samples = 308 KB each
+            const auto limit = PreloadBudget::computePreloadLimit({ 100 * kb, 2 * mb, 3 * mb, 4 * mb }, 1 * mb);
+            expectEquals(limit, (1 * mb - 100 * kb) / 3);
+
+            int64_t used = 0;
+            for (auto size : { 100 * kb, 2 * mb, 3 * mb, 4 * mb })
+                used += std::min(size, limit);
+            expect(used <= 1 * mb);
+        }
+
+        beginTest("Never below the minimum preload");
+        {
+            expectEquals(PreloadBudget::computePreloadLimit(std::vector<int64_t>(1000, 10 * mb), 1 * mb),
+                         PreloadBudget::minimumPreloadBytes);
+        }
+
+        beginTest("Weighted demand: heavier samples get proportionally longer preloads");
+        {
+            std::vector<PreloadBudget::Demand> demand(3);
+            demand[0] = { 1, 10 * mb, 2.0f };
+            demand[1] = { 2, 10 * mb, 1.0f };
+            demand[2] = { 3, 256 * kb, 0.25f };   // Whole at a 1 MB limit (its cap would be 256 KB)
+
+            // 3.25 MB: the small sample whole, the remaining 3 MB split 2:1
+            const auto limit = PreloadBudget::computePreloadLimit(demand, 3 * mb + 256 * kb);
+            expectEquals(limit, 1 * mb);
+        }
+
+        beginTest("Quantised limits step down in eighth octaves");
+        {
+            expectEquals(PreloadBudget::quantiseLimit(10), PreloadBudget::minimumPreloadBytes);
+            expectEquals(PreloadBudget::quantiseLimit(64 * kb), 64 * kb);
+
+            const auto quantised = PreloadBudget::quantiseLimit(100 * kb);
+            expect(quantised <= 100 * kb);
+            expect(quantised > 100 * kb * 9 / 10);
+            expectEquals(PreloadBudget::quantiseLimit(quantised + 1), quantised);
+        }
+
+        beginTest("Instances sharing a library count its preloads once");
+        {
+            PreloadBudget budget;
+            const auto first = budget.registerClient({});
+            const auto second = budget.registerClient({});
+
+            std::vector<PreloadBudget::Demand> demand;
+            for (uint64_t key = 1; key <= 4; ++key)
+                demand.push_back({ key, 1 * mb });
+
+            budget.setBudgetBytes(4 * mb);
+            budget.setDemand(first, demand);
+            expect(budget.isFullyResident());
+
+            budget.setDemand(second, demand);
+            expect(budget.isFullyResident());
+            expectEquals(budget.getPreloadLimitBytes(), 1 * mb);
+
+            // A different library doesn't fit alongside
+            for (auto& sample : demand)
+                sample.key += 100;
+            budget.setDemand(second, demand);
+            expect(!budget.isFullyResident());
+            expect(budget.getPreloadLimitBytes() <= 512 * kb);
+
+            budget.unregisterClient(second);
+            expect(budget.isFullyResident());
+
+            budget.setBudgetBytes(0);
+            expectEquals(budget.getPreloadLimitBytes(), int64_t(0));
+            budget.unregisterClient(first);
+        }
+    }
+};
+
+static PreloadBudgetTests preloadBudgetTests;
@@ -0,0 +1,81 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "../Source/PreloadPack.h"
+
+//==============================================================================
+// Preload Pack Tests (hibernation backing store)
+//==============================================================================
+class PreloadPackTests : public juce::UnitTest
+{
+public:
+    PreloadPackTests() : juce::UnitTest("Preload Pack") {}
+
+    void runTest() override
+    {
+        const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                   .getChildFile("HammerSamplerPreloadPackTests");
+        directory.deleteRecursively();
+
+        // Odd lengths so the channels need padding
+        juce::AudioBuffer<float> stereo(2, 1001);
+        juce::AudioBuffer<float> mono(1, 7);
+        for (int ch = 0; ch < stereo.getNumChannels(); ++ch)
+            for (int i = 0; i < stereo.getNumSamples(); ++i)
+                stereo.setSample(ch, i, static_cast<float>(ch * 10000 + i));
+        for (int i = 0; i < mono.getNumSamples(); ++i)
+            mono.setSample(0, i, static_cast<float>(-i));
+
+        beginTest("Packed preloads read back what was written");
+        {
+            auto packed = PreloadPack::create(directory, { &stereo, &mono });
+            expectEquals(static_cast<int>(packed.size()), 2);
+
+            expectEquals(packed[0]->getNumChannels(), 2);
+            expectEquals(packed[0]->getNumSamples(), 1001);
+            expectEquals(packed[0]->getSample(0, 1000), 1000.0f);
+            expectEquals(packed[0]->getSample(1, 0), 10000.0f);
+
+            expectEquals(packed[1]->getNumChannels(), 1);
+            expectEquals(packed[1]->getSample(0, 6), -6.0f);
+
+            // Channels start 16-byte aligned
+            const auto address = reinterpret_cast<uintptr_t>(packed[0]->getReadPointer(1));
+            expectEquals(static_cast<int>(address % 16), 0);
+        }
+
+        beginTest("The file goes with the last preload");
+        {
+            auto packed = PreloadPack::create(directory, { &stereo, &mono });
+            expectEquals(directory.getNumberOfChildFiles(juce::File::findFiles), 1);
+
+            auto kept = packed[1];
+            packed.clear();
+            expectEquals(directory.getNumberOfChildFiles(juce::File::findFiles), 1);
+            expectEquals(kept->getSample(0, 3), -3.0f);
+
+            kept.reset();
+            expectEquals(directory.getNumberOfChildFiles(juce::File::findFiles), 0);
+        }
+
+        beginTest("Prefaulting leaves the preloads as they were");
+        {
+            auto packed = PreloadPack::create(directory, { &stereo, &mono });
+            for (const auto& preload : packed)
+                PreloadPack::prefault(*preload);
+
+            expectEquals(packed[0]->getSample(1, 1000), 11000.0f);
+            expectEquals(packed[1]->getSample(0, 6), -6.0f);
+        }
+
+        beginTest("Nothing to pack gives nothing");
+        {
+            juce::AudioBuffer<float> empty;
+            expect(PreloadPack::create(directory, {}).empty());
+            expect(PreloadPack::create(directory, { &empty }).empty());
+        }
+
+        directory.deleteRecursively();
+    }
+};
+
+static PreloadPackTests preloadPackTests;
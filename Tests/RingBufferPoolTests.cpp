@@ -0,0 +1,176 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include "../Source/StreamingVoice.h"
+
+//==============================================================================
+// Ring Buffer Pool Tests (slab hand-out, parking and reuse by streaming voices)
+//==============================================================================
+class RingBufferPoolTests : public juce::UnitTest
+{
+public:
+    RingBufferPoolTests() : juce::UnitTest("Ring Buffer Pool") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+
+        beginTest("Slabs are handed out once and come back on release");
+        {
+            RingBufferPool pool;
+            pool.setMinimumReserve(2);
+            pool.maintain();
+            expectEquals(pool.getAllocatedBytes(), 2 * RingBufferPool::slabBytes);
+
+            const int first = pool.acquire();
+            const int second = pool.acquire();
+            expect(first != RingBufferPool::invalidSlab && second != RingBufferPool::invalidSlab);
+            expect(first != second);
+            expect(pool.getSlabData(first) != pool.getSlabData(second));
+
+            expectEquals(pool.acquire(), RingBufferPool::invalidSlab);
+            expectEquals(pool.getStarvationCount(), 1);
+
+            pool.release(first);
+            expectEquals(pool.acquire(), first);
+        }
+
+        // A stereo sample that streams, so every note needs two slabs
+        PreloadedSample sample;
+        sample.filePath = "ring.wav";
+        sample.totalSampleFrames = 100000;
+        sample.preloadSizeFrames = 1000;
+        sample.sampleRate = sampleRate;
+        sample.numChannels = 2;
+        sample.rootNote = 60;
+        sample.preloadBuffer.setSize(2, 1000);
+        sample.preloadBuffer.clear();
+
+        // Room for exactly one stereo voice
+        RingBufferPool pool;
+        pool.setMinimumReserve(2);
+        pool.maintain();
+
+        auto makeVoice = [&pool]
+        {
+            auto voice = std::make_unique<StreamingVoice>();
+            voice->setRingBufferPool(&pool);
+            voice->prepareToPlay(sampleRate, 512);
+            voice->setADSRParameters({ 0.001f, 0.1f, 1.0f, 0.3f });
+            return voice;
+        };
+
+        auto ringOf = [](StreamingVoice& voice)
+        {
+            StreamingVoice::RingLease lease;
+            if (voice.beginRingLease(voice.getRingGeneration(), lease))
+                voice.endRingLease();
+            return lease.channels;
+        };
+
+        auto first = makeVoice();
+        auto second = makeVoice();
+
+        beginTest("A restarted voice takes back its own parked slabs");
+        {
+            first->startVoice(&sample, 60, 1.0f, sampleRate);
+            expect(first->isActive());
+            const auto ring = ringOf(*first);
+            expect(ring[0] != nullptr && ring[1] != nullptr);
+
+            first->reset();
+            first->startVoice(&sample, 62, 1.0f, sampleRate);
+            expect(first->isActive());
+            expect(ringOf(*first) == ring);
+            expectEquals(pool.getStarvationCount(), 0);
+
+            // The pool had nothing else to give, so another voice can't start meanwhile
+            second->startVoice(&sample, 64, 1.0f, sampleRate);
+            expect(!second->isActive());
+            first->reset();
+        }
+
+        beginTest("Released parked slabs are reused by another voice");
+        {
+            const auto ring = ringOf(*first);
+            first->releaseParkedRing();
+
+            second->startVoice(&sample, 64, 1.0f, sampleRate);
+            expect(second->isActive());
+            expect(ringOf(*second) == ring);
+
+            second->reset();
+            second->releaseParkedRing();
+        }
+
+        beginTest("A disk read's lease keeps the ring until it ends");
+        {
+            first->startVoice(&sample, 60, 1.0f, sampleRate);
+            const uint32_t generation = first->getRingGeneration();
+
+            StreamingVoice::RingLease lease;
+            expect(first->beginRingLease(generation, lease));
+            expect(first->isRingLeased());
+            expect(lease.sample == &sample);
+
+            expect(first->getSamplesInUse()[0] == &sample);
+
+            // The audio thread retires the note mid-read: the read sees it, the ring stays put
+            first->reset();
+            expect(!first->isRingLeaseCurrent(lease));
+            first->startVoice(&sample, 62, 1.0f, sampleRate);
+            expect(!first->isActive());
+
+            // The sample can't be freed while the read still uses it
+            expect(first->getSamplesInUse()[0] == nullptr);
+            expect(first->getSamplesInUse()[1] == &sample);
+
+            first->endRingLease();
+            expect(first->getSamplesInUse()[1] == nullptr);
+            expect(!first->beginRingLease(generation, lease));
+
+            first->startVoice(&sample, 62, 1.0f, sampleRate);
+            expect(first->isActive());
+            expect(ringOf(*first) == lease.channels);
+            first->reset();
+        }
+
+        beginTest("An underrun never reads what an earlier note left in the slab");
+        {
+            for (auto quality : { InterpolationQuality::Linear, InterpolationQuality::Sinc })
+            {
+                for (int note : { 60, 61 })
+                {
+                    first->setInterpolationQuality(quality);
+                    first->startVoice(&sample, note, 1.0f, sampleRate);
+                    expect(first->isActive());
+
+                    // Stale data past the preload, and no disk thread to overwrite it
+                    const auto ring = ringOf(*first);
+                    for (auto* channel : ring)
+                        std::fill(channel + sample.preloadSizeFrames, channel + StreamingConstants::ringBufferFrames,
+                                  std::numeric_limits<float>::quiet_NaN());
+
+                    juce::AudioBuffer<float> output(2, 512);
+                    bool finite = true;
+                    for (int block = 0; block < 4 && first->isActive(); ++block)
+                    {
+                        output.clear();
+                        first->renderNextBlock(output, 0, output.getNumSamples());
+                        for (int ch = 0; ch < 2; ++ch)
+                            for (int i = 0; i < output.getNumSamples(); ++i)
+                                finite = finite && std::isfinite(output.getSample(ch, i));
+                    }
+
+                    expect(finite);
+                    expect(!first->isActive());
+                    first->reset();
+                }
+            }
+        }
+    }
+};
+
+static RingBufferPoolTests ringBufferPoolTests;
@@ -0,0 +1,137 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/SampleAnalysis.h"
+#include "TestAudioFiles.h"
+#include <cmath>
+
+//==============================================================================
+// Sample Analysis Tests (audible start and effective end of samples)
+//==============================================================================
+class SampleAnalysisTests : public juce::UnitTest
+{
+public:
+    SampleAnalysisTests() : juce::UnitTest("Sample Analysis") {}
+
+    void runTest() override
+    {
+        const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                .getChildFile("HammerSamplerAnalysisTests");
+        folder.deleteRecursively();
+        folder.createDirectory();
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        constexpr double sampleRate = 48000.0;
+        constexpr int numFrames = 48000 * 4;
+        constexpr int onset = 14400;    // 300 ms of pre-roll
+
+        // A note that decays 6 dB per ~115 ms after the pre-roll; it reaches -80 dB after about 1.5 s
+        auto note = [](int frame, double decayPerSecond)
+        {
+            if (frame < onset)
+                return 0.0;
+            const double t = (frame - onset) / sampleRate;
+            return 0.5 * std::exp(-decayPerSecond * t) * std::sin(juce::MathConstants<double>::twoPi * 220.0 * t);
+        };
+
+        beginTest("Pre-roll and a decayed tail are trimmed, the attack is kept");
+        {
+            const auto file = folder.getChildFile("C4_100_1.wav");
+            writeWav(file, numFrames, [&note](int frame) { return note(frame, 6.0); });
+
+            SampleAnalysis::Result result;
+            expect(SampleAnalysis::analyse(formatManager, file.getFullPathName(), result));
+            expect(result.startFrame <= onset);
+            expect(result.startFrame > onset - 1024);
+
+            const double endSeconds = result.endFrame / sampleRate;
+            expect(endSeconds > 1.6 && endSeconds < 2.0, "end at " + juce::String(endSeconds) + " s");
+        }
+
+        beginTest("The level envelope holds the loudest level still to come");
+        {
+            SampleAnalysis::Result result;
+            expect(SampleAnalysis::analyse(formatManager, folder.getChildFile("C4_100_1.wav").getFullPathName(), result));
+            expectEquals(static_cast<int>(result.levels.size()), (numFrames + SampleAnalysis::levelBlockFrames - 1) / SampleAnalysis::levelBlockFrames);
+
+            bool nonIncreasing = true;
+            for (size_t i = 1; i < result.levels.size(); ++i)
+                nonIncreasing = nonIncreasing && result.levels[i] <= result.levels[i - 1];
+            expect(nonIncreasing);
+
+            // The RMS of the attack (both channels), over the pre-roll too; inaudible after the decay
+            expectWithinAbsoluteError(result.levels.front(), 0.27f, 0.04f);
+            const auto afterDecay = static_cast<size_t>(3.0 * sampleRate / SampleAnalysis::levelBlockFrames);
+            expect(result.levels[afterDecay] < juce::Decibels::decibelsToGain(-90.0f));
+        }
+
+        beginTest("A tail ends where it meets the recording's noise floor");
+        {
+            juce::Random random(3);
+            const auto file = folder.getChildFile("D4_100_1.wav");
+            writeWav(file, numFrames, [&note, &random](int frame)
+            {
+                return note(frame, 6.0) + 2.0e-3 * (random.nextFloat() - 0.5f);   // About -60 dB below the peak
+            });
+
+            SampleAnalysis::Result result;
+            expect(SampleAnalysis::analyse(formatManager, file.getFullPathName(), result));
+            const double endSeconds = result.endFrame / sampleRate;
+            expect(endSeconds > 1.0 && endSeconds < 1.6, "end at " + juce::String(endSeconds) + " s");
+        }
+
+        beginTest("Silent samples and samples that never decay are left whole");
+        {
+            const auto silent = folder.getChildFile("E4_100_1.wav");
+            writeWav(silent, numFrames, [](int) { return 0.0; });
+
+            SampleAnalysis::Result result;
+            expect(SampleAnalysis::analyse(formatManager, silent.getFullPathName(), result));
+            expectEquals(result.startFrame, int64_t(0));
+            expectEquals(result.endFrame, int64_t(numFrames));
+
+            const auto held = folder.getChildFile("F4_100_1.wav");
+            writeWav(held, numFrames, [&note](int frame) { return note(frame, 0.0); });
+            expect(SampleAnalysis::analyse(formatManager, held.getFullPathName(), result));
+            expect(result.startFrame <= onset);
+            expectEquals(result.endFrame, int64_t(numFrames));
+
+            expect(!SampleAnalysis::analyse(formatManager, folder.getChildFile("missing.wav").getFullPathName(), result));
+        }
+
+        beginTest("The index keeps results per sample and merges additions");
+        {
+            const auto libraryPath = folder.getChildFile("Library").getFullPathName();
+            expect(SampleAnalysis::addToIndex(libraryPath, { { 1, { 10, 20, {} } }, { 2, { 0, 5, {} } } }));
+            expect(SampleAnalysis::addToIndex(libraryPath, { { 2, { 1, 6, {} } }, { 3, { 0, 9, { 0.5f, 0.25f } } } }));
+
+            auto index = SampleAnalysis::loadIndex(libraryPath);
+            expectEquals(static_cast<int>(index.size()), 3);
+            expectEquals(index[1].startFrame, int64_t(10));
+            expectEquals(index[2].startFrame, int64_t(1));
+            expectEquals(index[3].endFrame, int64_t(9));
+            expect(index[3].levels == std::vector<float>({ 0.5f, 0.25f }));
+            expect(index[1].levels.empty());
+
+            expect(SampleAnalysis::loadIndex(folder.getChildFile("Other").getFullPathName()).empty());
+            SampleAnalysis::getDefaultDirectory().getChildFile(juce::String::toHexString(libraryPath.hashCode64()) + ".idx").deleteFile();
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    template <typename Value>
+    void writeWav(const juce::File& file, int numFrames, Value value)
+    {
+        // The right channel at half the level
+        const auto buffer = TestAudioFiles::makeBuffer(2, numFrames, [&value](int channel, int frame)
+        {
+            return value(frame) * (channel == 0 ? 1.0 : 0.5);
+        });
+        expect(TestAudioFiles::writeWav(file, buffer, 48000.0, 32));
+    }
+};
+
+static SampleAnalysisTests sampleAnalysisTests;
@@ -0,0 +1,151 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/SampleContainer.h"
+#include "TestAudioFiles.h"
+
+//==============================================================================
+// Sample Container Tests (packed single-file libraries)
+//==============================================================================
+class SampleContainerTests : public juce::UnitTest
+{
+public:
+    SampleContainerTests() : juce::UnitTest("Sample Container") {}
+
+    void runTest() override
+    {
+        const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                .getChildFile("HammerSamplerContainerTests");
+        folder.deleteRecursively();
+        folder.createDirectory();
+
+        // Values on the 16-bit grid survive every format exactly
+        auto value = [](int channel, int frame) { return static_cast<float>((frame % 2000) - 1000 + channel * 7) / 32768.0f; };
+
+        expect(TestAudioFiles::writeWav(folder.getChildFile("C4_100_1.wav"), TestAudioFiles::makeBuffer(2, 5000, value), 44100.0, 16));
+        expect(TestAudioFiles::writeWav(folder.getChildFile("C4_100_2.wav"), TestAudioFiles::makeBuffer(1, 300, value), 44100.0, 24));
+        expect(TestAudioFiles::writeWav(folder.getChildFile("D4_80_1.wav"), TestAudioFiles::makeBuffer(2, 3000, value), 44100.0, 32));
+
+        // Small heads, so reads cross from the head region into the tail region
+        const auto containerFile = folder.getChildFile("Test.hspack");
+        const auto result = SampleContainer::pack(folder, containerFile, 4096);
+        expect(result.wasOk(), result.getErrorMessage());
+
+        const auto pcmFile = folder.getChildFile("Pcm").getChildFile("Test.hspack");
+        pcmFile.getParentDirectory().createDirectory();
+        const auto pcmResult = SampleContainer::pack(folder, pcmFile, 4096, false);
+        expect(pcmResult.wasOk(), pcmResult.getErrorMessage());
+
+        auto container = SampleContainer::open(containerFile);
+        auto pcmContainer = SampleContainer::open(pcmFile);
+        expect(container != nullptr && pcmContainer != nullptr);
+        if (container == nullptr || pcmContainer == nullptr)
+            return;
+
+        const auto& entries = container->getEntries();
+
+        beginTest("Index lists the samples in playback-likely order");
+        {
+            expectEquals(static_cast<int>(entries.size()), 3);
+            expectEquals(entries[0].name, juce::String("C4_100_1"));
+            expectEquals(entries[1].name, juce::String("D4_80_1"));
+            expectEquals(entries[2].name, juce::String("C4_100_2"));
+
+            expectEquals(entries[0].bitsPerSample, 16);
+            expectEquals(entries[1].bitsPerSample, 32);
+            expect(entries[1].isFloat);
+            expectEquals(entries[2].bitsPerSample, 24);
+        }
+
+        beginTest("Integer audio is compressed in whole blocks, float audio stays PCM");
+        {
+            expect(entries[0].compressed);
+            expect(!entries[1].compressed);
+            expect(entries[2].compressed);
+            expectEquals(entries[0].headFrames, int64_t(LosslessCodec::blockFrames));
+            expectEquals(entries[2].headFrames, int64_t(300));
+
+            const auto& pcmEntries = pcmContainer->getEntries();
+            expect(!pcmEntries[0].compressed && !pcmEntries[2].compressed);
+            expectEquals(pcmEntries[0].headFrames, int64_t(1024));
+
+            expect(containerFile.getSize() < pcmFile.getSize());
+        }
+
+        beginTest("Heads first, every region aligned");
+        {
+            for (const auto& entry : entries)
+            {
+                expectEquals(static_cast<int>(entry.headOffset % SampleContainer::alignment), 0);
+                expectEquals(static_cast<int>(entry.tailOffset % SampleContainer::alignment), 0);
+                expect(entry.headOffset < entries[0].tailOffset);
+            }
+        }
+
+        beginTest("Readers return the source audio, across the head and tail");
+        {
+            for (auto* packed : { container.get(), pcmContainer.get() })
+            {
+                for (int i = 0; i < static_cast<int>(entries.size()); ++i)
+                {
+                    auto reader = packed->createReader(i);
+                    const auto& entry = packed->getEntries()[static_cast<size_t>(i)];
+                    expectEquals(static_cast<int64_t>(reader->lengthInSamples), entry.totalFrames);
+
+                    const int numFrames = static_cast<int>(entry.totalFrames);
+                    juce::AudioBuffer<float> buffer(entry.numChannels, numFrames);
+                    expect(reader->read(&buffer, 0, numFrames, 0, true, true));
+
+                    int mismatches = 0;
+                    for (int ch = 0; ch < entry.numChannels; ++ch)
+                        for (int frame = 0; frame < numFrames; ++frame)
+                            mismatches += buffer.getSample(ch, frame) != value(ch, frame) ? 1 : 0;
+                    expectEquals(mismatches, 0);
+                }
+
+                // Reads starting in the head and ending in the tail (PCM heads end at 1024, compressed at 4096)
+                auto reader = packed->createReader(0);
+                juce::AudioBuffer<float> buffer(2, 200);
+                for (int start : { 1000, 4000 })
+                {
+                    expect(reader->read(&buffer, 0, 200, start, true, true));
+                    expectEquals(buffer.getSample(1, 0), value(1, start));
+                    expectEquals(buffer.getSample(1, 199), value(1, start + 199));
+                }
+            }
+        }
+
+        beginTest("Entry paths name samples inside a container");
+        {
+            const auto entryPath = SampleContainer::getEntryPath(containerFile, 2);
+            juce::String containerPath;
+            int entryIndex = -1;
+            expect(SampleContainer::parseEntryPath(entryPath, containerPath, entryIndex));
+            expectEquals(containerPath, containerFile.getFullPathName());
+            expectEquals(entryIndex, 2);
+
+            expect(!SampleContainer::parseEntryPath(folder.getChildFile("C4_100_1.wav").getFullPathName(), containerPath, entryIndex));
+            expect(!SampleContainer::parseEntryPath(folder.getChildFile("Take #2.wav").getFullPathName(), containerPath, entryIndex));
+
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+            auto reader = SampleContainer::createReaderFor(formatManager, entryPath);
+            expect(reader != nullptr);
+            expectEquals(static_cast<int64_t>(reader->lengthInSamples), int64_t(300));
+
+            // One container object (and descriptor) however often it is opened
+            expect(SampleContainer::open(containerFile) == container);
+            expect(SampleContainer::findInFolder(folder) == containerFile);
+        }
+
+        beginTest("Other files aren't containers");
+        {
+            expect(SampleContainer::open(folder.getChildFile("C4_100_1.wav")) == nullptr);
+        }
+
+        container.reset();
+        pcmContainer.reset();
+        folder.deleteRecursively();
+    }
+};
+
+static SampleContainerTests sampleContainerTests;
@@ -0,0 +1,79 @@
+#include <juce_core/juce_core.h>
+#include "../Source/SharedPreloadStore.h"
+
+//==============================================================================
+// Shared Preload Store Tests
+//==============================================================================
+class SharedPreloadStoreTests : public juce::UnitTest
+{
+public:
+    SharedPreloadStoreTests() : juce::UnitTest("SharedPreloadStore") {}
+
+    void runTest() override
+    {
+        if (!SharedPreloadStore::isSupported())
+            return;
+
+        const int numFrames = 1000;
+        int loads = 0;
+
+        auto loader = [&loads](juce::AudioBuffer<float>& buffer)
+        {
+            ++loads;
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                for (int i = 0; i < buffer.getNumSamples(); ++i)
+                    buffer.setSample(ch, i, static_cast<float>(ch * 10000 + i));
+            return true;
+        };
+
+        // Random key so leftovers of an aborted run can't interfere
+        const auto key = static_cast<uint64_t>(juce::Random::getSystemRandom().nextInt64());
+
+        beginTest("First acquire decodes, second maps the same data");
+        {
+            auto first = SharedPreloadStore::acquire(key, 2, numFrames, loader);
+            expect(first != nullptr);
+            expectEquals(loads, 1);
+
+            auto second = SharedPreloadStore::acquire(key, 2, numFrames, loader);
+            expect(second != nullptr);
+            expectEquals(loads, 1);
+
+            expectEquals(second->getNumChannels(), 2);
+            expectEquals(second->getNumSamples(), numFrames);
+            expectEquals(second->getSample(0, 123), 123.0f);
+            expectEquals(second->getSample(1, 999), 10999.0f);
+            expectEquals(SharedPreloadStore::getAttachedProcessCount(key), 2);
+        }
+
+        beginTest("Segment is removed when the last user releases it");
+        {
+            expectEquals(SharedPreloadStore::getAttachedProcessCount(key), 0);
+
+            auto again = SharedPreloadStore::acquire(key, 2, numFrames, loader);
+            expect(again != nullptr);
+            expectEquals(loads, 2);
+        }
+
+        beginTest("Mismatched layout and loader failure fall back to nullptr");
+        {
+            auto held = SharedPreloadStore::acquire(key, 2, numFrames, loader);
+            expect(SharedPreloadStore::acquire(key, 1, numFrames, loader) == nullptr);
+
+            const auto failingKey = key ^ 0x5a5a5a5aull;
+            expect(SharedPreloadStore::acquire(failingKey, 1, numFrames,
+                                               [](juce::AudioBuffer<float>&) { return false; }) == nullptr);
+            expectEquals(SharedPreloadStore::getAttachedProcessCount(failingKey), 0);
+        }
+
+        beginTest("Hash is stable");
+        {
+            expect(SharedPreloadStore::hash(juce::String("C4_v100_rr1.wav"))
+                   == SharedPreloadStore::hash(juce::String("C4_v100_rr1.wav")));
+            expect(SharedPreloadStore::hash(juce::String("a")) != SharedPreloadStore::hash(juce::String("b")));
+            expect(SharedPreloadStore::getSegmentName(key).length() <= 30);
+        }
+    }
+};
+
+static SharedPreloadStoreTests sharedPreloadStoreTests;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <memory>
+
+//==============================================================================
+// Sample files for the tests that read them back (container, FLAC index, caches, analysis)
+//==============================================================================
+namespace TestAudioFiles
+{
+    /** A buffer of numChannels x numFrames holding value(channel, frame) */
+    template <typename Value>
+    juce::AudioBuffer<float> makeBuffer(int numChannels, int numFrames, Value value)
+    {
+        juce::AudioBuffer<float> buffer(numChannels, numFrames);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int frame = 0; frame < numFrames; ++frame)
+                buffer.setSample(ch, frame, static_cast<float>(value(ch, frame)));
+        return buffer;
+    }
+
+    /** Write the buffer to file (replacing it) in a format; false if no writer could be made */
+    inline bool write(juce::AudioFormat& format, const juce::File& file, const juce::AudioBuffer<float>& buffer,
+                      double sampleRate, int bitsPerSample, int qualityOptionIndex = 0)
+    {
+        file.deleteFile();
+        std::unique_ptr<juce::AudioFormatWriter> writer(
+            format.createWriterFor(new juce::FileOutputStream(file), sampleRate,
+                                   static_cast<unsigned int>(buffer.getNumChannels()), bitsPerSample, {}, qualityOptionIndex));
+        return writer != nullptr && writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    inline bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate, int bitsPerSample)
+    {
+        juce::WavAudioFormat wav;
+        return write(wav, file, buffer, sampleRate, bitsPerSample);
+    }
+}
@@ -0,0 +1,118 @@
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "../Source/TranscodeCache.h"
+#include "TestAudioFiles.h"
+
+//==============================================================================
+// Transcode Cache Tests (decoded copies of MP3 samples)
+//==============================================================================
+class TranscodeCacheTests : public juce::UnitTest
+{
+public:
+    TranscodeCacheTests() : juce::UnitTest("Transcode Cache") {}
+
+    void runTest() override
+    {
+        const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                .getChildFile("HammerSamplerTranscodeTests");
+        folder.deleteRecursively();
+        folder.createDirectory();
+        const auto cacheFolder = folder.getChildFile("Cache");
+
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        beginTest("Only lossy formats are transcoded");
+        {
+            expect(TranscodeCache::needsTranscode(juce::File("/samples/C4_100_1.mp3")));
+            expect(!TranscodeCache::needsTranscode(juce::File("/samples/C4_100_1.wav")));
+            expect(!TranscodeCache::needsTranscode(juce::File("/samples/C4_100_1.flac")));
+        }
+
+        beginTest("A copy holds exactly what the source decodes to");
+        {
+            // Any readable source transcodes; a WAV stands in for an MP3 here
+            const auto source = folder.getChildFile("C4_100_1.wav");
+            writeWav(source, 2, 24, 150000);
+
+            const auto copy = TranscodeCache::getCopyFile(cacheFolder, source);
+            expect(TranscodeCache::transcode(formatManager, source, copy));
+            expect(copy.existsAsFile());
+
+            std::unique_ptr<juce::AudioFormatReader> original(formatManager.createReaderFor(source));
+            std::unique_ptr<juce::AudioFormatReader> transcoded(formatManager.createReaderFor(copy));
+            expect(transcoded != nullptr && transcoded->usesFloatingPointData);
+            expectEquals(transcoded->lengthInSamples, original->lengthInSamples);
+            expectEquals(transcoded->sampleRate, original->sampleRate);
+
+            const int numFrames = static_cast<int>(original->lengthInSamples);
+            juce::AudioBuffer<float> expected(2, numFrames), actual(2, numFrames);
+            original->read(&expected, 0, numFrames, 0, true, true);
+            transcoded->read(&actual, 0, numFrames, 0, true, true);
+
+            int mismatches = 0;
+            for (int ch = 0; ch < 2; ++ch)
+                for (int frame = 0; frame < numFrames; ++frame)
+                    mismatches += actual.getSample(ch, frame) != expected.getSample(ch, frame) ? 1 : 0;
+            expectEquals(mismatches, 0);
+        }
+
+        beginTest("A changed source gets a new copy");
+        {
+            const auto source = folder.getChildFile("D4_100_1.wav");
+            writeWav(source, 1, 16, 1000);
+            const auto before = TranscodeCache::getCopyFile(cacheFolder, source);
+            expect(before == TranscodeCache::getCopyFile(cacheFolder, source));
+
+            writeWav(source, 1, 16, 2000);
+            expect(before != TranscodeCache::getCopyFile(cacheFolder, source));
+
+            expect(!TranscodeCache::transcode(formatManager, folder.getChildFile("missing.mp3"),
+                                              cacheFolder.getChildFile("missing.wav")));
+        }
+
+        beginTest("Trimming deletes the least recently used copies");
+        {
+            const auto trimFolder = folder.getChildFile("Trim");
+            trimFolder.createDirectory();
+
+            const auto now = juce::Time::getCurrentTime();
+            juce::Array<juce::File> copies;
+            for (int i = 0; i < 4; ++i)
+            {
+                const auto copy = trimFolder.getChildFile("copy" + juce::String(i) + ".wav");
+                juce::MemoryBlock data(1000);
+                copy.replaceWithData(data.getData(), data.getSize());
+                copy.setLastAccessTime(now - juce::RelativeTime::hours(4 - i));   // copy0 is the oldest
+                copies.add(copy);
+            }
+
+            TranscodeCache::trim(trimFolder, 2500);
+            expect(!copies[0].existsAsFile());
+            expect(!copies[1].existsAsFile());
+            expect(copies[2].existsAsFile());
+            expect(copies[3].existsAsFile());
+
+            TranscodeCache::trim(trimFolder, 5000);
+            expect(copies[2].existsAsFile() && copies[3].existsAsFile());
+
+            // A copy still in use stays even when it is the oldest
+            copies[2].setLastAccessTime(now - juce::RelativeTime::hours(8));
+            TranscodeCache::trim(trimFolder, 1500, { copies[2].getFullPathName() });
+            expect(copies[2].existsAsFile());
+            expect(!copies[3].existsAsFile());
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    void writeWav(const juce::File& file, int numChannels, int bitsPerSample, int numFrames)
+    {
+        juce::Random random(numFrames);
+        const auto noise = TestAudioFiles::makeBuffer(numChannels, numFrames, [&random](int, int) { return random.nextFloat() - 0.5f; });
+        expect(TestAudioFiles::writeWav(file, noise, 44100.0, bitsPerSample));
+    }
+};
+
+static TranscodeCacheTests transcodeCacheTests;
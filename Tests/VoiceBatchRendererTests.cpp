@@ -0,0 +1,150 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include "../Source/VoiceBatchRenderer.h"
+
+//==============================================================================
+// Voice Batch Renderer Tests (lane-parallel rendering against the per-voice path)
+//==============================================================================
+class VoiceBatchRendererTests : public juce::UnitTest
+{
+public:
+    VoiceBatchRendererTests() : juce::UnitTest("Voice Batch Renderer") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 44100.0;
+        constexpr int numFrames = 20000;
+
+        // RAM-resident stereo sample of noise, so every voice reads straight from the preload
+        PreloadedSample sample;
+        sample.filePath = "batch.wav";
+        sample.totalSampleFrames = numFrames;
+        sample.preloadSizeFrames = numFrames;
+        sample.sampleRate = sampleRate;
+        sample.numChannels = 2;
+        sample.rootNote = 60;
+        sample.endFadeFrames = 2000;  // A trimmed tail, so both paths fade the end
+        sample.preloadBuffer.setSize(2, numFrames);
+
+        juce::Random random(29);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int frame = 0; frame < numFrames; ++frame)
+                sample.preloadBuffer.setSample(ch, frame, random.nextFloat() * 2.0f - 1.0f);
+
+        // Odd block sizes, some longer than a batch chunk, none a multiple of the lane width
+        const int blockSizes[] = { 37, 101, 300, 1, 513, 13, 259 };
+
+        for (int lanes : { 4, 8, 16 })
+        {
+            beginTest("Batches of " + juce::String(lanes) + " lanes match per-voice rendering");
+
+            auto scalarVoices = makeVoices(sample, sampleRate);
+            auto batchVoices = makeVoices(sample, sampleRate);
+
+            VoiceBatchRenderer renderer;
+            renderer.setLaneWidth(lanes);
+
+            juce::AudioBuffer<float> scalarOutput(2, 513), batchOutput(2, 513);
+            float maxError = 0.0f;
+            int scalarActive = 0, batchActive = 0;
+            int block = 0;
+
+            // Long enough for the lowest voice to reach the end of the sample
+            for (int rendered = 0; rendered < 2 * numFrames; ++block)
+            {
+                const int numSamples = blockSizes[block % std::size(blockSizes)];
+
+                // Release half the voices part-way through
+                if (block == 40)
+                {
+                    for (size_t v = 0; v < numTestVoices; v += 2)
+                    {
+                        (*scalarVoices)[v].stopVoice(true);
+                        (*batchVoices)[v].stopVoice(true);
+                    }
+                }
+
+                scalarOutput.clear();
+                batchOutput.clear();
+
+                for (auto& voice : *scalarVoices)
+                    if (voice.isActive())
+                        voice.renderNextBlock(scalarOutput, 0, numSamples);
+
+                renderer.render(*batchVoices, batchOutput, 0, numSamples);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        maxError = std::max(maxError, std::abs(scalarOutput.getSample(ch, i) - batchOutput.getSample(ch, i)));
+
+                scalarActive = countActive(*scalarVoices);
+                batchActive = countActive(*batchVoices);
+                if (scalarActive != batchActive)
+                    break;
+
+                rendered += numSamples;
+            }
+
+            // Summation order differs between the paths, so allow for float rounding only
+            expect(maxError < 1.0e-5f, "max difference " + juce::String(maxError));
+            expectEquals(batchActive, scalarActive);
+            expectEquals(scalarActive, 0);
+        }
+
+        beginTest("A trimmed end fades out instead of stopping dead");
+        {
+            // Full scale DC, so the output is the gain
+            PreloadedSample dc = sample;
+            dc.preloadBuffer.setSize(2, numFrames);
+            for (int ch = 0; ch < 2; ++ch)
+                for (int frame = 0; frame < numFrames; ++frame)
+                    dc.preloadBuffer.setSample(ch, frame, 1.0f);
+
+            StreamingVoice voice;
+            voice.prepareToPlay(sampleRate, 512);
+            voice.setADSRParameters({ 0.001f, 0.001f, 1.0f, 0.1f });
+            voice.startVoice(&dc, 60, 1.0f, sampleRate);
+
+            juce::AudioBuffer<float> output(2, numFrames + 64);
+            output.clear();
+            voice.renderNextBlock(output, 0, output.getNumSamples());
+
+            expect(!voice.isActive());
+            expectWithinAbsoluteError(output.getSample(0, numFrames - 2001), 1.0f, 1.0e-4f);
+            expectWithinAbsoluteError(output.getSample(0, numFrames - 1000), 0.5f, 1.0e-3f);
+            expect(output.getSample(0, numFrames - 1) < 0.001f);
+        }
+    }
+
+private:
+    // Not a multiple of any lane width, so the last group is always partly padding
+    static constexpr size_t numTestVoices = 11;
+
+    static std::unique_ptr<VoiceBatchRenderer::VoiceArray> makeVoices(const PreloadedSample& sample, double sampleRate)
+    {
+        auto voices = std::make_unique<VoiceBatchRenderer::VoiceArray>();
+        for (size_t v = 0; v < numTestVoices; ++v)
+        {
+            auto& voice = (*voices)[v];
+            voice.prepareToPlay(sampleRate, 512);
+            voice.setADSRParameters({ 0.005f, 0.05f, 0.6f, 0.02f });
+
+            // Root pitch (copy path) and pitched voices (linear interpolation), up and down
+            const int note = v % 3 == 0 ? 60 : 54 + static_cast<int>(v);
+            voice.startVoice(&sample, note, 0.3f + 0.06f * static_cast<float>(v), sampleRate);
+        }
+        return voices;
+    }
+
+    static int countActive(const VoiceBatchRenderer::VoiceArray& voices)
+    {
+        int active = 0;
+        for (const auto& voice : voices)
+            active += voice.isActive() ? 1 : 0;
+        return active;
+    }
+};
+
+static VoiceBatchRendererTests voiceBatchRendererTests;
@@ -0,0 +1,113 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <iterator>
+#include <memory>
+#include "../Source/VoiceRenderPool.h"
+
+//==============================================================================
+// Voice Render Pool Tests (multi-threaded rendering against the per-voice path)
+//==============================================================================
+class VoiceRenderPoolTests : public juce::UnitTest
+{
+public:
+    VoiceRenderPoolTests() : juce::UnitTest("Voice Render Pool") {}
+
+    void runTest() override
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int numFrames = 24000;
+        constexpr int numChannels = 3;   // One more than the sources: the extra channel mirrors the right
+
+        PreloadedSample sample;
+        sample.filePath = "pool.wav";
+        sample.totalSampleFrames = numFrames;
+        sample.preloadSizeFrames = numFrames;
+        sample.sampleRate = sampleRate;
+        sample.numChannels = 2;
+        sample.rootNote = 60;
+        sample.preloadBuffer.setSize(2, numFrames);
+
+        juce::Random random(31);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int frame = 0; frame < numFrames; ++frame)
+                sample.preloadBuffer.setSample(ch, frame, random.nextFloat() * 2.0f - 1.0f);
+
+        // Blocks longer than the prepared size are rendered in chunks
+        const int blockSizes[] = { 128, 61, 300, 1, 97 };
+
+        for (int numWorkers : { 1, 3, VoiceRenderPool::maxWorkers })
+        {
+            beginTest(juce::String(numWorkers) + " workers render bit-identically to one thread");
+
+            auto singleVoices = makeVoices(sample, sampleRate);
+            auto pooledVoices = makeVoices(sample, sampleRate);
+
+            VoiceRenderPool pool;
+            pool.prepare(sampleRate, 128, numChannels);
+            pool.setNumWorkers(numWorkers);
+            expectEquals(pool.getNumWorkers(), numWorkers);
+
+            juce::AudioBuffer<float> singleOutput(numChannels, 300), pooledOutput(numChannels, 300);
+            int mismatches = 0;
+            bool extraChannelRendered = true;
+            float loudest = 0.0f;
+
+            for (int rendered = 0, block = 0; rendered < numFrames; ++block)
+            {
+                const int numSamples = blockSizes[static_cast<size_t>(block) % std::size(blockSizes)];
+
+                // Release some voices part-way through
+                if (block == 30)
+                {
+                    for (size_t v = 0; v < numTestVoices; v += 3)
+                    {
+                        (*singleVoices)[v].stopVoice(true);
+                        (*pooledVoices)[v].stopVoice(true);
+                    }
+                }
+
+                singleOutput.clear();
+                pooledOutput.clear();
+
+                for (auto& voice : *singleVoices)
+                    if (voice.isActive())
+                        voice.renderNextBlock(singleOutput, 0, numSamples);
+
+                pool.render(*pooledVoices, pooledOutput, 0, numSamples);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < numSamples; ++i)
+                        mismatches += singleOutput.getSample(ch, i) != pooledOutput.getSample(ch, i) ? 1 : 0;
+
+                for (int i = 0; i < numSamples; ++i)
+                    extraChannelRendered = extraChannelRendered && pooledOutput.getSample(2, i) == pooledOutput.getSample(1, i);
+
+                loudest = std::max(loudest, pooledOutput.getMagnitude(2, 0, numSamples));
+                rendered += numSamples;
+            }
+
+            expectEquals(mismatches, 0);
+            expect(extraChannelRendered);
+            expect(loudest > 0.1f);
+        }
+    }
+
+private:
+    // Enough voices for every worker to get a partition
+    static constexpr size_t numTestVoices = 70;
+
+    static std::unique_ptr<VoiceRenderPool::VoiceArray> makeVoices(const PreloadedSample& sample, double sampleRate)
+    {
+        auto voices = std::make_unique<VoiceRenderPool::VoiceArray>();
+        for (size_t v = 0; v < numTestVoices; ++v)
+        {
+            auto& voice = (*voices)[v];
+            voice.prepareToPlay(sampleRate, 512);
+            voice.setADSRParameters({ 0.002f, 0.05f, 0.5f, 0.03f });
+            voice.setInterpolationQuality(v % 2 == 0 ? InterpolationQuality::Linear : InterpolationQuality::Cubic);
+            voice.startVoice(&sample, 48 + static_cast<int>(v % 25), 0.1f + 0.01f * static_cast<float>(v), sampleRate);
+        }
+        return voices;
+    }
+};
+
+static VoiceRenderPoolTests voiceRenderPoolTests;
@@ -0,0 +1,51 @@
+#include <juce_core/juce_core.h>
+#include <iostream>
+#include "../Source/SampleContainer.h"
+
+//==============================================================================
+// Packs a sample folder into a single-file library container (see SampleContainer)
+//
+//   HammerSamplerPack <folder> [--output <file>] [--head-kb <KB>] [--pcm]
+//
+// The container goes into the folder as <folder name>.hspack unless --output says otherwise;
+// the sampler then loads the folder from the container and ignores the loose files.
+// Integer audio is compressed losslessly unless --pcm is given.
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.size() == 0 || args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: HammerSamplerPack <folder> [--output <file>] [--head-kb <KB>] [--pcm]" << std::endl;
+        return args.size() == 0 ? 1 : 0;
+    }
+
+    const juce::File folder = args[0].resolveAsFile();
+    if (!folder.isDirectory())
+    {
+        std::cerr << folder.getFullPathName() << " is not a folder" << std::endl;
+        return 1;
+    }
+
+    juce::File destination = folder.getChildFile(folder.getFileName() + SampleContainer::fileExtension);
+    if (args.containsOption("--output"))
+        destination = args.getFileForOption("--output");
+
+    int64_t headBytes = SampleContainer::defaultHeadBytes;
+    if (args.containsOption("--head-kb"))
+        headBytes = static_cast<int64_t>(args.getValueForOption("--head-kb").getIntValue()) * 1024;
+
+    const bool compress = !args.containsOption("--pcm");
+
+    const auto result = SampleContainer::pack(folder, destination, headBytes, compress);
+    if (result.failed())
+    {
+        std::cerr << result.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Packed " << folder.getFullPathName() << " into " << destination.getFullPathName()
+              << " (" << destination.getSize() / (1024 * 1024) << " MB)" << std::endl;
+    return 0;
+}